@@ -0,0 +1,126 @@
+#include <stdio.h> // printf, fprintf
+#include <stdlib.h> // strtoul
+#include <string.h> // strncmp
+
+#include "rx/core/memory/stats_allocator.h"
+#include "rx/core/memory/heap_allocator.h"
+#include "rx/core/memory/system_allocator.h"
+
+#include "rx/core/concurrency/thread.h"
+#include "rx/core/time/stop_watch.h"
+#include "rx/core/vector.h"
+#include "rx/core/global.h"
+
+// Compares the system allocator to a heap allocator with statistics, which is
+// what the system allocator was before it had per-thread caches, on small
+// allocations made from several threads at once.
+//
+// Every thread keeps a window of live allocations of random small sizes and
+// replaces a random one of them on every operation, which is roughly what
+// loading many models and materials on the thread pool looks like. The time
+// is the wall time for every thread to finish, divided by all operations.
+//
+// Usage: allocator [--threads=N] [--operations=N]
+
+using namespace Rx;
+
+struct Options {
+  Size threads;
+  Size operations;
+};
+
+static constexpr const Size k_window{1024};
+static constexpr const Size k_max_size{512};
+
+static Uint64 next(Uint64& state_) {
+  state_ ^= state_ << 13;
+  state_ ^= state_ >> 7;
+  state_ ^= state_ << 17;
+  return state_;
+}
+
+static void churn(Memory::Allocator& _allocator, Size _seed, Size _operations) {
+  Byte* live[k_window]{};
+  Uint64 state{_seed * 0x9e3779b97f4a7c15_u64 + 1};
+  for (Size i{0}; i < _operations; i++) {
+    const Uint64 random{next(state)};
+    Byte*& slot{live[random % k_window]};
+    _allocator.deallocate(slot);
+    slot = _allocator.allocate((random >> 32) % k_max_size + 1);
+    slot[0] = 1;
+  }
+  for (Size i{0}; i < k_window; i++) {
+    _allocator.deallocate(live[i]);
+  }
+}
+
+static Float64 measure(Memory::Allocator& _allocator, const Options& _options) {
+  Time::StopWatch timer;
+  timer.start();
+  {
+    // The calling thread is one of the threads.
+    Vector<Concurrency::Thread> threads;
+    for (Size i{1}; i < _options.threads; i++) {
+      threads.emplace_back("churn", [&, i](int) {
+        churn(_allocator, i, _options.operations);
+      });
+    }
+    churn(_allocator, 0, _options.operations);
+    threads.each_fwd([](Concurrency::Thread& _thread) {
+      _thread.join();
+    });
+  }
+  timer.stop();
+  return timer.elapsed().total_milliseconds() * 1000000.0
+    / Float64(_options.operations * _options.threads);
+}
+
+static void print(const char* _name, Float64 _ns, Size _allocations) {
+  printf("  %-16s %7.1f ns  allocations %zu\n", _name, _ns, _allocations);
+}
+
+static bool parse(int _argc, char** _argv, Options& options_) {
+  for (int i{1}; i < _argc; i++) {
+    const char* argument{_argv[i]};
+    if (!strncmp(argument, "--threads=", 10)) {
+      options_.threads = strtoul(argument + 10, nullptr, 10);
+    } else if (!strncmp(argument, "--operations=", 13)) {
+      options_.operations = strtoul(argument + 13, nullptr, 10);
+    } else {
+      return false;
+    }
+  }
+  return options_.threads != 0 && options_.operations != 0;
+}
+
+int main(int _argc, char** _argv) {
+  Options options{4, 1000000};
+  if (!parse(_argc, _argv, options)) {
+    fprintf(stderr, "usage: %s [--threads=N] [--operations=N]\n", _argv[0]);
+    return 1;
+  }
+
+  if (!Globals::link()) {
+    return 1;
+  }
+
+  Globals::init();
+
+  printf("%zu threads, %zu operations each:\n", options.threads, options.operations);
+  {
+    Memory::StatsAllocator heap{Memory::HeapAllocator::instance()};
+    const Float64 ns{measure(heap, options)};
+    print("heap", ns, heap.stats().allocations);
+  }
+  {
+    // A thread only caches for one allocator, so this has to be the system one.
+    auto& system{static_cast<Memory::SystemAllocator&>(Memory::SystemAllocator::instance())};
+    const Size allocations{system.stats().allocations};
+    const Float64 ns{measure(system, options)};
+    print("system", ns, system.stats().allocations - allocations);
+  }
+
+  Globals::fini();
+
+  return 0;
+}
@@ -0,0 +1,157 @@
+#include <stdio.h> // printf, fprintf
+#include <stdlib.h> // strtoul
+#include <string.h> // strncmp
+
+#include "rx/core/concurrency/thread_pool.h"
+#include "rx/core/concurrency/atomic.h"
+#include "rx/core/concurrency/yield.h"
+
+#include "rx/core/memory/stats_allocator.h"
+
+#include "rx/core/time/stop_watch.h"
+#include "rx/core/function.h"
+#include "rx/core/global.h"
+
+// Counts the allocations made for every task given to ThreadPool::add.
+//
+// For every capture size the cost of a Function on its own is measured first,
+// then that of adding it to a thread pool and running it. Tasks are wrapped
+// in a Function on a StatsAllocator, which is also the allocator of the pool,
+// so both the allocations of the Function and those of the pool are counted.
+// Every capture size is warmed up once before the measured run so the pool
+// has already grown its job memory.
+//
+// Lambdas capturing up to Function::k_inline_size bytes should not allocate
+// at all, larger ones allocate once for the callable.
+//
+// Usage: function [--tasks=N] [--threads=N]
+
+using namespace Rx;
+
+using Task = Function<void(int)>;
+
+struct Options {
+  Size tasks;
+  Size threads;
+};
+
+template<Size E>
+struct Capture {
+  Concurrency::Atomic<Size>* done;
+  Byte padding[E];
+};
+
+// Construct, move, call and destroy a Function on its own.
+template<Size E>
+static void measure_function(Memory::StatsAllocator& _allocator, Size _tasks) {
+  Concurrency::Atomic<Size> done{0};
+
+  const auto before{_allocator.stats().allocations};
+  Time::StopWatch timer;
+  timer.start();
+  for (Size i{0}; i < _tasks; i++) {
+    Capture<E> capture;
+    capture.done = &done;
+    Task task{_allocator, [capture](int) {
+      capture.done->fetch_add(1, Concurrency::MemoryOrder::k_relaxed);
+    }};
+    Task moved{Utility::move(task)};
+    moved(0);
+  }
+  timer.stop();
+  const auto allocations{_allocator.stats().allocations - before};
+
+  printf("  function:\n");
+  printf("    allocations/task: %.3f\n", Float64(allocations) / _tasks);
+  printf("    time/task:        %.1f ns\n",
+    timer.elapsed().total_milliseconds() * 1000000.0 / Float64(_tasks));
+}
+
+template<Size E>
+static void measure_pool(Concurrency::ThreadPool& _pool,
+  Memory::StatsAllocator& _allocator, Size _tasks)
+{
+  Concurrency::Atomic<Size> done{0};
+
+  auto submit{[&](Size _count) {
+    done.store(0, Concurrency::MemoryOrder::k_relaxed);
+    for (Size i{0}; i < _count; i++) {
+      Capture<E> capture;
+      capture.done = &done;
+      _pool.add(Task{_allocator, [capture](int) {
+        capture.done->fetch_add(1, Concurrency::MemoryOrder::k_relaxed);
+      }});
+    }
+    while (done.load(Concurrency::MemoryOrder::k_acquire) != _count) {
+      if (!_pool.help()) {
+        Concurrency::yield();
+      }
+    }
+  }};
+
+  submit(_tasks);
+
+  const auto before{_allocator.stats().allocations};
+  Time::StopWatch timer;
+  timer.start();
+  submit(_tasks);
+  timer.stop();
+  const auto allocations{_allocator.stats().allocations - before};
+
+  printf("  thread pool:\n");
+  printf("    allocations/add:  %.3f\n", Float64(allocations) / _tasks);
+  printf("    time/add:         %.1f ns\n",
+    timer.elapsed().total_milliseconds() * 1000000.0 / Float64(_tasks));
+}
+
+template<Size E>
+static void run(const char* _name, Concurrency::ThreadPool& _pool,
+  Memory::StatsAllocator& _allocator, Size _tasks)
+{
+  printf("%s (%zu bytes):\n", _name, sizeof(Capture<E>));
+  measure_function<E>(_allocator, _tasks);
+  measure_pool<E>(_pool, _allocator, _tasks);
+}
+
+static bool parse(int _argc, char** _argv, Options& options_) {
+  for (int i{1}; i < _argc; i++) {
+    const char* argument{_argv[i]};
+    if (!strncmp(argument, "--tasks=", 8)) {
+      options_.tasks = strtoul(argument + 8, nullptr, 10);
+    } else if (!strncmp(argument, "--threads=", 10)) {
+      options_.threads = strtoul(argument + 10, nullptr, 10);
+    } else {
+      return false;
+    }
+  }
+  return options_.tasks != 0 && options_.threads != 0;
+}
+
+int main(int _argc, char** _argv) {
+  Options options{100000, 4};
+  if (!parse(_argc, _argv, options)) {
+    fprintf(stderr, "usage: %s [--tasks=N] [--threads=N]\n", _argv[0]);
+    return 1;
+  }
+
+  if (!Globals::link()) {
+    return 1;
+  }
+
+  Globals::init();
+
+  {
+    Memory::StatsAllocator allocator{Memory::SystemAllocator::instance()};
+    Concurrency::ThreadPool pool{allocator, options.threads, 4096};
+
+    printf("inline capacity: %zu bytes\n", Task::k_inline_size);
+
+    run<8>("pointers", pool, allocator, options.tasks);
+    run<Task::k_inline_size - sizeof(void*)>("inline", pool, allocator, options.tasks);
+    run<Task::k_inline_size>("large", pool, allocator, options.tasks);
+  }
+
+  Globals::fini();
+
+  return 0;
+}
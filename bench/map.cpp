@@ -0,0 +1,171 @@
+#include <stdio.h> // printf, fprintf
+#include <stdlib.h> // strtoul
+#include <string.h> // strncmp
+
+#include "rx/core/memory/stats_allocator.h"
+
+#include "rx/core/time/stop_watch.h"
+#include "rx/core/flat_map.h"
+#include "rx/core/map.h"
+#include "rx/core/string.h"
+#include "rx/core/vector.h"
+#include "rx/core/global.h"
+
+// Compares Map and FlatMap on integer and string keys.
+//
+// Every map has the same keys inserted, then every key is looked up, then as
+// many keys which are not in the map are looked up, then every key is erased.
+// Keys are visited in a scrambled order so lookups don't walk memory in
+// order. The allocations made by every map are counted as well.
+//
+// Usage: map [--keys=N] [--rounds=N]
+
+using namespace Rx;
+
+struct Options {
+  Size keys;
+  Size rounds;
+};
+
+struct Result {
+  Float64 insert;
+  Float64 hit;
+  Float64 miss;
+  Float64 erase;
+  Uint64 allocations;
+};
+
+static Uint32 scramble(Uint32 _value) {
+  _value ^= _value >> 16;
+  _value *= 0x7feb352d_u32;
+  _value ^= _value >> 15;
+  _value *= 0x846ca68b_u32;
+  _value ^= _value >> 16;
+  return _value;
+}
+
+static Float64 ns_per(const Time::StopWatch& _timer, Size _count) {
+  return _timer.elapsed().total_milliseconds() * 1000000.0 / Float64(_count);
+}
+
+template<template<typename, typename> class M, typename K>
+static Result measure(const Vector<K>& _keys, const Vector<K>& _misses, Size _rounds) {
+  Result result{};
+  Size found{0};
+
+  for (Size round{0}; round < _rounds; round++) {
+    Memory::StatsAllocator allocator{Memory::SystemAllocator::instance()};
+    M<K, Size> map{allocator};
+
+    Time::StopWatch timer;
+    timer.start();
+    for (Size i{0}; i < _keys.size(); i++) {
+      map.insert(_keys[i], i);
+    }
+    timer.stop();
+    result.insert += ns_per(timer, _keys.size());
+
+    timer.reset();
+    timer.start();
+    for (Size i{0}; i < _keys.size(); i++) {
+      found += *map.find(_keys[i]);
+    }
+    timer.stop();
+    result.hit += ns_per(timer, _keys.size());
+
+    timer.reset();
+    timer.start();
+    for (Size i{0}; i < _misses.size(); i++) {
+      found += map.find(_misses[i]) != nullptr;
+    }
+    timer.stop();
+    result.miss += ns_per(timer, _misses.size());
+
+    timer.reset();
+    timer.start();
+    for (Size i{0}; i < _keys.size(); i++) {
+      found += map.erase(_keys[i]);
+    }
+    timer.stop();
+    result.erase += ns_per(timer, _keys.size());
+
+    result.allocations += allocator.stats().allocations;
+  }
+
+  // Keep the lookups from being optimized out.
+  if (found == 0) {
+    printf("nothing found\n");
+  }
+
+  result.insert /= _rounds;
+  result.hit /= _rounds;
+  result.miss /= _rounds;
+  result.erase /= _rounds;
+  result.allocations /= _rounds;
+
+  return result;
+}
+
+static void print(const char* _name, const Result& _result) {
+  printf("  %-8s insert %7.1f ns  hit %7.1f ns  miss %7.1f ns  erase %7.1f ns  allocations %zu\n",
+    _name, _result.insert, _result.hit, _result.miss, _result.erase,
+    static_cast<Size>(_result.allocations));
+}
+
+template<typename K>
+static void run(const char* _name, const Vector<K>& _keys, const Vector<K>& _misses, Size _rounds) {
+  printf("%s (%zu keys):\n", _name, _keys.size());
+  print("Map", measure<Map>(_keys, _misses, _rounds));
+  print("FlatMap", measure<FlatMap>(_keys, _misses, _rounds));
+}
+
+static bool parse(int _argc, char** _argv, Options& options_) {
+  for (int i{1}; i < _argc; i++) {
+    const char* argument{_argv[i]};
+    if (!strncmp(argument, "--keys=", 7)) {
+      options_.keys = strtoul(argument + 7, nullptr, 10);
+    } else if (!strncmp(argument, "--rounds=", 9)) {
+      options_.rounds = strtoul(argument + 9, nullptr, 10);
+    } else {
+      return false;
+    }
+  }
+  return options_.keys != 0 && options_.rounds != 0;
+}
+
+int main(int _argc, char** _argv) {
+  Options options{100000, 5};
+  if (!parse(_argc, _argv, options)) {
+    fprintf(stderr, "usage: %s [--keys=N] [--rounds=N]\n", _argv[0]);
+    return 1;
+  }
+
+  if (!Globals::link()) {
+    return 1;
+  }
+
+  Globals::init();
+
+  {
+    // |scramble| is a bijection so all of these are different.
+    Vector<Uint32> integers;
+    Vector<Uint32> integer_misses;
+    Vector<String> strings;
+    Vector<String> string_misses;
+    for (Size i{0}; i < options.keys; i++) {
+      const Uint32 hit{scramble(static_cast<Uint32>(i))};
+      const Uint32 miss{scramble(static_cast<Uint32>(i + options.keys))};
+      integers.push_back(hit);
+      integer_misses.push_back(miss);
+      strings.push_back(String::format("textures/%08x.png", hit));
+      string_misses.push_back(String::format("textures/%08x.png", miss));
+    }
+
+    run("Uint32", integers, integer_misses, options.rounds);
+    run("String", strings, string_misses, options.rounds);
+  }
+
+  Globals::fini();
+
+  return 0;
+}
@@ -0,0 +1,292 @@
+#include <stdio.h> // printf, fprintf
+#include <stdlib.h> // strtoul
+#include <string.h> // strcmp, strncmp
+
+#include "rx/render/backend/null.h"
+
+#include "rx/render/frontend/context.h"
+#include "rx/render/frontend/target.h"
+
+#include "rx/render/immediate2D.h"
+#include "rx/render/immediate3D.h"
+#include "rx/render/gbuffer.h"
+#include "rx/render/model.h"
+
+#include "rx/core/time/stop_watch.h"
+#include "rx/core/function.h"
+#include "rx/core/global.h"
+
+// Headless benchmark for the CPU side of the renderer.
+//
+// Drives synthetic scenes through a frontend context on top of the null
+// backend. The null backend does no work so what's measured is the cost of
+// recording commands, generating geometry and processing the frame in the
+// frontend. This lets machines without a GPU catch regressions in it.
+//
+// Usage: render [--scene=all|model|immediate2D|immediate3D] [--frames=N]
+//               [--draws=N] [--capture=FILE]
+//
+// Where --draws is the number of draws to record each frame, in thousands.
+// With --capture one more frame is rendered after the measured ones and
+// captured to FILE, which can be handed to the replay benchmark. When more
+// than one scene runs the last one is what ends up captured.
+
+using namespace Rx;
+
+static constexpr const Math::Vec2z k_resolution{1600, 900};
+
+struct Options {
+  const char* scene;
+  Size frames;
+  Size draws;
+  const char* capture;
+};
+
+struct Result {
+  Float64 total_milliseconds;
+  Float64 worst_milliseconds;
+  Size draw_calls;
+  Size commands;
+  Size footprint;
+  Size command_memory;
+};
+
+using FrameFunction = Function<void(Size _frame)>;
+
+static const Math::Mat4x4f& projection() {
+  static const auto projection{Math::Mat4x4f::perspective(90.0f,
+    {0.01f, 2048.0f}, Float32(k_resolution.w) / Float32(k_resolution.h))};
+  return projection;
+}
+
+// Spread |_index| out on a grid in front of the camera.
+static Math::Vec3f position_of(Size _index) {
+  return {
+    Float32(_index % 32) - 16.0f,
+    Float32(_index / 32 % 32) - 16.0f,
+    Float32(_index / 1024) + 32.0f
+  };
+}
+
+// Run |_frame| for every frame, timing from the start of recording until the
+// frontend is done with the frame.
+static void run(Render::Frontend::Context& _frontend, const Options& _options,
+  FrameFunction&& frame_, Result& result_)
+{
+  // Warm up so caches, pools and command pages reach their steady state.
+  for (Size i{0}; i < 4; i++) {
+    frame_(i);
+    _frontend.process();
+    _frontend.swap();
+  }
+
+  result_ = {};
+
+  for (Size i{0}; i < _options.frames; i++) {
+    Time::StopWatch timer;
+    timer.start();
+    frame_(i);
+    _frontend.process();
+    timer.stop();
+
+    const Float64 milliseconds{timer.elapsed().total_milliseconds()};
+    result_.total_milliseconds += milliseconds;
+    if (milliseconds > result_.worst_milliseconds) {
+      result_.worst_milliseconds = milliseconds;
+    }
+
+    result_.draw_calls += _frontend.draw_calls();
+    result_.commands += _frontend.commands();
+    result_.footprint += _frontend.footprint();
+
+    _frontend.swap();
+  }
+
+  result_.command_memory = _frontend.command_memory_peak();
+
+  if (_options.capture) {
+    _frontend.capture(_options.capture);
+    frame_(_options.frames);
+    _frontend.process();
+    _frontend.swap();
+  }
+}
+
+// Draws a model once per instance, each mesh in it is a draw.
+static bool scene_model(Render::Frontend::Context& _frontend,
+  const Options& _options, Result& result_)
+{
+  Render::GBuffer gbuffer{&_frontend};
+  gbuffer.create(k_resolution);
+
+  Render::Model model{&_frontend};
+  if (!model.load("base/models/mrfixit/mrfixit.json5")) {
+    fprintf(stderr, "failed to load model\n");
+    return false;
+  }
+
+  const Size meshes{model.opaque_meshes().size()
+    + model.transparent_meshes().size()};
+  if (meshes == 0) {
+    fprintf(stderr, "model has no meshes\n");
+    return false;
+  }
+
+  const Size instances{(_options.draws * 1000 + meshes - 1) / meshes};
+
+  run(_frontend, _options, [&](Size) {
+    const Math::Mat4x4f view;
+    for (Size i{0}; i < instances; i++) {
+      const auto transform{Math::Mat4x4f::translate(position_of(i))};
+      model.render(gbuffer.target(), transform, view, projection());
+    }
+  }, result_);
+
+  return true;
+}
+
+// Alternates between opaque and translucent rectangles so every rectangle
+// ends up in a batch of it's own, and so a draw of it's own. The rectangles
+// move every frame so the geometry is generated every frame.
+static bool scene_immediate2D(Render::Frontend::Context& _frontend,
+  const Options& _options, Result& result_)
+{
+  Render::Immediate2D immediate{&_frontend};
+
+  const Size rectangles{_options.draws * 1000};
+
+  run(_frontend, _options, [&](Size _frame) {
+    auto& queue{immediate.frame_queue()};
+    for (Size i{0}; i < rectangles; i++) {
+      const Math::Vec2f position{
+        Float32((i * 7 + _frame) % k_resolution.w),
+        Float32((i * 13) % k_resolution.h)};
+      const Math::Vec4f color{1.0f, 1.0f, 1.0f, i % 2 ? 1.0f : 0.5f};
+      queue.record_rectangle(position, {16.0f, 16.0f}, 0.0f, color);
+    }
+    immediate.render(_frontend.swapchain());
+  }, result_);
+
+  return true;
+}
+
+// Alternates between depth tested and untested cubes so every cube ends up in
+// a batch of it's own.
+static bool scene_immediate3D(Render::Frontend::Context& _frontend,
+  const Options& _options, Result& result_)
+{
+  Render::Immediate3D immediate{&_frontend};
+
+  const Size cubes{_options.draws * 1000};
+
+  run(_frontend, _options, [&](Size _frame) {
+    auto& queue{immediate.frame_queue()};
+    for (Size i{0}; i < cubes; i++) {
+      const auto offset{Math::Vec3f{Float32(_frame % 2), 0.0f, 0.0f}};
+      const auto transform{Math::Mat4x4f::translate(position_of(i) + offset)};
+      const Uint8 flags{i % 2 ? Uint8(Render::Immediate3D::k_depth_test) : Uint8(0)};
+      queue.record_solid_cube({1.0f, 1.0f, 1.0f, 1.0f}, transform, flags);
+    }
+    immediate.render(_frontend.swapchain(), {}, projection());
+  }, result_);
+
+  return true;
+}
+
+static void report(const char* _scene, const Options& _options,
+  const Result& _result)
+{
+  const Float64 frames{Float64(_options.frames)};
+  const Float64 seconds{_result.total_milliseconds / 1000.0};
+
+  printf("%s:\n", _scene);
+  printf("  cpu/frame:    %.3f ms (worst %.3f ms)\n",
+    _result.total_milliseconds / frames, _result.worst_milliseconds);
+  printf("  draws/frame:  %.0f\n", Float64(_result.draw_calls) / frames);
+  printf("  commands/sec: %.0f\n", Float64(_result.commands) / seconds);
+  printf("  footprint:    %.0f bytes/frame\n",
+    Float64(_result.footprint) / frames);
+  printf("  commands:     %zu bytes peak\n", _result.command_memory);
+}
+
+static bool parse(int _argc, char** _argv, Options& options_) {
+  for (int i{1}; i < _argc; i++) {
+    const char* argument{_argv[i]};
+    if (!strncmp(argument, "--scene=", 8)) {
+      options_.scene = argument + 8;
+    } else if (!strncmp(argument, "--frames=", 9)) {
+      options_.frames = strtoul(argument + 9, nullptr, 10);
+    } else if (!strncmp(argument, "--draws=", 8)) {
+      options_.draws = strtoul(argument + 8, nullptr, 10);
+    } else if (!strncmp(argument, "--capture=", 10)) {
+      options_.capture = argument + 10;
+    } else {
+      return false;
+    }
+  }
+  return options_.frames != 0 && options_.draws != 0;
+}
+
+int main(int _argc, char** _argv) {
+  Options options{"all", 100, 10, nullptr};
+  if (!parse(_argc, _argv, options)) {
+    fprintf(stderr, "usage: %s [--scene=all|model|immediate2D|immediate3D]"
+      " [--frames=N] [--draws=N] [--capture=FILE]\n", _argv[0]);
+    return 1;
+  }
+
+  if (!Globals::link()) {
+    return 1;
+  }
+
+  Globals::init();
+
+  const struct {
+    const char* name;
+    bool (*run)(Render::Frontend::Context&, const Options&, Result&);
+  } k_scenes[]{
+    {"model",       scene_model},
+    {"immediate2D", scene_immediate2D},
+    {"immediate3D", scene_immediate3D}
+  };
+
+  auto& allocator{Memory::SystemAllocator::instance()};
+
+  int status{0};
+  {
+    Render::Backend::Null backend{allocator, nullptr};
+    if (!backend.init()) {
+      return 1;
+    }
+
+    bool found{false};
+    for (const auto& scene : k_scenes) {
+      if (strcmp(options.scene, "all") && strcmp(options.scene, scene.name)) {
+        continue;
+      }
+
+      found = true;
+
+      // Every scene gets a context of it's own so nothing it measures, like
+      // the peak of command memory, carries over from the scene before it.
+      Render::Frontend::Context frontend{allocator, &backend, k_resolution, false};
+
+      Result result;
+      if (!scene.run(frontend, options, result)) {
+        status = 1;
+        break;
+      }
+
+      report(scene.name, options, result);
+    }
+
+    if (!found) {
+      fprintf(stderr, "unknown scene '%s'\n", options.scene);
+      status = 1;
+    }
+  }
+
+  Globals::fini();
+
+  return status;
+}
@@ -0,0 +1,131 @@
+#include <stdio.h> // printf, fprintf
+#include <stdlib.h> // strtoul
+#include <string.h> // strncmp
+
+#include "rx/render/backend/null.h"
+
+#include "rx/render/frontend/context.h"
+#include "rx/render/frontend/replay.h"
+
+#include "rx/core/filesystem/file.h"
+#include "rx/core/time/stop_watch.h"
+#include "rx/core/global.h"
+
+// Benchmark for the backend side of the renderer.
+//
+// Loads a frame captured with the "capture_frame" console command, or with
+// the render benchmark, and hands it's commands to a backend over and over.
+// Since the commands are recorded once, what's measured is only the cost of
+// the backend consuming them.
+//
+// This drives the null backend, which consumes nothing, so here it mostly
+// checks that a capture loads. The same |Replay| works on any backend and is
+// how a captured frame gets measured on one that renders.
+//
+// Usage: replay FILE [--frames=N]
+
+using namespace Rx;
+
+struct Options {
+  const char* file;
+  Size frames;
+};
+
+static bool parse(int _argc, char** _argv, Options& options_) {
+  for (int i{1}; i < _argc; i++) {
+    const char* argument{_argv[i]};
+    if (!strncmp(argument, "--frames=", 9)) {
+      options_.frames = strtoul(argument + 9, nullptr, 10);
+    } else if (!options_.file && strncmp(argument, "--", 2)) {
+      options_.file = argument;
+    } else {
+      return false;
+    }
+  }
+  return options_.file && options_.frames != 0;
+}
+
+static bool run(Render::Frontend::Context& _frontend,
+  Render::Backend::Context& _backend, const Options& _options)
+{
+  Render::Frontend::Replay replay{&_frontend, &_backend};
+
+  {
+    Filesystem::File file{_options.file, "rb"};
+    if (!file) {
+      fprintf(stderr, "failed to open '%s'\n", _options.file);
+      return false;
+    }
+    if (!replay.load(&file)) {
+      fprintf(stderr, "failed to load capture '%s'\n", _options.file);
+      return false;
+    }
+  }
+
+  Float64 total_milliseconds{0.0};
+  Float64 worst_milliseconds{0.0};
+
+  for (Size i{0}; i < _options.frames; i++) {
+    Time::StopWatch timer;
+    timer.start();
+    replay.process();
+    timer.stop();
+
+    const Float64 milliseconds{timer.elapsed().total_milliseconds()};
+    total_milliseconds += milliseconds;
+    if (milliseconds > worst_milliseconds) {
+      worst_milliseconds = milliseconds;
+    }
+
+    _frontend.swap();
+  }
+
+  const Float64 frames{Float64(_options.frames)};
+  const Float64 seconds{total_milliseconds / 1000.0};
+
+  printf("%s:\n", _options.file);
+  printf("  resolution:   %zux%zu\n", replay.dimensions().w,
+    replay.dimensions().h);
+  printf("  commands:     %zu\n", replay.commands());
+  printf("  cpu/frame:    %.3f ms (worst %.3f ms)\n",
+    total_milliseconds / frames, worst_milliseconds);
+  printf("  commands/sec: %.0f\n", Float64(replay.commands()) * frames / seconds);
+
+  return true;
+}
+
+int main(int _argc, char** _argv) {
+  Options options{nullptr, 100};
+  if (!parse(_argc, _argv, options)) {
+    fprintf(stderr, "usage: %s FILE [--frames=N]\n", _argv[0]);
+    return 1;
+  }
+
+  if (!Globals::link()) {
+    return 1;
+  }
+
+  Globals::init();
+
+  auto& allocator{Memory::SystemAllocator::instance()};
+
+  int status{0};
+  {
+    Render::Backend::Null backend{allocator, nullptr};
+    if (!backend.init()) {
+      return 1;
+    }
+
+    Render::Frontend::Context frontend{allocator, &backend, {1, 1}, false};
+    if (!run(frontend, backend, options)) {
+      status = 1;
+    }
+
+    // Release the resources of the replay.
+    frontend.process();
+  }
+
+  Globals::fini();
+
+  return status;
+}
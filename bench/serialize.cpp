@@ -0,0 +1,279 @@
+#include <stdio.h> // printf, fprintf, remove
+#include <stdlib.h> // strtoul
+#include <string.h> // strncmp, memcpy
+
+#include "rx/core/serialize/encoder.h"
+#include "rx/core/serialize/decoder.h"
+
+#include "rx/core/filesystem/file.h"
+#include "rx/core/filesystem/mapped_file.h"
+
+#include "rx/core/time/stop_watch.h"
+#include "rx/core/vector.h"
+#include "rx/core/global.h"
+
+// Throughput of integer arrays through serialize::Encoder and Decoder.
+//
+// Every data set is written and read back a write_uint and read_uint an
+// element at a time, then as a single block in every ArrayEncoding, and raw
+// blocks are also viewed in place. Reads are from a MappedFile so the stream
+// is memory backed, which is the case the bulk paths are for. Throughput is
+// in bytes of the decoded array a second, next to that of a memcpy of the
+// same array for what memory bandwidth allows.
+//
+// The data sets are indices, which grow slowly like those of a mesh, small
+// values which are a byte each as varints, and random 32-bit values.
+//
+// Usage: serialize [--count=N] [--iterations=N] [--file=PATH]
+
+using namespace Rx;
+using namespace Rx::serialize;
+
+struct Options {
+  Size count;
+  Size iterations;
+  const char* file;
+};
+
+// How an array is written and read back.
+enum class Method {
+  k_element,
+  k_varint,
+  k_delta,
+  k_raw,
+  k_view
+};
+
+struct Result {
+  Size bytes;
+  Float64 write;
+  Float64 read;
+  bool ok;
+};
+
+static Uint64 next(Uint64& state_) {
+  state_ ^= state_ << 13;
+  state_ ^= state_ >> 7;
+  state_ ^= state_ << 17;
+  return state_;
+}
+
+static const char* name_of(Method _method) {
+  switch (_method) {
+  case Method::k_element:
+    return "element";
+  case Method::k_varint:
+    return "varint";
+  case Method::k_delta:
+    return "delta";
+  case Method::k_raw:
+    return "raw";
+  case Method::k_view:
+    return "view";
+  }
+  return "?";
+}
+
+static ArrayEncoding encoding_of(Method _method) {
+  switch (_method) {
+  case Method::k_delta:
+    return ArrayEncoding::k_delta;
+  case Method::k_raw:
+    [[fallthrough]];
+  case Method::k_view:
+    return ArrayEncoding::k_raw;
+  default:
+    return ArrayEncoding::k_varint;
+  }
+}
+
+static bool write(const Vector<Uint32>& _data, Method _method, const char* _file) {
+  Filesystem::File file{_file, "wb"};
+  if (!file) {
+    return false;
+  }
+
+  Encoder encoder{&file};
+  if (_method != Method::k_element) {
+    return encoder.write_uint_array(_data.data(), _data.size(), encoding_of(_method));
+  }
+
+  for (Size i{0}; i < _data.size(); i++) {
+    if (!encoder.write_uint(_data[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool read(Decoder& decoder_, Vector<Uint32>& result_, Method _method) {
+  switch (_method) {
+  case Method::k_element:
+    for (Size i{0}; i < result_.size(); i++) {
+      Uint64 value{0};
+      if (!decoder_.read_uint(value)) {
+        return false;
+      }
+      result_[i] = static_cast<Uint32>(value);
+    }
+    return true;
+  case Method::k_view:
+    {
+      const Uint32* view{nullptr};
+      Vector<Uint32> storage;
+      if (!decoder_.view_uint_array(view, storage, result_.size())) {
+        return false;
+      }
+      // Touch what's viewed so that it's read at all.
+      Uint32 sum{0};
+      for (Size i{0}; i < result_.size(); i++) {
+        sum += view[i];
+      }
+      result_[0] = sum;
+    }
+    return true;
+  default:
+    return decoder_.read_uint_array(result_.data(), result_.size());
+  }
+}
+
+static Result measure(const Vector<Uint32>& _data, Method _method, const Options& _options) {
+  Result result{0, 0.0, 0.0, false};
+
+  Time::StopWatch timer;
+  timer.start();
+  for (Size i{0}; i < _options.iterations; i++) {
+    if (!write(_data, _method, _options.file)) {
+      return result;
+    }
+  }
+  timer.stop();
+  result.write = timer.elapsed().total_seconds();
+
+  Vector<Uint32> decoded{_data.size()};
+  for (Size i{0}; i < _options.iterations; i++) {
+    Filesystem::MappedFile file{_options.file};
+    if (!file) {
+      return result;
+    }
+
+    result.bytes = static_cast<Size>(*file.size());
+
+    Decoder decoder{&file};
+    Time::StopWatch read_timer;
+    read_timer.start();
+    const bool ok{read(decoder, decoded, _method)};
+    read_timer.stop();
+    if (!ok) {
+      return result;
+    }
+    result.read += read_timer.elapsed().total_seconds();
+  }
+
+  // A view only sums what it sees.
+  result.ok = _method == Method::k_view
+    || memcmp(decoded.data(), _data.data(), _data.size() * sizeof(Uint32)) == 0;
+
+  return result;
+}
+
+static Float64 throughput(Size _bytes, Size _iterations, Float64 _seconds) {
+  return Float64(_bytes) * Float64(_iterations) / _seconds / Float64(1 << 20);
+}
+
+static bool run(const char* _name, const Vector<Uint32>& _data, const Options& _options) {
+  const Size bytes{_data.size() * sizeof(Uint32)};
+  const Method methods[]{
+    Method::k_element,
+    Method::k_varint,
+    Method::k_delta,
+    Method::k_raw,
+    Method::k_view
+  };
+
+  printf("%s:\n", _name);
+  for (const Method method : methods) {
+    const Result result{measure(_data, method, _options)};
+    if (!result.ok) {
+      fprintf(stderr, "%s %s failed\n", _name, name_of(method));
+      return false;
+    }
+    printf("  %-8s %10zu bytes  write %9.1f MiB/s  read %9.1f MiB/s\n",
+      name_of(method), result.bytes,
+      throughput(bytes, _options.iterations, result.write),
+      throughput(bytes, _options.iterations, result.read));
+  }
+
+  return true;
+}
+
+static Float64 copy_throughput(const Vector<Uint32>& _data, Size _iterations) {
+  Vector<Uint32> copy{_data.size()};
+  Time::StopWatch timer;
+  timer.start();
+  for (Size i{0}; i < _iterations; i++) {
+    memcpy(copy.data(), _data.data(), _data.size() * sizeof(Uint32));
+  }
+  timer.stop();
+  return throughput(_data.size() * sizeof(Uint32), _iterations, timer.elapsed().total_seconds());
+}
+
+static bool parse(int _argc, char** _argv, Options& options_) {
+  for (int i{1}; i < _argc; i++) {
+    const char* argument{_argv[i]};
+    if (!strncmp(argument, "--count=", 8)) {
+      options_.count = strtoul(argument + 8, nullptr, 10);
+    } else if (!strncmp(argument, "--iterations=", 13)) {
+      options_.iterations = strtoul(argument + 13, nullptr, 10);
+    } else if (!strncmp(argument, "--file=", 7)) {
+      options_.file = argument + 7;
+    } else {
+      return false;
+    }
+  }
+  return options_.count != 0 && options_.iterations != 0;
+}
+
+int main(int _argc, char** _argv) {
+  Options options{1 << 20, 10, "serialize.bench"};
+  if (!parse(_argc, _argv, options)) {
+    fprintf(stderr, "usage: %s [--count=N] [--iterations=N] [--file=PATH]\n",
+      _argv[0]);
+    return 1;
+  }
+
+  if (!Globals::link()) {
+    return 1;
+  }
+
+  Globals::init();
+
+  bool ok{true};
+  {
+    Vector<Uint32> indices{options.count};
+    Vector<Uint32> small{options.count};
+    Vector<Uint32> random{options.count};
+
+    Uint64 state{0x9e3779b97f4a7c15_u64};
+    for (Size i{0}; i < options.count; i++) {
+      const Uint64 value{next(state)};
+      indices[i] = static_cast<Uint32>(i / 3 + value % 8);
+      small[i] = static_cast<Uint32>(value % 128);
+      random[i] = static_cast<Uint32>(value >> 32);
+    }
+
+    printf("%zu Uint32 elements, %zu iterations, memcpy %.1f MiB/s\n",
+      options.count, options.iterations,
+      copy_throughput(random, options.iterations));
+
+    ok = run("indices", indices, options)
+      && run("small", small, options)
+      && run("random", random, options);
+  }
+
+  remove(options.file);
+
+  Globals::fini();
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+#include <stdio.h> // printf, fprintf
+#include <stdlib.h> // strtoul
+#include <string.h> // strncmp
+
+#include "rx/core/memory/buddy_allocator.h"
+#include "rx/core/memory/tlsf_allocator.h"
+#include "rx/core/memory/system_allocator.h"
+
+#include "rx/core/time/stop_watch.h"
+#include "rx/core/vector.h"
+#include "rx/core/global.h"
+
+// Compares BuddyAllocator and TLSFAllocator over the same region of memory.
+//
+// A window of live allocations of random sizes is kept and a random one of
+// them is replaced on every operation, that's the throughput. Afterwards more
+// random allocations are made until one fails, and the bytes live at that point
+// over the size of the region is the utilization. The lower the utilization,
+// the more the region is lost to fragmentation and rounding.
+//
+// Usage: tlsf [--region=MiB] [--live=N] [--max-size=N] [--operations=N]
+
+using namespace Rx;
+
+struct Options {
+  Size region;
+  Size live;
+  Size max_size;
+  Size operations;
+};
+
+struct Result {
+  Float64 ns;
+  Size failures;
+  Float64 utilization;
+};
+
+static Uint64 next(Uint64& state_) {
+  state_ ^= state_ << 13;
+  state_ ^= state_ >> 7;
+  state_ ^= state_ << 17;
+  return state_;
+}
+
+template<typename T>
+static Result measure(Byte* _region, const Options& _options) {
+  T allocator{_region, _options.region};
+
+  Vector<Byte*> live{_options.live};
+  Vector<Size> sizes{_options.live};
+
+  Result result{};
+  Uint64 state{0x9e3779b97f4a7c15_u64};
+
+  Time::StopWatch timer;
+  timer.start();
+  for (Size i{0}; i < _options.operations; i++) {
+    const Uint64 random{next(state)};
+    const Size slot{random % _options.live};
+    allocator.deallocate(live[slot]);
+    sizes[slot] = (random >> 32) % _options.max_size + 1;
+    if (!(live[slot] = allocator.allocate(sizes[slot]))) {
+      result.failures++;
+    }
+  }
+  timer.stop();
+  result.ns = timer.elapsed().total_milliseconds() * 1000000.0
+    / Float64(_options.operations);
+
+  Size bytes{0};
+  for (Size i{0}; i < _options.live; i++) {
+    if (live[i]) {
+      bytes += sizes[i];
+    }
+  }
+  for (;;) {
+    const Size size{next(state) % _options.max_size + 1};
+    if (!allocator.allocate(size)) {
+      break;
+    }
+    bytes += size;
+  }
+  result.utilization = Float64(bytes) / Float64(_options.region);
+
+  return result;
+}
+
+static void print(const char* _name, const Result& _result) {
+  printf("  %-8s %8.1f ns  failures %zu  utilization %5.1f%%\n", _name,
+    _result.ns, _result.failures, _result.utilization * 100.0);
+}
+
+static bool parse(int _argc, char** _argv, Options& options_) {
+  for (int i{1}; i < _argc; i++) {
+    const char* argument{_argv[i]};
+    if (!strncmp(argument, "--region=", 9)) {
+      options_.region = strtoul(argument + 9, nullptr, 10) << 20;
+    } else if (!strncmp(argument, "--live=", 7)) {
+      options_.live = strtoul(argument + 7, nullptr, 10);
+    } else if (!strncmp(argument, "--max-size=", 11)) {
+      options_.max_size = strtoul(argument + 11, nullptr, 10);
+    } else if (!strncmp(argument, "--operations=", 13)) {
+      options_.operations = strtoul(argument + 13, nullptr, 10);
+    } else {
+      return false;
+    }
+  }
+  // BuddyAllocator needs the region to be a power of two.
+  return options_.region != 0 && (options_.region & (options_.region - 1)) == 0
+    && options_.live != 0 && options_.max_size != 0 && options_.operations != 0;
+}
+
+int main(int _argc, char** _argv) {
+  Options options{16 << 20, 2048, 4096, 200000};
+  if (!parse(_argc, _argv, options)) {
+    fprintf(stderr,
+      "usage: %s [--region=MiB] [--live=N] [--max-size=N] [--operations=N]\n",
+      _argv[0]);
+    return 1;
+  }
+
+  if (!Globals::link()) {
+    return 1;
+  }
+
+  Globals::init();
+
+  auto& allocator{Memory::SystemAllocator::instance()};
+  const auto region{allocator.allocate(options.region)};
+  if (region) {
+    printf("%zu MiB region, %zu live allocations of up to %zu bytes, %zu operations:\n",
+      options.region >> 20, options.live, options.max_size, options.operations);
+    print("buddy", measure<Memory::BuddyAllocator>(region, options));
+    print("tlsf", measure<Memory::TLSFAllocator>(region, options));
+    allocator.deallocate(region);
+  }
+
+  Globals::fini();
+
+  return region ? 0 : 1;
+}
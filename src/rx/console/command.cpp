@@ -230,7 +230,7 @@ error:
   return false;
 }
 
-bool Command::execute_tokens(Context& console_, const Vector<Token>& _tokens) {
+bool Command::execute_tokens(Context& console_, const Parser::Tokens& _tokens) {
   m_arguments.clear();
   _tokens.each_fwd([&](const Token& _token) {
     switch (_token.kind()) {
@@ -66,7 +66,7 @@ struct Command {
   template<typename... Ts>
   bool execute_arguments(Context& console_, Ts&&... _arguments);
 
-  bool execute_tokens(Context& console_, const Vector<Token>& _tokens);
+  bool execute_tokens(Context& console_, const Parser::Tokens& _tokens);
 
   const String& name() const &;
 
@@ -11,6 +11,7 @@
 #include "rx/core/concurrency/scope_lock.h"
 
 #include "rx/core/filesystem/file.h"
+#include "rx/core/buffered_stream.h"
 
 #include "rx/core/log.h" // RX_LOG
 
@@ -174,8 +175,11 @@ bool Context::load(const char* file_name) {
 
   logger->info("loading '%s'", file_name);
 
+  // Lines are found in what's read ahead instead of a read of the file each.
+  BufferedStream buffered{&file};
+
   Parser parse{Memory::SystemAllocator::instance()};
-  for (String line_contents; file.read_line(line_contents); ) {
+  for (String line_contents; buffered.read_line(line_contents); ) {
     String line{line_contents.lstrip(" \t")};
     if (line.is_empty() || strchr("#;[", line[0])) {
       // ignore empty and comment lines
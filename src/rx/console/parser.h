@@ -7,6 +7,7 @@
 
 #include "rx/core/assert.h"
 #include "rx/core/string.h"
+#include "rx/core/small_vector.h"
 
 #include "rx/core/utility/construct.h"
 #include "rx/core/utility/destruct.h"
@@ -208,12 +209,15 @@ struct Parser {
     bool caret;
   };
 
+  // Lines rarely have more than a name and a few arguments.
+  using Tokens = SmallVector<Token, 8>;
+
   Parser(Memory::Allocator& _allocator);
 
   bool parse(const String& _contents);
 
   const Diagnostic& error() const &;
-  Vector<Token>&& tokens();
+  Tokens&& tokens();
 
   constexpr Memory::Allocator& allocator() const;
 
@@ -227,7 +231,7 @@ private:
   bool error(bool _caret, const char* _format, Ts&&... _arguments);
 
   Memory::Allocator& m_allocator;
-  Vector<Token> m_tokens;
+  Tokens m_tokens;
   Diagnostic m_diagnostic;
 
   const char* m_ch;
@@ -246,7 +250,7 @@ inline const Parser::Diagnostic& Parser::error() const & {
   return m_diagnostic;
 }
 
-inline Vector<Token>&& Parser::tokens() {
+inline Parser::Tokens&& Parser::tokens() {
   return Utility::move(m_tokens);
 }
 
@@ -43,6 +43,10 @@ void quick_sort(T* start_, T* end_, F&& _compare) {
       Utility::swap(*start_, *(end_ - 1));
     }
 
+    // The pivot is kept out of the partition, the element at the end of it
+    // takes its place.
+    *middle = Utility::move(*(end_ - 2));
+
     do {
       while (_compare(*item1, pivot)) {
         if (++item1 >= item2) {
@@ -60,7 +64,9 @@ void quick_sort(T* start_, T* end_, F&& _compare) {
     } while (++item1 < item2);
 
 partitioned:
-    *(end_ - 2) = Utility::move(*item1);
+    if (item1 != end_ - 2) {
+      *(end_ - 2) = Utility::move(*item1);
+    }
     *item1 = Utility::move(pivot);
 
     if (item1 - start_ < end_ - item1 + 1) {
@@ -0,0 +1,273 @@
+#include <string.h> // memcpy, memcmp
+
+#include "rx/core/atom.h"
+#include "rx/core/abort.h"
+#include "rx/core/global.h"
+#include "rx/core/vector.h"
+
+#include "rx/core/concurrency/spin_lock.h"
+#include "rx/core/concurrency/scope_lock.h"
+
+#include "rx/core/hints/unlikely.h"
+
+#include "rx/core/memory/system_allocator.h"
+
+namespace Rx {
+
+// Every atom has an entry with the size, followed by the characters and the
+// null-terminator. Entries are packed into blocks which are never moved or
+// freed until the table is, so the pointer to the characters can be read
+// without a lock.
+//
+// The pointers to the entries are kept in pages of |k_page_size| which don't
+// move either, the page and index in it come from the id.
+struct AtomTable {
+  static inline constexpr const Size k_page_size{1024};
+  static inline constexpr const Size k_max_pages{1024};
+  static inline constexpr const Size k_block_size{64 << 10};
+  static inline constexpr const Size k_initial_slots{256};
+
+  AtomTable();
+  AtomTable(Memory::Allocator& _allocator);
+  ~AtomTable();
+
+  Optional<Uint32> intern(StringView _string);
+  Optional<Uint32> find(StringView _string);
+
+  const char* data(Uint32 _id) const;
+  Size size(Uint32 _id) const;
+
+private:
+  struct Slot {
+    Size hash;
+    Uint32 id;
+  };
+
+  Optional<Uint32> find(StringView _string, Size _hash) const;
+  Optional<Uint32> add(StringView _string, Size _hash);
+  bool index(Uint32 _id, Size _hash);
+  bool grow();
+
+  char* allocate(Size _size);
+
+  Memory::Allocator& m_allocator;
+
+  Concurrency::SpinLock m_lock;
+
+  Vector<Slot> m_slots   RX_HINT_GUARDED_BY(m_lock);
+  Vector<Byte*> m_blocks RX_HINT_GUARDED_BY(m_lock);
+  Byte* m_block          RX_HINT_GUARDED_BY(m_lock);
+  Size m_block_used      RX_HINT_GUARDED_BY(m_lock);
+
+  // One more than the number of strings interned, id zero is the empty one.
+  Uint32 m_count RX_HINT_GUARDED_BY(m_lock);
+
+  const char** m_pages[k_max_pages];
+};
+
+static Global<AtomTable> s_atoms{"system", "atoms"};
+
+AtomTable::AtomTable()
+  : AtomTable{Memory::SystemAllocator::instance()}
+{
+}
+
+AtomTable::AtomTable(Memory::Allocator& _allocator)
+  : m_allocator{_allocator}
+  , m_slots{_allocator}
+  , m_blocks{_allocator}
+  , m_block{nullptr}
+  , m_block_used{k_block_size}
+  , m_count{1}
+  , m_pages{}
+{
+}
+
+AtomTable::~AtomTable() {
+  m_blocks.each_fwd([this](Byte* _block) {
+    m_allocator.deallocate(_block);
+  });
+  for (Size i{0}; i < k_max_pages; i++) {
+    m_allocator.deallocate(m_pages[i]);
+  }
+}
+
+const char* AtomTable::data(Uint32 _id) const {
+  return m_pages[_id / k_page_size][_id % k_page_size];
+}
+
+Size AtomTable::size(Uint32 _id) const {
+  return reinterpret_cast<const Size*>(data(_id))[-1];
+}
+
+char* AtomTable::allocate(Size _size) {
+  // Keep the size in front of every entry aligned.
+  const Size size{(sizeof(Size) + _size + 1 + alignof(Size) - 1) & ~(alignof(Size) - 1)};
+
+  // Strings too large for a block get one of their own.
+  if (size > k_block_size / 4) {
+    auto block{m_allocator.allocate(size)};
+    if (!block || !m_blocks.push_back(block)) {
+      m_allocator.deallocate(block);
+      return nullptr;
+    }
+    return reinterpret_cast<char*>(block + sizeof(Size));
+  }
+
+  if (m_block_used + size > k_block_size) {
+    auto block{m_allocator.allocate(k_block_size)};
+    if (!block || !m_blocks.push_back(block)) {
+      m_allocator.deallocate(block);
+      return nullptr;
+    }
+    m_block = block;
+    m_block_used = 0;
+  }
+
+  Byte* entry{m_block + m_block_used};
+  m_block_used += size;
+  return reinterpret_cast<char*>(entry + sizeof(Size));
+}
+
+Optional<Uint32> AtomTable::find(StringView _string, Size _hash) const {
+  if (m_slots.is_empty()) {
+    return nullopt;
+  }
+
+  const Size mask{m_slots.size() - 1};
+  for (Size i{_hash & mask}; ; i = (i + 1) & mask) {
+    const Slot& slot{m_slots[i]};
+    if (slot.id == 0) {
+      return nullopt;
+    }
+    if (slot.hash == _hash && size(slot.id) == _string.size()
+      && memcmp(data(slot.id), _string.data(), _string.size()) == 0)
+    {
+      return slot.id;
+    }
+  }
+}
+
+Optional<Uint32> AtomTable::add(StringView _string, Size _hash) {
+  const Uint32 id{m_count};
+  const Size page{id / k_page_size};
+  if (page == k_max_pages) {
+    return nullopt;
+  }
+
+  if (!m_pages[page]) {
+    auto data{m_allocator.allocate(sizeof(const char*) * k_page_size)};
+    if (!data) {
+      return nullopt;
+    }
+    m_pages[page] = reinterpret_cast<const char**>(data);
+  }
+
+  // When the index can't grow the entry is lost, but that's only memory.
+  char* string{allocate(_string.size())};
+  if (!string || !index(id, _hash)) {
+    return nullopt;
+  }
+
+  reinterpret_cast<Size*>(string)[-1] = _string.size();
+  memcpy(string, _string.data(), _string.size());
+  string[_string.size()] = '\0';
+
+  m_pages[page][id % k_page_size] = string;
+  m_count++;
+
+  return id;
+}
+
+bool AtomTable::index(Uint32 _id, Size _hash) {
+  // Keep the load factor at or below 3/4.
+  if (m_count * 4 > m_slots.size() * 3 && !grow()) {
+    return false;
+  }
+
+  const Size mask{m_slots.size() - 1};
+  for (Size i{_hash & mask}; ; i = (i + 1) & mask) {
+    Slot& slot{m_slots[i]};
+    if (slot.id == 0) {
+      slot = {_hash, _id};
+      return true;
+    }
+  }
+}
+
+bool AtomTable::grow() {
+  const Size size{m_slots.is_empty() ? k_initial_slots : m_slots.size() * 2};
+
+  Vector<Slot> slots{m_allocator};
+  if (!slots.resize(size, {0, 0})) {
+    return false;
+  }
+
+  const Size mask{size - 1};
+  m_slots.each_fwd([&](const Slot& _slot) {
+    if (_slot.id == 0) {
+      return;
+    }
+    Size i{_slot.hash & mask};
+    while (slots[i].id != 0) {
+      i = (i + 1) & mask;
+    }
+    slots[i] = _slot;
+  });
+
+  m_slots = Utility::move(slots);
+
+  return true;
+}
+
+Optional<Uint32> AtomTable::intern(StringView _string) {
+  if (_string.is_empty()) {
+    return 0_u32;
+  }
+
+  const Size hash{_string.hash()};
+
+  Concurrency::ScopeLock lock{m_lock};
+  if (auto id{find(_string, hash)}) {
+    return id;
+  }
+  return add(_string, hash);
+}
+
+Optional<Uint32> AtomTable::find(StringView _string) {
+  if (_string.is_empty()) {
+    return 0_u32;
+  }
+
+  const Size hash{_string.hash()};
+
+  Concurrency::ScopeLock lock{m_lock};
+  return find(_string, hash);
+}
+
+Atom::Atom(StringView _string) {
+  auto id{s_atoms->intern(_string)};
+  if (RX_HINT_UNLIKELY(!id)) {
+    // There's no atom to fall back on that isn't some other string.
+    abort("failed to intern atom \"%.*s\"", static_cast<int>(_string.size()),
+      _string.data());
+  }
+  m_id = *id;
+}
+
+Optional<Atom> Atom::find(StringView _string) {
+  if (auto id{s_atoms->find(_string)}) {
+    return Atom{*id};
+  }
+  return nullopt;
+}
+
+const char* Atom::data() const {
+  return m_id ? s_atoms->data(m_id) : "";
+}
+
+Size Atom::size() const {
+  return m_id ? s_atoms->size(m_id) : 0;
+}
+
+} // namespace rx
@@ -0,0 +1,87 @@
+#ifndef RX_CORE_ATOM_H
+#define RX_CORE_ATOM_H
+#include "rx/core/string_view.h"
+#include "rx/core/optional.h"
+#include "rx/core/hash.h"
+
+namespace Rx {
+
+// # Atom
+//
+// An interned string. Interning the same contents twice gives the same atom,
+// so two atoms are equal exactly when their strings are and comparing or
+// hashing one is comparing or hashing an integer. That makes atoms a cheap
+// key for hash containers that are searched by name often.
+//
+// The strings are kept in a process-wide table which is never shrunk, so
+// only intern names there's a bounded number of. Interning takes a lock,
+// reading the string of an atom does not.
+//
+// The default atom is the empty string. Atoms can't be made before globals
+// are initialized.
+//
+// 32-bit: 4 bytes
+// 64-bit: 4 bytes
+struct RX_API Atom {
+  constexpr Atom();
+
+  // Interns |_string|. Aborts when it can't, out of memory or once a million
+  // strings are interned.
+  explicit Atom(StringView _string);
+
+  // The atom for |_string| if it was interned, without interning it.
+  static Optional<Atom> find(StringView _string);
+
+  // Null-terminated.
+  const char* data() const;
+  Size size() const;
+  StringView view() const;
+
+  bool is_empty() const;
+
+  Uint32 id() const;
+  Size hash() const;
+
+private:
+  constexpr Atom(Uint32 _id);
+
+  Uint32 m_id;
+};
+
+inline constexpr Atom::Atom()
+  : Atom{0}
+{
+}
+
+inline constexpr Atom::Atom(Uint32 _id)
+  : m_id{_id}
+{
+}
+
+inline StringView Atom::view() const {
+  return {data(), size()};
+}
+
+inline bool Atom::is_empty() const {
+  return m_id == 0;
+}
+
+inline Uint32 Atom::id() const {
+  return m_id;
+}
+
+inline Size Atom::hash() const {
+  return hash_uint32(m_id);
+}
+
+inline bool operator==(Atom _lhs, Atom _rhs) {
+  return _lhs.id() == _rhs.id();
+}
+
+inline bool operator!=(Atom _lhs, Atom _rhs) {
+  return _lhs.id() != _rhs.id();
+}
+
+} // namespace rx
+
+#endif // RX_CORE_ATOM_H
@@ -0,0 +1,197 @@
+#include "rx/core/buffered_stream.h"
+#include "rx/core/string.h"
+
+#include "rx/core/algorithm/min.h"
+#include "rx/core/algorithm/max.h"
+
+#include "rx/core/utility/exchange.h"
+
+#include "rx/core/hints/unlikely.h"
+
+#include "rx/core/assert.h"
+
+namespace Rx {
+
+static Uint32 flags_of(const Stream* _stream) {
+  Uint32 flags{0};
+  if (_stream->can_read()) {
+    flags |= Stream::READ;
+  }
+  if (_stream->can_write()) {
+    flags |= Stream::WRITE;
+  }
+  if (_stream->can_stat()) {
+    flags |= Stream::STAT;
+  }
+  return flags;
+}
+
+BufferedStream::BufferedStream(Memory::Allocator& _allocator, Stream* _stream, Size _size)
+  : Stream{flags_of(_stream)}
+  , m_allocator{_allocator}
+  , m_stream{_stream}
+  , m_data{m_allocator.allocate(_size)}
+  , m_size{_size}
+  , m_position{_stream->tell()}
+  , m_length{0}
+  , m_dirty{0}
+{
+  RX_ASSERT(m_size, "empty buffer");
+  RX_ASSERT(m_data, "out of memory");
+
+  m_offset = m_position;
+}
+
+BufferedStream::~BufferedStream() {
+  flush();
+  m_allocator.deallocate(m_data);
+}
+
+bool BufferedStream::flush() {
+  if (m_dirty == 0) {
+    return true;
+  }
+
+  // Whatever happens it's not written again.
+  const Size dirty{Utility::exchange(m_dirty, 0_z)};
+  if (!move_to(m_position) || m_stream->write(m_data, dirty) != dirty) {
+    return false;
+  }
+
+  m_position += dirty;
+  return true;
+}
+
+bool BufferedStream::read_line(String& line_) {
+  line_.clear();
+
+  for (;;) {
+    if (!fill()) {
+      return !line_.is_empty();
+    }
+
+    const Size offset{static_cast<Size>(m_offset - m_position)};
+    const char* data{reinterpret_cast<const char*>(m_data + offset)};
+    const Size size{m_length - offset};
+
+    Size length{0};
+    while (length < size && data[length] != '\r' && data[length] != '\n') {
+      length++;
+    }
+
+    line_.append(data, length);
+    m_offset += length;
+
+    // The line continues past the buffer.
+    if (length == size) {
+      continue;
+    }
+
+    // The \n of a \r\n may only be in what's read ahead next.
+    const bool carriage{data[length] == '\r'};
+    m_offset++;
+    if (carriage && fill() && m_data[m_offset - m_position] == '\n') {
+      m_offset++;
+    }
+
+    return true;
+  }
+}
+
+Uint64 BufferedStream::on_read(Byte* _data, Uint64 _size, Uint64 _offset) {
+  // What's to be written has to be there before it can be read back.
+  if (RX_HINT_UNLIKELY(m_dirty && !flush())) {
+    return 0;
+  }
+
+  // Start with whatever of it is already in the buffer.
+  Uint64 bytes{0};
+  if (_offset >= m_position && _offset - m_position < m_length) {
+    const Size offset{static_cast<Size>(_offset - m_position)};
+    bytes = Algorithm::min(_size, Uint64{m_length - offset});
+    memcpy(_data, m_data + offset, static_cast<Size>(bytes));
+  }
+
+  if (bytes == _size || !move_to(_offset + bytes)) {
+    return bytes;
+  }
+
+  // Too large to be worth going through the buffer.
+  const Uint64 remaining{_size - bytes};
+  if (remaining >= m_size) {
+    return bytes + m_stream->read(_data + bytes, remaining);
+  }
+
+  // Read ahead as much as fits.
+  m_position = _offset + bytes;
+  m_length = static_cast<Size>(m_stream->read(m_data, m_size));
+
+  const Uint64 more{Algorithm::min(remaining, Uint64{m_length})};
+  memcpy(_data + bytes, m_data, static_cast<Size>(more));
+
+  return bytes + more;
+}
+
+Uint64 BufferedStream::on_write(const Byte* _data, Uint64 _size, Uint64 _offset) {
+  // What was read ahead may not be what's there anymore.
+  m_length = 0;
+
+  if (m_dirty == 0) {
+    m_position = _offset;
+  } else if (_offset != m_position + m_dirty || _size > m_size - m_dirty) {
+    if (!flush()) {
+      return 0;
+    }
+    m_position = _offset;
+  }
+
+  // Too large to be worth going through the buffer.
+  if (_size >= m_size) {
+    return move_to(_offset) ? m_stream->write(_data, _size) : 0;
+  }
+
+  memcpy(m_data + m_dirty, _data, static_cast<Size>(_size));
+  m_dirty += static_cast<Size>(_size);
+
+  return _size;
+}
+
+bool BufferedStream::on_stat(Stat& stat_) const {
+  const auto size{m_stream->size()};
+  if (!size) {
+    return false;
+  }
+
+  // Writes past the end aren't in the stream yet.
+  stat_.size = Algorithm::max(*size, m_position + m_dirty);
+  return true;
+}
+
+const Byte* BufferedStream::on_view(Uint64 _size, Uint64 _offset) {
+  if (RX_HINT_UNLIKELY(m_dirty && !flush())) {
+    return nullptr;
+  }
+  return move_to(_offset) ? m_stream->view(_size) : nullptr;
+}
+
+bool BufferedStream::fill() {
+  if (m_offset >= m_position && m_offset - m_position < m_length) {
+    return true;
+  }
+
+  if (!can_read() || (m_dirty && !flush()) || !move_to(m_offset)) {
+    return false;
+  }
+
+  m_position = m_offset;
+  m_length = static_cast<Size>(m_stream->read(m_data, m_size));
+
+  return m_length != 0;
+}
+
+bool BufferedStream::move_to(Uint64 _offset) {
+  return m_stream->tell() == _offset
+    || m_stream->seek(static_cast<Sint64>(_offset), Whence::SET);
+}
+
+} // namespace rx
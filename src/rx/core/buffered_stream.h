@@ -0,0 +1,124 @@
+#ifndef RX_CORE_BUFFERED_STREAM_H
+#define RX_CORE_BUFFERED_STREAM_H
+#include <string.h> // memcpy
+
+#include "rx/core/stream.h"
+
+#include "rx/core/hints/likely.h"
+#include "rx/core/hints/force_inline.h"
+
+namespace Rx {
+
+// # Buffered Stream
+//
+// Buffers any other stream so many small reads and writes become a few large
+// ones on the stream underneath.
+//
+// Reads fill the buffer with as much as fits after what was asked for, which
+// the following reads are served from. Writes are collected in the buffer
+// until it's full, the stream is read or seeked somewhere else, or |flush| is
+// called, and then written at once. Reads and writes as large as the buffer
+// or larger go to the stream directly.
+//
+// The |read| and |write| here hide those of |Stream|. When what's asked for is
+// in the buffer, or fits in it, they're a copy inline without a call to the
+// stream at all. Through a |Stream*| the buffer is still used, by way of
+// |on_read| and |on_write|.
+//
+// The stream underneath must not be used by anything else while it's buffered
+// since what it has and where it is may be behind. The buffered stream starts
+// where it is.
+struct RX_API BufferedStream
+  final : Stream
+{
+  static inline constexpr const Size k_default_size{16 << 10};
+
+  BufferedStream(Memory::Allocator& _allocator, Stream* _stream, Size _size = k_default_size);
+  BufferedStream(Stream* _stream, Size _size = k_default_size);
+  ~BufferedStream();
+
+  [[nodiscard]] Uint64 read(Byte* _data, Uint64 _size);
+  [[nodiscard]] Uint64 write(const Byte* _data, Uint64 _size);
+
+  // Read up to the next line ending, which is one of \r, \n or \r\n, into
+  // |line_| without it. The line is found in the buffer rather than read and
+  // seeked back over. Returns false when there's nothing left to read.
+  bool read_line(String& line_);
+
+  // Write everything collected so far to the stream.
+  bool flush();
+
+  virtual const String& name() const &;
+
+  constexpr Memory::Allocator& allocator() const;
+
+protected:
+  virtual Uint64 on_read(Byte* _data, Uint64 _size, Uint64 _offset);
+  virtual Uint64 on_write(const Byte* _data, Uint64 _size, Uint64 _offset);
+  virtual bool on_stat(Stat& stat_) const;
+  virtual const Byte* on_view(Uint64 _size, Uint64 _offset);
+
+private:
+  bool move_to(Uint64 _offset);
+
+  // Read ahead from where the stream is when it's past the buffer.
+  bool fill();
+
+  Memory::Allocator& m_allocator;
+  Stream* m_stream;
+  Byte* m_data;
+  Size m_size;
+
+  // Where in |m_stream| the buffer starts. Either the first |m_length| bytes
+  // are what was read from there, or the first |m_dirty| bytes are what's to
+  // be written there. It's never both.
+  Uint64 m_position;
+  Size m_length;
+  Size m_dirty;
+};
+
+inline BufferedStream::BufferedStream(Stream* _stream, Size _size)
+  : BufferedStream{Memory::SystemAllocator::instance(), _stream, _size}
+{
+}
+
+RX_HINT_FORCE_INLINE Uint64 BufferedStream::read(Byte* _data, Uint64 _size) {
+  const Uint64 offset{tell()};
+  if (RX_HINT_LIKELY(can_read()
+    && offset >= m_position
+    && offset - m_position <= m_length
+    && _size <= m_length - (offset - m_position)))
+  {
+    memcpy(_data, m_data + (offset - m_position), static_cast<Size>(_size));
+    m_offset = offset + _size;
+    return _size;
+  }
+  return Stream::read(_data, _size);
+}
+
+RX_HINT_FORCE_INLINE Uint64 BufferedStream::write(const Byte* _data, Uint64 _size) {
+  const Uint64 offset{tell()};
+  if (RX_HINT_LIKELY(can_write()
+    && m_length == 0
+    && offset == m_position + m_dirty
+    && _size <= m_size - m_dirty))
+  {
+    memcpy(m_data + m_dirty, _data, static_cast<Size>(_size));
+    m_dirty += static_cast<Size>(_size);
+    m_offset = offset + _size;
+    return _size;
+  }
+  return Stream::write(_data, _size);
+}
+
+inline const String& BufferedStream::name() const & {
+  return m_stream->name();
+}
+
+RX_HINT_FORCE_INLINE constexpr Memory::Allocator& BufferedStream::allocator() const {
+  return m_allocator;
+}
+
+} // namespace rx
+
+#endif // RX_CORE_BUFFERED_STREAM_H
@@ -0,0 +1,222 @@
+#include <string.h> // memcpy, memset
+
+#include "rx/core/compression/lz4.h"
+
+#include "rx/core/algorithm/min.h"
+
+#include "rx/core/hints/unlikely.h"
+
+namespace Rx::Compression {
+
+// A match is at least four bytes, the last five bytes of a block are always
+// literals and the last match has to start at least twelve bytes before the
+// end. These are part of the format, the reference decompressor relies on them
+// to copy in larger steps than it's asked to.
+static constexpr const Size k_min_match{4};
+static constexpr const Size k_last_literals{5};
+static constexpr const Size k_match_limit{12};
+static constexpr const Size k_max_offset{65535};
+
+static constexpr const Size k_hash_bits{12};
+
+static inline Uint32 read32(const Byte* _data) {
+  Uint32 value;
+  memcpy(&value, _data, sizeof value);
+  return value;
+}
+
+static inline Size hash(Uint32 _sequence) {
+  return (_sequence * 2654435761_u32) >> (32 - k_hash_bits);
+}
+
+// Lengths which don't fit in the four bits of the token continue in bytes of
+// 255 until one which is less than that.
+static Byte* write_length(Byte* dst_, const Byte* _end, Size _length) {
+  for (; _length >= 255; _length -= 255) {
+    if (RX_HINT_UNLIKELY(dst_ == _end)) {
+      return nullptr;
+    }
+    *dst_++ = 255;
+  }
+
+  if (RX_HINT_UNLIKELY(dst_ == _end)) {
+    return nullptr;
+  }
+
+  *dst_++ = static_cast<Byte>(_length);
+  return dst_;
+}
+
+static bool read_length(const Byte*& src_, const Byte* _end, Size& length_) {
+  for (;;) {
+    if (RX_HINT_UNLIKELY(src_ == _end)) {
+      return false;
+    }
+    const Byte byte{*src_++};
+    length_ += byte;
+    if (byte != 255) {
+      return true;
+    }
+  }
+}
+
+// Write a sequence of |_count| literals followed by a match of |_length| bytes
+// at |_offset| bytes back. The last sequence of a block has no match, that's a
+// |_length| of zero.
+static Byte* write_sequence(Byte* dst_, const Byte* _end, const Byte* _literals,
+  Size _count, Size _offset, Size _length)
+{
+  if (RX_HINT_UNLIKELY(dst_ == _end)) {
+    return nullptr;
+  }
+
+  const Size length{_length ? _length - k_min_match : 0};
+
+  Byte* token{dst_++};
+  *token = static_cast<Byte>((Algorithm::min(_count, 15_z) << 4) | Algorithm::min(length, 15_z));
+
+  if (_count >= 15 && !(dst_ = write_length(dst_, _end, _count - 15))) {
+    return nullptr;
+  }
+
+  if (RX_HINT_UNLIKELY(Size(_end - dst_) < _count)) {
+    return nullptr;
+  }
+
+  memcpy(dst_, _literals, _count);
+  dst_ += _count;
+
+  if (_length == 0) {
+    return dst_;
+  }
+
+  if (RX_HINT_UNLIKELY(_end - dst_ < 2)) {
+    return nullptr;
+  }
+
+  *dst_++ = static_cast<Byte>(_offset);
+  *dst_++ = static_cast<Byte>(_offset >> 8);
+
+  if (length >= 15 && !(dst_ = write_length(dst_, _end, length - 15))) {
+    return nullptr;
+  }
+
+  return dst_;
+}
+
+Size lz4_compress(const Byte* _src, Size _size, Byte* dst_, Size _capacity) {
+  const Byte* const end{dst_ + _capacity};
+
+  Byte* dst{dst_};
+  Size anchor{0};
+
+  if (_size >= k_match_limit) {
+    // The last position each hash was seen at, plus one so zero is empty.
+    Size table[1 << k_hash_bits];
+    memset(table, 0, sizeof table);
+
+    const Size match_limit{_size - k_match_limit};
+    const Size match_end{_size - k_last_literals};
+
+    for (Size i{0}; i <= match_limit; ) {
+      const Uint32 sequence{read32(_src + i)};
+      Size& slot{table[hash(sequence)]};
+      const Size candidate{slot};
+      slot = i + 1;
+
+      if (candidate == 0
+        || i - (candidate - 1) > k_max_offset
+        || read32(_src + candidate - 1) != sequence)
+      {
+        i++;
+        continue;
+      }
+
+      const Size match{candidate - 1};
+
+      Size length{k_min_match};
+      while (i + length < match_end && _src[match + length] == _src[i + length]) {
+        length++;
+      }
+
+      dst = write_sequence(dst, end, _src + anchor, i - anchor, i - match, length);
+      if (RX_HINT_UNLIKELY(!dst)) {
+        return 0;
+      }
+
+      i += length;
+      anchor = i;
+    }
+  }
+
+  dst = write_sequence(dst, end, _src + anchor, _size - anchor, 0, 0);
+
+  return dst ? Size(dst - dst_) : 0;
+}
+
+bool lz4_decompress(const Byte* _src, Size _size, Byte* dst_, Size _capacity) {
+  const Byte* src{_src};
+  const Byte* const src_end{_src + _size};
+
+  Byte* dst{dst_};
+  Byte* const dst_end{dst_ + _capacity};
+
+  while (src < src_end) {
+    const Byte token{*src++};
+
+    Size count{Size(token >> 4)};
+    if (count == 15 && !read_length(src, src_end, count)) {
+      return false;
+    }
+
+    if (RX_HINT_UNLIKELY(Size(src_end - src) < count || Size(dst_end - dst) < count)) {
+      return false;
+    }
+
+    memcpy(dst, src, count);
+    src += count;
+    dst += count;
+
+    // The last sequence is only literals.
+    if (src == src_end) {
+      break;
+    }
+
+    if (RX_HINT_UNLIKELY(src_end - src < 2)) {
+      return false;
+    }
+
+    const Size offset{Size(src[0]) | (Size(src[1]) << 8)};
+    src += 2;
+
+    if (RX_HINT_UNLIKELY(offset == 0 || offset > Size(dst - dst_))) {
+      return false;
+    }
+
+    Size length{Size(token & 15)};
+    if (length == 15 && !read_length(src, src_end, length)) {
+      return false;
+    }
+    length += k_min_match;
+
+    if (RX_HINT_UNLIKELY(Size(dst_end - dst) < length)) {
+      return false;
+    }
+
+    // A match closer than its length overlaps what it's writing, which repeats
+    // the last |offset| bytes. That has to be copied a byte at a time.
+    const Byte* match{dst - offset};
+    if (offset >= length) {
+      memcpy(dst, match, length);
+      dst += length;
+    } else {
+      for (Size i{0}; i < length; i++) {
+        *dst++ = match[i];
+      }
+    }
+  }
+
+  return dst == dst_end;
+}
+
+} // namespace rx::compression
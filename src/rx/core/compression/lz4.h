@@ -0,0 +1,34 @@
+#ifndef RX_CORE_COMPRESSION_LZ4_H
+#define RX_CORE_COMPRESSION_LZ4_H
+#include "rx/core/types.h"
+
+// # LZ4
+//
+// Compressor and decompressor for the LZ4 block format.
+//
+// Compression is a single greedy pass with a small hash table of recent
+// positions, it doesn't try as hard as the reference compressor does but the
+// output is still a valid LZ4 block. Decompression is what matters here, it's
+// a copy of literals and matches with nothing to decode per byte.
+//
+// Neither allocates and neither reads or writes past the sizes given.
+
+namespace Rx::Compression {
+
+// The most a block of |_size| bytes can compress to.
+constexpr Size lz4_bound(Size _size) {
+  return _size + _size / 255 + 16;
+}
+
+// Compress |_size| bytes of |_src| into at most |_capacity| bytes of |dst_|.
+// Returns the size of the block, or zero when it doesn't fit in |_capacity|.
+RX_API Size lz4_compress(const Byte* _src, Size _size, Byte* dst_, Size _capacity);
+
+// Decompress the block of |_size| bytes in |_src| into exactly |_capacity|
+// bytes of |dst_|. Returns false when the block is malformed or doesn't
+// decompress to exactly |_capacity| bytes.
+RX_API bool lz4_decompress(const Byte* _src, Size _size, Byte* dst_, Size _capacity);
+
+} // namespace rx::compression
+
+#endif // RX_CORE_COMPRESSION_LZ4_H
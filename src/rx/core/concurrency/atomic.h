@@ -80,41 +80,41 @@ namespace detail {
     bool compare_exchange_weak(T& expected_, T _value, MemoryOrder _success,
       MemoryOrder _failure) volatile
     {
-      return atomic_compare_exchange_weak(&m_value, expected_, _value, _success, _failure);
+      return atomic_compare_exchange_weak(&m_value, &expected_, _value, _success, _failure);
     }
 
     bool compare_exchange_weak(T& expected_, T _value, MemoryOrder _success,
       MemoryOrder _failure)
     {
-      return atomic_compare_exchange_weak(&m_value, expected_, _value, _success, _failure);
+      return atomic_compare_exchange_weak(&m_value, &expected_, _value, _success, _failure);
     }
 
     bool compare_exchange_strong(T& expected_, T _value, MemoryOrder _success,
       MemoryOrder _failure) volatile
     {
-      return atomic_compare_exchange_strong(&m_value, expected_, _value, _success, _failure);
+      return atomic_compare_exchange_strong(&m_value, &expected_, _value, _success, _failure);
     }
 
     bool compare_exchange_strong(T& expected_, T _value, MemoryOrder _success,
       MemoryOrder _failure)
     {
-      return atomic_compare_exchange_strong(&m_value, expected_, _value, _success, _failure);
+      return atomic_compare_exchange_strong(&m_value, &expected_, _value, _success, _failure);
     }
 
     bool compare_exchange_weak(T& expected_, T _value, MemoryOrder _order = MemoryOrder::k_seq_cst) volatile {
-      return atomic_compare_exchange_weak(&m_value, expected_, _value, _order, _order);
+      return atomic_compare_exchange_weak(&m_value, &expected_, _value, _order, _order);
     }
 
     bool compare_exchange_weak(T& expected_, T _value, MemoryOrder _order = MemoryOrder::k_seq_cst) {
-      return atomic_compare_exchange_weak(&m_value, expected_, _value, _order, _order);
+      return atomic_compare_exchange_weak(&m_value, &expected_, _value, _order, _order);
     }
 
     bool compare_exchange_strong(T& expected_, T _value, MemoryOrder _order) volatile {
-      return atomic_compare_exchange_strong(&m_value, expected_, _value, _order, _order);
+      return atomic_compare_exchange_strong(&m_value, &expected_, _value, _order, _order);
     }
 
     bool compare_exchange_strong(T& expected_, T _value, MemoryOrder _order) {
-      return atomic_compare_exchange_strong(&m_value, expected_, _value, _order, _order);
+      return atomic_compare_exchange_strong(&m_value, &expected_, _value, _order, _order);
     }
 
   protected:
@@ -150,7 +150,7 @@ namespace detail {
     }
 
     T fetch_and(T _pattern, MemoryOrder _order = MemoryOrder::k_seq_cst) {
-      return atomic_fetch_sub(&this->m_value, _pattern, _order);
+      return atomic_fetch_and(&this->m_value, _pattern, _order);
     }
 
     T fetch_or(T _pattern, MemoryOrder _order = MemoryOrder::k_seq_cst) volatile {
@@ -345,6 +345,14 @@ struct Atomic<T*> : detail::Atomic<T*> {
   }
 };
 
+inline void atomic_thread_fence(MemoryOrder _order) {
+  detail::atomic_thread_fence(_order);
+}
+
+inline void atomic_signal_fence(MemoryOrder _order) {
+  detail::atomic_signal_fence(_order);
+}
+
 struct AtomicFlag {
   RX_MARK_NO_COPY(AtomicFlag);
 
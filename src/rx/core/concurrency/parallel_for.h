@@ -0,0 +1,84 @@
+#ifndef RX_CORE_CONCURRENCY_PARALLEL_FOR_H
+#define RX_CORE_CONCURRENCY_PARALLEL_FOR_H
+#include "rx/core/algorithm/min.h"
+#include "rx/core/algorithm/max.h"
+
+#include "rx/core/concurrency/thread_pool.h"
+#include "rx/core/concurrency/atomic.h"
+#include "rx/core/concurrency/yield.h"
+
+namespace Rx::Concurrency {
+
+// # Parallel For
+//
+// Calls |_function(begin, end)| for consecutive chunks of at most |_grain|
+// indices in [_begin, _end) across the threads of |pool_|. The calling thread
+// takes chunks too and, once they're all taken, runs other tasks of the pool
+// until the chunks in flight are done, so it's safe to call from a task.
+//
+// Chunks are handed out from a shared counter rather than split up front, so
+// uneven work balances itself out. Pick |_grain| large enough that a chunk
+// is worth more than the atomic increment that claims it.
+//
+// |_function| is called concurrently from multiple threads.
+template<typename F>
+void parallel_for(ThreadPool& pool_, Size _begin, Size _end, Size _grain,
+  F&& _function)
+{
+  if (_begin >= _end) {
+    return;
+  }
+
+  const Size grain{Algorithm::max(_grain, 1_z)};
+  const Size chunks{(_end - _begin + grain - 1) / grain};
+
+  // Don't bother the pool when there's only one chunk.
+  if (chunks == 1 || pool_.threads() == 0) {
+    _function(_begin, _end);
+    return;
+  }
+
+  Atomic<Size> next{0};
+  Atomic<Size> active{0};
+
+  auto run = [&]() {
+    for (;;) {
+      const Size chunk{next.fetch_add(1, MemoryOrder::k_relaxed)};
+      if (chunk >= chunks) {
+        break;
+      }
+      const Size begin{_begin + chunk * grain};
+      _function(begin, Algorithm::min(begin + grain, _end));
+    }
+  };
+
+  // The calling thread is one of the threads taking chunks.
+  const Size helpers{Algorithm::min(chunks - 1, pool_.threads())};
+  active.store(helpers, MemoryOrder::k_relaxed);
+  for (Size i{0}; i < helpers; i++) {
+    pool_.add([&](int) {
+      run();
+      active.fetch_sub(1, MemoryOrder::k_release);
+    });
+  }
+
+  run();
+
+  // Every task refers to this frame, wait for all of them, not just for the
+  // chunks to be done.
+  while (active.load(MemoryOrder::k_acquire)) {
+    if (!pool_.help()) {
+      yield();
+    }
+  }
+}
+
+template<typename F>
+inline void parallel_for(Size _begin, Size _end, Size _grain, F&& _function) {
+  parallel_for(ThreadPool::instance(), _begin, _end, _grain,
+    Utility::forward<F>(_function));
+}
+
+} // namespace rx::concurrency
+
+#endif // RX_CORE_CONCURRENCY_PARALLEL_FOR_H
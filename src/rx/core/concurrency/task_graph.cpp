@@ -0,0 +1,127 @@
+#include "rx/core/concurrency/task_graph.h"
+#include "rx/core/concurrency/yield.h"
+
+#include "rx/core/utility/construct.h"
+
+namespace Rx::Concurrency {
+
+TaskGraph::Node::Node(Memory::Allocator& _allocator, Function<void()>&& function_)
+  : function{Utility::move(function_)}
+  , successors{_allocator}
+  , dependencies{0}
+{
+}
+
+TaskGraph::TaskGraph(Memory::Allocator& _allocator, ThreadPool& _pool)
+  : m_allocator{_allocator}
+  , m_pool{_pool}
+  , m_nodes{allocator()}
+  , m_dependencies{nullptr}
+  , m_capacity{0}
+  , m_pending{0}
+{
+}
+
+TaskGraph::~TaskGraph() {
+  wait();
+  allocator().deallocate(m_dependencies);
+}
+
+TaskGraph::Task TaskGraph::add(Function<void()>&& function_) {
+  RX_ASSERT(is_done(), "graph changed while executing");
+  if (!m_nodes.emplace_back(allocator(), Utility::move(function_))) {
+    return -1_z;
+  }
+  return m_nodes.size() - 1;
+}
+
+bool TaskGraph::precede(Task _before, Task _after) {
+  RX_ASSERT(is_done(), "graph changed while executing");
+  if (_before >= m_nodes.size() || _after >= m_nodes.size() || _before == _after) {
+    return false;
+  }
+  if (!m_nodes[_before].successors.push_back(_after)) {
+    return false;
+  }
+  m_nodes[_after].dependencies++;
+  return true;
+}
+
+void TaskGraph::run() {
+  RX_ASSERT(is_done(), "graph already executing");
+
+  const Size n_nodes{m_nodes.size()};
+  if (n_nodes == 0) {
+    return;
+  }
+
+  if (n_nodes > m_capacity) {
+    auto data{allocator().reallocate(m_dependencies, sizeof *m_dependencies * n_nodes)};
+    RX_ASSERT(data, "out of memory");
+    m_dependencies = reinterpret_cast<Atomic<Size>*>(data);
+    m_capacity = n_nodes;
+  }
+
+  for (Size i{0}; i < n_nodes; i++) {
+    Utility::construct<Atomic<Size>>(m_dependencies + i, m_nodes[i].dependencies);
+  }
+
+  m_pending.store(n_nodes, MemoryOrder::k_release);
+
+  // Everything without a dependency is ready to go.
+  for (Size i{0}; i < n_nodes; i++) {
+    if (m_nodes[i].dependencies == 0) {
+      spawn(i);
+    }
+  }
+}
+
+void TaskGraph::wait() {
+  while (!is_done()) {
+    if (!m_pool.help()) {
+      yield();
+    }
+  }
+}
+
+void TaskGraph::clear() {
+  RX_ASSERT(is_done(), "graph changed while executing");
+  m_nodes.clear();
+}
+
+void TaskGraph::spawn(Task _task) {
+  m_pool.add([this, _task](int) {
+    complete(_task);
+  });
+}
+
+void TaskGraph::complete(Task _task) {
+  Task task{_task};
+  while (task != -1_z) {
+    const Node& node{m_nodes[task]};
+    node.function();
+
+    // Keep the first successor made ready to run on this thread next, the
+    // rest go to the pool.
+    Task next{-1_z};
+    node.successors.each_fwd([&](Task _successor) {
+      if (m_dependencies[_successor].fetch_sub(1, MemoryOrder::k_acq_rel) != 1) {
+        return;
+      }
+      if (next == -1_z) {
+        next = _successor;
+      } else {
+        spawn(_successor);
+      }
+    });
+
+    // Nothing may touch the graph once the last node is accounted for since
+    // the waiting thread is free to destroy it. There's no problem when there
+    // is a |next| node, that one is still pending.
+    m_pending.fetch_sub(1, MemoryOrder::k_acq_rel);
+
+    task = next;
+  }
+}
+
+} // namespace rx::concurrency
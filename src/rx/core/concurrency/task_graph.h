@@ -0,0 +1,135 @@
+#ifndef RX_CORE_CONCURRENCY_TASK_GRAPH_H
+#define RX_CORE_CONCURRENCY_TASK_GRAPH_H
+#include "rx/core/vector.h"
+#include "rx/core/function.h"
+
+#include "rx/core/concurrency/thread_pool.h"
+#include "rx/core/concurrency/atomic.h"
+
+namespace Rx::Concurrency {
+
+// # Task Graph
+//
+// A set of tasks with dependencies between them, executed on a thread pool.
+//
+// A task only runs once every task that precedes it has completed; tasks
+// without any dependency between them run concurrently. The graph is built
+// once and can be executed any number of times, e.g once a frame.
+//
+//  TaskGraph graph;
+//  auto animate = graph.add([&] { ... });
+//  auto cull = graph.add([&] { ... });
+//  auto draw = graph.add([&] { ... });
+//  graph.precede(animate, draw);
+//  graph.precede(cull, draw);
+//  graph.execute();
+//
+// When a task completes and makes another task ready, the ready task is run
+// right away by the same thread instead of going through the pool. Any other
+// ready tasks are added to the pool.
+//
+// The thread waiting on the graph runs tasks of the pool while it waits, so
+// it's safe to execute a graph from a task.
+//
+// The dependencies must not form a cycle and the graph must not be changed
+// while it's executing.
+struct RX_API TaskGraph {
+  RX_MARK_NO_COPY(TaskGraph);
+  RX_MARK_NO_MOVE(TaskGraph);
+
+  using Task = Size;
+
+  TaskGraph(Memory::Allocator& _allocator, ThreadPool& _pool);
+  TaskGraph(ThreadPool& _pool);
+  TaskGraph();
+  ~TaskGraph();
+
+  // Add |function_| to the graph.
+  Task add(Function<void()>&& function_);
+
+  // Only run |_after| once |_before| has completed.
+  bool precede(Task _before, Task _after);
+
+  // Add |function_| to run once |_task| has completed.
+  Task then(Task _task, Function<void()>&& function_);
+
+  // Start executing the graph and return immediately.
+  void run();
+
+  // Wait for the graph started with |run| to complete.
+  void wait();
+
+  bool is_done() const;
+
+  // Run the graph and wait for it.
+  void execute();
+
+  void clear();
+
+  Size size() const;
+
+  constexpr Memory::Allocator& allocator() const;
+
+private:
+  struct Node {
+    Node(Memory::Allocator& _allocator, Function<void()>&& function_);
+
+    Function<void()> function;
+    Vector<Task> successors;
+    Size dependencies;
+  };
+
+  void spawn(Task _task);
+  void complete(Task _task);
+
+  Memory::Allocator& m_allocator;
+  ThreadPool& m_pool;
+
+  Vector<Node> m_nodes;
+
+  // Dependencies left of every node in the current execution.
+  Atomic<Size>* m_dependencies;
+  Size m_capacity;
+
+  // Number of nodes yet to complete in the current execution.
+  Atomic<Size> m_pending;
+};
+
+inline TaskGraph::TaskGraph(ThreadPool& _pool)
+  : TaskGraph{_pool.allocator(), _pool}
+{
+}
+
+inline TaskGraph::TaskGraph()
+  : TaskGraph{ThreadPool::instance()}
+{
+}
+
+inline TaskGraph::Task TaskGraph::then(Task _task, Function<void()>&& function_) {
+  const Task task{add(Utility::move(function_))};
+  if (task != -1_z && !precede(_task, task)) {
+    return -1_z;
+  }
+  return task;
+}
+
+inline bool TaskGraph::is_done() const {
+  return m_pending.load(MemoryOrder::k_acquire) == 0;
+}
+
+inline void TaskGraph::execute() {
+  run();
+  wait();
+}
+
+inline Size TaskGraph::size() const {
+  return m_nodes.size();
+}
+
+RX_HINT_FORCE_INLINE constexpr Memory::Allocator& TaskGraph::allocator() const {
+  return m_allocator;
+}
+
+} // namespace rx::concurrency
+
+#endif // RX_CORE_CONCURRENCY_TASK_GRAPH_H
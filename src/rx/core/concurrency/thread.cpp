@@ -2,6 +2,7 @@
 
 #include "rx/core/concurrency/atomic.h"
 #include "rx/core/memory/system_allocator.h"
+#include "rx/core/memory/thread_cache_allocator.h"
 #include "rx/core/string.h"
 #include "rx/core/profiler.h"
 
@@ -49,6 +50,9 @@ void* Thread::State::wrap(void* _data) {
   // Dispatch the actual thread function.
   self->m_function(g_thread_id++);
 
+  // Give back the small blocks this thread has cached.
+  Memory::ThreadCacheAllocator::release_thread_cache();
+
   return nullptr;
 }
 
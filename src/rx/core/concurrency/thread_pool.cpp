@@ -1,8 +1,9 @@
 #include "rx/core/concurrency/thread_pool.h"
 #include "rx/core/concurrency/wait_group.h"
+#include "rx/core/concurrency/scope_lock.h"
+#include "rx/core/concurrency/yield.h"
 
 #include "rx/core/time/stop_watch.h"
-#include "rx/core/time/delay.h"
 
 #include "rx/core/log.h"
 
@@ -12,66 +13,285 @@ RX_LOG("ThreadPool", logger);
 
 Global<ThreadPool> ThreadPool::s_instance{"system", "thread_pool", 4_z, 4096_z};
 
-struct Work {
+// Number of attempts to find work before a thread parks. The first half of
+// them busy loop, the second half yield between attempts.
+static constexpr const Size k_spin_count{64};
+
+// The thread pool and index in it of the calling thread, when it's in one.
+static thread_local struct {
+  const ThreadPool* pool;
+  Size index;
+  int thread_id;
+  Uint32 seed;
+} t_worker;
+
+// xorshift32 on a per-thread seed, for picking a victim to steal from.
+static Uint32 random() {
+  auto& seed{t_worker.seed};
+  if (!seed) {
+    seed = static_cast<Uint32>(reinterpret_cast<UintPtr>(&t_worker)) | 1;
+  }
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  return seed;
+}
+
+struct ThreadPool::Work {
   RX_MARK_NO_COPY(Work);
   RX_MARK_NO_MOVE(Work);
 
-  Work(Function<void(int)>&& callback_)
-    : callback{Utility::move(callback_)}
+  Work(JobMemory* _memory, Function<void(int)>&& callback_)
+    : memory{_memory}
+    , callback{Utility::move(callback_)}
   {
   }
 
   IntrusiveList::Node link;
+  JobMemory* memory;
   Function<void(int)> callback;
 };
 
+struct ThreadPool::JobMemory {
+  JobMemory(Memory::Allocator& _allocator, Size _static_pool_size)
+    : pool{_allocator, sizeof(Work), _static_pool_size}
+  {
+  }
+
+  SpinLock lock;
+  DynamicPool pool RX_HINT_GUARDED_BY(lock);
+};
+
+// # Worker
+//
+// The deque is the one described in "Dynamic Circular Work-Stealing Deque"
+// by Chase and Lev, with the memory orders of "Correct and Efficient
+// Work-Stealing for Weak Memory Models" by Lê et al.
+//
+// The owner pushes and pops at |bottom| while other threads steal at |top|.
+// The ring is of fixed capacity so it never has to be reclaimed, when it's
+// full tasks go to the shared queue instead.
+struct ThreadPool::Worker {
+  RX_MARK_NO_COPY(Worker);
+  RX_MARK_NO_MOVE(Worker);
+
+  static inline constexpr const Sint64 k_capacity{1024};
+
+  Worker(Memory::Allocator& _allocator, Size _static_pool_size)
+    : top{0}
+    , bottom{0}
+    , memory{_allocator, _static_pool_size}
+  {
+    for (Sint64 i{0}; i < k_capacity; i++) {
+      ring[i].store(nullptr, MemoryOrder::k_relaxed);
+    }
+  }
+
+  // Only called by the owner.
+  bool push(Work* _work) {
+    const Sint64 b{bottom.load(MemoryOrder::k_relaxed)};
+    const Sint64 t{top.load(MemoryOrder::k_acquire)};
+    if (b - t >= k_capacity) {
+      return false;
+    }
+    ring[b & (k_capacity - 1)].store(_work, MemoryOrder::k_relaxed);
+    atomic_thread_fence(MemoryOrder::k_release);
+    bottom.store(b + 1, MemoryOrder::k_relaxed);
+    return true;
+  }
+
+  // Only called by the owner.
+  Work* pop() {
+    const Sint64 b{bottom.load(MemoryOrder::k_relaxed) - 1};
+    bottom.store(b, MemoryOrder::k_relaxed);
+    atomic_thread_fence(MemoryOrder::k_seq_cst);
+    Sint64 t{top.load(MemoryOrder::k_relaxed)};
+
+    if (t > b) {
+      // Empty.
+      bottom.store(b + 1, MemoryOrder::k_relaxed);
+      return nullptr;
+    }
+
+    Work* work{ring[b & (k_capacity - 1)].load(MemoryOrder::k_relaxed)};
+    if (t == b) {
+      // The last task, race the thieves for it.
+      if (!top.compare_exchange_strong(t, t + 1, MemoryOrder::k_seq_cst,
+        MemoryOrder::k_relaxed))
+      {
+        work = nullptr;
+      }
+      bottom.store(b + 1, MemoryOrder::k_relaxed);
+    }
+
+    return work;
+  }
+
+  // Called by any thread. Sets |contended_| when the steal lost a race and
+  // there may still be something to steal.
+  Work* steal(bool& contended_) {
+    Sint64 t{top.load(MemoryOrder::k_acquire)};
+    atomic_thread_fence(MemoryOrder::k_seq_cst);
+    const Sint64 b{bottom.load(MemoryOrder::k_acquire)};
+
+    if (t >= b) {
+      return nullptr;
+    }
+
+    Work* work{ring[t & (k_capacity - 1)].load(MemoryOrder::k_relaxed)};
+    if (!top.compare_exchange_strong(t, t + 1, MemoryOrder::k_seq_cst,
+      MemoryOrder::k_relaxed))
+    {
+      contended_ = true;
+      return nullptr;
+    }
+
+    return work;
+  }
+
+  bool is_empty() const {
+    const Sint64 t{top.load(MemoryOrder::k_acquire)};
+    const Sint64 b{bottom.load(MemoryOrder::k_acquire)};
+    return t >= b;
+  }
+
+  // Keep |top| and |bottom| on different cache lines, they're written by
+  // different threads.
+  Atomic<Sint64> top;
+  Byte pad[64 - sizeof(Atomic<Sint64>)];
+  Atomic<Sint64> bottom;
+
+  Atomic<Work*> ring[k_capacity];
+
+  // Memory of the tasks added by the owner.
+  JobMemory memory;
+};
+
+// # Injector
+//
+// The bounded queue of many producers and many consumers described by Dmitry
+// Vyukov. Every cell has a sequence number which tells whether it's ready to
+// be written or read at a given position, so producers and consumers each
+// only contend on the position they claim with a compare-exchange and never
+// take a lock.
+struct ThreadPool::Injector {
+  RX_MARK_NO_COPY(Injector);
+  RX_MARK_NO_MOVE(Injector);
+
+  static inline constexpr const Size k_capacity{1024};
+
+  Injector()
+    : enqueue_position{0}
+    , dequeue_position{0}
+  {
+    for (Size i{0}; i < k_capacity; i++) {
+      cells[i].sequence.store(i, MemoryOrder::k_relaxed);
+      cells[i].work = nullptr;
+    }
+  }
+
+  // Called by any thread. Returns false when full.
+  bool push(Work* _work) {
+    Size position{enqueue_position.load(MemoryOrder::k_relaxed)};
+    for (;;) {
+      Cell& cell{cells[position & (k_capacity - 1)]};
+      const Size sequence{cell.sequence.load(MemoryOrder::k_acquire)};
+      const auto difference{static_cast<PtrDiff>(sequence - position)};
+      if (difference == 0) {
+        if (enqueue_position.compare_exchange_weak(position, position + 1,
+          MemoryOrder::k_relaxed, MemoryOrder::k_relaxed))
+        {
+          cell.work = _work;
+          cell.sequence.store(position + 1, MemoryOrder::k_release);
+          return true;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = enqueue_position.load(MemoryOrder::k_relaxed);
+      }
+    }
+  }
+
+  // Called by any thread. Returns nullptr when empty.
+  Work* pop() {
+    Size position{dequeue_position.load(MemoryOrder::k_relaxed)};
+    for (;;) {
+      Cell& cell{cells[position & (k_capacity - 1)]};
+      const Size sequence{cell.sequence.load(MemoryOrder::k_acquire)};
+      const auto difference{static_cast<PtrDiff>(sequence - (position + 1))};
+      if (difference == 0) {
+        if (dequeue_position.compare_exchange_weak(position, position + 1,
+          MemoryOrder::k_relaxed, MemoryOrder::k_relaxed))
+        {
+          Work* work{cell.work};
+          cell.sequence.store(position + k_capacity, MemoryOrder::k_release);
+          return work;
+        }
+      } else if (difference < 0) {
+        return nullptr;
+      } else {
+        position = dequeue_position.load(MemoryOrder::k_relaxed);
+      }
+    }
+  }
+
+  // A task which was claimed but not written yet counts, so that a thread
+  // about to park waits for it rather than miss it.
+  bool is_empty() const {
+    return enqueue_position.load(MemoryOrder::k_acquire)
+      == dequeue_position.load(MemoryOrder::k_acquire);
+  }
+
+  struct Cell {
+    Atomic<Size> sequence;
+    Work* work;
+  };
+
+  // Keep the positions on different cache lines, they're written by
+  // producers and consumers respectively.
+  Atomic<Size> enqueue_position;
+  Byte pad0[64 - sizeof(Atomic<Size>)];
+  Atomic<Size> dequeue_position;
+  Byte pad1[64 - sizeof(Atomic<Size>)];
+
+  Cell cells[k_capacity];
+};
+
 ThreadPool::ThreadPool(Memory::Allocator& _allocator, Size _threads, Size _static_pool_size)
   : m_allocator{_allocator}
+  , m_injector{make_ptr<Injector>(allocator())}
+  , m_queued{0}
+  , m_job_memory{make_ptr<JobMemory>(allocator(), allocator(), _static_pool_size)}
+  , m_workers{allocator()}
   , m_threads{allocator()}
-  , m_job_memory{allocator(), sizeof(Work), _static_pool_size}
+  , m_sleeping{0}
+  , m_epoch{0}
   , m_stop{false}
 {
   Time::StopWatch timer;
   timer.start();
 
   logger->info("starting pool with %zu threads", _threads);
+
+  // Every worker has to exist before any thread starts stealing from them.
+  m_workers.reserve(_threads);
+  for (Size i{0}; i < _threads; i++) {
+    m_workers.push_back(make_ptr<Worker>(allocator(), allocator(), _static_pool_size));
+  }
+
   m_threads.reserve(_threads);
 
   WaitGroup group{_threads};
   for (Size i{0}; i < _threads; i++) {
-    m_threads.emplace_back("thread pool", [this, &group](int _thread_id) {
+    m_threads.emplace_back("thread pool", [this, &group, i](int _thread_id) {
       logger->info("starting thread %d", _thread_id);
 
       group.signal();
 
-      for (;;) {
-        Function<void(int)> task;
-        {
-          ScopeLock lock{m_mutex};
-          m_task_cond.wait(lock, [this] { return m_stop || !m_queue.is_empty(); });
-          if (m_stop && m_queue.is_empty()) {
-            logger->info("stopping thread %d", _thread_id);
-            return;
-          }
-
-          auto node = m_queue.pop_back();
-          auto item = node->data<Work>(&Work::link);
+      run(i, _thread_id);
 
-          task = Utility::move(item->callback);
-
-          m_job_memory.destroy(item);
-        }
-
-        logger->verbose("starting task on thread %d", _thread_id);
-
-        Time::StopWatch timer;
-        timer.start();
-        task(_thread_id);
-        timer.stop();
-
-        logger->verbose("finished task on thread %d (took %s)",
-          _thread_id, timer.elapsed());
-      }
+      logger->info("stopping thread %d", _thread_id);
     });
   }
 
@@ -102,10 +322,181 @@ ThreadPool::~ThreadPool() {
 }
 
 void ThreadPool::add(Function<void(int)>&& task_) {
+  if (t_worker.pool == this) {
+    // Called from a task, keep it on this thread unless the deque is full.
+    auto& worker{*m_workers[t_worker.index]};
+    auto work{create_work(worker.memory, Utility::move(task_))};
+    if (!worker.push(work)) {
+      inject(work);
+    }
+  } else {
+    inject(create_work(*m_job_memory, Utility::move(task_)));
+  }
+  wake();
+}
+
+void ThreadPool::inject(Work* _work) {
+  if (!m_injector->push(_work)) {
+    ScopeLock lock{m_mutex};
+    m_queue.push_back(&_work->link);
+    m_queued++;
+  }
+}
+
+ThreadPool::Work* ThreadPool::create_work(JobMemory& memory_,
+  Function<void(int)>&& task_)
+{
+  ScopeLock lock{memory_.lock};
+  auto work{memory_.pool.create<Work>(&memory_, Utility::move(task_))};
+  RX_ASSERT(work, "out of memory");
+  return work;
+}
+
+void ThreadPool::destroy_work(Work* _work) {
+  auto& memory{*_work->memory};
+  ScopeLock lock{memory.lock};
+  memory.pool.destroy<Work>(_work);
+}
+
+ThreadPool::Work* ThreadPool::find_work(Size _index) {
+  // The most recently added task of this thread.
+  if (auto work{m_workers[_index]->pop()}) {
+    return work;
+  }
+
+  // One of the oldest tasks added from outside the pool.
+  if (auto work{take_work()}) {
+    return work;
+  }
+
+  return steal_work(_index);
+}
+
+ThreadPool::Work* ThreadPool::take_work() {
+  if (auto work{m_injector->pop()}) {
+    return work;
+  }
+
+  // Only when the injector overflowed.
+  if (m_queued.load(MemoryOrder::k_relaxed)) {
+    ScopeLock lock{m_mutex};
+    if (auto node{m_queue.pop_front()}) {
+      m_queued--;
+      return node->data<Work>(&Work::link);
+    }
+  }
+  return nullptr;
+}
+
+ThreadPool::Work* ThreadPool::steal_work(Size _index) {
+  const Size n_workers{m_workers.size()};
+  if (n_workers == 0 || (n_workers == 1 && _index == 0)) {
+    return nullptr;
+  }
+
+  // Visit every other worker once, starting at a random one. Keep going
+  // while steals are lost to other thieves since there's work left then.
+  for (;;) {
+    bool contended{false};
+    const Size start{random() % n_workers};
+    for (Size i{0}; i < n_workers; i++) {
+      const Size victim{(start + i) % n_workers};
+      if (victim == _index) {
+        continue;
+      }
+      if (auto work{m_workers[victim]->steal(contended)}) {
+        return work;
+      }
+    }
+    if (!contended) {
+      return nullptr;
+    }
+  }
+}
+
+bool ThreadPool::has_work() const {
+  if (!m_injector->is_empty() || m_queued.load()) {
+    return true;
+  }
+  return !m_workers.each_fwd([](const Ptr<Worker>& _worker) {
+    return _worker->is_empty();
+  });
+}
+
+void ThreadPool::run(Size _index, int _thread_id) {
+  t_worker.pool = this;
+  t_worker.index = _index;
+  t_worker.thread_id = _thread_id;
+
+  for (;;) {
+    Work* work{nullptr};
+
+    // Spin for a while before parking, tasks tend to come in bursts.
+    for (Size i{0}; i < k_spin_count && !work; i++) {
+      if (i >= k_spin_count / 2) {
+        yield();
+      }
+      work = find_work(_index);
+    }
+
+    if (!work) {
+      Uint64 epoch;
+      {
+        ScopeLock lock{m_mutex};
+        if (m_stop) {
+          break;
+        }
+        epoch = m_epoch;
+      }
+
+      // Announce the intent to park before checking for work one last time.
+      // Either the check sees a task that was just added or |wake| sees this
+      // thread as sleeping and bumps the epoch.
+      m_sleeping++;
+      atomic_thread_fence(MemoryOrder::k_seq_cst);
+      if (!has_work()) {
+        ScopeLock lock{m_mutex};
+        m_task_cond.wait(lock, [&] { return m_stop || m_epoch != epoch; });
+      }
+      m_sleeping--;
+      continue;
+    }
+
+    auto task{Utility::move(work->callback)};
+    destroy_work(work);
+    task(_thread_id);
+  }
+
+  t_worker.pool = nullptr;
+}
+
+bool ThreadPool::help() {
+  Work* work{nullptr};
+  if (t_worker.pool == this) {
+    work = find_work(t_worker.index);
+  } else if (!(work = take_work())) {
+    work = steal_work(-1_z);
+  }
+
+  if (!work) {
+    return false;
+  }
+
+  auto task{Utility::move(work->callback)};
+  destroy_work(work);
+  task(t_worker.pool == this ? t_worker.thread_id : -1);
+  return true;
+}
+
+void ThreadPool::wake() {
+  // Pairs with the fence in |run| before it checks for work.
+  atomic_thread_fence(MemoryOrder::k_seq_cst);
+  if (m_sleeping.load(MemoryOrder::k_relaxed) == 0) {
+    return;
+  }
   {
     ScopeLock lock{m_mutex};
-    auto item = m_job_memory.create<Work>(Utility::move(task_));
-    m_queue.push_back(&item->link);
+    m_epoch++;
   }
   m_task_cond.signal();
 }
@@ -3,13 +3,34 @@
 #include "rx/core/intrusive_list.h"
 #include "rx/core/function.h"
 #include "rx/core/dynamic_pool.h"
+#include "rx/core/ptr.h"
 
 #include "rx/core/concurrency/thread.h"
 #include "rx/core/concurrency/mutex.h"
+#include "rx/core/concurrency/spin_lock.h"
 #include "rx/core/concurrency/condition_variable.h"
+#include "rx/core/concurrency/atomic.h"
 
 namespace Rx::Concurrency {
 
+// # Thread Pool
+//
+// Work stealing thread pool.
+//
+// Every thread in the pool owns a deque of tasks. Tasks added from a thread
+// in the pool are pushed onto the bottom of it's own deque and popped from
+// the bottom again, so the most recently added task, which is likely still
+// in cache, runs first. Tasks added from any other thread go into a shared
+// lock-free queue instead, which only spills into one behind a lock when it's
+// full.
+//
+// A thread with nothing in it's own deque takes from the shared queue and
+// then steals from the top of the deque of the other threads, starting at a
+// random one. Only when there's nothing to steal anywhere does a thread spin
+// for a bit and then park until more tasks are added.
+//
+// The task memory is pooled per thread as well, so adding tasks from the
+// threads in the pool does not contend on a single lock.
 struct RX_API ThreadPool {
   RX_MARK_NO_COPY(ThreadPool);
   RX_MARK_NO_MOVE(ThreadPool);
@@ -19,24 +40,62 @@ struct RX_API ThreadPool {
   ~ThreadPool();
 
   // insert |_task| into the thread pool to be executed, the integer passed
-  // to |_task| is the thread id of the calling thread in the pool
+  // to |_task| is the thread id of the calling thread in the pool, or -1 when
+  // it's run by |help| on a thread outside the pool
   void add(Function<void(int)>&& task_);
 
+  // Run one task of the pool on the calling thread if there is one. Returns
+  // false when there was nothing to run.
+  //
+  // Use this to wait on other tasks without blocking a thread, anything that
+  // waits from inside a task must do so or it can deadlock the pool.
+  bool help();
+
+  Size threads() const;
+
   constexpr Memory::Allocator& allocator() const;
 
   static constexpr ThreadPool& instance();
 
 private:
+  struct Work;
+  struct JobMemory;
+  struct Worker;
+  struct Injector;
+
+  Work* create_work(JobMemory& memory_, Function<void(int)>&& task_);
+  void inject(Work* _work);
+  void destroy_work(Work* _work);
+
+  // Find a task for the thread |_index| in the pool.
+  Work* find_work(Size _index);
+  Work* take_work();
+  // Steal from any thread but |_index|, which is -1 outside the pool.
+  Work* steal_work(Size _index);
+  bool has_work() const;
+
+  void run(Size _index, int _thread_id);
+  void wake();
+
   Memory::Allocator& m_allocator;
 
   Mutex m_mutex;
   ConditionVariable m_task_cond;
-  ConditionVariable m_ready_cond;
 
-  IntrusiveList m_queue     RX_HINT_GUARDED_BY(m_mutex);
-  Vector<Thread> m_threads  RX_HINT_GUARDED_BY(m_mutex);
-  DynamicPool m_job_memory  RX_HINT_GUARDED_BY(m_mutex);
-  bool m_stop               RX_HINT_GUARDED_BY(m_mutex);
+  // Tasks added from outside the pool, and those which didn't fit in
+  // |m_injector| or the deque of the thread adding them.
+  Ptr<Injector> m_injector;
+  IntrusiveList m_queue              RX_HINT_GUARDED_BY(m_mutex);
+  Atomic<Size> m_queued;
+  Ptr<JobMemory> m_job_memory;
+
+  Vector<Ptr<Worker>> m_workers;
+  Vector<Thread> m_threads;
+
+  // Parked threads wait for |m_epoch| to change.
+  Atomic<Size> m_sleeping;
+  Uint64 m_epoch                     RX_HINT_GUARDED_BY(m_mutex);
+  bool m_stop                        RX_HINT_GUARDED_BY(m_mutex);
 
   static Global<ThreadPool> s_instance;
 };
@@ -46,6 +105,10 @@ inline ThreadPool::ThreadPool(Size _threads, Size _static_pool_size)
 {
 }
 
+inline Size ThreadPool::threads() const {
+  return m_workers.size();
+}
+
 RX_HINT_FORCE_INLINE constexpr Memory::Allocator& ThreadPool::allocator() const {
   return m_allocator;
 }
@@ -2,6 +2,12 @@
 #include "rx/core/assert.h"
 #include "rx/core/abort.h"
 
+// Over-aligned types are allocated with these forms, declared the way the
+// compiler expects without including <new>.
+namespace std {
+  enum class align_val_t : Rx::Size {};
+} // namespace std
+
 // These cannot be disabled in debug builds under Emscripten.
 #if !defined(RX_PLATFORM_EMSCRIPTEN) || (defined(RX_PLATFORM_EMSCRIPTEN) && !defined(RX_DEBUG))
 void* operator new(Rx::Size) {
@@ -27,6 +33,30 @@ void operator delete[](void*) {
 void operator delete[](void*, Rx::Size) {
   Rx::abort("operator delete[] is disabled");
 }
+
+void* operator new(Rx::Size, std::align_val_t) {
+  Rx::abort("operator new is disabled");
+}
+
+void* operator new[](Rx::Size, std::align_val_t) {
+  Rx::abort("operator new[] is disabled");
+}
+
+void operator delete(void*, std::align_val_t) {
+  Rx::abort("operator delete is disabled");
+}
+
+void operator delete(void*, Rx::Size, std::align_val_t) {
+  Rx::abort("operator delete is disabled");
+}
+
+void operator delete[](void*, std::align_val_t) {
+  Rx::abort("operator delete[] is disabled");
+}
+
+void operator delete[](void*, Rx::Size, std::align_val_t) {
+  Rx::abort("operator delete[] is disabled");
+}
 #endif
 
 extern "C" {
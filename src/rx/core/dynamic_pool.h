@@ -91,7 +91,7 @@ void DynamicPool::destroy(T* _data) {
 
   // When the pool is empty and it's the last pool in the list, to reduce
   // memory, remove it from |m_pools|.
-  if (pool->is_empty() && pool == m_pools.last()) {
+  if (pool->is_empty() && &pool == &m_pools.last()) {
     m_pools.pop_back();
   }
 }
@@ -0,0 +1,233 @@
+#include <string.h> // memcmp, memcpy, strcmp, strchr, strlen, strncmp
+
+#include "rx/core/filesystem/archive.h"
+
+#include "rx/core/compression/lz4.h"
+
+#include "rx/core/hash/fnv1a.h"
+
+#include "rx/core/hints/unlikely.h"
+
+#include "rx/core/log.h"
+
+RX_LOG("filesystem/archive", logger);
+
+namespace Rx::Filesystem {
+
+// These are written to disk as they are.
+static_assert(sizeof(Archive::Header) == 32, "unexpected size");
+static_assert(sizeof(Archive::Entry) == 40, "unexpected size");
+
+// Everything the index refers to has to be inside the archive, once that's
+// been checked nothing has to be checked again when files are looked up.
+static bool validate(const Byte* _data, Uint64 _size) {
+  if (_size < sizeof(Archive::Header)) {
+    return false;
+  }
+
+  const auto header = reinterpret_cast<const Archive::Header*>(_data);
+  if (memcmp(header->magic, "RXPK", sizeof header->magic) != 0) {
+    return false;
+  }
+
+  if (header->version != Archive::k_version) {
+    logger->error("unsupported version %u", header->version);
+    return false;
+  }
+
+  if (header->alignment == 0 || (header->alignment & (header->alignment - 1)) != 0) {
+    return false;
+  }
+
+  const Uint64 index_end{sizeof *header + Uint64{header->entries} * sizeof(Archive::Entry)};
+  if (index_end > _size) {
+    return false;
+  }
+
+  if (header->names_offset < index_end
+    || header->names_offset > _size
+    || header->names_size > _size - header->names_offset)
+  {
+    return false;
+  }
+
+  const auto names = reinterpret_cast<const char*>(_data + header->names_offset);
+  if (header->names_size != 0 && names[header->names_size - 1] != '\0') {
+    return false;
+  }
+
+  const auto entries = reinterpret_cast<const Archive::Entry*>(header + 1);
+  for (Uint32 i{0}; i < header->entries; i++) {
+    const auto& entry{entries[i]};
+
+    // Sorted by hash, without two of the same.
+    if (i != 0 && entries[i - 1].hash >= entry.hash) {
+      return false;
+    }
+
+    if (entry.name >= header->names_size) {
+      return false;
+    }
+
+    if (entry.offset > _size || entry.stored_size > _size - entry.offset) {
+      return false;
+    }
+
+    switch (entry.compression) {
+    case Archive::Compression::k_none:
+      if (entry.stored_size != entry.size) {
+        return false;
+      }
+      break;
+    case Archive::Compression::k_lz4:
+      break;
+    default:
+      return false;
+    }
+  }
+
+  return true;
+}
+
+Archive::Archive(Memory::Allocator& _allocator)
+  : m_allocator{_allocator}
+  , m_data{nullptr}
+  , m_entries{nullptr}
+  , m_count{0}
+  , m_names{nullptr}
+{
+}
+
+bool Archive::mount(const char* _file_name) {
+  unmount();
+
+  MappedFile file{allocator(), _file_name};
+  if (!file) {
+    return false;
+  }
+
+  const auto size{*file.size()};
+  const auto data{file.view(size)};
+  if (!data || !validate(data, size)) {
+    logger->error("'%s' is not a valid archive", _file_name);
+    return false;
+  }
+
+  const auto header{reinterpret_cast<const Header*>(data)};
+
+  m_file = Utility::move(file);
+  m_data = data;
+  m_entries = reinterpret_cast<const Entry*>(header + 1);
+  m_count = header->entries;
+  m_names = reinterpret_cast<const char*>(data + header->names_offset);
+
+  logger->info("mounted '%s' with %u files", _file_name, m_count);
+
+  return true;
+}
+
+void Archive::unmount() {
+  m_file = nullopt;
+  m_data = nullptr;
+  m_entries = nullptr;
+  m_count = 0;
+  m_names = nullptr;
+}
+
+const Archive::Entry* Archive::find(const char* _file_name) const {
+  if (m_count == 0) {
+    return nullptr;
+  }
+
+  PathResolver resolver{allocator()};
+  if (!resolve(_file_name, resolver)) {
+    return nullptr;
+  }
+
+  const char* name{resolver.path()};
+  const Uint64 key{hash(name)};
+
+  Size lo{0};
+  Size hi{m_count};
+  while (lo < hi) {
+    const Size mid{lo + (hi - lo) / 2};
+    if (m_entries[mid].hash < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  if (lo == m_count || m_entries[lo].hash != key) {
+    return nullptr;
+  }
+
+  // Another path with the same hash isn't the same file.
+  const auto& entry{m_entries[lo]};
+  return strcmp(this->name(entry), name) == 0 ? &entry : nullptr;
+}
+
+bool Archive::extract(const Entry& _entry, Byte* data_) const {
+  const auto size{static_cast<Size>(_entry.size)};
+  const auto stored_size{static_cast<Size>(_entry.stored_size)};
+
+  switch (_entry.compression) {
+  case Compression::k_none:
+    memcpy(data_, data(_entry), size);
+    return true;
+  case Compression::k_lz4:
+    if (RX_HINT_UNLIKELY(!Rx::Compression::lz4_decompress(data(_entry), stored_size, data_, size))) {
+      logger->error("'%s' is corrupt", name(_entry));
+      return false;
+    }
+    return true;
+  }
+
+  return false;
+}
+
+bool Archive::each(const char* _directory, Function<void(const char*)>&& _function) const {
+  if (m_count == 0) {
+    return false;
+  }
+
+  PathResolver resolver{allocator()};
+  if (!resolve(_directory, resolver)) {
+    return false;
+  }
+
+  // Only the root ends with a separator.
+  const char* directory{resolver.path()};
+  const Size length{strlen(directory)};
+  const Size skip{directory[length - 1] == '/' ? length : length + 1};
+
+  bool found{false};
+  for (Uint32 i{0}; i < m_count; i++) {
+    const char* name{this->name(m_entries[i])};
+    if (strncmp(name, directory, length) != 0 || (skip != length && name[length] != '/')) {
+      continue;
+    }
+
+    // Files in directories of |_directory| aren't in it.
+    if (strchr(name + skip, '/')) {
+      continue;
+    }
+
+    _function(name + skip);
+    found = true;
+  }
+
+  return found;
+}
+
+bool Archive::resolve(const char* _path, PathResolver& resolver_) {
+  return resolver_.append(_path) && resolver_.push('\0');
+}
+
+Uint64 Archive::hash(const char* _name) {
+  return Hash::fnv1a<Uint64>(reinterpret_cast<const Byte*>(_name), strlen(_name));
+}
+
+Global<Archive> Archive::s_instance{"system", "archive"};
+
+} // namespace rx::filesystem
@@ -0,0 +1,145 @@
+#ifndef RX_CORE_FILESYSTEM_ARCHIVE_H
+#define RX_CORE_FILESYSTEM_ARCHIVE_H
+#include "rx/core/filesystem/mapped_file.h"
+#include "rx/core/filesystem/path_resolver.h"
+#include "rx/core/function.h"
+#include "rx/core/global.h"
+
+namespace Rx::Filesystem {
+
+// # Archive
+//
+// Many files packed into one, which is mapped into memory whole when it's
+// mounted.
+//
+// Files in the mounted archive are found by the hash of their path with a
+// binary search of the index, no file is opened or stat'd to find them. Files
+// stored as they are can be used in place in the mapping, compressed ones
+// are decompressed when they're opened.
+//
+// The archive mounted on |instance| is looked in first by |MappedFile|, and
+// everything built on it, before the file system. Paths are resolved with
+// |PathResolver| so "base/./a/../b" and "base/b" are the same file. Mount it
+// before anything is loaded, the archive isn't changed once it's in use.
+//
+// The layout of an archive, all of it little-endian.
+//
+//   Header
+//   Entry[entries], sorted by hash
+//   names, the resolved path of every entry, each terminated by a null
+//   data, every entry starts on a multiple of |alignment|
+//
+// Archives are built by the pack tool in tools/pack.cpp.
+struct RX_API Archive {
+  RX_MARK_NO_COPY(Archive);
+  RX_MARK_NO_MOVE(Archive);
+
+  static inline constexpr const Uint32 k_version{1};
+
+  enum class Compression : Uint32 {
+    k_none,
+    k_lz4
+  };
+
+  struct Header {
+    char magic[4]; // "RXPK"
+    Uint32 version;
+    Uint32 entries;
+    Uint32 alignment;
+    Uint64 names_offset;
+    Uint64 names_size;
+  };
+
+  struct Entry {
+    Uint64 hash;
+    Uint64 offset;
+    Uint64 size;
+    Uint64 stored_size;
+    Uint32 name;
+    Compression compression;
+  };
+
+  Archive(Memory::Allocator& _allocator);
+  Archive();
+  ~Archive();
+
+  // Mount the archive |_file_name|, replacing whatever was mounted before.
+  bool mount(const char* _file_name);
+  bool mount(const String& _file_name);
+  void unmount();
+
+  bool is_mounted() const;
+
+  // Find the entry for |_file_name|. Returns nullptr when there isn't one.
+  const Entry* find(const char* _file_name) const;
+
+  // The data of |_entry| as it's stored in the archive.
+  const Byte* data(const Entry& _entry) const;
+
+  // The resolved path of |_entry|.
+  const char* name(const Entry& _entry) const;
+
+  // Decompress |_entry| into |data_|, which must be |_entry.size| bytes.
+  bool extract(const Entry& _entry, Byte* data_) const;
+
+  // Call |_function| with the name of every file directly in |_directory|.
+  // Returns false when the archive has nothing in |_directory|.
+  bool each(const char* _directory, Function<void(const char*)>&& _function) const;
+
+  // Resolve |_path| the way paths in an archive are, into |resolver_|.
+  static bool resolve(const char* _path, PathResolver& resolver_);
+
+  // The hash of the resolved path |_name|.
+  static Uint64 hash(const char* _name);
+
+  constexpr Memory::Allocator& allocator() const;
+
+  static constexpr Archive& instance();
+
+private:
+  Memory::Allocator& m_allocator;
+  Optional<MappedFile> m_file;
+  const Byte* m_data;
+  const Entry* m_entries;
+  Uint32 m_count;
+  const char* m_names;
+
+  static Global<Archive> s_instance;
+};
+
+inline Archive::Archive()
+  : Archive{Memory::SystemAllocator::instance()}
+{
+}
+
+inline Archive::~Archive() {
+  unmount();
+}
+
+inline bool Archive::mount(const String& _file_name) {
+  return mount(_file_name.data());
+}
+
+inline bool Archive::is_mounted() const {
+  return m_count != 0;
+}
+
+inline const Byte* Archive::data(const Entry& _entry) const {
+  return m_data + _entry.offset;
+}
+
+inline const char* Archive::name(const Entry& _entry) const {
+  return m_names + _entry.name;
+}
+
+RX_HINT_FORCE_INLINE constexpr Memory::Allocator& Archive::allocator() const {
+  return m_allocator;
+}
+
+RX_HINT_FORCE_INLINE constexpr Archive& Archive::instance() {
+  return *s_instance;
+}
+
+} // namespace rx::filesystem
+
+#endif // RX_CORE_FILESYSTEM_ARCHIVE_H
@@ -6,6 +6,7 @@
 #include "rx/core/algorithm/min.h"
 
 #include "rx/core/filesystem/file.h"
+#include "rx/core/filesystem/mapped_file.h"
 
 #include "rx/core/hints/unlikely.h"
 #include "rx/core/hints/unreachable.h"
@@ -336,16 +337,16 @@ bool File::read_line(String& line_) {
 }
 
 Optional<Vector<Byte>> read_binary_file(Memory::Allocator& _allocator, const char* _file_name) {
-  if (File open_file{_file_name, "rb"}) {
+  if (MappedFile open_file{_allocator, _file_name}) {
     return read_binary_stream(_allocator, &open_file);
   }
 
-  logger->error("failed to open file '%s' [%s]", _file_name);
+  logger->error("failed to open file '%s'", _file_name);
   return nullopt;
 }
 
 Optional<Vector<Byte>> read_text_file(Memory::Allocator& _allocator, const char* _file_name) {
-  if (File open_file{_file_name, "rb"}) {
+  if (MappedFile open_file{_allocator, _file_name}) {
     return read_text_stream(_allocator, &open_file);
   }
 
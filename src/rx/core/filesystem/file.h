@@ -130,6 +130,7 @@ inline bool File::print(const char* _format, Ts&&... _arguments) {
   return print(Memory::SystemAllocator::instance(), _format, Utility::forward<Ts>(_arguments)...);
 }
 
+// Read all of |_file_name|, from the mounted |Archive| when it's in there.
 RX_API Optional<Vector<Byte>> read_binary_file(Memory::Allocator& _allocator, const char* _file_name);
 RX_API Optional<Vector<Byte>> read_text_file(Memory::Allocator& _allocator, const char* _file_name);
 
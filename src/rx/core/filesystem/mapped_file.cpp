@@ -0,0 +1,202 @@
+#include <string.h> // memcpy
+
+#include "rx/core/filesystem/mapped_file.h"
+#include "rx/core/filesystem/archive.h"
+
+#include "rx/core/algorithm/min.h"
+
+#include "rx/core/hints/unlikely.h"
+
+#include "rx/core/assert.h"
+
+#if defined(RX_PLATFORM_POSIX)
+#include <sys/mman.h> // mmap, munmap, MAP_{FAILED,PRIVATE}, PROT_READ
+#include <sys/stat.h> // fstat, struct stat
+#include <unistd.h> // close
+#include <fcntl.h> // open, O_RDONLY
+#elif defined(RX_PLATFORM_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace Rx::Filesystem {
+
+#if defined(RX_PLATFORM_POSIX)
+static bool map_file([[maybe_unused]] Memory::Allocator& _allocator,
+  const char* _file_name, const Byte*& data_, Uint64& size_)
+{
+  const int fd = open(_file_name, O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat buf;
+  if (fstat(fd, &buf) == -1) {
+    close(fd);
+    return false;
+  }
+
+  // An empty file has nothing to map, it's still a valid file though.
+  size_ = static_cast<Uint64>(buf.st_size);
+  if (size_ != 0) {
+    const auto map = mmap(nullptr, static_cast<Size>(size_), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+      close(fd);
+      return false;
+    }
+    data_ = static_cast<const Byte*>(map);
+  }
+
+  // The mapping keeps a reference to the file.
+  close(fd);
+  return true;
+}
+
+static bool unmap_file(const Byte* _data, Uint64 _size) {
+  return !_data || munmap(const_cast<Byte*>(_data), static_cast<Size>(_size)) == 0;
+}
+#elif defined(RX_PLATFORM_WINDOWS)
+static bool map_file(Memory::Allocator& _allocator, const char* _file_name,
+  const Byte*& data_, Uint64& size_)
+{
+  WideString file_name = String::format(_allocator, "%s", _file_name).to_utf16();
+
+  HANDLE file = CreateFileW(
+    reinterpret_cast<LPCWSTR>(file_name.data()),
+    GENERIC_READ,
+    FILE_SHARE_READ,
+    nullptr,
+    OPEN_EXISTING,
+    FILE_ATTRIBUTE_NORMAL,
+    nullptr);
+
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size)) {
+    CloseHandle(file);
+    return false;
+  }
+
+  size_ = static_cast<Uint64>(size.QuadPart);
+  if (size_ != 0) {
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+      CloseHandle(file);
+      return false;
+    }
+
+    // The view keeps a reference to both the mapping and the file.
+    data_ = static_cast<const Byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle(mapping);
+    if (!data_) {
+      CloseHandle(file);
+      return false;
+    }
+  }
+
+  CloseHandle(file);
+  return true;
+}
+
+static bool unmap_file(const Byte* _data, Uint64) {
+  return !_data || UnmapViewOfFile(_data);
+}
+#endif
+
+MappedFile::MappedFile(Memory::Allocator& _allocator, const char* _file_name)
+  : Stream{READ | STAT}
+  , m_allocator{_allocator}
+  , m_data{nullptr}
+  , m_size{0}
+  , m_backing{Backing::k_none}
+  , m_name{allocator(), _file_name}
+{
+  const auto& archive{Archive::instance()};
+  const auto entry{archive.find(_file_name)};
+  if (!entry) {
+    if (map_file(m_allocator, _file_name, m_data, m_size)) {
+      m_backing = Backing::k_mapping;
+    }
+    return;
+  }
+
+  m_size = entry->size;
+
+  // Stored as it is, it's already in memory.
+  if (entry->compression == Archive::Compression::k_none) {
+    m_data = archive.data(*entry);
+    m_backing = Backing::k_archive;
+    return;
+  }
+
+  const auto data{m_allocator.allocate(static_cast<Size>(m_size))};
+  if (RX_HINT_UNLIKELY(!data)) {
+    return;
+  }
+
+  if (!archive.extract(*entry, data)) {
+    m_allocator.deallocate(data);
+    return;
+  }
+
+  m_data = data;
+  m_backing = Backing::k_memory;
+}
+
+Uint64 MappedFile::on_read(Byte* _data, Uint64 _size, Uint64 _offset) {
+  RX_ASSERT(is_valid(), "invalid");
+
+  if (RX_HINT_UNLIKELY(_offset >= m_size)) {
+    return 0;
+  }
+
+  const auto bytes = Algorithm::min(_size, m_size - _offset);
+  memcpy(_data, m_data + _offset, static_cast<Size>(bytes));
+  return bytes;
+}
+
+bool MappedFile::on_stat(Stat& stat_) const {
+  RX_ASSERT(is_valid(), "invalid");
+  stat_.size = m_size;
+  return true;
+}
+
+const Byte* MappedFile::on_view(Uint64 _size, Uint64 _offset) {
+  RX_ASSERT(is_valid(), "invalid");
+
+  if (RX_HINT_UNLIKELY(_offset > m_size || _size > m_size - _offset)) {
+    return nullptr;
+  }
+
+  // Any pointer will do for an empty view, it's never dereferenced.
+  return m_data ? m_data + _offset : reinterpret_cast<const Byte*>(this);
+}
+
+bool MappedFile::close() {
+  switch (m_backing) {
+  case Backing::k_none:
+    return false;
+  case Backing::k_mapping:
+    if (!unmap_file(m_data, m_size)) {
+      return false;
+    }
+    break;
+  case Backing::k_archive:
+    // The archive stays mapped.
+    break;
+  case Backing::k_memory:
+    m_allocator.deallocate(const_cast<Byte*>(m_data));
+    break;
+  }
+
+  m_data = nullptr;
+  m_size = 0;
+  m_backing = Backing::k_none;
+  return true;
+}
+
+} // namespace rx::filesystem
@@ -0,0 +1,113 @@
+#ifndef RX_CORE_FILESYSTEM_MAPPED_FILE_H
+#define RX_CORE_FILESYSTEM_MAPPED_FILE_H
+#include "rx/core/stream.h"
+#include "rx/core/string.h"
+
+#include "rx/core/utility/exchange.h"
+
+namespace Rx::Filesystem {
+
+// # Mapped File
+//
+// Read-only file stream which maps the whole file into memory rather than
+// reading it through the file handle.
+//
+// Reading is a copy out of the mapping, and |view| hands out the mapping
+// itself, so loaders which only need the contents of a file for as long as the
+// stream is open can use them without any copy or allocation at all. The pages
+// are brought in by the operating system as they're touched and can be dropped
+// again under memory pressure since they're backed by the file.
+//
+// Files in the mounted |Archive| are opened from there rather than the file
+// system. Those stored as they are are a view of the mapping of the archive,
+// compressed ones are decompressed into memory allocated with |allocator|.
+struct RX_API MappedFile
+  final : Stream
+{
+  MappedFile(Memory::Allocator& _allocator, const char* _file_name);
+  MappedFile(Memory::Allocator& _allocator, const String& _file_name);
+  MappedFile(const char* _file_name);
+  MappedFile(const String& _file_name);
+  MappedFile(MappedFile&& other_);
+  ~MappedFile();
+
+  bool close();
+
+  // Query if the mapping is valid, will be false if the file has been closed
+  // with |close| or if the file failed to open or map.
+  bool is_valid() const;
+
+  operator bool() const;
+
+  virtual const String& name() const &;
+
+  constexpr Memory::Allocator& allocator() const;
+
+protected:
+  virtual Uint64 on_read(Byte* _data, Uint64 _size, Uint64 _offset);
+  virtual bool on_stat(Stat& stat_) const;
+  virtual const Byte* on_view(Uint64 _size, Uint64 _offset);
+
+private:
+  enum class Backing : Uint8 {
+    k_none,
+    k_mapping,
+    k_archive,
+    k_memory
+  };
+
+  Memory::Allocator& m_allocator;
+  const Byte* m_data;
+  Uint64 m_size;
+  Backing m_backing;
+  String m_name;
+};
+
+inline MappedFile::MappedFile(Memory::Allocator& _allocator, const String& _file_name)
+  : MappedFile{_allocator, _file_name.data()}
+{
+}
+
+inline MappedFile::MappedFile(const char* _file_name)
+  : MappedFile{Memory::SystemAllocator::instance(), _file_name}
+{
+}
+
+inline MappedFile::MappedFile(const String& _file_name)
+  : MappedFile{Memory::SystemAllocator::instance(), _file_name}
+{
+}
+
+inline MappedFile::MappedFile(MappedFile&& other_)
+  : Stream{Utility::move(other_)}
+  , m_allocator{other_.m_allocator}
+  , m_data{Utility::exchange(other_.m_data, nullptr)}
+  , m_size{Utility::exchange(other_.m_size, 0)}
+  , m_backing{Utility::exchange(other_.m_backing, Backing::k_none)}
+  , m_name{Utility::move(other_.m_name)}
+{
+}
+
+inline MappedFile::~MappedFile() {
+  close();
+}
+
+inline bool MappedFile::is_valid() const {
+  return m_backing != Backing::k_none;
+}
+
+inline MappedFile::operator bool() const {
+  return is_valid();
+}
+
+inline const String& MappedFile::name() const & {
+  return m_name;
+}
+
+RX_HINT_FORCE_INLINE constexpr Memory::Allocator& MappedFile::allocator() const {
+  return m_allocator;
+}
+
+} // namespace rx::filesystem
+
+#endif // RX_CORE_FILESYSTEM_MAPPED_FILE_H
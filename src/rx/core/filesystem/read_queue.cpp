@@ -0,0 +1,184 @@
+#include <string.h> // memcpy
+
+#include "rx/core/filesystem/read_queue.h"
+#include "rx/core/filesystem/file.h"
+
+#include "rx/core/concurrency/scope_lock.h"
+#include "rx/core/concurrency/atomic.h"
+
+#include "rx/core/algorithm/min.h"
+
+#include "rx/core/hints/unlikely.h"
+
+#include "rx/core/string.h"
+#include "rx/core/log.h"
+
+RX_LOG("filesystem/read_queue", logger);
+
+namespace Rx::Filesystem {
+
+// Shared by the |Read| and the thread, whichever lets go of it last frees it.
+// When the |Read| is gone before the thread gets to it, the file isn't read.
+struct ReadQueue::Request {
+  Request(ReadQueue* _queue, const String& _name);
+
+  ReadQueue* queue;
+  String name;
+  Vector<Byte> contents;
+  Concurrency::Atomic<Size> references;
+  bool done      RX_HINT_GUARDED_BY(queue->m_mutex);
+  bool succeeded RX_HINT_GUARDED_BY(queue->m_mutex);
+};
+
+ReadQueue::Request::Request(ReadQueue* _queue, const String& _name)
+  : queue{_queue}
+  , name{_queue->allocator(), _name}
+  , contents{_queue->allocator()}
+  , references{2}
+  , done{false}
+  , succeeded{false}
+{
+}
+
+ReadQueue::Read::~Read() {
+  if (m_request) {
+    m_request->queue->release(m_request);
+  }
+}
+
+bool ReadQueue::Read::wait() {
+  return m_request && m_request->queue->wait(m_request);
+}
+
+const String& ReadQueue::Read::name() const & {
+  return m_request->name;
+}
+
+Uint64 ReadQueue::Read::on_read(Byte* _data, Uint64 _size, Uint64 _offset) {
+  if (RX_HINT_UNLIKELY(!wait())) {
+    return 0;
+  }
+
+  const auto& contents = m_request->contents;
+  if (RX_HINT_UNLIKELY(_offset >= contents.size())) {
+    return 0;
+  }
+
+  const auto bytes = Algorithm::min(_size, Uint64{contents.size() - _offset});
+  memcpy(_data, contents.data() + _offset, static_cast<Size>(bytes));
+  return bytes;
+}
+
+bool ReadQueue::Read::on_stat(Stat& stat_) const {
+  if (!m_request || !m_request->queue->wait(m_request)) {
+    return false;
+  }
+  stat_.size = m_request->contents.size();
+  return true;
+}
+
+const Byte* ReadQueue::Read::on_view(Uint64 _size, Uint64 _offset) {
+  if (RX_HINT_UNLIKELY(!wait())) {
+    return nullptr;
+  }
+
+  const auto& contents = m_request->contents;
+  if (RX_HINT_UNLIKELY(_offset > contents.size() || _size > contents.size() - _offset)) {
+    return nullptr;
+  }
+
+  return contents.data() + _offset;
+}
+
+ReadQueue::ReadQueue(Memory::Allocator& _allocator)
+  : m_allocator{_allocator}
+  , m_queue{allocator()}
+  , m_stop{false}
+  , m_thread{allocator(), "read queue", [this](int) { run(); }}
+{
+}
+
+ReadQueue::~ReadQueue() {
+  {
+    Concurrency::ScopeLock lock{m_mutex};
+    m_stop = true;
+  }
+  m_ready_cond.signal();
+  m_thread.join();
+}
+
+ReadQueue::Read ReadQueue::read(const String& _file_name) {
+  const auto request = allocator().create<Request>(this, _file_name);
+  RX_ASSERT(request, "out of memory");
+  bool queued;
+  {
+    Concurrency::ScopeLock lock{m_mutex};
+    queued = m_queue.push_back(request);
+    // The thread never sees the request, complete it as failed in it's place.
+    if (RX_HINT_UNLIKELY(!queued)) {
+      request->done = true;
+    }
+  }
+
+  if (RX_HINT_UNLIKELY(!queued)) {
+    logger->error("failed to queue read of \"%s\"", _file_name);
+    // Drop the reference of the thread, the |Read| frees the request.
+    release(request);
+    return Read{request};
+  }
+
+  m_ready_cond.signal();
+  return Read{request};
+}
+
+void ReadQueue::run() {
+  for (;;) {
+    Vector<Request*> batch{allocator()};
+    {
+      Concurrency::ScopeLock lock{m_mutex};
+      m_ready_cond.wait(lock, [this] { return m_stop || !m_queue.is_empty(); });
+      if (m_queue.is_empty()) {
+        return;
+      }
+      batch = Utility::move(m_queue);
+    }
+
+    logger->verbose("reading %zu files", batch.size());
+
+    batch.each_fwd([this](Request* _request) {
+      // Don't bother reading when the |Read| is already gone.
+      bool succeeded{false};
+      if (_request->references.load(Concurrency::MemoryOrder::k_acquire) > 1) {
+        if (auto contents = read_binary_file(allocator(), _request->name)) {
+          _request->contents = Utility::move(*contents);
+          succeeded = true;
+        }
+      }
+
+      {
+        Concurrency::ScopeLock lock{m_mutex};
+        _request->done = true;
+        _request->succeeded = succeeded;
+      }
+      m_done_cond.broadcast();
+
+      release(_request);
+    });
+  }
+}
+
+bool ReadQueue::wait(Request* _request) {
+  Concurrency::ScopeLock lock{m_mutex};
+  m_done_cond.wait(lock, [_request] { return _request->done; });
+  return _request->succeeded;
+}
+
+void ReadQueue::release(Request* _request) {
+  if (_request->references.fetch_sub(1, Concurrency::MemoryOrder::k_acq_rel) == 1) {
+    allocator().destroy<Request>(_request);
+  }
+}
+
+Global<ReadQueue> ReadQueue::s_instance{"system", "read_queue"};
+
+} // namespace rx::filesystem
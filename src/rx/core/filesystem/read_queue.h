@@ -0,0 +1,110 @@
+#ifndef RX_CORE_FILESYSTEM_READ_QUEUE_H
+#define RX_CORE_FILESYSTEM_READ_QUEUE_H
+#include "rx/core/stream.h"
+#include "rx/core/global.h"
+
+#include "rx/core/concurrency/thread.h"
+#include "rx/core/concurrency/mutex.h"
+#include "rx/core/concurrency/condition_variable.h"
+
+namespace Rx::Filesystem {
+
+// # Read Queue
+//
+// Reads whole files on a thread of its own.
+//
+// Loaders which know the files they need before they decode any of them queue
+// a |read| of all of them up front, then decode each one as it arrives. The
+// rest are read while the first is decoded, instead of the loader stopping on
+// every file in turn.
+//
+// Every |Read| is a stream of the contents of the file, which waits for the
+// read to finish when it's first used. Everything queued while the thread is
+// busy is picked up in one batch once it's done.
+struct RX_API ReadQueue {
+  RX_MARK_NO_COPY(ReadQueue);
+  RX_MARK_NO_MOVE(ReadQueue);
+
+  struct Request;
+
+  struct RX_API Read
+    final : Stream
+  {
+    Read(Read&& read_);
+    ~Read();
+
+    // Wait for the read to finish. Returns false when it couldn't be read.
+    bool wait();
+
+    virtual const String& name() const &;
+
+  protected:
+    virtual Uint64 on_read(Byte* _data, Uint64 _size, Uint64 _offset);
+    virtual bool on_stat(Stat& stat_) const;
+    virtual const Byte* on_view(Uint64 _size, Uint64 _offset);
+
+  private:
+    friend struct ReadQueue;
+
+    Read(Request* _request);
+
+    Request* m_request;
+  };
+
+  ReadQueue(Memory::Allocator& _allocator);
+  ReadQueue();
+  ~ReadQueue();
+
+  // Queue a read of all of |_file_name|. The |Read| must not outlive the queue.
+  Read read(const String& _file_name);
+
+  constexpr Memory::Allocator& allocator() const;
+
+  static constexpr ReadQueue& instance();
+
+private:
+  void run();
+  bool wait(Request* _request);
+  void release(Request* _request);
+
+  Memory::Allocator& m_allocator;
+
+  Concurrency::Mutex m_mutex;
+  Concurrency::ConditionVariable m_ready_cond;
+  Concurrency::ConditionVariable m_done_cond;
+  Vector<Request*> m_queue RX_HINT_GUARDED_BY(m_mutex);
+  bool m_stop              RX_HINT_GUARDED_BY(m_mutex);
+
+  Concurrency::Thread m_thread;
+
+  static Global<ReadQueue> s_instance;
+};
+
+inline ReadQueue::ReadQueue()
+  : ReadQueue{Memory::SystemAllocator::instance()}
+{
+}
+
+inline ReadQueue::Read::Read(Request* _request)
+  : Stream{READ | STAT}
+  , m_request{_request}
+{
+}
+
+inline ReadQueue::Read::Read(Read&& read_)
+  : Stream{Utility::move(read_)}
+  , m_request{Utility::exchange(read_.m_request, nullptr)}
+{
+}
+
+RX_HINT_FORCE_INLINE constexpr Memory::Allocator& ReadQueue::allocator() const {
+  return m_allocator;
+}
+
+RX_HINT_FORCE_INLINE constexpr ReadQueue& ReadQueue::instance() {
+  return *s_instance;
+}
+
+} // namespace rx::filesystem
+
+#endif // RX_CORE_FILESYSTEM_READ_QUEUE_H
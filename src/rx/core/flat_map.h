@@ -0,0 +1,755 @@
+#ifndef RX_CORE_FLAT_MAP_H
+#define RX_CORE_FLAT_MAP_H
+#include "rx/core/array.h"
+#include "rx/core/hash.h"
+
+#include "rx/core/traits/is_trivially_destructible.h"
+#include "rx/core/traits/return_type.h"
+#include "rx/core/traits/remove_cvref.h"
+#include "rx/core/traits/is_same.h"
+
+#include "rx/core/utility/bit.h"
+#include "rx/core/utility/exchange.h"
+#include "rx/core/utility/pair.h"
+
+#include "rx/core/hints/likely.h"
+#include "rx/core/hints/unlikely.h"
+
+#include "rx/core/memory/system_allocator.h"
+#include "rx/core/memory/aggregate.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RX_FLAT_MAP_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define RX_FLAT_MAP_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Rx {
+
+namespace detail {
+  // Every slot of a |FlatMap| has a control byte, which is either one of the
+  // values below or, when the slot is in use, the low seven bits of the hash
+  // of its key. The slots are probed a group of |k_width| at a time by
+  // comparing all of their control bytes at once.
+  struct FlatMapGroup {
+    static inline constexpr const Size k_width{16};
+
+    static inline constexpr const Sint8 k_empty{-128};
+    static inline constexpr const Sint8 k_deleted{-2};
+
+#if defined(RX_FLAT_MAP_NEON)
+    // NEON has no movemask, the comparison is narrowed to a nibble a slot and
+    // only the top bit of every nibble is kept.
+    static inline constexpr const Size k_shift{2};
+#else
+    static inline constexpr const Size k_shift{0};
+#endif
+
+    // The slots of a group matching a comparison, one bit a slot.
+    struct Mask {
+      explicit operator bool() const;
+      Size lowest() const;
+      void next();
+      Uint64 bits;
+    };
+
+    FlatMapGroup(const Sint8* _control);
+
+    Mask match(Sint8 _h2) const;
+    Mask match_empty() const;
+    Mask match_empty_or_deleted() const;
+
+  private:
+#if defined(RX_FLAT_MAP_SSE2)
+    __m128i m_control;
+#elif defined(RX_FLAT_MAP_NEON)
+    static Uint64 mask_of(uint8x16_t _match);
+    uint8x16_t m_control;
+#else
+    const Sint8* m_control;
+#endif
+  };
+
+  inline FlatMapGroup::Mask::operator bool() const {
+    return bits != 0;
+  }
+
+  inline Size FlatMapGroup::Mask::lowest() const {
+    return bit_search_lsb(bits) >> k_shift;
+  }
+
+  inline void FlatMapGroup::Mask::next() {
+    bits &= bits - 1;
+  }
+
+#if defined(RX_FLAT_MAP_SSE2)
+  inline FlatMapGroup::FlatMapGroup(const Sint8* _control)
+    : m_control{_mm_loadu_si128(reinterpret_cast<const __m128i*>(_control))}
+  {
+  }
+
+  inline FlatMapGroup::Mask FlatMapGroup::match(Sint8 _h2) const {
+    const auto match{_mm_cmpeq_epi8(m_control, _mm_set1_epi8(_h2))};
+    return {static_cast<Uint64>(_mm_movemask_epi8(match))};
+  }
+
+  inline FlatMapGroup::Mask FlatMapGroup::match_empty() const {
+    const auto match{_mm_cmpeq_epi8(m_control, _mm_set1_epi8(k_empty))};
+    return {static_cast<Uint64>(_mm_movemask_epi8(match))};
+  }
+
+  inline FlatMapGroup::Mask FlatMapGroup::match_empty_or_deleted() const {
+    // Only the empty and deleted control bytes have the sign bit set.
+    return {static_cast<Uint64>(_mm_movemask_epi8(m_control))};
+  }
+#elif defined(RX_FLAT_MAP_NEON)
+  inline FlatMapGroup::FlatMapGroup(const Sint8* _control)
+    : m_control{vld1q_u8(reinterpret_cast<const uint8_t*>(_control))}
+  {
+  }
+
+  inline Uint64 FlatMapGroup::mask_of(uint8x16_t _match) {
+    const auto nibbles{vshrn_n_u16(vreinterpretq_u16_u8(_match), 4)};
+    return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & 0x8888888888888888_u64;
+  }
+
+  inline FlatMapGroup::Mask FlatMapGroup::match(Sint8 _h2) const {
+    return {mask_of(vceqq_u8(m_control, vdupq_n_u8(static_cast<Uint8>(_h2))))};
+  }
+
+  inline FlatMapGroup::Mask FlatMapGroup::match_empty() const {
+    return {mask_of(vceqq_u8(m_control, vdupq_n_u8(static_cast<Uint8>(k_empty))))};
+  }
+
+  inline FlatMapGroup::Mask FlatMapGroup::match_empty_or_deleted() const {
+    const auto control{vreinterpretq_s8_u8(m_control)};
+    return {mask_of(vcltq_s8(control, vdupq_n_s8(-1)))};
+  }
+#else
+  inline FlatMapGroup::FlatMapGroup(const Sint8* _control)
+    : m_control{_control}
+  {
+  }
+
+  inline FlatMapGroup::Mask FlatMapGroup::match(Sint8 _h2) const {
+    Uint64 bits{0};
+    for (Size i{0}; i < k_width; i++) {
+      bits |= Uint64{m_control[i] == _h2} << i;
+    }
+    return {bits};
+  }
+
+  inline FlatMapGroup::Mask FlatMapGroup::match_empty() const {
+    return match(k_empty);
+  }
+
+  inline FlatMapGroup::Mask FlatMapGroup::match_empty_or_deleted() const {
+    Uint64 bits{0};
+    for (Size i{0}; i < k_width; i++) {
+      bits |= Uint64{m_control[i] < -1} << i;
+    }
+    return {bits};
+  }
+#endif
+} // namespace detail
+
+// # Flat Map
+//
+// An unordered map with the same interface as |Map|, laid out and probed the
+// way "Swiss tables" are.
+//
+// Next to the keys and values is an array of one control byte a slot. Seven
+// bits of the hash of a key are kept in its control byte, the rest pick the
+// group of sixteen slots to start probing at. A lookup compares the control
+// bytes of a whole group against the seven bits with SSE2 or NEON and only
+// compares the keys of the slots that match, which is rarely more than one.
+// A lookup for a key that is not in the map usually ends at the first group.
+//
+// Unlike |Map| nothing is allocated until the first insert, and inserting a
+// key that is already in the map replaces the value.
+//
+// Pointers to values are stable until the map grows.
+//
+// 32-bit: 28 bytes
+// 64-bit: 56 bytes
+template<typename K, typename V>
+struct FlatMap {
+  template<typename Kt, typename Vt, Size E>
+  using Initializers = Array<Pair<Kt, Vt>[E]>;
+
+  static inline constexpr const Size k_initial_size{16};
+
+  FlatMap();
+  FlatMap(Memory::Allocator& _allocator);
+  FlatMap(Memory::Allocator& _allocator, const FlatMap& _map);
+  FlatMap(FlatMap&& map_);
+  FlatMap(const FlatMap& _map);
+
+  template<typename Kt, typename Vt, Size E>
+  FlatMap(Memory::Allocator& _allocator, Initializers<Kt, Vt, E>&& initializers_);
+
+  template<typename Kt, typename Vt, Size E>
+  FlatMap(Initializers<Kt, Vt, E>&& initializers_);
+
+  ~FlatMap();
+
+  FlatMap& operator=(FlatMap&& map_);
+  FlatMap& operator=(const FlatMap& _map);
+
+  V* insert(const K& _key, V&& value_);
+  V* insert(const K& _key, const V& _value);
+
+  V* find(LookupKey<K> _key);
+  const V* find(LookupKey<K> _key) const;
+
+  bool erase(LookupKey<K> _key);
+  Size size() const;
+  bool is_empty() const;
+
+  // Destroys every element but keeps the memory.
+  void clear();
+
+  template<typename F>
+  bool each_key(F&& _function);
+  template<typename F>
+  bool each_key(F&& _function) const;
+
+  template<typename F>
+  bool each_value(F&& _function);
+  template<typename F>
+  bool each_value(F&& _function) const;
+
+  template<typename F>
+  bool each_pair(F&& _function);
+  template<typename F>
+  bool each_pair(F&& _function) const;
+
+  constexpr Memory::Allocator& allocator() const;
+
+private:
+  using Group = detail::FlatMapGroup;
+
+  static Size hash_key(LookupKey<K> _key);
+  static Sint8 h2(Size _hash);
+  static Size max_size_for(Size _capacity);
+  static bool is_full(Sint8 _control);
+
+  void clear_and_deallocate();
+
+  [[nodiscard]] bool allocate(Size _capacity);
+  [[nodiscard]] bool rehash(Size _capacity);
+  [[nodiscard]] bool grow();
+
+  Size lookup_index(LookupKey<K> _key) const;
+  Size insert_index(Size _hash) const;
+
+  template<typename Vt>
+  V* inserter(const K& _key, Vt&& value_);
+
+  Memory::Allocator* m_allocator;
+
+  union {
+    Byte* m_data;
+    Sint8* m_control;
+  };
+  K* m_keys;
+  V* m_values;
+
+  Size m_size;
+  Size m_capacity;
+
+  // Number of empty slots which can still be used before the map grows.
+  Size m_growth_left;
+};
+
+template<typename K, typename V>
+inline FlatMap<K, V>::FlatMap()
+  : FlatMap{Memory::SystemAllocator::instance()}
+{
+}
+
+template<typename K, typename V>
+inline FlatMap<K, V>::FlatMap(Memory::Allocator& _allocator)
+  : m_allocator{&_allocator}
+  , m_data{nullptr}
+  , m_keys{nullptr}
+  , m_values{nullptr}
+  , m_size{0}
+  , m_capacity{0}
+  , m_growth_left{0}
+{
+}
+
+template<typename K, typename V>
+inline FlatMap<K, V>::FlatMap(FlatMap&& map_)
+  : m_allocator{&map_.allocator()}
+  , m_data{Utility::exchange(map_.m_data, nullptr)}
+  , m_keys{Utility::exchange(map_.m_keys, nullptr)}
+  , m_values{Utility::exchange(map_.m_values, nullptr)}
+  , m_size{Utility::exchange(map_.m_size, 0)}
+  , m_capacity{Utility::exchange(map_.m_capacity, 0)}
+  , m_growth_left{Utility::exchange(map_.m_growth_left, 0)}
+{
+}
+
+template<typename K, typename V>
+inline FlatMap<K, V>::FlatMap(Memory::Allocator& _allocator, const FlatMap& _map)
+  : FlatMap{_allocator}
+{
+  if (_map.m_capacity == 0) {
+    return;
+  }
+
+  // Same capacity so every element can go in the same slot.
+  RX_ASSERT(allocate(_map.m_capacity), "out of memory");
+  for (Size i{0}; i < m_capacity; i++) {
+    m_control[i] = _map.m_control[i];
+    if (is_full(m_control[i])) {
+      Utility::construct<K>(m_keys + i, _map.m_keys[i]);
+      Utility::construct<V>(m_values + i, _map.m_values[i]);
+    }
+  }
+
+  m_size = _map.m_size;
+  m_growth_left = _map.m_growth_left;
+}
+
+template<typename K, typename V>
+inline FlatMap<K, V>::FlatMap(const FlatMap& _map)
+  : FlatMap{_map.allocator(), _map}
+{
+}
+
+template<typename K, typename V>
+template<typename Kt, typename Vt, Size E>
+inline FlatMap<K, V>::FlatMap(Memory::Allocator& _allocator, Initializers<Kt, Vt, E>&& initializers_)
+  : FlatMap{_allocator}
+{
+  for (Size i = 0; i < E; i++) {
+    auto& item = initializers_[i];
+    insert(Utility::move(item.first), Utility::move(item.second));
+  }
+}
+
+template<typename K, typename V>
+template<typename Kt, typename Vt, Size E>
+inline FlatMap<K, V>::FlatMap(Initializers<Kt, Vt, E>&& initializers_)
+  : FlatMap{Memory::SystemAllocator::instance(), Utility::move(initializers_)}
+{
+}
+
+template<typename K, typename V>
+inline FlatMap<K, V>::~FlatMap() {
+  clear_and_deallocate();
+}
+
+template<typename K, typename V>
+inline FlatMap<K, V>& FlatMap<K, V>::operator=(FlatMap&& map_) {
+  RX_ASSERT(&map_ != this, "self assignment");
+
+  clear_and_deallocate();
+
+  m_allocator = &map_.allocator();
+  m_data = Utility::exchange(map_.m_data, nullptr);
+  m_keys = Utility::exchange(map_.m_keys, nullptr);
+  m_values = Utility::exchange(map_.m_values, nullptr);
+  m_size = Utility::exchange(map_.m_size, 0);
+  m_capacity = Utility::exchange(map_.m_capacity, 0);
+  m_growth_left = Utility::exchange(map_.m_growth_left, 0);
+
+  return *this;
+}
+
+template<typename K, typename V>
+inline FlatMap<K, V>& FlatMap<K, V>::operator=(const FlatMap& _map) {
+  RX_ASSERT(&_map != this, "self assignment");
+
+  clear();
+  _map.each_pair([this](const K& _key, const V& _value) {
+    insert(_key, _value);
+  });
+
+  return *this;
+}
+
+template<typename K, typename V>
+inline V* FlatMap<K, V>::insert(const K& _key, V&& value_) {
+  return inserter(_key, Utility::move(value_));
+}
+
+template<typename K, typename V>
+inline V* FlatMap<K, V>::insert(const K& _key, const V& _value) {
+  return inserter(_key, _value);
+}
+
+template<typename K, typename V>
+inline V* FlatMap<K, V>::find(LookupKey<K> _key) {
+  if (const Size index{lookup_index(_key)}; index != -1_z) {
+    return m_values + index;
+  }
+  return nullptr;
+}
+
+template<typename K, typename V>
+inline const V* FlatMap<K, V>::find(LookupKey<K> _key) const {
+  if (const Size index{lookup_index(_key)}; index != -1_z) {
+    return m_values + index;
+  }
+  return nullptr;
+}
+
+template<typename K, typename V>
+inline bool FlatMap<K, V>::erase(LookupKey<K> _key) {
+  const Size index{lookup_index(_key)};
+  if (index == -1_z) {
+    return false;
+  }
+
+  if constexpr (!traits::is_trivially_destructible<K>) {
+    Utility::destruct<K>(m_keys + index);
+  }
+  if constexpr (!traits::is_trivially_destructible<V>) {
+    Utility::destruct<V>(m_values + index);
+  }
+
+  // A group with an empty slot has never been full, so no probe has gone past
+  // it and the slot can be made empty rather than deleted.
+  const Size group{index & ~(Group::k_width - 1)};
+  if (Group{m_control + group}.match_empty()) {
+    m_control[index] = Group::k_empty;
+    m_growth_left++;
+  } else {
+    m_control[index] = Group::k_deleted;
+  }
+
+  m_size--;
+  return true;
+}
+
+template<typename K, typename V>
+inline Size FlatMap<K, V>::size() const {
+  return m_size;
+}
+
+template<typename K, typename V>
+inline bool FlatMap<K, V>::is_empty() const {
+  return m_size == 0;
+}
+
+template<typename K, typename V>
+inline void FlatMap<K, V>::clear() {
+  for (Size i{0}; i < m_capacity; i++) {
+    if (is_full(m_control[i])) {
+      if constexpr (!traits::is_trivially_destructible<K>) {
+        Utility::destruct<K>(m_keys + i);
+      }
+      if constexpr (!traits::is_trivially_destructible<V>) {
+        Utility::destruct<V>(m_values + i);
+      }
+    }
+    m_control[i] = Group::k_empty;
+  }
+
+  m_size = 0;
+  m_growth_left = max_size_for(m_capacity);
+}
+
+template<typename K, typename V>
+inline void FlatMap<K, V>::clear_and_deallocate() {
+  clear();
+
+  allocator().deallocate(m_data);
+
+  m_data = nullptr;
+  m_keys = nullptr;
+  m_values = nullptr;
+  m_capacity = 0;
+  m_growth_left = 0;
+}
+
+template<typename K, typename V>
+inline Size FlatMap<K, V>::hash_key(LookupKey<K> _key) {
+  // The low bits pick the control byte and the high ones the group, mix the
+  // hash so both are good even when |Hash<K>| isn't.
+  const Uint64 hash{Uint64{Hash<traits::remove_cvref<LookupKey<K>>>{}(_key)} * 0x9e3779b97f4a7c15_u64};
+  return static_cast<Size>(hash ^ (hash >> 32));
+}
+
+template<typename K, typename V>
+inline Sint8 FlatMap<K, V>::h2(Size _hash) {
+  return static_cast<Sint8>(_hash & 0x7f);
+}
+
+template<typename K, typename V>
+inline Size FlatMap<K, V>::max_size_for(Size _capacity) {
+  // Keep the load factor at or below 7/8.
+  return _capacity - _capacity / 8;
+}
+
+template<typename K, typename V>
+inline bool FlatMap<K, V>::is_full(Sint8 _control) {
+  return _control >= 0;
+}
+
+template<typename K, typename V>
+inline bool FlatMap<K, V>::allocate(Size _capacity) {
+  Memory::Aggregate aggregate;
+  aggregate.add<Sint8>(_capacity);
+  aggregate.add<K>(_capacity);
+  aggregate.add<V>(_capacity);
+  aggregate.finalize();
+
+  if (!(m_data = allocator().allocate(aggregate.bytes()))) {
+    return false;
+  }
+
+  m_keys = reinterpret_cast<K*>(m_data + aggregate[1]);
+  m_values = reinterpret_cast<V*>(m_data + aggregate[2]);
+
+  for (Size i{0}; i < _capacity; i++) {
+    m_control[i] = Group::k_empty;
+  }
+
+  m_capacity = _capacity;
+  m_growth_left = max_size_for(_capacity);
+
+  return true;
+}
+
+template<typename K, typename V>
+inline bool FlatMap<K, V>::rehash(Size _capacity) {
+  auto data{m_data};
+  auto control{m_control};
+  auto keys{m_keys};
+  auto values{m_values};
+  const auto capacity{m_capacity};
+
+  if (!allocate(_capacity)) {
+    m_data = data;
+    m_keys = keys;
+    m_values = values;
+    return false;
+  }
+
+  for (Size i{0}; i < capacity; i++) {
+    if (!is_full(control[i])) {
+      continue;
+    }
+
+    const Size hash{hash_key(keys[i])};
+    const Size index{insert_index(hash)};
+    m_control[index] = h2(hash);
+    Utility::construct<K>(m_keys + index, Utility::move(keys[i]));
+    Utility::construct<V>(m_values + index, Utility::move(values[i]));
+    if constexpr (!traits::is_trivially_destructible<K>) {
+      Utility::destruct<K>(keys + i);
+    }
+    if constexpr (!traits::is_trivially_destructible<V>) {
+      Utility::destruct<V>(values + i);
+    }
+  }
+
+  m_growth_left -= m_size;
+
+  allocator().deallocate(data);
+
+  return true;
+}
+
+template<typename K, typename V>
+inline bool FlatMap<K, V>::grow() {
+  if (m_capacity == 0) {
+    return rehash(k_initial_size);
+  }
+
+  // When most of what's used up is deleted slots, rehashing at the same size
+  // is enough to get them back.
+  if (m_size <= max_size_for(m_capacity) / 2) {
+    return rehash(m_capacity);
+  }
+
+  return rehash(m_capacity * 2);
+}
+
+template<typename K, typename V>
+inline Size FlatMap<K, V>::lookup_index(LookupKey<K> _key) const {
+  if (RX_HINT_UNLIKELY(m_size == 0)) {
+    return -1_z;
+  }
+
+  const Size hash{hash_key(_key)};
+  const Sint8 control{h2(hash)};
+  const Size mask{m_capacity - 1};
+
+  // Triangular probing over the groups visits all of them since the number
+  // of groups is a power of two.
+  Size group{(hash >> 7) * Group::k_width & mask};
+  for (Size step{Group::k_width}; ; step += Group::k_width) {
+    const Group slots{m_control + group};
+    for (auto match{slots.match(control)}; match; match.next()) {
+      const Size index{group + match.lowest()};
+      if (RX_HINT_LIKELY(m_keys[index] == _key)) {
+        return index;
+      }
+    }
+    if (slots.match_empty()) {
+      return -1_z;
+    }
+    group = (group + step) & mask;
+  }
+}
+
+template<typename K, typename V>
+inline Size FlatMap<K, V>::insert_index(Size _hash) const {
+  const Size mask{m_capacity - 1};
+  Size group{(_hash >> 7) * Group::k_width & mask};
+  for (Size step{Group::k_width}; ; step += Group::k_width) {
+    if (const auto match{Group{m_control + group}.match_empty_or_deleted()}) {
+      return group + match.lowest();
+    }
+    group = (group + step) & mask;
+  }
+}
+
+template<typename K, typename V>
+template<typename Vt>
+inline V* FlatMap<K, V>::inserter(const K& _key, Vt&& value_) {
+  if (const Size index{lookup_index(_key)}; index != -1_z) {
+    Utility::destruct<V>(m_values + index);
+    return Utility::construct<V>(m_values + index, Utility::forward<Vt>(value_));
+  }
+
+  const Size hash{hash_key(_key)};
+  Size index{m_capacity ? insert_index(hash) : 0};
+
+  // Reusing a deleted slot doesn't take away from the empty ones.
+  if (m_capacity == 0 || (m_growth_left == 0 && m_control[index] != Group::k_deleted)) {
+    if (!grow()) {
+      return nullptr;
+    }
+    index = insert_index(hash);
+  }
+
+  if (m_control[index] == Group::k_empty) {
+    m_growth_left--;
+  }
+
+  m_control[index] = h2(hash);
+  Utility::construct<K>(m_keys + index, _key);
+  m_size++;
+
+  return Utility::construct<V>(m_values + index, Utility::forward<Vt>(value_));
+}
+
+template<typename K, typename V>
+template<typename F>
+inline bool FlatMap<K, V>::each_key(F&& _function) {
+  for (Size i{0}; i < m_capacity; i++) {
+    if (is_full(m_control[i])) {
+      if constexpr (traits::is_same<traits::return_type<F>, bool>) {
+        if (!_function(m_keys[i])) {
+          return false;
+        }
+      } else {
+        _function(m_keys[i]);
+      }
+    }
+  }
+  return true;
+}
+
+template<typename K, typename V>
+template<typename F>
+inline bool FlatMap<K, V>::each_key(F&& _function) const {
+  for (Size i{0}; i < m_capacity; i++) {
+    if (is_full(m_control[i])) {
+      if constexpr (traits::is_same<traits::return_type<F>, bool>) {
+        if (!_function(m_keys[i])) {
+          return false;
+        }
+      } else {
+        _function(m_keys[i]);
+      }
+    }
+  }
+  return true;
+}
+
+template<typename K, typename V>
+template<typename F>
+inline bool FlatMap<K, V>::each_value(F&& _function) {
+  for (Size i{0}; i < m_capacity; i++) {
+    if (is_full(m_control[i])) {
+      if constexpr (traits::is_same<traits::return_type<F>, bool>) {
+        if (!_function(m_values[i])) {
+          return false;
+        }
+      } else {
+        _function(m_values[i]);
+      }
+    }
+  }
+  return true;
+}
+
+template<typename K, typename V>
+template<typename F>
+inline bool FlatMap<K, V>::each_value(F&& _function) const {
+  for (Size i{0}; i < m_capacity; i++) {
+    if (is_full(m_control[i])) {
+      if constexpr (traits::is_same<traits::return_type<F>, bool>) {
+        if (!_function(m_values[i])) {
+          return false;
+        }
+      } else {
+        _function(m_values[i]);
+      }
+    }
+  }
+  return true;
+}
+
+template<typename K, typename V>
+template<typename F>
+inline bool FlatMap<K, V>::each_pair(F&& _function) {
+  for (Size i{0}; i < m_capacity; i++) {
+    if (is_full(m_control[i])) {
+      if constexpr (traits::is_same<traits::return_type<F>, bool>) {
+        if (!_function(m_keys[i], m_values[i])) {
+          return false;
+        }
+      } else {
+        _function(m_keys[i], m_values[i]);
+      }
+    }
+  }
+  return true;
+}
+
+template<typename K, typename V>
+template<typename F>
+inline bool FlatMap<K, V>::each_pair(F&& _function) const {
+  for (Size i{0}; i < m_capacity; i++) {
+    if (is_full(m_control[i])) {
+      if constexpr (traits::is_same<traits::return_type<F>, bool>) {
+        if (!_function(m_keys[i], m_values[i])) {
+          return false;
+        }
+      } else {
+        _function(m_keys[i], m_values[i]);
+      }
+    }
+  }
+  return true;
+}
+
+template<typename K, typename V>
+RX_HINT_FORCE_INLINE constexpr Memory::Allocator& FlatMap<K, V>::allocator() const {
+  return *m_allocator;
+}
+
+} // namespace rx
+
+#endif // RX_CORE_FLAT_MAP_H
@@ -2,20 +2,33 @@
 #define RX_CORE_FUNCTION_H
 #include "rx/core/traits/is_callable.h"
 #include "rx/core/traits/enable_if.h"
+#include "rx/core/traits/remove_cvref.h"
+#include "rx/core/traits/is_trivially_copyable.h"
+#include "rx/core/traits/is_trivially_destructible.h"
 
 #include "rx/core/utility/exchange.h"
+#include "rx/core/utility/nat.h"
 
 #include "rx/core/memory/system_allocator.h"
 
 namespace Rx {
 
-// 32-bit: 12 bytes
-// 64-bit: 24 bytes
+// 32-bit: 64 bytes
+// 64-bit: 64 bytes
+//
+// Callables which fit in |k_inline_size| bytes and don't need more alignment
+// than |k_inline_alignment| are stored inline, only others are allocated with
+// the allocator. Callables which are trivially copyable and stored inline,
+// like most lambdas capturing a few pointers or references, are copied, moved
+// and destroyed without calling anything.
 template<typename T>
 struct Function;
 
 template<typename R, typename... Ts>
 struct Function<R(Ts...)> {
+  static inline constexpr const Size k_inline_alignment{8};
+  static inline constexpr const Size k_inline_size{(64 - sizeof(void*) * 3) & ~(k_inline_alignment - 1)};
+
   constexpr Function(Memory::Allocator& _allocator);
   constexpr Function();
 
@@ -44,63 +57,102 @@ struct Function<R(Ts...)> {
 
 private:
   enum class Lifetime {
-    k_construct,
+    k_copy,
+    k_relocate,
     k_destruct
   };
 
+  struct alignas(k_inline_alignment) Storage {
+    Byte data[k_inline_size];
+  };
+
   using InvokeFn = R (*)(const Byte*, Ts&&...);
-  using ModifyLifetimeFn = void (*)(Lifetime, Byte*, const Byte*);
+  using ModifyLifetimeFn = void (*)(Lifetime, Memory::Allocator&, Byte*, Byte*);
+
+  template<typename F>
+  static inline constexpr const bool k_is_inline{sizeof(F) <= k_inline_size
+    && alignof(F) <= k_inline_alignment};
+
+  template<typename F>
+  static inline constexpr const bool k_is_trivial{k_is_inline<F>
+    && traits::is_trivially_copyable<F> && traits::is_trivially_destructible<F>};
+
+  // Callables not stored inline are stored by pointer.
+  template<typename F>
+  static F* callable(Byte* _storage) {
+    if constexpr (k_is_inline<F>) {
+      return reinterpret_cast<F*>(_storage);
+    } else {
+      return *reinterpret_cast<F**>(_storage);
+    }
+  }
 
   template<typename F>
-  static R invoke(const Byte* _function, Ts&&... _arguments) {
+  static R invoke(const Byte* _storage, Ts&&... _arguments) {
+    const F* function{callable<F>(const_cast<Byte*>(_storage))};
     if constexpr(traits::is_same<R, void>) {
-      (*reinterpret_cast<const F*>(_function))(Utility::forward<Ts>(_arguments)...);
+      (*function)(Utility::forward<Ts>(_arguments)...);
     } else {
-      return (*reinterpret_cast<const F*>(_function))(Utility::forward<Ts>(_arguments)...);
+      return (*function)(Utility::forward<Ts>(_arguments)...);
     }
   }
 
+  // Relocating moves the callable from |_src| to |_dst| and leaves nothing
+  // behind in |_src|, which is just the pointer when it's not inline.
   template<typename F>
-  static void modify_lifetime(Lifetime _lifetime, Byte* _dst, const Byte* _src) {
+  static void modify_lifetime(Lifetime _lifetime, Memory::Allocator& _allocator,
+    Byte* _dst, Byte* _src)
+  {
     switch (_lifetime) {
-    case Lifetime::k_construct:
-      Utility::construct<F>(_dst, *reinterpret_cast<const F*>(_src));
+    case Lifetime::k_copy:
+      if constexpr (k_is_inline<F>) {
+        Utility::construct<F>(_dst, *callable<F>(_src));
+      } else {
+        auto data{_allocator.allocate(sizeof(F))};
+        RX_ASSERT(data, "out of memory");
+        *reinterpret_cast<F**>(_dst) = Utility::construct<F>(data, *callable<F>(_src));
+      }
+      break;
+    case Lifetime::k_relocate:
+      if constexpr (k_is_inline<F>) {
+        Utility::construct<F>(_dst, Utility::move(*callable<F>(_src)));
+        Utility::destruct<F>(_src);
+      } else {
+        *reinterpret_cast<F**>(_dst) = callable<F>(_src);
+      }
       break;
     case Lifetime::k_destruct:
-      Utility::destruct<F>(_dst);
+      if constexpr (k_is_inline<F>) {
+        Utility::destruct<F>(_dst);
+      } else {
+        auto function{callable<F>(_dst)};
+        Utility::destruct<F>(function);
+        _allocator.deallocate(function);
+      }
       break;
     }
   }
 
-  // Keep control block aligned so the function proceeding it is always aligned.
-  struct alignas(Memory::Allocator::ALIGNMENT) ControlBlock {
-    constexpr ControlBlock(ModifyLifetimeFn _modify_lifetime, InvokeFn _invoke)
-      : modify_lifetime{_modify_lifetime}
-      , invoke{_invoke}
-    {
-    }
-    ModifyLifetimeFn modify_lifetime;
-    InvokeFn invoke;
-  };
-
+  void copy(const Function& _function);
+  void relocate(Function& function_);
   void destroy();
 
-  ControlBlock* control();
-  const ControlBlock* control() const;
-
-  Byte* storage();
-  const Byte* storage() const;
-
+  union {
+    Storage m_storage;
+    Utility::Nat m_nat;
+  };
   Memory::Allocator* m_allocator;
-  Byte* m_data;
-  Size m_size;
+  InvokeFn m_invoke;
+  // This is nullptr for trivial callables.
+  ModifyLifetimeFn m_modify_lifetime;
 };
 
 template<typename R, typename... Ts>
 inline constexpr Function<R(Ts...)>::Function(Memory::Allocator& _allocator)
-  : m_allocator{&_allocator}
-  , m_data{nullptr}
-  , m_size{0}
+  : m_nat{}
+  , m_allocator{&_allocator}
+  , m_invoke{nullptr}
+  , m_modify_lifetime{nullptr}
 {
 }
 
@@ -122,27 +174,28 @@ template<typename F, typename>
 inline Function<R(Ts...)>::Function(Memory::Allocator& _allocator, F&& _function)
   : Function{_allocator}
 {
-  m_size = sizeof(ControlBlock) + sizeof _function;
-  m_data = allocator().allocate(m_size);
-  RX_ASSERT(m_data, "out of memory");
+  using T = traits::remove_cvref<F>;
+
+  if constexpr (k_is_inline<T>) {
+    Utility::construct<T>(m_storage.data, Utility::forward<F>(_function));
+  } else {
+    auto data{allocator().allocate(sizeof(T))};
+    RX_ASSERT(data, "out of memory");
+    *reinterpret_cast<T**>(m_storage.data) =
+      Utility::construct<T>(data, Utility::forward<F>(_function));
+  }
 
-  Utility::construct<ControlBlock>(m_data, &modify_lifetime<F>, &invoke<F>);
-  Utility::construct<F>(storage(), Utility::forward<F>(_function));
+  m_invoke = &invoke<T>;
+  if constexpr (!k_is_trivial<T>) {
+    m_modify_lifetime = &modify_lifetime<T>;
+  }
 }
 
 template<typename R, typename... Ts>
 inline Function<R(Ts...)>::Function(Memory::Allocator& _allocator, const Function& _function)
   : Function{_allocator}
 {
-  if (_function.m_data) {
-    m_size = _function.m_size;
-    m_data = allocator().allocate(m_size);
-    RX_ASSERT(m_data, "out of memory");
-
-    // Copy construct the control block and the function.
-    Utility::construct<ControlBlock>(m_data, *_function.control());
-    control()->modify_lifetime(Lifetime::k_construct, storage(), _function.storage());
-  }
+  copy(_function);
 }
 
 template<typename R, typename... Ts>
@@ -153,81 +206,51 @@ inline Function<R(Ts...)>::Function(const Function& _function)
 
 template<typename R, typename... Ts>
 inline Function<R(Ts...)>::Function(Function&& function_)
-  : m_allocator{function_.m_allocator}
-  , m_data{Utility::exchange(function_.m_data, nullptr)}
-  , m_size{Utility::exchange(function_.m_size, 0)}
+  : Function{function_.allocator()}
 {
+  relocate(function_);
 }
 
 template<typename R, typename... Ts>
 inline Function<R(Ts...)>& Function<R(Ts...)>::operator=(const Function& _function) {
   RX_ASSERT(&_function != this, "self assignment");
-
-  if (m_data) {
-    control()->modify_lifetime(Lifetime::k_destruct, storage(), nullptr);
-  }
-
-  if (_function.m_data) {
-    // Reallocate storage to make function fit.
-    if (_function.m_size > m_size) {
-      m_size = _function.m_size;
-      m_data = allocator().reallocate(m_data, m_size);
-      RX_ASSERT(m_data, "out of memory");
-    }
-    // Copy construct the control block and the function.
-    Utility::construct<ControlBlock>(m_data, *_function.control());
-    control()->modify_lifetime(Lifetime::k_construct, storage(), _function.storage());
-  } else {
-    destroy();
-  }
-
+  destroy();
+  copy(_function);
   return *this;
 }
 
 template<typename R, typename... Ts>
 inline Function<R(Ts...)>& Function<R(Ts...)>::operator=(Function&& function_) {
   RX_ASSERT(&function_ != this, "self assignment");
-
-  if (m_data) {
-    control()->modify_lifetime(Lifetime::k_destruct, storage(), nullptr);
-  }
-
+  destroy();
   m_allocator = function_.m_allocator;
-  m_size = Utility::exchange(function_.m_size, 0);
-  m_data = Utility::exchange(function_.m_data, nullptr);
-
+  relocate(function_);
   return *this;
 }
 
 template<typename R, typename... Ts>
 inline Function<R(Ts...)>& Function<R(Ts...)>::operator=(NullPointer) {
-  if (m_data) {
-    control()->modify_lifetime(Lifetime::k_destruct, storage(), nullptr);
-    destroy();
-  }
+  destroy();
   return *this;
 }
 
 template<typename R, typename... Ts>
 inline Function<R(Ts...)>::~Function() {
-  if (m_data) {
-    control()->modify_lifetime(Lifetime::k_destruct, storage(), nullptr);
-    destroy();
-  }
+  destroy();
 }
 
 template<typename R, typename... Ts>
 inline R Function<R(Ts...)>::operator()(Ts... _arguments) const {
   if constexpr(traits::is_same<R, void>) {
-    control()->invoke(storage(), Utility::forward<Ts>(_arguments)...);
+    m_invoke(m_storage.data, Utility::forward<Ts>(_arguments)...);
   } else {
-    return control()->invoke(storage(), Utility::forward<Ts>(_arguments)...);
+    return m_invoke(m_storage.data, Utility::forward<Ts>(_arguments)...);
   }
 }
 
 template<typename R, typename... Ts>
 Function<R(Ts...)>::operator bool() const {
-  return m_size != 0;
+  return m_invoke != nullptr;
 }
 
 template<typename R, typename... Ts>
@@ -235,31 +258,39 @@ RX_HINT_FORCE_INLINE constexpr Memory::Allocator& Function<R(Ts...)>::allocator(
   return *m_allocator;
 }
 
+// The callable of |_function| is copied with this allocator.
 template<typename R, typename... Ts>
-inline void Function<R(Ts...)>::destroy() {
-  allocator().deallocate(m_data);
-  m_data = nullptr;
-  m_size = 0;
-}
-
-template<typename R, typename... Ts>
-RX_HINT_FORCE_INLINE typename Function<R(Ts...)>::ControlBlock* Function<R(Ts...)>::control() {
-  return reinterpret_cast<ControlBlock*>(m_data);
-}
-
-template<typename R, typename... Ts>
-RX_HINT_FORCE_INLINE const typename Function<R(Ts...)>::ControlBlock* Function<R(Ts...)>::control() const {
-  return reinterpret_cast<const ControlBlock*>(m_data);
+inline void Function<R(Ts...)>::copy(const Function& _function) {
+  m_invoke = _function.m_invoke;
+  m_modify_lifetime = _function.m_modify_lifetime;
+  if (m_modify_lifetime) {
+    m_modify_lifetime(Lifetime::k_copy, allocator(), m_storage.data,
+      const_cast<Byte*>(_function.m_storage.data));
+  } else if (m_invoke) {
+    m_storage = _function.m_storage;
+  }
 }
 
+// Both functions are expected to have the same allocator.
 template<typename R, typename... Ts>
-RX_HINT_FORCE_INLINE Byte* Function<R(Ts...)>::storage() {
-  return m_data + sizeof(ControlBlock);
+inline void Function<R(Ts...)>::relocate(Function& function_) {
+  m_invoke = Utility::exchange(function_.m_invoke, nullptr);
+  m_modify_lifetime = Utility::exchange(function_.m_modify_lifetime, nullptr);
+  if (m_modify_lifetime) {
+    m_modify_lifetime(Lifetime::k_relocate, allocator(), m_storage.data,
+      function_.m_storage.data);
+  } else if (m_invoke) {
+    m_storage = function_.m_storage;
+  }
 }
 
 template<typename R, typename... Ts>
-RX_HINT_FORCE_INLINE const Byte* Function<R(Ts...)>::storage() const {
-  return m_data + sizeof(ControlBlock);
+inline void Function<R(Ts...)>::destroy() {
+  if (m_modify_lifetime) {
+    m_modify_lifetime(Lifetime::k_destruct, allocator(), m_storage.data, nullptr);
+  }
+  m_invoke = nullptr;
+  m_modify_lifetime = nullptr;
 }
 
 } // namespace rx::core
@@ -190,6 +190,29 @@ struct Hash<T*> {
   }
 };
 
+// The type the hash containers find and erase keys of type |K| with. Keys
+// which can be searched for without constructing one, like |String|, name a
+// cheaper type with a |LookupKey| member. That type must hash the same and
+// compare equal to the keys it stands for. Every other key is taken by
+// reference.
+namespace detail {
+  template<typename K>
+  using HasLookupKey = typename K::LookupKey;
+
+  template<typename K, bool = traits::detect<K, HasLookupKey>>
+  struct LookupKey {
+    using Type = const K&;
+  };
+
+  template<typename K>
+  struct LookupKey<K, true> {
+    using Type = typename K::LookupKey;
+  };
+} // namespace detail
+
+template<typename K>
+using LookupKey = typename detail::LookupKey<K>::Type;
+
 inline constexpr Size hash_combine(Size _hash1, Size _hash2) {
   return _hash1 ^ (_hash2 + 0x9E3779B9 + (_hash1 << 6) + (_hash1 >> 2));
 }
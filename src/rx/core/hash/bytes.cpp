@@ -0,0 +1,123 @@
+#include <string.h> // memcpy
+
+#include "rx/core/hash/bytes.h"
+
+#include "rx/core/hints/likely.h"
+
+#if defined(RX_COMPILER_MSVC) && defined(_M_X64)
+#include <intrin.h> // _umul128
+#endif
+
+namespace Rx::Hash {
+
+static constexpr const Uint64 k_secret[]{
+  0xa0761d6478bd642f_u64,
+  0xe7037ed1a0b428db_u64,
+  0x8ebc6af09c88c6e3_u64,
+  0x589965cc75374cc3_u64
+};
+
+// The 128-bit product of |a_| and |b_|, low half in |a_| and high in |b_|.
+static inline void multiply(Uint64& a_, Uint64& b_) {
+#if defined(__SIZEOF_INT128__)
+  const auto product{static_cast<unsigned __int128>(a_) * b_};
+  a_ = static_cast<Uint64>(product);
+  b_ = static_cast<Uint64>(product >> 64);
+#elif defined(RX_COMPILER_MSVC) && defined(_M_X64)
+  a_ = _umul128(a_, b_, &b_);
+#else
+  const Uint64 ha{a_ >> 32};
+  const Uint64 hb{b_ >> 32};
+  const Uint64 la{a_ & 0xffffffff_u64};
+  const Uint64 lb{b_ & 0xffffffff_u64};
+  const Uint64 hh{ha * hb};
+  const Uint64 hl{ha * lb};
+  const Uint64 lh{la * hb};
+  const Uint64 ll{la * lb};
+  const Uint64 t{ll + (hl << 32)};
+  const Uint64 lo{t + (lh << 32)};
+  const Uint64 carry{Uint64{t < ll} + Uint64{lo < t}};
+  a_ = lo;
+  b_ = hh + (hl >> 32) + (lh >> 32) + carry;
+#endif
+}
+
+static inline Uint64 mix(Uint64 _a, Uint64 _b) {
+  multiply(_a, _b);
+  return _a ^ _b;
+}
+
+static inline Uint64 read64(const Byte* _data) {
+  Uint64 value;
+  memcpy(&value, _data, sizeof value);
+  return value;
+}
+
+static inline Uint64 read32(const Byte* _data) {
+  Uint32 value;
+  memcpy(&value, _data, sizeof value);
+  return value;
+}
+
+// Reads all of 1 to 3 bytes.
+static inline Uint64 read_small(const Byte* _data, Size _size) {
+  return (Uint64{_data[0]} << 16) | (Uint64{_data[_size >> 1]} << 8) | _data[_size - 1];
+}
+
+Size bytes(const Byte* _data, Size _size, Uint64 _seed) {
+  const Byte* data{_data};
+  Uint64 seed{_seed ^ mix(_seed ^ k_secret[0], k_secret[1])};
+  Uint64 a;
+  Uint64 b;
+
+  if (RX_HINT_LIKELY(_size <= 16)) {
+    if (_size >= 4) {
+      // Two overlapping pairs of 32-bit reads cover 4 to 16 bytes.
+      const Size middle{(_size >> 3) << 2};
+      a = (read32(data) << 32) | read32(data + middle);
+      b = (read32(data + _size - 4) << 32) | read32(data + _size - 4 - middle);
+    } else if (_size > 0) {
+      a = read_small(data, _size);
+      b = 0;
+    } else {
+      a = 0;
+      b = 0;
+    }
+  } else {
+    Size size{_size};
+    if (size > 48) {
+      // Three independent lanes so the multiplies can overlap.
+      Uint64 lane1{seed};
+      Uint64 lane2{seed};
+      do {
+        seed = mix(read64(data) ^ k_secret[1], read64(data + 8) ^ seed);
+        lane1 = mix(read64(data + 16) ^ k_secret[2], read64(data + 24) ^ lane1);
+        lane2 = mix(read64(data + 32) ^ k_secret[3], read64(data + 40) ^ lane2);
+        data += 48;
+        size -= 48;
+      } while (size > 48);
+      seed ^= lane1 ^ lane2;
+    }
+    while (size > 16) {
+      seed = mix(read64(data) ^ k_secret[1], read64(data + 8) ^ seed);
+      data += 16;
+      size -= 16;
+    }
+    // The last 16 bytes, which may overlap those already read.
+    a = read64(data + size - 16);
+    b = read64(data + size - 8);
+  }
+
+  a ^= k_secret[1];
+  b ^= seed;
+  multiply(a, b);
+
+  const Uint64 hash{mix(a ^ k_secret[0] ^ _size, b ^ k_secret[1])};
+  if constexpr (sizeof(Size) == 8) {
+    return static_cast<Size>(hash);
+  } else {
+    return static_cast<Size>(hash ^ (hash >> 32));
+  }
+}
+
+} // namespace rx::hash
@@ -0,0 +1,21 @@
+#ifndef RX_CORE_HASH_BYTES_H
+#define RX_CORE_HASH_BYTES_H
+#include "rx/core/types.h"
+
+// # Byte hash
+//
+// A fast hash of a range of bytes for hash tables, read a 64-bit word at a
+// time and mixed with 64-bit multiplies. It's based on wyhash.
+//
+// The result depends on the seed, the platform and the version of this code,
+// so it must never be stored. Use |fnv1a| for hashes written to disk.
+
+namespace Rx::Hash {
+
+inline constexpr const Uint64 k_bytes_seed{0x243f6a8885a308d3_u64};
+
+RX_API Size bytes(const Byte* _data, Size _size, Uint64 _seed = k_bytes_seed);
+
+} // namespace rx::hash
+
+#endif // RX_CORE_HASH_BYTES_H
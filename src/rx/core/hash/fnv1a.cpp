@@ -12,6 +12,7 @@ T fnv1a(const Byte* _data, Size _size) {
       hash = hash ^ _data[i];
       hash *= k_prime;
     }
+    return hash;
   } else if constexpr (traits::is_same<T, Uint64>) {
     static constexpr const Uint64 k_prime = 0x100000001b3_u64;
     Uint64 hash = 0xcbf29ce484222325_u64;
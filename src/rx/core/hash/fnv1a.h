@@ -3,6 +3,9 @@
 #include "rx/core/types.h"
 
 // # Fowler-Noll-Vo hash
+//
+// Slow since it reads a byte at a time, but the result is the same on every
+// platform, so this is the one to use for hashes that are stored.
 
 namespace Rx::Hash {
 
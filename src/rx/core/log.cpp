@@ -1,16 +1,19 @@
 #include <time.h> // time_t, time
-#include <string.h> // strlen
+#include <string.h> // strlen, strchr, memcpy, memcmp
 
 #include "rx/core/log.h"
-#include "rx/core/ptr.h"
+#include "rx/core/map.h"
 #include "rx/core/stream.h"
-#include "rx/core/intrusive_list.h"
 
 #include "rx/core/algorithm/max.h"
 
 #include "rx/core/concurrency/mutex.h"
 #include "rx/core/concurrency/condition_variable.h"
 #include "rx/core/concurrency/thread.h"
+#include "rx/core/concurrency/atomic.h"
+
+#include "rx/core/time/qpc.h"
+#include "rx/core/time/delay.h"
 
 namespace Rx {
 
@@ -23,9 +26,13 @@ struct Logger {
   static constexpr Logger& instance();
 
   bool subscribe(Stream* _stream);
+  bool subscribe_binary(Stream* _stream);
   bool unsubscribe(Stream* _stream);
   bool enqueue(Log* _log, Log::Level _level, String&& _message);
+  bool enqueue(Log* _log, Log::Level _level, const char* _format,
+    const Log::Arguments& _arguments);
   void flush();
+  Uint64 dropped() const;
 
 private:
   enum {
@@ -33,33 +40,89 @@ private:
     k_ready   = 1 << 1
   };
 
-  struct Queue {
-    Log* owner;
-    IntrusiveList messages;
-  };
-
+  // The queue is a bounded multi-producer queue of preallocated messages as
+  // described by Dmitry Vyukov. Any thread can push without a lock, the only
+  // thread to pop is the one holding |m_write_mutex|.
+  //
+  // Every slot has a sequence number that tells who's turn it is. A slot is
+  // free to push to when it's sequence matches the position pushed to and
+  // ready to be popped when it's one more than the position popped from.
+  // Popping hands the slot to the next lap around the ring.
+  static inline constexpr const Size k_capacity{2048};
+
+  // How long a push waits for room in a full queue before the message is
+  // dropped, in milliseconds.
+  static inline constexpr const Uint64 k_claim_timeout{100};
+
+  // Deferred messages have a |format| and |arguments| and no |contents|
+  // until they're formatted by the logging thread.
   struct Message {
-    Queue* owner;
+    Log* owner;
     Log::Level level;
     time_t time;
     String contents;
-    IntrusiveList::Node link;
+    const char* format;
+    Log::Arguments arguments;
   };
 
+  struct Slot {
+    Concurrency::Atomic<Size> sequence;
+    Message message;
+  };
+
+  // Strings written to a binary stream so far, by address, and the id they
+  // were given in it.
+  struct BinaryStream {
+    Stream* stream;
+    Map<const void*, Uint32> ids;
+  };
+
+  Message* claim(Size& position_);
+  bool try_claim(Size& position_);
+  void publish(Size _position);
+  Message* peek();
+  void pop();
+  bool has_messages() const;
+
   void process(int _thread_id);
 
   void flush_unlocked();
-  void write(Ptr<Message>& message_);
+  void write(Message& message_);
+  void write_binary(BinaryStream& stream_, const Message& _message);
+  Uint32 write_binary_string(BinaryStream& stream_, const void* _key,
+    const char* _string);
 
+  // Only held to decide if the logging thread sleeps and to wake it up, never
+  // while messages are written.
   Concurrency::Mutex m_mutex;
   Concurrency::ConditionVariable m_ready_cond;
   Concurrency::ConditionVariable m_wakeup_cond;
 
-  Vector<Stream*> m_streams       RX_HINT_GUARDED_BY(m_mutex);
-  Vector<Queue> m_queues          RX_HINT_GUARDED_BY(m_mutex);
-  Vector<Ptr<Message>> m_messages RX_HINT_GUARDED_BY(m_mutex);
+  // Held by the one thread writing messages out, be it the logging thread or
+  // one calling |flush|. The delegates of a log are called with it held.
+  Concurrency::Mutex m_write_mutex;
+
+  Vector<Stream*> m_streams       RX_HINT_GUARDED_BY(m_write_mutex);
+  Vector<BinaryStream> m_binary_streams RX_HINT_GUARDED_BY(m_write_mutex);
   int m_status                    RX_HINT_GUARDED_BY(m_mutex);
-  int m_padding                   RX_HINT_GUARDED_BY(m_mutex);
+  int m_padding                   RX_HINT_GUARDED_BY(m_write_mutex);
+
+  // Set by the logging thread before it sleeps, a push wakes it up by setting
+  // |m_signaled| under |m_mutex|.
+  Concurrency::Atomic<bool> m_sleeping;
+  bool m_signaled                 RX_HINT_GUARDED_BY(m_mutex);
+
+  Slot m_slots[k_capacity];
+
+  // Keep the positions on different cache lines, they're written by
+  // different threads.
+  Concurrency::Atomic<Size> m_push_position;
+  Byte m_pad[64 - sizeof(Concurrency::Atomic<Size>)];
+  // Only written with |m_write_mutex| held.
+  Concurrency::Atomic<Size> m_pop_position;
+
+  // Number of messages dropped because the queue stayed full.
+  Concurrency::Atomic<Uint64> m_dropped;
 
   // NOTE(dweiler): This should come last.
   Concurrency::Thread m_thread;
@@ -69,6 +132,10 @@ private:
 
 static GlobalGroup g_group_loggers{"loggers"};
 
+// Set on the thread holding |Logger::m_write_mutex| while it writes messages
+// out, as seen by the delegates it calls.
+static thread_local bool t_writing;
+
 Global<Logger> Logger::s_instance{"system", "logger"};
 
 static inline const char* string_for_level(Log::Level _level, const bool color = true) {
@@ -138,11 +205,55 @@ Size ansi_color_strlen(const char* str) {
   return size;
 }	
 
+// # Binary log
+//
+// Starts with the four bytes "RXLG" and a Uint32 version, followed by any
+// number of records. Every integer is written in the byte order of the host.
+//
+//  k_record_string   Byte kind, Uint32 id, Uint32 length, char[length]
+//  k_record_text     Byte kind, Byte level, Sint64 time, Uint32 log,
+//                    Uint32 length, char[length]
+//  k_record_message  Byte kind, Byte level, Sint64 time, Uint32 log,
+//                    Uint32 format, Uint32 size, Byte[size]
+//
+// Log names and format strings are written once as a string record before
+// the first record that refers to them by id. The bytes of a message record
+// are the |Log::Arguments| of a deferred message.
+static constexpr const Byte k_binary_magic[4]{'R', 'X', 'L', 'G'};
+static constexpr const Uint32 k_binary_version{1};
+
+enum : Byte {
+  k_record_string,
+  k_record_text,
+  k_record_message
+};
+
+// Builds a record in place, fields are unaligned.
+struct Record {
+  template<typename T>
+  void put(const T& _value) {
+    memcpy(data + size, &_value, sizeof _value);
+    size += sizeof _value;
+  }
+  Byte data[32];
+  Size size = 0;
+};
+
 Logger::Logger()
   : m_status{k_running}
   , m_padding{0}
+  , m_sleeping{false}
+  , m_signaled{false}
+  , m_push_position{0}
+  , m_pad{}
+  , m_pop_position{0}
+  , m_dropped{0}
   , m_thread{"logger", [this](int _thread_id) { process(_thread_id); }}
 {
+  for (Size i{0}; i < k_capacity; i++) {
+    m_slots[i].sequence.store(i, Concurrency::MemoryOrder::k_relaxed);
+  }
+
   // Calculate padding needed for formatting log level.
   int max_level = Algorithm::max(
     strlen(string_for_level(Log::Level::k_warning, false)),
@@ -155,9 +266,7 @@ Logger::Logger()
     // Initialize the logger.
     _node->init();
 
-    // Associate a message queue with the logger.
     auto this_log = _node->cast<Log>();
-    m_queues.emplace_back(this_log, IntrusiveList{});
 
     // Keep track of the largest logger name.
     const auto length = ansi_color_strlen(this_log->name());
@@ -200,7 +309,12 @@ bool Logger::subscribe(Stream* _stream) {
     return false;
   }
 
-  Concurrency::ScopeLock lock{m_mutex};
+  // The streams can't change while they're written to, as by a delegate.
+  if (t_writing) {
+    return false;
+  }
+
+  Concurrency::ScopeLock lock{m_write_mutex};
   if (const auto find = m_streams.find(_stream); find != -1_z) {
     return false;
   }
@@ -208,82 +322,259 @@ bool Logger::subscribe(Stream* _stream) {
   return m_streams.push_back(_stream);
 }
 
+bool Logger::subscribe_binary(Stream* _stream) {
+  if (!_stream->can_write() || t_writing) {
+    return false;
+  }
+
+  Concurrency::ScopeLock lock{m_write_mutex};
+  if (m_binary_streams.find_if([_stream](const BinaryStream& _binary_stream) {
+    return _binary_stream.stream == _stream;
+  }) != -1_z) {
+    return false;
+  }
+
+  Record header;
+  header.put(k_binary_magic);
+  header.put(k_binary_version);
+  if (_stream->write(header.data, header.size) != header.size) {
+    return false;
+  }
+
+  return m_binary_streams.emplace_back(_stream, Map<const void*, Uint32>{});
+}
+
 bool Logger::unsubscribe(Stream* _stream) {
-  Concurrency::ScopeLock lock{m_mutex};
+  if (t_writing) {
+    return false;
+  }
+
+  Concurrency::ScopeLock lock{m_write_mutex};
   if (const auto find = m_streams.find(_stream); find != -1_z) {
     // Flush any contents when removing a stream from the logger.
     flush_unlocked();
     m_streams.erase(find, find + 1);
     return true;
   }
+  if (const auto find = m_binary_streams.find_if([_stream](const BinaryStream& _binary_stream) {
+    return _binary_stream.stream == _stream;
+  }); find != -1_z) {
+    flush_unlocked();
+    m_binary_streams.erase(find, find + 1);
+    return true;
+  }
   return false;
 }
 
 bool Logger::enqueue(Log* _owner, Log::Level _level, String&& message_) {
-  Concurrency::ScopeLock lock{m_mutex};
+  Size position;
+  auto message{claim(position)};
+  if (!message) {
+    return false;
+  }
+  message->owner = _owner;
+  message->level = _level;
+  message->time = time(nullptr);
+  message->contents = Utility::move(message_);
+  message->format = nullptr;
+  publish(position);
+  return true;
+}
 
-  const auto index = m_queues.find_if([_owner](const Queue& _queue) {
-    return _queue.owner == _owner;
-  });
+bool Logger::enqueue(Log* _owner, Log::Level _level, const char* _format,
+  const Log::Arguments& _arguments)
+{
+  Size position;
+  auto message{claim(position)};
+  if (!message) {
+    return false;
+  }
+  message->owner = _owner;
+  message->level = _level;
+  message->time = time(nullptr);
+  message->format = _format;
+  message->arguments.size = _arguments.size;
+  memcpy(message->arguments.data, _arguments.data, _arguments.size);
+  publish(position);
+  return true;
+}
 
-  if (index != -1_z) {
-    auto& this_queue = m_queues[index];
+Logger::Message* Logger::claim(Size& position_) {
+  if (try_claim(position_)) {
+    return &m_slots[position_ & (k_capacity - 1)].message;
+  }
 
-    // Record the message.
-    auto this_message = make_ptr<Message>(Memory::SystemAllocator::instance(),
-                                          &this_queue, _level, time(nullptr), Utility::move(message_),
-                                          IntrusiveList::Node{});
+  // The queue is full. A thread writing messages out can't wait for itself to
+  // make room, any other thread waits for the logging thread for a bounded
+  // time before the message is dropped rather than blocking for good.
+  if (!t_writing) {
+    const Uint64 start{Time::qpc_ticks()};
+    const Uint64 timeout{Time::qpc_frequency() * k_claim_timeout / 1000};
+    do {
+      // Sleep rather than yield so the logging thread gets to run even with
+      // many threads waiting.
+      Time::delay(1);
+      if (try_claim(position_)) {
+        return &m_slots[position_ & (k_capacity - 1)].message;
+      }
+    } while (Time::qpc_ticks() - start < timeout);
+  }
+
+  m_dropped.fetch_add(1, Concurrency::MemoryOrder::k_relaxed);
+  return nullptr;
+}
 
-    if (!this_message || !m_messages.emplace_back(Utility::move(this_message))) {
+bool Logger::try_claim(Size& position_) {
+  using Concurrency::MemoryOrder;
+
+  Size position{m_push_position.load(MemoryOrder::k_relaxed)};
+  for (;;) {
+    const auto& slot{m_slots[position & (k_capacity - 1)]};
+    const Size sequence{slot.sequence.load(MemoryOrder::k_acquire)};
+    const auto difference{static_cast<PtrDiff>(sequence - position)};
+    if (difference == 0) {
+      // The slot is free, claim it.
+      if (m_push_position.compare_exchange_weak(position, position + 1,
+        MemoryOrder::k_relaxed, MemoryOrder::k_relaxed))
+      {
+        position_ = position;
+        return true;
+      }
+    } else if (difference < 0) {
+      // The slot still holds a message from the previous lap, full.
       return false;
+    } else {
+      // Another thread claimed the slot.
+      position = m_push_position.load(MemoryOrder::k_relaxed);
     }
+  }
+}
 
-    // Record the link.
-    this_queue.messages.push_back(&m_messages.last()->link);
+void Logger::publish(Size _position) {
+  using Concurrency::MemoryOrder;
 
-    // Wakeup logging thread when we have a few messages.
-    if (!m_streams.is_empty() && !m_messages.is_empty()) {
-      m_wakeup_cond.signal();
-    }
+  auto& slot{m_slots[_position & (k_capacity - 1)]};
+  slot.sequence.store(_position + 1, MemoryOrder::k_release);
 
-    return true;
+  // Pairs with the fence in |process| before it checks for messages.
+  Concurrency::atomic_thread_fence(MemoryOrder::k_seq_cst);
+  if (m_sleeping.load(MemoryOrder::k_relaxed)) {
+    Concurrency::ScopeLock lock{m_mutex};
+    m_signaled = true;
+    m_wakeup_cond.signal();
   }
+}
 
-  return false;
+Logger::Message* Logger::peek() {
+  const Size position{m_pop_position.load(Concurrency::MemoryOrder::k_relaxed)};
+  auto& slot{m_slots[position & (k_capacity - 1)]};
+  const Size sequence{slot.sequence.load(Concurrency::MemoryOrder::k_acquire)};
+  return sequence == position + 1 ? &slot.message : nullptr;
+}
+
+void Logger::pop() {
+  const Size position{m_pop_position.load(Concurrency::MemoryOrder::k_relaxed)};
+  auto& slot{m_slots[position & (k_capacity - 1)]};
+  // Hand the slot to the next lap.
+  slot.sequence.store(position + k_capacity,
+    Concurrency::MemoryOrder::k_release);
+  m_pop_position.store(position + 1, Concurrency::MemoryOrder::k_release);
+}
+
+bool Logger::has_messages() const {
+  // Claimed messages count too, the push of one not published yet sees the
+  // logging thread as sleeping and wakes it.
+  return m_push_position.load(Concurrency::MemoryOrder::k_relaxed)
+    != m_pop_position.load(Concurrency::MemoryOrder::k_acquire);
 }
 
 void Logger::flush() {
-  Concurrency::ScopeLock lock{m_mutex};
+  // A delegate flushing from a thread already writing messages out has them
+  // written once it returns.
+  if (t_writing) {
+    return;
+  }
+
+  Concurrency::ScopeLock lock{m_write_mutex};
   flush_unlocked();
 }
 
-void Logger::process([[maybe_unused]] int _thread_id) {
-  Concurrency::ScopeLock locked{m_mutex};
+Uint64 Logger::dropped() const {
+  return m_dropped.load(Concurrency::MemoryOrder::k_relaxed);
+}
 
+void Logger::process([[maybe_unused]] int _thread_id) {
   // Block the logging thread until |this| is ready.
-  m_ready_cond.wait(locked, [this] { return m_status & k_ready; });
+  {
+    Concurrency::ScopeLock locked{m_mutex};
+    m_ready_cond.wait(locked, [this] { return m_status & k_ready; });
+  }
 
-  while (m_status & k_running) {
-    // Block until another we're woken up again to flush something.
-    m_wakeup_cond.wait(locked);
+  for (;;) {
+    // Write out the queued messages without |m_mutex| held so that a push can
+    // always wake this thread, even one from a delegate.
+    flush();
 
-    // Flush the queued contents. Use the unlocked variant since |m_mutex| is
-    // held by |m_wakeup_cond|.
-    flush_unlocked();
+    Concurrency::ScopeLock locked{m_mutex};
+    if (!(m_status & k_running)) {
+      break;
+    }
+
+    // Announce the intent to sleep before checking for messages one last
+    // time. Either the check sees the message just pushed or the push sees
+    // this thread as sleeping and signals it.
+    m_sleeping.store(true, Concurrency::MemoryOrder::k_relaxed);
+    Concurrency::atomic_thread_fence(Concurrency::MemoryOrder::k_seq_cst);
+    if (!has_messages()) {
+      // Block until we're woken up again to flush something.
+      m_wakeup_cond.wait(locked, [this] {
+        return m_signaled || !(m_status & k_running);
+      });
+    }
+    m_sleeping.store(false, Concurrency::MemoryOrder::k_relaxed);
+    m_signaled = false;
   }
+
+  // Write out anything queued while stopping.
+  flush();
 }
 
 void Logger::flush_unlocked() {
-  // Flush all message entries.
-  m_messages.each_fwd([this](Ptr<Message>& message_) { write(message_); });
-  m_messages.clear();
+  // Flush all message entries. Anything the delegates log while this thread
+  // writes is dropped rather than waited for when the queue is full.
+  t_writing = true;
+  while (auto message = peek()) {
+    write(*message);
+    pop();
+  }
+  t_writing = false;
 }
 
-void Logger::write(Ptr<Message>& message_) {
-  auto this_queue = message_->owner;
+void Logger::write(Message& message_) {
+  const auto owner = message_.owner;
+
+  // Format deferred messages only when there's something to see the text.
+  if (message_.format) {
+    if (!m_streams.is_empty() || owner->is_observed()) {
+      message_.contents = message_.arguments.format(
+        message_.contents.allocator(), message_.format);
+      owner->signal_queue(message_.level, message_.contents);
+    } else {
+      message_.contents.clear();
+    }
+  }
+
+  m_binary_streams.each_fwd([&](BinaryStream& stream_) {
+    write_binary(stream_, message_);
+  });
+
+  if (m_streams.is_empty()) {
+    owner->signal_write(message_.level, Utility::move(message_.contents));
+    return;
+  }
 
-  const auto name = this_queue->owner->name();
-  const auto level = string_for_level(message_->level);
+  const auto name = owner->name();
+  const auto level = string_for_level(message_.level);
   const auto padding = ansi_color_strlen(name) + ansi_color_strlen(level) + 1; // +1 for '/'
 
   // The streams written to are all binary streams. Handle platform differences
@@ -297,12 +588,12 @@ void Logger::write(Ptr<Message>& message_) {
 
   const auto contents = String::format(
     format,
-    string_for_time(message_->time),
+    string_for_time(message_.time),
     name,
     level,
     m_padding - padding,
     "",
-    message_->contents);
+    message_.contents);
 
   // Send formatted message to each stream.
   m_streams.each_fwd([&contents](Stream* _stream) {
@@ -312,18 +603,61 @@ void Logger::write(Ptr<Message>& message_) {
   });
 
   // Signal the write event for the log associated with this message.
-  this_queue->owner->signal_write(message_->level,
-                                  Utility::move(message_->contents));
+  owner->signal_write(message_.level, Utility::move(message_.contents));
+}
+
+void Logger::write_binary(BinaryStream& stream_, const Message& _message) {
+  const auto log = write_binary_string(stream_, _message.owner, _message.owner->name());
+
+  Record record;
+  Size size;
+  const Byte* data;
+  if (_message.format) {
+    const auto format = write_binary_string(stream_, _message.format, _message.format);
+    record.put(k_record_message);
+    record.put(static_cast<Byte>(_message.level));
+    record.put(static_cast<Sint64>(_message.time));
+    record.put(log);
+    record.put(format);
+    size = _message.arguments.size;
+    data = _message.arguments.data;
+  } else {
+    record.put(k_record_text);
+    record.put(static_cast<Byte>(_message.level));
+    record.put(static_cast<Sint64>(_message.time));
+    record.put(log);
+    size = _message.contents.size();
+    data = reinterpret_cast<const Byte*>(_message.contents.data());
+  }
+  record.put(static_cast<Uint32>(size));
 
-  // Remove the message from the log's queue associated with this message.
-  this_queue->messages.erase(&message_->link);
+  auto stream = stream_.stream;
+  RX_ASSERT(stream->write(record.data, record.size) == record.size
+    && stream->write(data, size) == size, "failed to write to stream");
+}
 
-  // The queue for the log associated with this message is now empty.
-  if (this_queue->messages.is_empty()) {
-    // Signal the flush operation on that log, to indicate any messages
-    // queued up on it are now all written out.
-    this_queue->owner->signal_flush();
+Uint32 Logger::write_binary_string(BinaryStream& stream_, const void* _key,
+  const char* _string)
+{
+  if (auto id = stream_.ids.find(_key)) {
+    return *id;
   }
+
+  const auto id = static_cast<Uint32>(stream_.ids.size());
+  RX_ASSERT(stream_.ids.insert(_key, id), "out of memory");
+
+  const auto length = strlen(_string);
+  Record record;
+  record.put(k_record_string);
+  record.put(id);
+  record.put(static_cast<Uint32>(length));
+
+  auto stream = stream_.stream;
+  RX_ASSERT(stream->write(record.data, record.size) == record.size
+    && stream->write(reinterpret_cast<const Byte*>(_string), length) == length,
+    "failed to write to stream");
+
+  return id;
 }
 
 } // anon-namespace
@@ -331,6 +665,20 @@ void Logger::write(Ptr<Message>& message_) {
 void Log::signal_write(Level _level, String&& contents_) {
   // NOTE(dweiler): This is called by the logging thread.
   m_write_event.signal(_level, Utility::move(contents_));
+
+  // When the last message queued for this log is written, signal the flush
+  // operation to indicate any messages queued up on it are now all written
+  // out.
+  if (m_pending.fetch_sub(1, Concurrency::MemoryOrder::k_acq_rel) == 1) {
+    signal_flush();
+  }
+}
+
+void Log::signal_drop() {
+  // NOTE(dweiler): This is called by the thread whose message was dropped.
+  if (m_pending.fetch_sub(1, Concurrency::MemoryOrder::k_acq_rel) == 1) {
+    signal_flush();
+  }
 }
 
 void Log::signal_flush() {
@@ -338,20 +686,313 @@ void Log::signal_flush() {
   m_flush_event.signal();
 }
 
+void Log::signal_queue(Level _level, const String& _contents) {
+  // NOTE(dweiler): This is called by the logging thread.
+  m_queue_event.signal(_level, _contents);
+}
+
+bool Log::enqueue(Log* _owner, Level _level, const char* _format,
+  const Arguments& _arguments)
+{
+  // Count the message before it's queued so it can't be written first.
+  _owner->m_pending.fetch_add(1, Concurrency::MemoryOrder::k_relaxed);
+  if (Logger::instance().enqueue(_owner, _level, _format, _arguments)) {
+    return true;
+  }
+  _owner->signal_drop();
+  return false;
+}
+
 bool Log::enqueue(Log* _owner, Level _level, String&& contents_) {
-  return Logger::instance().enqueue(_owner, _level, Utility::move(contents_));
+  // Count the message before it's queued so it can't be written first.
+  _owner->m_pending.fetch_add(1, Concurrency::MemoryOrder::k_relaxed);
+  if (Logger::instance().enqueue(_owner, _level, Utility::move(contents_))) {
+    return true;
+  }
+  _owner->signal_drop();
+  return false;
 }
 
 void Log::flush() {
   Logger::instance().flush();
 }
 
+Uint64 Log::dropped() {
+  return Logger::instance().dropped();
+}
+
 bool Log::subscribe(Stream* _stream) {
   return Logger::instance().subscribe(_stream);
 }
 
+bool Log::subscribe_binary(Stream* _stream) {
+  return Logger::instance().subscribe_binary(_stream);
+}
+
 bool Log::unsubscribe(Stream* _stream) {
   return Logger::instance().unsubscribe(_stream);
 }
 
+bool Log::read_binary(Stream* _stream, ReadFunction&& function_) {
+  auto& allocator = Memory::SystemAllocator::instance();
+
+  auto read = [&](void* data_, Size _size) {
+    return _stream->read(reinterpret_cast<Byte*>(data_), _size) == _size;
+  };
+
+  Byte magic[sizeof k_binary_magic];
+  Uint32 version;
+  if (!read(magic, sizeof magic) || memcmp(magic, k_binary_magic, sizeof magic)
+    || !read(&version, sizeof version) || version != k_binary_version)
+  {
+    return false;
+  }
+
+  // Strings by id.
+  Vector<String> strings{allocator};
+  Arguments arguments;
+
+  for (Byte kind; read(&kind, sizeof kind); ) {
+    if (kind == k_record_string) {
+      Uint32 id;
+      Uint32 length;
+      if (!read(&id, sizeof id) || !read(&length, sizeof length) || id != strings.size()) {
+        return false;
+      }
+      String string{allocator};
+      if (!string.resize(length) || !read(string.data(), length)) {
+        return false;
+      }
+      if (!strings.push_back(Utility::move(string))) {
+        return false;
+      }
+      continue;
+    }
+
+    Byte level;
+    Sint64 time;
+    Uint32 log;
+    if (!read(&level, sizeof level) || !read(&time, sizeof time)
+      || !read(&log, sizeof log) || log >= strings.size()
+      || level > static_cast<Byte>(Level::k_verbose))
+    {
+      return false;
+    }
+
+    if (kind == k_record_text) {
+      Uint32 length;
+      String contents{allocator};
+      if (!read(&length, sizeof length) || !contents.resize(length)
+        || !read(contents.data(), length))
+      {
+        return false;
+      }
+      function_(strings[log].data(), static_cast<Level>(level), time, contents);
+    } else if (kind == k_record_message) {
+      Uint32 format;
+      Uint32 size;
+      if (!read(&format, sizeof format) || format >= strings.size()
+        || !read(&size, sizeof size) || size > Arguments::k_capacity
+        || !read(arguments.data, size))
+      {
+        return false;
+      }
+      arguments.size = size;
+      const auto contents = arguments.format(allocator, strings[format].data());
+      function_(strings[log].data(), static_cast<Level>(level), time, contents);
+    } else {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Log::Arguments
+bool Log::Arguments::append(Byte _tag, const void* _data, Size _size) {
+  if (size + 1 + _size > k_capacity) {
+    return false;
+  }
+  data[size++] = _tag;
+  memcpy(data + size, _data, _size);
+  size += _size;
+  return true;
+}
+
+bool Log::Arguments::append_string(const char* _string) {
+  // Strings are stored with a length in front.
+  const char* string = _string ? _string : "(null)";
+  const Size length = strlen(string);
+  if (size + 1 + sizeof(Uint32) + length > k_capacity) {
+    return false;
+  }
+  const auto length32 = static_cast<Uint32>(length);
+  data[size++] = k_string;
+  memcpy(data + size, &length32, sizeof length32);
+  size += sizeof length32;
+  memcpy(data + size, string, length);
+  size += length;
+  return true;
+}
+
+// Format one conversion given by |_specification| with |_value| and the
+// values of any * in it.
+template<typename T>
+static void format_one(String& result_, const char* _specification,
+  const Sint32* _stars, Size _n_stars, T _value)
+{
+  Size length = 0;
+  switch (_n_stars) {
+  case 0:
+    length = format_buffer_va_args(nullptr, 0, _specification, _value);
+    break;
+  case 1:
+    length = format_buffer_va_args(nullptr, 0, _specification, _stars[0], _value);
+    break;
+  case 2:
+    length = format_buffer_va_args(nullptr, 0, _specification, _stars[0], _stars[1], _value);
+    break;
+  }
+
+  const Size offset = result_.size();
+  if (!result_.resize(offset + length)) {
+    return;
+  }
+
+  char* output = result_.data() + offset;
+  switch (_n_stars) {
+  case 0:
+    format_buffer_va_args(output, length + 1, _specification, _value);
+    break;
+  case 1:
+    format_buffer_va_args(output, length + 1, _specification, _stars[0], _value);
+    break;
+  case 2:
+    format_buffer_va_args(output, length + 1, _specification, _stars[0], _stars[1], _value);
+    break;
+  }
+}
+
+String Log::Arguments::format(Memory::Allocator& _allocator, const char* _format) const {
+  String result{_allocator};
+
+  Size offset = 0;
+  auto read = [&](void* value_, Size _size) {
+    if (offset + _size > size) {
+      return false;
+    }
+    memcpy(value_, data + offset, _size);
+    offset += _size;
+    return true;
+  };
+
+  const char* ch = _format;
+  while (*ch) {
+    if (*ch != '%') {
+      const char* next = strchr(ch, '%');
+      const Size length = next ? next - ch : strlen(ch);
+      result.append(ch, length);
+      ch += length;
+      continue;
+    }
+
+    if (ch[1] == '%') {
+      result.append('%');
+      ch += 2;
+      continue;
+    }
+
+    // Find the end of the conversion: %[flags][width][.precision][length]type
+    const char* begin = ch++;
+    Sint32 stars[2];
+    Size n_stars = 0;
+    auto width = [&] {
+      if (*ch == '*') {
+        Byte tag;
+        if (n_stars < 2 && read(&tag, 1) && tag == k_s32) {
+          read(&stars[n_stars++], sizeof(Sint32));
+        }
+        ch++;
+      } else {
+        while (*ch >= '0' && *ch <= '9') {
+          ch++;
+        }
+      }
+    };
+    while (*ch && strchr("-+ #0", *ch)) {
+      ch++;
+    }
+    width();
+    if (*ch == '.') {
+      ch++;
+      width();
+    }
+    while (*ch && strchr("hlLqjzt", *ch)) {
+      ch++;
+    }
+    if (!*ch) {
+      result.append(begin);
+      break;
+    }
+
+    char specification[32];
+    const Size length = ++ch - begin;
+    Byte tag;
+    if (length >= sizeof specification || !read(&tag, 1)) {
+      // Nothing to format it with, keep it as is.
+      result.append(begin, length);
+      continue;
+    }
+    memcpy(specification, begin, length);
+    specification[length] = '\0';
+
+    switch (tag) {
+    case k_s32:
+      if (Sint32 value; read(&value, sizeof value)) {
+        format_one(result, specification, stars, n_stars, value);
+      }
+      break;
+    case k_u32:
+      if (Uint32 value; read(&value, sizeof value)) {
+        format_one(result, specification, stars, n_stars, value);
+      }
+      break;
+    case k_s64:
+      if (Sint64 value; read(&value, sizeof value)) {
+        format_one(result, specification, stars, n_stars, value);
+      }
+      break;
+    case k_u64:
+      if (Uint64 value; read(&value, sizeof value)) {
+        format_one(result, specification, stars, n_stars, value);
+      }
+      break;
+    case k_f64:
+      if (Float64 value; read(&value, sizeof value)) {
+        format_one(result, specification, stars, n_stars, value);
+      }
+      break;
+    case k_pointer:
+      if (UintPtr value; read(&value, sizeof value)) {
+        format_one(result, specification, stars, n_stars,
+          reinterpret_cast<const void*>(value));
+      }
+      break;
+    case k_string:
+      if (Uint32 string_length; read(&string_length, sizeof string_length)
+        && offset + string_length <= size)
+      {
+        // The string isn't terminated in |data|.
+        String string{_allocator, reinterpret_cast<const char*>(data + offset),
+          string_length};
+        offset += string_length;
+        format_one(result, specification, stars, n_stars, string.data());
+      }
+      break;
+    }
+  }
+
+  return result;
+}
+
 } // namespace rx
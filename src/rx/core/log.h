@@ -3,6 +3,17 @@
 #include "rx/core/event.h"
 #include "rx/core/string.h"
 #include "rx/core/source_location.h"
+#include "rx/core/format.h"
+
+#include "rx/core/traits/is_same.h"
+#include "rx/core/traits/is_enum.h"
+#include "rx/core/traits/is_integral.h"
+#include "rx/core/traits/is_signed.h"
+#include "rx/core/traits/remove_cvref.h"
+#include "rx/core/traits/remove_pointer.h"
+#include "rx/core/traits/underlying_type.h"
+
+#include "rx/core/concurrency/atomic.h"
 
 namespace Rx {
 
@@ -20,20 +31,53 @@ struct RX_API Log {
   using WriteEvent = Event<void(Level, String)>;
   using FlushEvent = Event<void()>;
 
+  struct Arguments;
+
   constexpr Log(const char* _name, const SourceLocation& _source_location);
 
   [[nodiscard]] static bool subscribe(Stream* _stream);
   [[nodiscard]] static bool unsubscribe(Stream* _stream);
   [[nodiscard]] static bool enqueue(Log* _owner, Level _level, String&& _contents);
+  [[nodiscard]] static bool enqueue(Log* _owner, Level _level, const char* _format,
+    const Arguments& _arguments);
+
+  // Subscribe |_stream| to receive every message in the binary log format
+  // rather than as text. Deferred messages are written to it unformatted, see
+  // |Arguments|. Use |unsubscribe| to remove it again.
+  [[nodiscard]] static bool subscribe_binary(Stream* _stream);
+
+  // Defer formatting of messages with arguments to the logging thread.
+  //
+  // The calling thread only copies the arguments, the format string is kept
+  // by pointer and must outlive the logger, which string literals do. The
+  // |on_queue| delegates of deferred messages are called by the logging
+  // thread rather than the calling thread.
+  static void defer(bool _defer);
+  static bool is_deferred();
+
+  // Read the binary log in |_stream| and call |_function| with the name of
+  // the log, the level, the time and the formatted text of every message in
+  // it, in order. Returns false if the stream isn't a binary log or it's cut
+  // short.
+  using ReadFunction = Function<void(const char* _name, Level _level,
+    Sint64 _time, const String& _contents)>;
+  static bool read_binary(Stream* _stream, ReadFunction&& function_);
 
+  // Write out every queued message on the calling thread, unless it's the one
+  // already writing them out, as from a delegate.
   static void flush();
 
+  // Number of messages dropped because the queue stayed full. A message is
+  // only dropped after its thread waited a while for room, or right away on
+  // a thread writing messages out, so a delegate that logs can't deadlock.
+  static Uint64 dropped();
+
   // Write a formatted message given by |_format| and |_arguments| of associated
   // severity level |_level|. This will queue the given message on the logger
-  // thread.
+  // thread. Returns false if the message was dropped, see |dropped|.
   //
-  // All delegates given by |on_queue| will be called immediately by this
-  // function (and thus on the same thread).
+  // All delegates given by |on_queue| are called by this function on the same
+  // thread, unless the message is deferred, see |defer|.
   //
   // This function is thread-safe.
   template<typename... Ts>
@@ -58,7 +102,8 @@ struct RX_API Log {
   // When a message is queued, all delegates associated by this function are
   // called. This is different from |on_write| in that |callback_| is called
   // by the same thread which calls |write|, |warning|, |info|, |verbose|, or
-  // |error| immediately.
+  // |error| immediately, or by the logging thread once formatted when the
+  // message is deferred.
   //
   // This function returns the event handle, keep the handle alive for as
   // long as you want the delegate |callback_| to be called for such event.
@@ -91,26 +136,151 @@ struct RX_API Log {
   // Query the source information of where this log is defined.
   const SourceLocation& source_info() const &;
 
+  // Called by the logging thread for every message written, signals the
+  // flush event once no more messages of this log are queued.
   void signal_write(Level _level, String&& contents_);
   void signal_flush();
 
+  // Called for a message of this log that was dropped because the queue stayed
+  // full.
+  void signal_drop();
+
+  // Called by the logging thread for deferred messages once formatted.
+  void signal_queue(Level _level, const String& _contents);
+
+  // If anything is connected to the queue or write events of this log.
+  bool is_observed() const;
+
 private:
   const char* m_name;
   SourceLocation m_source_location;
   QueueEvent m_queue_event;
   WriteEvent m_write_event;
   FlushEvent m_flush_event;
+
+  // Number of messages queued and not yet written.
+  Concurrency::Atomic<Size> m_pending;
+
+  static inline Concurrency::Atomic<bool> s_deferred{false};
+};
+
+// # Arguments
+//
+// The arguments of a deferred message, packed with a tag in front of every
+// argument so they can be formatted later without the types.
+//
+// Every argument is stored as the type it's passed through |...| as, so
+// formatting later gives the same result as formatting right away. Strings
+// are copied, including those produced by |FormatNormalize|.
+//
+// The same layout is written to binary logs, where an offline decoder
+// formats them with the format strings stored in the log.
+struct RX_API Log::Arguments {
+  static inline constexpr const Size k_capacity{128};
+
+  enum : Byte {
+    k_s32,
+    k_u32,
+    k_s64,
+    k_u64,
+    k_f64,
+    k_string,
+    k_pointer
+  };
+
+  Arguments();
+
+  // Returns false when the arguments don't fit or there's an argument of a
+  // type that can't be deferred.
+  template<typename... Ts>
+  bool pack(const Ts&... _arguments);
+
+  // Format the arguments with |_format|.
+  String format(Memory::Allocator& _allocator, const char* _format) const;
+
+  Byte data[k_capacity];
+  Size size;
+
+private:
+  template<typename T>
+  bool pack_one(const T& _argument);
+  bool append(Byte _tag, const void* _data, Size _size);
+  bool append_string(const char* _string);
 };
 
 inline constexpr Log::Log(const char* _name, const SourceLocation& _source_location)
   : m_name{_name}
   , m_source_location{_source_location}
+  , m_pending{0}
+{
+}
+
+inline void Log::defer(bool _defer) {
+  s_deferred.store(_defer, Concurrency::MemoryOrder::k_relaxed);
+}
+
+inline bool Log::is_deferred() {
+  return s_deferred.load(Concurrency::MemoryOrder::k_relaxed);
+}
+
+inline bool Log::is_observed() const {
+  return !m_queue_event.is_empty() || !m_write_event.is_empty();
+}
+
+inline Log::Arguments::Arguments()
+  : size{0}
 {
 }
 
+template<typename... Ts>
+inline bool Log::Arguments::pack(const Ts&... _arguments) {
+  return (pack_one(_arguments) && ...);
+}
+
+template<typename T>
+inline bool Log::Arguments::pack_one(const T& _argument) {
+  using U = traits::remove_cvref<T>;
+  if constexpr (traits::is_same<U, const char*> || traits::is_same<U, char*>) {
+    return append_string(_argument);
+  } else if constexpr (traits::is_same<U, Float32> || traits::is_same<U, Float64>) {
+    const Float64 value = _argument;
+    return append(k_f64, &value, sizeof value);
+  } else if constexpr (traits::is_enum<U>) {
+    return pack_one(static_cast<traits::underlying_type<U>>(_argument));
+  } else if constexpr (traits::is_integral<U>) {
+    // Integers smaller than int are promoted to int through |...|.
+    if constexpr (sizeof(U) < sizeof(Sint32) || (sizeof(U) == sizeof(Sint32) && traits::is_signed<U>)) {
+      const Sint32 value = _argument;
+      return append(k_s32, &value, sizeof value);
+    } else if constexpr (sizeof(U) == sizeof(Uint32)) {
+      const Uint32 value = _argument;
+      return append(k_u32, &value, sizeof value);
+    } else if constexpr (traits::is_signed<U>) {
+      const Sint64 value = _argument;
+      return append(k_s64, &value, sizeof value);
+    } else {
+      const Uint64 value = _argument;
+      return append(k_u64, &value, sizeof value);
+    }
+  } else if constexpr (!traits::is_same<U, traits::remove_pointer<U>>) {
+    const auto value = reinterpret_cast<UintPtr>(_argument);
+    return append(k_pointer, &value, sizeof value);
+  } else {
+    return false;
+  }
+}
+
 template<typename... Ts>
 inline bool Log::write(Level _level, const char* _format, Ts&&... _arguments) {
   if constexpr (sizeof...(Ts) > 0) {
+    if (is_deferred()) {
+      // The normalized arguments only live until the end of this expression,
+      // |pack| copies anything they point to.
+      Arguments arguments;
+      if (arguments.pack(FormatNormalize<traits::remove_cvref<Ts>>{}(Utility::forward<Ts>(_arguments))...)) {
+        return enqueue(this, _level, _format, arguments);
+      }
+    }
     auto format = String::format(_format, Utility::forward<Ts>(_arguments)...);
     m_queue_event.signal(_level, {format.allocator(), format});
     return enqueue(this, _level, Utility::move(format));
@@ -5,6 +5,7 @@
 
 #include "rx/core/traits/is_trivially_destructible.h"
 #include "rx/core/traits/return_type.h"
+#include "rx/core/traits/remove_cvref.h"
 #include "rx/core/traits/is_same.h"
 
 #include "rx/core/utility/swap.h"
@@ -47,10 +48,10 @@ struct Map {
   V* insert(const K& _key, V&& value_);
   V* insert(const K& _key, const V& _value);
 
-  V* find(const K& _key);
-  const V* find(const K& _key) const;
+  V* find(LookupKey<K> _key);
+  const V* find(LookupKey<K> _key) const;
 
-  bool erase(const K& _key);
+  bool erase(LookupKey<K> _key);
   Size size() const;
   bool is_empty() const;
 
@@ -76,7 +77,7 @@ struct Map {
 private:
   void clear_and_deallocate();
 
-  static Size hash_key(const K& _key);
+  static Size hash_key(LookupKey<K> _key);
   static bool is_deleted(Size _hash);
 
   Size desired_position(Size _hash) const;
@@ -95,7 +96,7 @@ private:
   V* inserter(Size _hash, const K& _key, const V& _value);
   V* inserter(Size _hash, const K& _key, V&& value_);
 
-  bool lookup_index(const K& _key, Size& _index) const;
+  bool lookup_index(LookupKey<K> _key, Size& _index) const;
 
   Memory::Allocator* m_allocator;
 
@@ -269,7 +270,7 @@ inline V* Map<K, V>::insert(const K& _key, const V& _value) {
 }
 
 template<typename K, typename V>
-V* Map<K, V>::find(const K& _key) {
+V* Map<K, V>::find(LookupKey<K> _key) {
   if (Size index; lookup_index(_key, index)) {
     return m_values + index;
   }
@@ -277,7 +278,7 @@ V* Map<K, V>::find(const K& _key) {
 }
 
 template<typename K, typename V>
-const V* Map<K, V>::find(const K& _key) const {
+const V* Map<K, V>::find(LookupKey<K> _key) const {
   if (Size index; lookup_index(_key, index)) {
     return m_values + index;
   }
@@ -285,7 +286,7 @@ const V* Map<K, V>::find(const K& _key) const {
 }
 
 template<typename K, typename V>
-inline bool Map<K, V>::erase(const K& _key) {
+inline bool Map<K, V>::erase(LookupKey<K> _key) {
   if (Size index; lookup_index(_key, index)) {
     if constexpr (!traits::is_trivially_destructible<K>) {
       Utility::destruct<K>(m_keys + index);
@@ -317,8 +318,8 @@ inline bool Map<K, V>::is_empty() const {
 }
 
 template<typename K, typename V>
-inline Size Map<K, V>::hash_key(const K& _key) {
-  auto hash_value{Hash<K>{}(_key)};
+inline Size Map<K, V>::hash_key(LookupKey<K> _key) {
+  auto hash_value{Hash<traits::remove_cvref<LookupKey<K>>>{}(_key)};
 
   // MSB is used to indicate deleted elements
   if constexpr(sizeof hash_value == 8) {
@@ -478,7 +479,7 @@ inline V* Map<K, V>::inserter(Size _hash, const K& _key, const V& _value) {
 }
 
 template<typename K, typename V>
-inline bool Map<K, V>::lookup_index(const K& _key, Size& _index) const {
+inline bool Map<K, V>::lookup_index(LookupKey<K> _key, Size& _index) const {
   const Size hash{hash_key(_key)};
   Size position{desired_position(hash)};
   Size distance{0};
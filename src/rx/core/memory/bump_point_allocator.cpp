@@ -3,6 +3,8 @@
 #include "rx/core/memory/bump_point_allocator.h"
 #include "rx/core/concurrency/scope_lock.h"
 
+#include "rx/core/algorithm/min.h"
+
 #include "rx/core/hints/likely.h"
 #include "rx/core/hints/unlikely.h"
 
@@ -78,8 +80,10 @@ Byte* BumpPointAllocator::reallocate(void* _data, Size _size) {
       // as such copy represents uninitialized memory to the caller anyways.
       //
       // However, since it's possible for the copy to land into ourselves, we
-      // cannot use memcpy here, use memmove instead.
-      memmove(data, _data, _size);
+      // cannot use memcpy here, use memmove instead. The copy must still stop
+      // at the end of the memory given to us.
+      const Size tail{Size(m_data + m_size - static_cast<Byte*>(_data))};
+      memmove(data, _data, Algorithm::min(_size, tail));
       return data;
     } else {
       // Out of memory.
@@ -0,0 +1,167 @@
+#include <string.h> // memcpy
+
+#include "rx/core/memory/frame_allocator.h"
+
+#include "rx/core/concurrency/scope_lock.h"
+
+#include "rx/core/algorithm/min.h"
+
+#include "rx/core/utility/construct.h"
+#include "rx/core/utility/destruct.h"
+
+#include "rx/core/hints/unlikely.h"
+#include "rx/core/hints/likely.h"
+
+#include "rx/core/assert.h"
+
+namespace Rx::Memory {
+
+// Allocations which did not fit in the arena of their frame are prefixed with
+// this header and linked into the overflow list of that frame. |link| points
+// at whatever points at this one so it can be unlinked without knowing which
+// frame it's from.
+struct alignas(Allocator::ALIGNMENT) FrameAllocator::Overflow {
+  Overflow* next;
+  Overflow** link;
+  Size size;
+};
+
+FrameAllocator::FrameAllocator(Allocator& _allocator, Size _size, Size _frames)
+  : m_allocator{_allocator}
+  , m_size{round_to_alignment(_size)}
+  , m_frames{_frames}
+  , m_data{m_allocator.allocate(m_size * m_frames)}
+  , m_index{0}
+  , m_overflow{}
+{
+  RX_ASSERT(m_frames >= 2 && m_frames <= k_max_frames,
+    "_frames must be between 2 and %zu", k_max_frames);
+  RX_ASSERT(m_data, "out of memory");
+
+  for (Size i{0}; i < m_frames; i++) {
+    Utility::construct<BumpPointAllocator>(m_arenas[i].data(),
+      m_data + m_size * i, m_size);
+  }
+}
+
+FrameAllocator::~FrameAllocator() {
+  for (Size i{0}; i < m_frames; i++) {
+    release_overflow(i);
+    Utility::destruct<BumpPointAllocator>(m_arenas[i].data());
+  }
+  m_allocator.deallocate(m_data);
+}
+
+Byte* FrameAllocator::allocate(Size _size) {
+  const Size frame{m_index.load(Concurrency::MemoryOrder::k_acquire)};
+  if (const auto data = arena(frame).allocate(_size); RX_HINT_LIKELY(data)) {
+    return data;
+  }
+  return allocate_overflow(frame, _size);
+}
+
+Byte* FrameAllocator::reallocate(void* _data, Size _size) {
+  if (RX_HINT_UNLIKELY(!_data)) {
+    return allocate(_size);
+  }
+
+  const auto data = reinterpret_cast<Byte*>(_data);
+
+  Size size;
+  if (contains(data)) {
+    // Only the arena of the current frame may still grow in place.
+    const Size frame{m_index.load(Concurrency::MemoryOrder::k_acquire)};
+    const Size owner{Size(data - m_data) / m_size};
+    if (owner == frame) {
+      if (const auto resized = arena(frame).reallocate(_data, _size)) {
+        return resized;
+      }
+    }
+    // The arena has no record of how large the allocation was. It cannot
+    // extend past the end of its arena though.
+    size = m_data + m_size * (owner + 1) - data;
+  } else {
+    size = (reinterpret_cast<Overflow*>(_data) - 1)->size;
+  }
+
+  const auto resized = allocate(_size);
+  if (RX_HINT_UNLIKELY(!resized)) {
+    return nullptr;
+  }
+
+  memcpy(resized, _data, Algorithm::min(size, _size));
+  deallocate(_data);
+
+  return resized;
+}
+
+void FrameAllocator::deallocate(void* _data) {
+  if (RX_HINT_UNLIKELY(!_data)) {
+    return;
+  }
+
+  const auto data = reinterpret_cast<Byte*>(_data);
+  if (RX_HINT_LIKELY(contains(data))) {
+    // Gives the memory back only when it's the last allocation of its arena,
+    // otherwise it waits for the frame to be reset.
+    arena(Size(data - m_data) / m_size).deallocate(_data);
+    return;
+  }
+
+  const auto overflow = reinterpret_cast<Overflow*>(_data) - 1;
+  {
+    Concurrency::ScopeLock locked{m_lock};
+    if ((*overflow->link = overflow->next)) {
+      overflow->next->link = overflow->link;
+    }
+  }
+  m_allocator.deallocate(overflow);
+}
+
+void FrameAllocator::next_frame() {
+  const Size frame{(m_index.load(Concurrency::MemoryOrder::k_relaxed) + 1) % m_frames};
+
+  // Nothing is allocated from the next frame until it's made current, so it can
+  // be reset first.
+  arena(frame).reset();
+  release_overflow(frame);
+
+  m_index.store(frame, Concurrency::MemoryOrder::k_release);
+}
+
+Byte* FrameAllocator::allocate_overflow(Size _frame, Size _size) {
+  const auto overflow =
+    reinterpret_cast<Overflow*>(m_allocator.allocate(sizeof(Overflow) + _size));
+  if (RX_HINT_UNLIKELY(!overflow)) {
+    return nullptr;
+  }
+
+  overflow->size = _size;
+
+  Concurrency::ScopeLock locked{m_lock};
+  auto& head = m_overflow[_frame];
+  if ((overflow->next = head)) {
+    head->link = &overflow->next;
+  }
+  overflow->link = &head;
+  head = overflow;
+
+  return reinterpret_cast<Byte*>(overflow + 1);
+}
+
+void FrameAllocator::release_overflow(Size _frame) {
+  Overflow* overflow;
+  {
+    Concurrency::ScopeLock locked{m_lock};
+    overflow = m_overflow[_frame];
+    m_overflow[_frame] = nullptr;
+  }
+
+  while (overflow) {
+    const auto next = overflow->next;
+    m_allocator.deallocate(overflow);
+    overflow = next;
+  }
+}
+
+} // namespace rx::memory
@@ -0,0 +1,94 @@
+#ifndef RX_CORE_MEMORY_FRAME_ALLOCATOR_H
+#define RX_CORE_MEMORY_FRAME_ALLOCATOR_H
+#include "rx/core/memory/bump_point_allocator.h"
+#include "rx/core/memory/uninitialized_storage.h"
+
+#include "rx/core/concurrency/atomic.h"
+
+namespace Rx::Memory {
+
+// # Frame Allocator
+//
+// Allocator for data which only lives for a frame or so.
+//
+// Every frame has its own |BumpPointAllocator| and |next_frame| moves on to
+// the next one, resetting it. There are |frames()| of these used round-robin,
+// so anything allocated stays valid until |next_frame| has been called that
+// many times, which is what lets another thread, or the backend, still read
+// the data of the previous frame while the current one is being recorded.
+//
+// Allocating is a pointer bump and deallocating is mostly nothing at all, the
+// memory is all given back at once when the frame comes around again. When a
+// frame runs out of room, allocations spill over to the wrapped allocator and
+// are freed along with the frame.
+struct RX_API FrameAllocator
+  final : Allocator
+{
+  static inline constexpr const Size k_max_frames = 4;
+
+  // Every frame gets |_size| bytes from one allocation of |_allocator|.
+  FrameAllocator(Allocator& _allocator, Size _size, Size _frames);
+  ~FrameAllocator();
+
+  virtual Byte* allocate(Size _size);
+  virtual Byte* reallocate(void* _data, Size _size);
+  virtual void deallocate(void* _data);
+
+  // Ends the current frame. Everything allocated |frames()| frames ago is
+  // released.
+  void next_frame();
+
+  Size frames() const;
+  Size size() const;
+  Size used() const;
+
+private:
+  struct Overflow;
+
+  BumpPointAllocator& arena(Size _frame);
+  const BumpPointAllocator& arena(Size _frame) const;
+
+  Byte* allocate_overflow(Size _frame, Size _size);
+  void release_overflow(Size _frame);
+
+  bool contains(const Byte* _data) const;
+
+  Allocator& m_allocator;
+  Size m_size;
+  Size m_frames;
+  Byte* m_data;
+  Concurrency::Atomic<Size> m_index;
+
+  UninitializedStorage<sizeof(BumpPointAllocator), alignof(BumpPointAllocator)> m_arenas[k_max_frames];
+
+  Concurrency::SpinLock m_lock;
+  Overflow* m_overflow[k_max_frames] RX_HINT_GUARDED_BY(m_lock);
+};
+
+inline Size FrameAllocator::frames() const {
+  return m_frames;
+}
+
+inline Size FrameAllocator::size() const {
+  return m_size;
+}
+
+inline Size FrameAllocator::used() const {
+  return arena(m_index.load(Concurrency::MemoryOrder::k_relaxed)).used();
+}
+
+inline BumpPointAllocator& FrameAllocator::arena(Size _frame) {
+  return *reinterpret_cast<BumpPointAllocator*>(m_arenas[_frame].data());
+}
+
+inline const BumpPointAllocator& FrameAllocator::arena(Size _frame) const {
+  return *reinterpret_cast<const BumpPointAllocator*>(m_arenas[_frame].data());
+}
+
+inline bool FrameAllocator::contains(const Byte* _data) const {
+  return _data >= m_data && _data < m_data + m_size * m_frames;
+}
+
+} // namespace rx::memory
+
+#endif // RX_CORE_MEMORY_FRAME_ALLOCATOR_H
@@ -1,6 +1,4 @@
 #include "rx/core/memory/stats_allocator.h"
-#include "rx/core/concurrency/scope_lock.h"
-#include "rx/core/algorithm/max.h"
 #include "rx/core/hints/unlikely.h"
 #include "rx/core/assert.h"
 
@@ -22,6 +20,64 @@ static constexpr inline Size actual_bytes_for_request(Size _request_bytes) {
   return Allocator::round_to_alignment(_request_bytes + sizeof(Header));
 }
 
+// Shards are handed out to threads round-robin on first use. The index is
+// stored plus one so zero-initialization means unassigned.
+static Concurrency::Atomic<Size> s_next_shard{0};
+static thread_local Size t_shard;
+
+static constexpr const auto k_relaxed{Concurrency::MemoryOrder::k_relaxed};
+
+// The byte counters hold wrapped-around differences, read them signed.
+static inline Sint64 as_signed(Uint64 _value) {
+  return static_cast<Sint64>(_value);
+}
+
+static inline bool should_flush(Uint64 _pending) {
+  const Sint64 pending{as_signed(_pending)};
+  return pending > Sint64(StatsAllocator::k_flush_bytes)
+    || pending < -Sint64(StatsAllocator::k_flush_bytes);
+}
+
+template<typename T>
+static inline void raise_peak(T& bytes_, Uint64 _used) {
+  Uint64 peak{bytes_.peak.load(k_relaxed)};
+  while (as_signed(_used) > as_signed(peak)
+    && !bytes_.peak.compare_exchange_weak(peak, _used, k_relaxed))
+  {
+  }
+}
+
+template<typename T>
+static inline void publish(T& bytes_, Uint64 _delta) {
+  raise_peak(bytes_, bytes_.used.fetch_add(_delta, k_relaxed) + _delta);
+}
+
+StatsAllocator::Shard& StatsAllocator::shard() {
+  if (RX_HINT_UNLIKELY(t_shard == 0)) {
+    t_shard = s_next_shard.fetch_add(1, k_relaxed) % k_shards + 1;
+  }
+  return m_shards[t_shard - 1];
+}
+
+void StatsAllocator::update(Shard& shard_, Uint64 _request_delta, Uint64 _actual_delta) {
+  const Uint64 request{shard_.request_bytes.fetch_add(_request_delta, k_relaxed) + _request_delta};
+  const Uint64 actual{shard_.actual_bytes.fetch_add(_actual_delta, k_relaxed) + _actual_delta};
+  if (RX_HINT_UNLIKELY(should_flush(request) || should_flush(actual))) {
+    publish(m_request_bytes, shard_.request_bytes.exchange(0, k_relaxed));
+    publish(m_actual_bytes, shard_.actual_bytes.exchange(0, k_relaxed));
+    return;
+  }
+
+  // What this shard holds on to counts towards the peaks too. Only growth
+  // can raise them.
+  if (as_signed(_request_delta) > 0) {
+    raise_peak(m_request_bytes, m_request_bytes.used.load(k_relaxed) + request);
+  }
+  if (as_signed(_actual_delta) > 0) {
+    raise_peak(m_actual_bytes, m_actual_bytes.used.load(k_relaxed) + actual);
+  }
+}
+
 Byte* StatsAllocator::allocate(Size _request_bytes) {
   const auto actual_bytes = actual_bytes_for_request(_request_bytes);
   const auto base = m_allocator.allocate(actual_bytes);
@@ -33,14 +89,11 @@ Byte* StatsAllocator::allocate(Size _request_bytes) {
   header->request_bytes = _request_bytes;
 
   const auto aligned = reinterpret_cast<Byte*>(header + 1);
-  {
-    Concurrency::ScopeLock locked{m_lock};
-    m_statistics.allocations++;
-    m_statistics.used_request_bytes += _request_bytes;
-    m_statistics.used_actual_bytes += actual_bytes;
-    m_statistics.peak_request_bytes = Algorithm::max(m_statistics.peak_request_bytes, m_statistics.used_request_bytes);
-    m_statistics.peak_actual_bytes = Algorithm::max(m_statistics.peak_actual_bytes, m_statistics.used_actual_bytes);
-  }
+
+  auto& counters = shard();
+  counters.allocations.fetch_add(1, k_relaxed);
+  update(counters, _request_bytes, actual_bytes);
+
   return aligned;
 }
 
@@ -64,17 +117,15 @@ Byte* StatsAllocator::reallocate(void* _data, Size _new_request_bytes) {
   new_header->request_bytes = _new_request_bytes;
 
   const auto aligned = reinterpret_cast<Byte*>(new_header + 1);
-  {
-    Concurrency::ScopeLock locked{m_lock};
-    m_statistics.request_reallocations++;
-    if (new_base == old_base) {
-      m_statistics.actual_reallocations++;
-    }
-    m_statistics.used_request_bytes -= old_request_bytes;
-    m_statistics.used_actual_bytes -= old_actual_bytes;
-    m_statistics.used_request_bytes += _new_request_bytes;
-    m_statistics.used_actual_bytes += new_actual_bytes;
+
+  auto& counters = shard();
+  counters.request_reallocations.fetch_add(1, k_relaxed);
+  if (new_base == old_base) {
+    counters.actual_reallocations.fetch_add(1, k_relaxed);
   }
+  update(counters,
+    Uint64{_new_request_bytes} - old_request_bytes,
+    Uint64{new_actual_bytes} - old_actual_bytes);
 
   return aligned;
 }
@@ -89,20 +140,40 @@ void StatsAllocator::deallocate(void* _data) {
   const auto old_actual_bytes = actual_bytes_for_request(old_request_bytes);
   const auto old_base = reinterpret_cast<Byte*>(old_header);
 
-  {
-    Concurrency::ScopeLock locked{m_lock};
-    m_statistics.deallocations++;
-    m_statistics.used_request_bytes -= old_request_bytes;
-    m_statistics.used_actual_bytes -= old_actual_bytes;
-  }
+  auto& counters = shard();
+  counters.deallocations.fetch_add(1, k_relaxed);
+  update(counters, Uint64{0} - old_request_bytes, Uint64{0} - old_actual_bytes);
 
   m_allocator.deallocate(old_base);
 }
 
 StatsAllocator::Statistics StatsAllocator::stats() const {
-  // Hold a lock and make an entire copy of the structure atomically
-  Concurrency::ScopeLock locked{m_lock};
-  return m_statistics;
+  // Merge the shards with what has already been published. While other threads
+  // are allocating this is only a close approximation.
+  Statistics result{};
+  Uint64 request_bytes{m_request_bytes.used.load(k_relaxed)};
+  Uint64 actual_bytes{m_actual_bytes.used.load(k_relaxed)};
+  for (Size i{0}; i < k_shards; i++) {
+    const Shard& shard{m_shards[i]};
+    result.allocations += shard.allocations.load(k_relaxed);
+    result.request_reallocations += shard.request_reallocations.load(k_relaxed);
+    result.actual_reallocations += shard.actual_reallocations.load(k_relaxed);
+    result.deallocations += shard.deallocations.load(k_relaxed);
+    request_bytes += shard.request_bytes.load(k_relaxed);
+    actual_bytes += shard.actual_bytes.load(k_relaxed);
+  }
+
+  result.used_request_bytes = request_bytes;
+  result.used_actual_bytes = actual_bytes;
+
+  const Uint64 peak_request_bytes{m_request_bytes.peak.load(k_relaxed)};
+  const Uint64 peak_actual_bytes{m_actual_bytes.peak.load(k_relaxed)};
+  result.peak_request_bytes = as_signed(request_bytes) > as_signed(peak_request_bytes)
+    ? request_bytes : peak_request_bytes;
+  result.peak_actual_bytes = as_signed(actual_bytes) > as_signed(peak_actual_bytes)
+    ? actual_bytes : peak_actual_bytes;
+
+  return result;
 }
 
 } // namespace rx::memory
@@ -1,7 +1,7 @@
 #ifndef RX_CORE_MEMORY_STATS_ALLOCATOR_H
 #define RX_CORE_MEMORY_STATS_ALLOCATOR_H
 #include "rx/core/memory/allocator.h"
-#include "rx/core/concurrency/spin_lock.h"
+#include "rx/core/concurrency/atomic.h"
 
 namespace Rx::Memory {
 
@@ -13,6 +13,17 @@ namespace Rx::Memory {
 //
 // The purpose of this allocator is to provide a means to debug and track
 // information about any allocator.
+//
+// Counting happens in one of |k_shards| cache-line sized shards picked per
+// thread, so threads allocating at the same time don't contend on one lock or
+// cache line. The shards are merged when |stats| is called. Each shard holds
+// on to up to |k_flush_bytes| of change in used bytes before publishing it.
+//
+// The peaks are raised with what's published plus what the shard making the
+// change holds on to, so they're exact when one thread allocates at a time.
+// When threads allocate at the same time what the other shards hold on to
+// isn't seen, which is never more than |k_flush_bytes| each. The counts and
+// used bytes are exact once no other thread is allocating.
 struct RX_API StatsAllocator
   final : Allocator
 {
@@ -41,15 +52,37 @@ struct RX_API StatsAllocator
 
   Statistics stats() const;
 
+  static inline constexpr const Size k_shards = 16;
+  static inline constexpr const Uint64 k_flush_bytes = 16 << 10;
+
 private:
+  // The byte counters are changes in used bytes not yet published, they wrap
+  // around when more has been freed than allocated through the shard.
+  struct alignas(64) Shard {
+    Concurrency::Atomic<Size> allocations{0};
+    Concurrency::Atomic<Size> request_reallocations{0};
+    Concurrency::Atomic<Size> actual_reallocations{0};
+    Concurrency::Atomic<Size> deallocations{0};
+    Concurrency::Atomic<Uint64> request_bytes{0};
+    Concurrency::Atomic<Uint64> actual_bytes{0};
+  };
+
+  struct Bytes {
+    Concurrency::Atomic<Uint64> used{0};
+    Concurrency::Atomic<Uint64> peak{0};
+  };
+
+  Shard& shard();
+  void update(Shard& shard_, Uint64 _request_delta, Uint64 _actual_delta);
+
   Allocator& m_allocator;
-  mutable Concurrency::SpinLock m_lock;
-  Statistics m_statistics RX_HINT_GUARDED_BY(m_lock);
+  Shard m_shards[k_shards];
+  Bytes m_request_bytes;
+  Bytes m_actual_bytes;
 };
 
 inline constexpr StatsAllocator::StatsAllocator(Allocator& _allocator)
   : m_allocator{_allocator}
-  , m_statistics{}
 {
 }
 
@@ -5,10 +5,11 @@
 namespace Rx::Memory {
 
 SystemAllocator::SystemAllocator()
+  : m_cache_allocator{HeapAllocator::instance()}
 #if defined(RX_ESAN)
-  : m_stats_allocator{ElectricFenceAllocator::instance()}
+  , m_stats_allocator{ElectricFenceAllocator::instance()}
 #else
-  : m_stats_allocator{HeapAllocator::instance()}
+  , m_stats_allocator{m_cache_allocator}
 #endif
 {
 }
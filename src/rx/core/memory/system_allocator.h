@@ -1,6 +1,7 @@
 #ifndef RX_CORE_MEMORY_SYSTEM_ALLOCATOR_H
 #define RX_CORE_MEMORY_SYSTEM_ALLOCATOR_H
 #include "rx/core/memory/stats_allocator.h"
+#include "rx/core/memory/thread_cache_allocator.h"
 
 #include "rx/core/global.h"
 
@@ -12,6 +13,10 @@ namespace Rx::Memory {
 // allocator to track global system allocations. When something isn't provided
 // an allocator, this is the allocator used. More specifically, the global
 // g_system_allocator is used.
+//
+// Small allocations are served from per-thread caches by a thread cache
+// allocator in front of the heap allocator. When built with RX_ESAN the cache
+// is skipped so every allocation still gets its own fenced pages.
 struct RX_API SystemAllocator
   final : Allocator
 {
@@ -26,6 +31,7 @@ struct RX_API SystemAllocator
   static constexpr Allocator& instance();
 
 private:
+  ThreadCacheAllocator m_cache_allocator;
   StatsAllocator m_stats_allocator;
 
   static Global<SystemAllocator> s_instance;
@@ -0,0 +1,396 @@
+#include <string.h> // memcpy
+
+#include "rx/core/memory/thread_cache_allocator.h"
+
+#include "rx/core/concurrency/scope_lock.h"
+
+#include "rx/core/algorithm/clamp.h"
+#include "rx/core/algorithm/min.h"
+
+#include "rx/core/utility/bit.h"
+
+#include "rx/core/hints/unlikely.h"
+#include "rx/core/hints/likely.h"
+
+namespace Rx::Memory {
+
+// Every block is prefixed with this header. Blocks too large for a size class
+// record |k_large| and the size that was asked for, since that's needed to
+// copy them somewhere else. Blocks of a size class record the chunk they're
+// in, which is written once when the chunk is carved.
+struct alignas(Allocator::ALIGNMENT) Header {
+  Size size_class;
+  union {
+    Size size;
+    void* chunk;
+  };
+};
+
+static_assert(sizeof(Header) == Allocator::ALIGNMENT);
+
+// Free blocks are linked through their first bytes, which leaves
+// |Header::chunk| alone.
+struct Node {
+  Node* next;
+};
+
+static_assert(sizeof(Node) == sizeof(Size));
+
+// Every chunk starts with this, the blocks follow it.
+struct ThreadCacheAllocator::Chunk {
+  Chunk* prev;
+  Chunk* next;
+  Node* free;
+  Size free_count;
+};
+
+static constexpr const Size k_chunk_header{
+  Allocator::round_to_alignment(sizeof(ThreadCacheAllocator::Chunk))};
+
+static constexpr const Size k_large{ThreadCacheAllocator::k_classes};
+
+// Free lists of the calling thread. This is zero-initialized so it needs no
+// constructor or destructor to run.
+static thread_local struct {
+  ThreadCacheAllocator* owner;
+  struct {
+    Node* head;
+    Size count;
+  } lists[ThreadCacheAllocator::k_classes];
+} t_cache;
+
+// Size classes are every 16 bytes up to 128 bytes, then four evenly spaced
+// classes between every power of two after that, up to |k_max_block|. The sizes
+// here include the header.
+static inline Size class_of(Size _block_size) {
+  if (_block_size <= 128) {
+    return _block_size <= 32 ? 0 : _block_size / 16 - 2;
+  }
+  const Size bit{bit_search_msb(Uint64{_block_size - 1})};
+  return 7 + (bit - 7) * 4 + ((_block_size - 1 - (Size{1} << bit)) >> (bit - 2));
+}
+
+static inline Size block_size_of(Size _class) {
+  if (_class < 7) {
+    return (_class + 2) * 16;
+  }
+  const Size bit{7 + (_class - 7) / 4};
+  return (Size{1} << bit) + ((_class - 7) % 4 + 1) * (Size{1} << (bit - 2));
+}
+
+static_assert(ThreadCacheAllocator::k_max_block == 2048 && ThreadCacheAllocator::k_classes == 23,
+  "size classes no longer cover k_max_block");
+
+// Number of blocks moved between a thread and the central list at once. About
+// 16 KiB worth of blocks, but never fewer than 8 or more than 64.
+static inline Size batch_of(Size _class) {
+  return Algorithm::clamp(Size{16 << 10} / block_size_of(_class), Size{8}, Size{64});
+}
+
+static inline Size blocks_of(Size _class) {
+  return (ThreadCacheAllocator::k_chunk_size - k_chunk_header) / block_size_of(_class);
+}
+
+template<typename T>
+static inline void link(T*& head_, T* _node) {
+  _node->prev = nullptr;
+  _node->next = head_;
+  if (head_) {
+    head_->prev = _node;
+  }
+  head_ = _node;
+}
+
+template<typename T>
+static inline void unlink(T*& head_, T* _node) {
+  if (_node->prev) {
+    _node->prev->next = _node->next;
+  } else {
+    head_ = _node->next;
+  }
+  if (_node->next) {
+    _node->next->prev = _node->prev;
+  }
+}
+
+// Unlinks up to |_count| nodes from the front of |head_|.
+static inline Node* take(Node*& head_, Size _count, Size& count_) {
+  Node* head{head_};
+  Node* tail{head};
+  count_ = 1;
+  while (count_ < _count && tail->next) {
+    tail = tail->next;
+    count_++;
+  }
+  head_ = tail->next;
+  tail->next = nullptr;
+  return head;
+}
+
+// Claims the thread cache for |_allocator| if no allocator has it yet.
+static inline bool owns_cache(ThreadCacheAllocator* _allocator) {
+  if (RX_HINT_LIKELY(t_cache.owner == _allocator)) {
+    return true;
+  }
+  if (!t_cache.owner) {
+    t_cache.owner = _allocator;
+    return true;
+  }
+  return false;
+}
+
+ThreadCacheAllocator::ThreadCacheAllocator(Allocator& _allocator)
+  : m_allocator{_allocator}
+{
+}
+
+ThreadCacheAllocator::~ThreadCacheAllocator() {
+  // Blocks cached by the calling thread are in the chunks about to be freed.
+  if (t_cache.owner == this) {
+    t_cache = {};
+  }
+
+  for (auto& central_ : m_central) {
+    Concurrency::ScopeLock locked{central_.lock};
+    auto deallocate_all = [this](Chunk* _chunk) {
+      while (_chunk) {
+        const auto next = _chunk->next;
+        m_allocator.deallocate(_chunk);
+        _chunk = next;
+      }
+    };
+    deallocate_all(central_.partial);
+    deallocate_all(central_.full);
+    central_.partial = nullptr;
+    central_.full = nullptr;
+    central_.empty = 0;
+  }
+}
+
+Byte* ThreadCacheAllocator::allocate(Size _size) {
+  const Size block_size{round_to_alignment(_size + sizeof(Header))};
+  if (RX_HINT_UNLIKELY(block_size > k_max_block)) {
+    const auto header = reinterpret_cast<Header*>(m_allocator.allocate(block_size));
+    if (RX_HINT_UNLIKELY(!header)) {
+      return nullptr;
+    }
+    header->size_class = k_large;
+    header->size = _size;
+    return reinterpret_cast<Byte*>(header + 1);
+  }
+
+  const Size size_class{class_of(block_size)};
+
+  Byte* block;
+  if (RX_HINT_LIKELY(owns_cache(this))) {
+    auto& list = t_cache.lists[size_class];
+    if (RX_HINT_UNLIKELY(!list.head)) {
+      list.head = static_cast<Node*>(refill(size_class, batch_of(size_class), list.count));
+      if (RX_HINT_UNLIKELY(!list.head)) {
+        return nullptr;
+      }
+    }
+    const auto node = list.head;
+    list.head = node->next;
+    list.count--;
+    block = reinterpret_cast<Byte*>(node);
+  } else {
+    // Without a cache blocks come from the central lists one at a time.
+    Size count;
+    if (!(block = static_cast<Byte*>(refill(size_class, 1, count)))) {
+      return nullptr;
+    }
+  }
+
+  const auto header = reinterpret_cast<Header*>(block);
+  header->size_class = size_class;
+  return reinterpret_cast<Byte*>(header + 1);
+}
+
+Byte* ThreadCacheAllocator::reallocate(void* _data, Size _size) {
+  if (RX_HINT_UNLIKELY(!_data)) {
+    return allocate(_size);
+  }
+
+  const auto header = reinterpret_cast<Header*>(_data) - 1;
+  const Size size_class{header->size_class};
+  const Size block_size{round_to_alignment(_size + sizeof(Header))};
+
+  Size old_size;
+  if (size_class == k_large) {
+    // Large blocks that stay large are left to the wrapped allocator.
+    if (block_size > k_max_block) {
+      const auto resized = reinterpret_cast<Header*>(m_allocator.reallocate(header, block_size));
+      if (RX_HINT_UNLIKELY(!resized)) {
+        return nullptr;
+      }
+      resized->size = _size;
+      return reinterpret_cast<Byte*>(resized + 1);
+    }
+    old_size = header->size;
+  } else {
+    // Still fits the same size class.
+    if (block_size <= k_max_block && class_of(block_size) == size_class) {
+      return reinterpret_cast<Byte*>(_data);
+    }
+    old_size = block_size_of(size_class) - sizeof(Header);
+  }
+
+  const auto data = allocate(_size);
+  if (RX_HINT_UNLIKELY(!data)) {
+    return nullptr;
+  }
+
+  memcpy(data, _data, Algorithm::min(old_size, _size));
+  deallocate(_data);
+
+  return data;
+}
+
+void ThreadCacheAllocator::deallocate(void* _data) {
+  if (RX_HINT_UNLIKELY(!_data)) {
+    return;
+  }
+
+  const auto header = reinterpret_cast<Header*>(_data) - 1;
+  const Size size_class{header->size_class};
+  if (RX_HINT_UNLIKELY(size_class == k_large)) {
+    m_allocator.deallocate(header);
+    return;
+  }
+
+  const auto node = reinterpret_cast<Node*>(header);
+  if (RX_HINT_UNLIKELY(!owns_cache(this))) {
+    node->next = nullptr;
+    release(size_class, node);
+    return;
+  }
+
+  auto& list = t_cache.lists[size_class];
+  node->next = list.head;
+  list.head = node;
+
+  // Holding more than two batches, give one back.
+  const Size batch{batch_of(size_class)};
+  if (RX_HINT_UNLIKELY(++list.count > batch * 2)) {
+    Size count;
+    const auto head = take(list.head, batch, count);
+    list.count -= count;
+    release(size_class, head);
+  }
+}
+
+void ThreadCacheAllocator::release_thread_cache() {
+  const auto owner = t_cache.owner;
+  if (!owner) {
+    return;
+  }
+
+  for (Size i{0}; i < k_classes; i++) {
+    if (const auto head = t_cache.lists[i].head) {
+      owner->release(i, head);
+    }
+  }
+
+  t_cache = {};
+}
+
+// Takes up to |_count| blocks of |_class| from the first chunk with any free.
+void* ThreadCacheAllocator::refill(Size _class, Size _count, Size& count_) {
+  Central& central{m_central[_class]};
+
+  Concurrency::ScopeLock locked{central.lock};
+  if (RX_HINT_UNLIKELY(!central.partial)) {
+    // Carved with the lock held so two threads that both find no free blocks
+    // don't carve a chunk each.
+    const auto chunk = carve(_class);
+    if (RX_HINT_UNLIKELY(!chunk)) {
+      return nullptr;
+    }
+    link(central.partial, chunk);
+    central.empty++;
+  }
+
+  const auto chunk = central.partial;
+  if (chunk->free_count == blocks_of(_class)) {
+    central.empty--;
+  }
+
+  const auto batch = take(chunk->free, _count, count_);
+  chunk->free_count -= count_;
+
+  if (!chunk->free) {
+    unlink(central.partial, chunk);
+    link(central.full, chunk);
+  }
+
+  return batch;
+}
+
+// Splits a new chunk into blocks of |_class|, all of them free.
+ThreadCacheAllocator::Chunk* ThreadCacheAllocator::carve(Size _class) {
+  const auto data = m_allocator.allocate(k_chunk_size);
+  if (RX_HINT_UNLIKELY(!data)) {
+    return nullptr;
+  }
+
+  const auto chunk = reinterpret_cast<Chunk*>(data);
+  const Size block_size{block_size_of(_class)};
+  const Size blocks{blocks_of(_class)};
+
+  Byte* first{data + k_chunk_header};
+  for (Size i{0}; i < blocks; i++) {
+    const auto header = reinterpret_cast<Header*>(first + block_size * i);
+    header->chunk = chunk;
+    reinterpret_cast<Node*>(header)->next = i + 1 < blocks
+      ? reinterpret_cast<Node*>(first + block_size * (i + 1)) : nullptr;
+  }
+
+  chunk->free = reinterpret_cast<Node*>(first);
+  chunk->free_count = blocks;
+
+  return chunk;
+}
+
+// Gives the blocks linked from |_head| back to the chunks they're in. Chunks
+// with every block back are given back to the wrapped allocator, all but one.
+void ThreadCacheAllocator::release(Size _class, void* _head) {
+  Central& central{m_central[_class]};
+  const Size blocks{blocks_of(_class)};
+
+  // Chunks to give back once the lock is released, linked through |next|.
+  Chunk* unused{nullptr};
+  {
+    Concurrency::ScopeLock locked{central.lock};
+    auto node = static_cast<Node*>(_head);
+    while (node) {
+      const auto next = node->next;
+      const auto chunk = static_cast<Chunk*>(reinterpret_cast<Header*>(node)->chunk);
+
+      if (!chunk->free) {
+        unlink(central.full, chunk);
+        link(central.partial, chunk);
+      }
+
+      node->next = chunk->free;
+      chunk->free = node;
+
+      if (++chunk->free_count == blocks && ++central.empty > 1) {
+        unlink(central.partial, chunk);
+        central.empty--;
+        chunk->next = unused;
+        unused = chunk;
+      }
+
+      node = next;
+    }
+  }
+
+  while (unused) {
+    const auto next = unused->next;
+    m_allocator.deallocate(unused);
+    unused = next;
+  }
+}
+
+} // namespace rx::memory
@@ -0,0 +1,76 @@
+#ifndef RX_CORE_MEMORY_THREAD_CACHE_ALLOCATOR_H
+#define RX_CORE_MEMORY_THREAD_CACHE_ALLOCATOR_H
+#include "rx/core/memory/allocator.h"
+#include "rx/core/concurrency/spin_lock.h"
+
+namespace Rx::Memory {
+
+// # Thread Cache Allocator
+//
+// Wraps an existing allocator and keeps free lists of small blocks for every
+// thread, so most small allocations and deallocations never take a lock.
+//
+// Small allocations are rounded up to one of |k_classes| size classes. Every
+// thread has a free list for each size class which it allocates from and frees
+// into without synchronization. When a thread's list runs out it's refilled
+// with a batch of blocks from the central lists for that size class, and when
+// it holds more than two batches, a batch is released back to them. Only the
+// central lists are locked, one lock per size class.
+//
+// Blocks are carved from |k_chunk_size| chunks of the wrapped allocator, every
+// chunk holds blocks of one size class and has a central list of its own. Once
+// every block of a chunk is back on it's list the chunk is given back to the
+// wrapped allocator, except for one such chunk per size class which is kept so
+// that a size class going back and forth around a chunk's worth of blocks
+// doesn't allocate and free a chunk every time.
+//
+// Allocations larger than |k_max_block| go to the wrapped allocator directly.
+//
+// A thread caches for the first thread cache allocator it uses, any other one
+// it uses goes to the central lists every time. Threads made with
+// |Concurrency::Thread| give their cached blocks back when they finish, others
+// can call |release_thread_cache| themselves.
+//
+// Blocks cached by a thread keep their chunk from being given back until the
+// thread gives them back too. This must outlive every thread that used it.
+struct RX_API ThreadCacheAllocator
+  final : Allocator
+{
+  ThreadCacheAllocator(Allocator& _allocator);
+  ~ThreadCacheAllocator();
+
+  virtual Byte* allocate(Size _size);
+  virtual Byte* reallocate(void* _data, Size _size);
+  virtual void deallocate(void* _data);
+
+  // Give every block cached by the calling thread back to the central lists.
+  static void release_thread_cache();
+
+  static inline constexpr const Size k_classes = 23;
+  static inline constexpr const Size k_max_block = 2048;
+  static inline constexpr const Size k_chunk_size = 64 << 10;
+
+  // The start of a chunk, defined where it's used.
+  struct Chunk;
+
+private:
+  // Chunks with free blocks are on |partial|, the rest are on |full|. Of the
+  // chunks on |partial|, |empty| have every block free.
+  struct alignas(64) Central {
+    Concurrency::SpinLock lock;
+    Chunk* partial RX_HINT_GUARDED_BY(lock) = nullptr;
+    Chunk* full RX_HINT_GUARDED_BY(lock) = nullptr;
+    Size empty RX_HINT_GUARDED_BY(lock) = 0;
+  };
+
+  void* refill(Size _class, Size _count, Size& count_);
+  Chunk* carve(Size _class);
+  void release(Size _class, void* _head);
+
+  Allocator& m_allocator;
+  Central m_central[k_classes];
+};
+
+} // namespace rx::memory
+
+#endif // RX_CORE_MEMORY_THREAD_CACHE_ALLOCATOR_H
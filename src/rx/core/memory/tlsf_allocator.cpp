@@ -0,0 +1,279 @@
+#include <string.h> // memcpy
+
+#include "rx/core/memory/tlsf_allocator.h"
+
+#include "rx/core/concurrency/scope_lock.h"
+
+#include "rx/core/utility/bit.h"
+
+#include "rx/core/hints/unlikely.h"
+#include "rx/core/hints/likely.h"
+
+#include "rx/core/assert.h"
+
+namespace Rx::Memory {
+
+// Every block in the region starts with |prev| and |size|. The low bit of
+// |size| is set when the block is free, the rest is the size of the block
+// including this header. Free blocks also link into their list through the
+// bytes after |size|, which are the first bytes of what would otherwise be the
+// allocation, or padding of the header where |Size| is smaller than 8 bytes.
+struct Block {
+  Block* prev;
+  Size size;
+  Block* next_free;
+  Block* prev_free;
+};
+
+static constexpr const Size k_header{Allocator::ALIGNMENT};
+static constexpr const Size k_min_block{sizeof(Block)};
+static constexpr const Size k_max_block{(Size{1} << TLSFAllocator::k_fl_max) - 1};
+
+static_assert(sizeof(Block::prev) + sizeof(Block::size) <= k_header,
+  "header doesn't fit in |ALIGNMENT|");
+static_assert(TLSFAllocator::k_fl_shift - TLSFAllocator::k_sl_shift == 4,
+  "small lists must be |ALIGNMENT| apart");
+
+static inline Size size_of(const Block* _block) {
+  return _block->size & ~Size{1};
+}
+
+static inline bool is_free(const Block* _block) {
+  return _block->size & 1;
+}
+
+static inline Block* next(Block* _block) {
+  return reinterpret_cast<Block*>(reinterpret_cast<Byte*>(_block) + size_of(_block));
+}
+
+static inline void resize(Block* block_, Size _size, bool _free) {
+  block_->size = _size | (_free ? 1 : 0);
+}
+
+// Finds the list |_size| belongs in.
+static inline void map(Size _size, Size& fl_, Size& sl_) {
+  if (_size < TLSFAllocator::k_small_size) {
+    fl_ = 0;
+    sl_ = _size / Allocator::ALIGNMENT;
+  } else {
+    const Size bit{bit_search_msb(Uint64{_size})};
+    fl_ = bit - (TLSFAllocator::k_fl_shift - 1);
+    sl_ = (_size >> (bit - TLSFAllocator::k_sl_shift)) ^ TLSFAllocator::k_sl_count;
+  }
+}
+
+// Size of the block needed for an allocation of |_size|.
+static inline Size block_size_for(Size _size) {
+  const Size size{Allocator::round_to_alignment(_size) + k_header};
+  return size < k_min_block ? k_min_block : size;
+}
+
+TLSFAllocator::TLSFAllocator(Byte* _data, Size _size)
+  : m_fl_bitmap{0}
+  , m_sl_bitmap{}
+  , m_lists{}
+{
+  // Ensure |_data| and |_size| are multiples of |ALIGNMENT|.
+  RX_ASSERT(reinterpret_cast<UintPtr>(_data) % ALIGNMENT == 0,
+    "_data not aligned on %zu-byte boundary", ALIGNMENT);
+  RX_ASSERT(_size % ALIGNMENT == 0,
+    "_size not a multiple of %zu", ALIGNMENT);
+
+  // Room for one block and the sentinel after it.
+  RX_ASSERT(_size >= k_min_block + k_header, "_size too small");
+  RX_ASSERT(_size - k_header <= k_max_block, "_size too large");
+
+  // One free block covering everything but the sentinel at the end. The
+  // sentinel is a used, empty block so nothing ever merges past the end.
+  const auto block = reinterpret_cast<Block*>(_data);
+  block->prev = nullptr;
+  resize(block, _size - k_header, true);
+
+  const auto sentinel = next(block);
+  sentinel->prev = block;
+  resize(sentinel, 0, false);
+
+  insert(block);
+}
+
+Byte* TLSFAllocator::allocate(Size _size) {
+  Concurrency::ScopeLock lock{m_lock};
+  return allocate_unlocked(_size);
+}
+
+Byte* TLSFAllocator::reallocate(void* _data, Size _size) {
+  Concurrency::ScopeLock lock{m_lock};
+
+  if (RX_HINT_UNLIKELY(!_data)) {
+    return allocate_unlocked(_size);
+  }
+
+  if (RX_HINT_UNLIKELY(_size > k_max_block - k_header)) {
+    return nullptr;
+  }
+
+  const auto block = reinterpret_cast<Block*>(reinterpret_cast<Byte*>(_data) - k_header);
+  const Size size{block_size_for(_size)};
+
+  // Grow into the next block when it's free and large enough.
+  const auto after = next(block);
+  if (size > size_of(block) && is_free(after) && size_of(block) + size_of(after) >= size) {
+    remove(after);
+    resize(block, size_of(block) + size_of(after), false);
+    next(block)->prev = block;
+  }
+
+  if (size <= size_of(block)) {
+    // Give back what is left over when it's enough for a block of its own.
+    if (size_of(block) - size >= k_min_block) {
+      const auto rest = reinterpret_cast<Block*>(reinterpret_cast<Byte*>(block) + size);
+      rest->prev = block;
+      resize(rest, size_of(block) - size, false);
+      next(rest)->prev = rest;
+      resize(block, size, false);
+      deallocate_unlocked(reinterpret_cast<Byte*>(rest) + k_header);
+    }
+    return reinterpret_cast<Byte*>(_data);
+  }
+
+  const auto data = allocate_unlocked(_size);
+  if (RX_HINT_LIKELY(data)) {
+    memcpy(data, _data, size_of(block) - k_header);
+    deallocate_unlocked(_data);
+  }
+
+  return data;
+}
+
+void TLSFAllocator::deallocate(void* _data) {
+  Concurrency::ScopeLock lock{m_lock};
+  deallocate_unlocked(_data);
+}
+
+Byte* TLSFAllocator::allocate_unlocked(Size _size) {
+  if (RX_HINT_UNLIKELY(_size > k_max_block - k_header)) {
+    return nullptr;
+  }
+
+  const Size size{block_size_for(_size)};
+  const auto block = reinterpret_cast<Block*>(find(size));
+  if (RX_HINT_UNLIKELY(!block)) {
+    // Out of memory.
+    return nullptr;
+  }
+
+  remove(block);
+
+  // Split off what is left over when it's enough for a block of its own.
+  if (size_of(block) - size >= k_min_block) {
+    const auto rest = reinterpret_cast<Block*>(reinterpret_cast<Byte*>(block) + size);
+    rest->prev = block;
+    resize(rest, size_of(block) - size, true);
+    next(rest)->prev = rest;
+    resize(block, size, false);
+    insert(rest);
+  } else {
+    resize(block, size_of(block), false);
+  }
+
+  return reinterpret_cast<Byte*>(block) + k_header;
+}
+
+void TLSFAllocator::deallocate_unlocked(void* _data) {
+  if (RX_HINT_UNLIKELY(!_data)) {
+    return;
+  }
+
+  auto block = reinterpret_cast<Block*>(reinterpret_cast<Byte*>(_data) - k_header);
+  RX_ASSERT(!is_free(block), "double free");
+
+  // Merge with the free blocks on either side.
+  if (const auto before = block->prev; before && is_free(before)) {
+    remove(before);
+    resize(before, size_of(before) + size_of(block), true);
+    block = before;
+    next(block)->prev = block;
+  }
+
+  if (const auto after = next(block); is_free(after)) {
+    remove(after);
+    resize(block, size_of(block) + size_of(after), true);
+    next(block)->prev = block;
+  }
+
+  resize(block, size_of(block), true);
+  insert(block);
+}
+
+void TLSFAllocator::insert(void* _block) {
+  const auto block = reinterpret_cast<Block*>(_block);
+
+  Size fl;
+  Size sl;
+  map(size_of(block), fl, sl);
+
+  const auto head = reinterpret_cast<Block*>(m_lists[fl][sl]);
+  block->next_free = head;
+  block->prev_free = nullptr;
+  if (head) {
+    head->prev_free = block;
+  }
+
+  m_lists[fl][sl] = block;
+  m_fl_bitmap |= Uint64{1} << fl;
+  m_sl_bitmap[fl] |= Uint32{1} << sl;
+}
+
+void TLSFAllocator::remove(void* _block) {
+  const auto block = reinterpret_cast<Block*>(_block);
+
+  Size fl;
+  Size sl;
+  map(size_of(block), fl, sl);
+
+  if (block->next_free) {
+    block->next_free->prev_free = block->prev_free;
+  }
+
+  if (block->prev_free) {
+    block->prev_free->next_free = block->next_free;
+  } else if (!(m_lists[fl][sl] = block->next_free)) {
+    // The list is empty now.
+    if (!(m_sl_bitmap[fl] &= ~(Uint32{1} << sl))) {
+      m_fl_bitmap &= ~(Uint64{1} << fl);
+    }
+  }
+}
+
+// Finds a block of at least |_size| in constant time. The size is rounded up
+// to the next list first so that any block in the list found will do. When
+// there's no such list, the first block in the list |_size| belongs in may
+// still be large enough.
+void* TLSFAllocator::find(Size _size) {
+  Size rounded{_size};
+  if (rounded >= k_small_size) {
+    rounded += (Size{1} << (bit_search_msb(Uint64{rounded}) - k_sl_shift)) - 1;
+  }
+
+  Size fl;
+  Size sl;
+  map(rounded, fl, sl);
+
+  // Any list in this level from |sl| up, else the first level above with any.
+  Uint32 sl_bitmap{fl < k_fl_count ? m_sl_bitmap[fl] & (~Uint32{0} << sl) : 0};
+  if (!sl_bitmap) {
+    const Uint64 fl_bitmap{fl + 1 < k_fl_count ? m_fl_bitmap & (~Uint64{0} << (fl + 1)) : 0};
+    if (RX_HINT_UNLIKELY(!fl_bitmap)) {
+      map(_size, fl, sl);
+      const auto head = reinterpret_cast<Block*>(m_lists[fl][sl]);
+      return head && size_of(head) >= _size ? head : nullptr;
+    }
+    fl = bit_search_lsb(fl_bitmap);
+    sl_bitmap = m_sl_bitmap[fl];
+  }
+
+  sl = bit_search_lsb(sl_bitmap);
+  return m_lists[fl][sl];
+}
+
+} // namespace rx::memory
@@ -0,0 +1,58 @@
+#ifndef RX_CORE_MEMORY_TLSF_ALLOCATOR_H
+#define RX_CORE_MEMORY_TLSF_ALLOCATOR_H
+#include "rx/core/memory/allocator.h"
+#include "rx/core/concurrency/spin_lock.h"
+
+namespace Rx::Memory {
+
+// # Two-Level Segregated Fit Allocator
+//
+// Allocates from a fixed region of memory in constant time.
+//
+// Free blocks are kept in lists segregated by size. The first level splits
+// sizes by power of two and the second level splits every power of two into
+// |k_sl_count| evenly sized lists. Two levels of bitmaps record which lists
+// have blocks in them, so finding a list with a large enough block is a couple
+// of bit scans rather than a search. Blocks are split on allocation and merged
+// with free neighbours on deallocation, so there's no search there either.
+//
+// Unlike |BuddyAllocator| the region doesn't have to be a power of two in size,
+// and a block is never more than 1/|k_sl_count| larger than asked for.
+struct RX_API TLSFAllocator
+  final : Allocator
+{
+  TLSFAllocator(Byte* _data, Size _size);
+
+  virtual Byte* allocate(Size _size);
+  virtual Byte* reallocate(void* _data, Size _size);
+  virtual void deallocate(void* _data);
+
+  static inline constexpr const Size k_sl_shift = 4;
+  static inline constexpr const Size k_sl_count = 1 << k_sl_shift;
+
+  // Blocks smaller than this all go in the first list of the first level.
+  static inline constexpr const Size k_fl_shift = k_sl_shift + 4;
+  static inline constexpr const Size k_small_size = 1 << k_fl_shift;
+
+  // Largest block is just under 1 << |k_fl_max|, which has to fit in |Size|.
+  static inline constexpr const Size k_fl_max = sizeof(Size) == 8 ? 40 : 31;
+  static inline constexpr const Size k_fl_count = k_fl_max - k_fl_shift + 1;
+
+private:
+  Byte* allocate_unlocked(Size _size);
+  void deallocate_unlocked(void* _data);
+
+  void insert(void* _block);
+  void remove(void* _block);
+  void* find(Size _size);
+
+  Concurrency::SpinLock m_lock;
+
+  Uint64 m_fl_bitmap RX_HINT_GUARDED_BY(m_lock);
+  Uint32 m_sl_bitmap[k_fl_count] RX_HINT_GUARDED_BY(m_lock);
+  void* m_lists[k_fl_count][k_sl_count] RX_HINT_GUARDED_BY(m_lock);
+};
+
+} // namespace rx::memory
+
+#endif // RX_CORE_MEMORY_TLSF_ALLOCATOR_H
@@ -10,6 +10,7 @@ Buffer::Buffer(Stream* _stream, Mode _mode)
   : m_stream{_stream}
   , m_mode{_mode}
   , m_cursor{0}
+  , m_length{0}
 {
   switch (_mode) {
   case Mode::k_read:
@@ -49,6 +50,11 @@ bool Buffer::read_byte(Byte* byte_) {
 }
 
 bool Buffer::write_bytes(const Byte* _bytes, Size _size) {
+  // Too large to be worth copying into the buffer first.
+  if (_size >= k_size) {
+    return flush() && m_stream->write(_bytes, _size) == _size;
+  }
+
   while (_size) {
     if (m_cursor == k_size && !flush()) {
       return false;
@@ -64,6 +70,10 @@ bool Buffer::write_bytes(const Byte* _bytes, Size _size) {
 
 bool Buffer::read_bytes(Byte* bytes_, Size _size) {
   while (_size) {
+    // Too large to be worth copying through the buffer.
+    if (m_cursor == m_length && _size >= k_size) {
+      return m_stream->read(bytes_, _size) == _size;
+    }
     if (m_cursor == m_length && !read()) {
       return false;
     }
@@ -91,4 +101,28 @@ bool Buffer::read(Uint64 _max_bytes) {
   return m_length != 0;
 }
 
+const Byte* Buffer::view(Size _size) {
+  RX_ASSERT(m_mode == Mode::k_read, "view requires read mode");
+
+  // Put the stream back to where reading left off.
+  if (!m_stream->seek(static_cast<Sint64>(tell()), Stream::Whence::SET)) {
+    return nullptr;
+  }
+
+  m_cursor = 0;
+  m_length = 0;
+
+  return m_stream->view(_size);
+}
+
+Uint64 Buffer::tell() const {
+  switch (m_mode) {
+  case Mode::k_read:
+    return m_stream->tell() - (m_length - m_cursor);
+  case Mode::k_write:
+    return m_stream->tell() + m_cursor;
+  }
+  return 0;
+}
+
 } // namespace rx::serialize
@@ -28,6 +28,13 @@ struct RX_API Buffer {
   [[nodiscard]] bool read(Uint64 _at_most = k_size);
   [[nodiscard]] bool flush();
 
+  // View the next |_size| bytes of the stream in place, when the stream can.
+  // Either way what was read ahead is dropped.
+  [[nodiscard]] const Byte* view(Size _size);
+
+  // Where in the stream the next byte read or written is.
+  Uint64 tell() const;
+
 private:
   Stream* m_stream;
   Mode m_mode;
@@ -1,11 +1,300 @@
-#include <string.h> // memcmp
+#include <string.h> // memcmp, memcpy
 
 #include "rx/core/serialize/decoder.h"
 #include "rx/core/stream.h"
 #include "rx/core/assert.h"
 
+#include "rx/core/hints/likely.h"
+#include "rx/core/hints/unlikely.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RX_SERIALIZE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define RX_SERIALIZE_NEON
+#include <arm_neon.h>
+#endif
+
 namespace Rx::serialize {
 
+static inline Uint64 unzigzag(Uint64 _value) {
+  return (_value >> 1) ^ (0_u64 - (_value & 1));
+}
+
+// Integers of every width are encoded as 64-bit ones, |_value| has to fit
+// back in T.
+template<typename T>
+static inline bool narrow(Uint64 _value, T& result_) {
+  const T value{static_cast<T>(_value)};
+  if constexpr (traits::is_signed<T>) {
+    if (static_cast<Uint64>(static_cast<Sint64>(value)) != _value) {
+      return false;
+    }
+  } else if (static_cast<Uint64>(value) != _value) {
+    return false;
+  }
+  result_ = value;
+  return true;
+}
+
+// Sixteen bytes of a varint block. When none of them continue into the next
+// they're sixteen elements of a byte each, which are widened into the result
+// all at once rather than decoded one at a time.
+struct VarintGroup {
+  static inline constexpr const Size k_width{16};
+
+  VarintGroup(const Byte* _data);
+
+  // None of the bytes continue into the next.
+  bool is_bytes() const;
+
+  // Every byte with its zigzag encoding undone, a signed byte each.
+  VarintGroup unzigzag() const;
+
+  // Sign extend every byte to T. Bytes which aren't zigzagged are all below
+  // 0x80 so that's the same as zero extending them.
+  template<typename T>
+  void store(T* result_) const;
+
+private:
+#if defined(RX_SERIALIZE_SSE2)
+  VarintGroup(__m128i _bytes);
+  __m128i m_bytes;
+#elif defined(RX_SERIALIZE_NEON)
+  VarintGroup(int8x16_t _bytes);
+  int8x16_t m_bytes;
+#else
+  VarintGroup() = default;
+  Sint8 m_bytes[k_width];
+#endif
+};
+
+#if defined(RX_SERIALIZE_SSE2)
+inline VarintGroup::VarintGroup(const Byte* _data)
+  : m_bytes{_mm_loadu_si128(reinterpret_cast<const __m128i*>(_data))}
+{
+}
+
+inline VarintGroup::VarintGroup(__m128i _bytes)
+  : m_bytes{_bytes}
+{
+}
+
+inline bool VarintGroup::is_bytes() const {
+  return _mm_movemask_epi8(m_bytes) == 0;
+}
+
+inline VarintGroup VarintGroup::unzigzag() const {
+  // There's no shift of bytes, shift words and clear what crossed over.
+  const auto half{_mm_and_si128(_mm_srli_epi16(m_bytes, 1), _mm_set1_epi8(0x7f))};
+  const auto sign{_mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(m_bytes, _mm_set1_epi8(1)))};
+  return {_mm_xor_si128(half, sign)};
+}
+
+template<typename T>
+inline void VarintGroup::store(T* result_) const {
+  auto* result{reinterpret_cast<__m128i*>(result_)};
+  if constexpr (sizeof(T) == 1) {
+    _mm_storeu_si128(result, m_bytes);
+    return;
+  }
+
+  // Interleaving every lane with its sign doubles its width.
+  const auto zero{_mm_setzero_si128()};
+  const __m128i sign8{traits::is_signed<T> ? _mm_cmpgt_epi8(zero, m_bytes) : zero};
+  const __m128i words[2]{
+    _mm_unpacklo_epi8(m_bytes, sign8),
+    _mm_unpackhi_epi8(m_bytes, sign8)
+  };
+  if constexpr (sizeof(T) == 2) {
+    _mm_storeu_si128(result + 0, words[0]);
+    _mm_storeu_si128(result + 1, words[1]);
+    return;
+  }
+
+  __m128i dwords[4];
+  for (Size i{0}; i < 2; i++) {
+    const __m128i sign16{traits::is_signed<T> ? _mm_srai_epi16(words[i], 15) : zero};
+    dwords[i * 2 + 0] = _mm_unpacklo_epi16(words[i], sign16);
+    dwords[i * 2 + 1] = _mm_unpackhi_epi16(words[i], sign16);
+  }
+  if constexpr (sizeof(T) == 4) {
+    for (Size i{0}; i < 4; i++) {
+      _mm_storeu_si128(result + i, dwords[i]);
+    }
+    return;
+  }
+
+  for (Size i{0}; i < 4; i++) {
+    const __m128i sign32{traits::is_signed<T> ? _mm_srai_epi32(dwords[i], 31) : zero};
+    _mm_storeu_si128(result + i * 2 + 0, _mm_unpacklo_epi32(dwords[i], sign32));
+    _mm_storeu_si128(result + i * 2 + 1, _mm_unpackhi_epi32(dwords[i], sign32));
+  }
+}
+#elif defined(RX_SERIALIZE_NEON)
+inline VarintGroup::VarintGroup(const Byte* _data)
+  : m_bytes{vld1q_s8(reinterpret_cast<const int8_t*>(_data))}
+{
+}
+
+inline VarintGroup::VarintGroup(int8x16_t _bytes)
+  : m_bytes{_bytes}
+{
+}
+
+inline bool VarintGroup::is_bytes() const {
+  // NEON has no movemask, only whether any of the top bits is set matters.
+  const auto halves{vreinterpretq_u64_s8(m_bytes)};
+  const Uint64 bits{vgetq_lane_u64(halves, 0) | vgetq_lane_u64(halves, 1)};
+  return (bits & 0x8080808080808080_u64) == 0;
+}
+
+inline VarintGroup VarintGroup::unzigzag() const {
+  const auto bytes{vreinterpretq_u8_s8(m_bytes)};
+  const auto half{vreinterpretq_s8_u8(vshrq_n_u8(bytes, 1))};
+  const auto sign{vnegq_s8(vreinterpretq_s8_u8(vandq_u8(bytes, vdupq_n_u8(1))))};
+  return {veorq_s8(half, sign)};
+}
+
+template<typename T>
+inline void VarintGroup::store(T* result_) const {
+  if constexpr (sizeof(T) == 1) {
+    vst1q_s8(reinterpret_cast<int8_t*>(result_), m_bytes);
+    return;
+  }
+
+  // Lengthening moves do the widening, the bytes are all sign extended.
+  const int16x8_t words[2]{
+    vmovl_s8(vget_low_s8(m_bytes)),
+    vmovl_s8(vget_high_s8(m_bytes))
+  };
+  if constexpr (sizeof(T) == 2) {
+    vst1q_s16(reinterpret_cast<int16_t*>(result_) + 0, words[0]);
+    vst1q_s16(reinterpret_cast<int16_t*>(result_) + 8, words[1]);
+    return;
+  }
+
+  int32x4_t dwords[4];
+  for (Size i{0}; i < 2; i++) {
+    dwords[i * 2 + 0] = vmovl_s16(vget_low_s16(words[i]));
+    dwords[i * 2 + 1] = vmovl_s16(vget_high_s16(words[i]));
+  }
+  if constexpr (sizeof(T) == 4) {
+    for (Size i{0}; i < 4; i++) {
+      vst1q_s32(reinterpret_cast<int32_t*>(result_) + i * 4, dwords[i]);
+    }
+    return;
+  }
+
+  for (Size i{0}; i < 4; i++) {
+    vst1q_s64(reinterpret_cast<int64_t*>(result_) + i * 4 + 0, vmovl_s32(vget_low_s32(dwords[i])));
+    vst1q_s64(reinterpret_cast<int64_t*>(result_) + i * 4 + 2, vmovl_s32(vget_high_s32(dwords[i])));
+  }
+}
+#else
+inline VarintGroup::VarintGroup(const Byte* _data) {
+  memcpy(m_bytes, _data, sizeof m_bytes);
+}
+
+inline bool VarintGroup::is_bytes() const {
+  Uint64 words[2];
+  memcpy(words, m_bytes, sizeof words);
+  return ((words[0] | words[1]) & 0x8080808080808080_u64) == 0;
+}
+
+inline VarintGroup VarintGroup::unzigzag() const {
+  VarintGroup group;
+  for (Size i{0}; i < k_width; i++) {
+    group.m_bytes[i] = static_cast<Sint8>(serialize::unzigzag(static_cast<Byte>(m_bytes[i])));
+  }
+  return group;
+}
+
+template<typename T>
+inline void VarintGroup::store(T* result_) const {
+  for (Size i{0}; i < k_width; i++) {
+    result_[i] = static_cast<T>(m_bytes[i]);
+  }
+}
+#endif
+
+// Decode the |_count| elements of the varint or, with |_delta|, delta block
+// of |_size| bytes at |_data|. The block has to end with the last of them.
+template<typename T>
+static bool decode_varints(const Byte* _data, Size _size, T* result_, Size _count, bool _delta) {
+  const Byte* data{_data};
+  const Byte* const end{_data + _size};
+
+  Uint64 previous{0};
+  const auto store = [&](Size _index, Uint64 _value) {
+    if (_delta) {
+      previous += unzigzag(_value);
+      return narrow(previous, result_[_index]);
+    }
+    return narrow(traits::is_signed<T> ? unzigzag(_value) : _value, result_[_index]);
+  };
+
+  // Where a group is looked at next. When one has a byte which continues
+  // into the next, the ones after it aren't looked at until it's passed.
+  const Byte* next_group{data};
+
+  Size i{0};
+  while (i < _count) {
+    // Runs of elements a byte each are common, take them a group at a time.
+    // A byte fits every T, zigzagged or not, only the running sum of a delta
+    // block has to be checked.
+    constexpr const Size k_width{VarintGroup::k_width};
+    if (data >= next_group && _count - i >= k_width
+      && static_cast<Size>(end - data) >= k_width)
+    {
+      const VarintGroup group{data};
+      if (RX_HINT_LIKELY(group.is_bytes())) {
+        if (_delta) {
+          Sint8 deltas[k_width];
+          group.unzigzag().store(deltas);
+          for (Size j{0}; j < k_width; j++) {
+            previous += static_cast<Uint64>(static_cast<Sint64>(deltas[j]));
+            if (RX_HINT_UNLIKELY(!narrow(previous, result_[i + j]))) {
+              return false;
+            }
+          }
+        } else if (traits::is_signed<T>) {
+          group.unzigzag().store(result_ + i);
+        } else {
+          group.store(result_ + i);
+        }
+        data += k_width;
+        i += k_width;
+        next_group = data;
+        continue;
+      }
+      next_group = data + k_width;
+    }
+
+    Uint64 value{0};
+    Uint64 shift{0};
+    Byte byte;
+    do {
+      if (RX_HINT_UNLIKELY(data == end)) {
+        return false;
+      }
+      byte = *data++;
+      const Uint64 slice{byte & 0x7f_u64};
+      if (RX_HINT_UNLIKELY(shift >= 64 || slice << shift >> shift != slice)) {
+        return false;
+      }
+      value |= slice << shift;
+      shift += 7;
+    } while (byte & 0x80);
+
+    if (RX_HINT_UNLIKELY(!store(i++, value))) {
+      return false;
+    }
+  }
+
+  return data == end;
+}
+
 Decoder::Decoder(Memory::Allocator& _allocator, Stream* _stream)
   : m_allocator{_allocator}
   , m_stream{_stream}
@@ -134,6 +423,199 @@ bool Decoder::read_byte_array(Byte* result_, Size _count) {
   return m_buffer.read_bytes(result_, _count);
 }
 
+template<typename T>
+bool Decoder::read_array(T* result_, Size _count) {
+  ArrayEncoding encoding;
+  return read_array_header(_count, encoding)
+    && read_elements(result_, _count, encoding);
+}
+
+template<typename T>
+bool Decoder::view_array(const T*& view_, Vector<T>& storage_, Size _count) {
+  ArrayEncoding encoding;
+  if (!read_array_header(_count, encoding)) {
+    return false;
+  }
+
+#if defined(RX_BYTE_ORDER_LITTLE_ENDIAN)
+  // Where the stream is in memory a raw block is already what's wanted.
+  if (encoding == ArrayEncoding::k_raw) {
+    if (!read_raw_header(sizeof(T))) {
+      return false;
+    }
+    const auto data{m_buffer.view(_count * sizeof(T))};
+    if (data && reinterpret_cast<UintPtr>(data) % alignof(T) == 0) {
+      view_ = reinterpret_cast<const T*>(data);
+      return true;
+    }
+    if (!storage_.resize(_count, Utility::UninitializedTag{})) {
+      return error("out of memory");
+    }
+    if (data) {
+      memcpy(storage_.data(), data, _count * sizeof(T));
+    } else if (!m_buffer.read_bytes(reinterpret_cast<Byte*>(storage_.data()), _count * sizeof(T))) {
+      return error("unexpected end of stream");
+    }
+    view_ = storage_.data();
+    return true;
+  }
+#endif
+
+  if (!storage_.resize(_count, Utility::UninitializedTag{})) {
+    return error("out of memory");
+  }
+
+  if (!read_elements(storage_.data(), _count, encoding)) {
+    return false;
+  }
+
+  view_ = storage_.data();
+  return true;
+}
+
+bool Decoder::read_array_header(Size _count, ArrayEncoding& encoding_) {
+  Uint64 count = 0;
+  if (!read_uint(count)) {
+    return false;
+  }
+
+  if (count != _count) {
+    return error("array count mismatch");
+  }
+
+  Byte encoding;
+  if (!m_buffer.read_byte(&encoding)) {
+    return error("unexpected end of stream");
+  }
+
+  switch (static_cast<ArrayEncoding>(encoding)) {
+  case ArrayEncoding::k_varint:
+    [[fallthrough]];
+  case ArrayEncoding::k_raw:
+    [[fallthrough]];
+  case ArrayEncoding::k_delta:
+    encoding_ = static_cast<ArrayEncoding>(encoding);
+    return true;
+  }
+
+  return error("unknown array encoding %u", static_cast<Uint32>(encoding));
+}
+
+bool Decoder::read_raw_header(Size _width) {
+  Byte width;
+  Byte padding;
+  if (!m_buffer.read_byte(&width) || !m_buffer.read_byte(&padding)) {
+    return error("unexpected end of stream");
+  }
+
+  if (width != _width) {
+    return error("array width mismatch");
+  }
+
+  if (padding >= _width) {
+    return error("encoding error");
+  }
+
+  Byte skip[8];
+  if (!m_buffer.read_bytes(skip, padding)) {
+    return error("unexpected end of stream");
+  }
+
+  return true;
+}
+
+template<typename T>
+bool Decoder::read_elements(T* result_, Size _count, ArrayEncoding _encoding) {
+  switch (_encoding) {
+  case ArrayEncoding::k_varint:
+    [[fallthrough]];
+  case ArrayEncoding::k_delta:
+    {
+      Uint64 size = 0;
+      if (!read_uint(size)) {
+        return false;
+      }
+
+      // Every element is at least a byte and at most ten.
+      if (size < _count || size > _count * 10_u64 || size > m_header.data_size) {
+        return error("encoding error");
+      }
+
+      // Small blocks are read through |m_buffer|, larger ones are decoded in
+      // place when the stream is in memory.
+      Byte chunk[256];
+      Vector<Byte> block{allocator()};
+      const Byte* data{nullptr};
+      if (size <= sizeof chunk) {
+        if (m_buffer.read_bytes(chunk, static_cast<Size>(size))) {
+          data = chunk;
+        }
+      } else if (!(data = m_buffer.view(static_cast<Size>(size)))) {
+        if (!block.resize(static_cast<Size>(size), Utility::UninitializedTag{})) {
+          return error("out of memory");
+        }
+        if (m_buffer.read_bytes(block.data(), block.size())) {
+          data = block.data();
+        }
+      }
+
+      if (!data) {
+        return error("unexpected end of stream");
+      }
+
+      if (!decode_varints(data, static_cast<Size>(size), result_, _count,
+        _encoding == ArrayEncoding::k_delta))
+      {
+        return error("encoding error");
+      }
+    }
+    return true;
+  case ArrayEncoding::k_raw:
+    if (!read_raw_header(sizeof(T))) {
+      return false;
+    }
+
+#if defined(RX_BYTE_ORDER_LITTLE_ENDIAN)
+    if (!m_buffer.read_bytes(reinterpret_cast<Byte*>(result_), _count * sizeof(T))) {
+      return error("unexpected end of stream");
+    }
+#else
+    for (Size i{0}; i < _count; i++) {
+      Byte bytes[sizeof(T)];
+      if (!m_buffer.read_bytes(bytes, sizeof bytes)) {
+        return error("unexpected end of stream");
+      }
+      Uint64 value{0};
+      for (Size j{0}; j < sizeof(T); j++) {
+        value |= static_cast<Uint64>(bytes[j]) << (j * 8);
+      }
+      result_[i] = static_cast<T>(value);
+    }
+#endif
+    return true;
+  }
+
+  return error("unknown array encoding");
+}
+
+template bool Decoder::read_array<Uint8>(Uint8*, Size);
+template bool Decoder::read_array<Uint16>(Uint16*, Size);
+template bool Decoder::read_array<Uint32>(Uint32*, Size);
+template bool Decoder::read_array<Uint64>(Uint64*, Size);
+template bool Decoder::read_array<Sint8>(Sint8*, Size);
+template bool Decoder::read_array<Sint16>(Sint16*, Size);
+template bool Decoder::read_array<Sint32>(Sint32*, Size);
+template bool Decoder::read_array<Sint64>(Sint64*, Size);
+
+template bool Decoder::view_array<Uint8>(const Uint8*&, Vector<Uint8>&, Size);
+template bool Decoder::view_array<Uint16>(const Uint16*&, Vector<Uint16>&, Size);
+template bool Decoder::view_array<Uint32>(const Uint32*&, Vector<Uint32>&, Size);
+template bool Decoder::view_array<Uint64>(const Uint64*&, Vector<Uint64>&, Size);
+template bool Decoder::view_array<Sint8>(const Sint8*&, Vector<Sint8>&, Size);
+template bool Decoder::view_array<Sint16>(const Sint16*&, Vector<Sint16>&, Size);
+template bool Decoder::view_array<Sint32>(const Sint32*&, Vector<Sint32>&, Size);
+template bool Decoder::view_array<Sint64>(const Sint64*&, Vector<Sint64>&, Size);
+
 bool Decoder::finalize() {
   if (m_header.string_size) {
     m_strings.fini();
@@ -158,7 +640,8 @@ bool Decoder::read_header() {
   size += m_header.data_size;
   size += m_header.string_size;
 
-  if (size != m_stream->size()) {
+  const auto stream_size = m_stream->size();
+  if (!stream_size || size != *stream_size) {
     return error("corrupted stream");
   }
 
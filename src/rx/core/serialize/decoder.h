@@ -30,12 +30,22 @@ struct RX_API Decoder {
   [[nodiscard]] bool read_float_array(Float32* result_, Size _count);
   [[nodiscard]] bool read_byte_array(Byte* result_, Size _count);
 
+  // Read |_count| integers written by |Encoder| in any |ArrayEncoding|.
   template<typename T>
   [[nodiscard]] bool read_uint_array(T* result_, Size _count);
 
   template<typename T>
   [[nodiscard]] bool read_sint_array(T* result_, Size _count);
 
+  // Like the above, except arrays written with ArrayEncoding::k_raw aren't
+  // copied when the stream is in memory, |view_| points into the stream. The
+  // rest are read into |storage_| and |view_| points there.
+  template<typename T>
+  [[nodiscard]] bool view_uint_array(const T*& view_, Vector<T>& storage_, Size _count);
+
+  template<typename T>
+  [[nodiscard]] bool view_sint_array(const T*& view_, Vector<T>& storage_, Size _count);
+
   const String& message() const &;
   constexpr Memory::Allocator& allocator() const;
 
@@ -43,6 +53,18 @@ private:
   template<typename... Ts>
   bool error(const char* _format, Ts&&... _arguments);
 
+  template<typename T>
+  [[nodiscard]] bool read_array(T* result_, Size _count);
+
+  template<typename T>
+  [[nodiscard]] bool view_array(const T*& view_, Vector<T>& storage_, Size _count);
+
+  [[nodiscard]] bool read_array_header(Size _count, ArrayEncoding& encoding_);
+  [[nodiscard]] bool read_raw_header(Size _width);
+
+  template<typename T>
+  [[nodiscard]] bool read_elements(T* result_, Size _count, ArrayEncoding _encoding);
+
   [[nodiscard]] bool read_header();
   [[nodiscard]] bool read_strings();
   [[nodiscard]] bool finalize();
@@ -64,45 +86,25 @@ inline Decoder::Decoder(Stream* _stream)
 template<typename T>
 inline bool Decoder::read_uint_array(T* result_, Size _count) {
   static_assert(traits::is_unsigned<T>, "T must be unsigned integer");
-
-  Uint64 count = 0;
-  if (!read_uint(count)) {
-    return false;
-  }
-
-  if (count != _count) {
-    return false;
-  }
-
-  for (Size i = 0; i < _count; i++) {
-    if (!read_uint(result_[i])) {
-      return error("array count mismatch");
-    }
-  }
-
-  return true;
+  return read_array(result_, _count);
 }
 
 template<typename T>
 inline bool Decoder::read_sint_array(T* result_, Size _count) {
   static_assert(traits::is_signed<T>, "T must be signed integer");
+  return read_array(result_, _count);
+}
 
-  Uint64 count = 0;
-  if (!read_uint(count)) {
-    return false;
-  }
-
-  if (count != _count) {
-    return error("array count mismatch");
-  }
-
-  for (Size i = 0; i < _count; i++) {
-    if (!read_uint(result_[i])) {
-      return false;
-    }
-  }
+template<typename T>
+inline bool Decoder::view_uint_array(const T*& view_, Vector<T>& storage_, Size _count) {
+  static_assert(traits::is_unsigned<T>, "T must be unsigned integer");
+  return view_array(view_, storage_, _count);
+}
 
-  return true;
+template<typename T>
+inline bool Decoder::view_sint_array(const T*& view_, Vector<T>& storage_, Size _count) {
+  static_assert(traits::is_signed<T>, "T must be signed integer");
+  return view_array(view_, storage_, _count);
 }
 
 inline const String& Decoder::message() const & {
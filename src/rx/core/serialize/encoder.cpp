@@ -5,6 +5,51 @@
 
 namespace Rx::serialize {
 
+// Integers of every width are encoded as 64-bit ones, signed ones sign
+// extended.
+template<typename T>
+static inline Uint64 widen(T _value) {
+  if constexpr (traits::is_signed<T>) {
+    return static_cast<Uint64>(static_cast<Sint64>(_value));
+  } else {
+    return static_cast<Uint64>(_value);
+  }
+}
+
+static inline Uint64 zigzag(Uint64 _value) {
+  return (_value << 1) ^ (0_u64 - (_value >> 63));
+}
+
+// The value element |_index| of |_data| is encoded as in a varint block, or
+// with |_delta|, in a delta block.
+template<typename T>
+static inline Uint64 varint_of(const T* _data, Size _index, bool _delta) {
+  const Uint64 value{widen(_data[_index])};
+  if (_delta) {
+    // The difference wraps around, which is undone when it's added back.
+    return zigzag(value - (_index ? widen(_data[_index - 1]) : 0));
+  }
+  return traits::is_signed<T> ? zigzag(value) : value;
+}
+
+static inline Size uleb128_size(Uint64 _value) {
+  Size size{1};
+  while (_value >>= 7) {
+    size++;
+  }
+  return size;
+}
+
+static inline Size write_uleb128(Byte* data_, Uint64 _value) {
+  Size size{0};
+  while (_value >= 0x80) {
+    data_[size++] = static_cast<Byte>(_value | 0x80);
+    _value >>= 7;
+  }
+  data_[size++] = static_cast<Byte>(_value);
+  return size;
+}
+
 Encoder::Encoder(Memory::Allocator& _allocator, Stream* _stream)
   : m_allocator{_allocator}
   , m_stream{_stream}
@@ -102,6 +147,94 @@ bool Encoder::write_byte_array(const Byte* _data, Size _count) {
   return m_buffer.write_bytes(_data, _count);
 }
 
+template<typename T>
+bool Encoder::write_array(const T* _data, Size _count, ArrayEncoding _encoding) {
+  if (!write_uint(_count) || !write_byte(static_cast<Byte>(_encoding))) {
+    return error("write failed");
+  }
+
+  // Encoded a chunk at a time rather than a byte at a time into |m_buffer|.
+  Byte chunk[256];
+  Size used{0};
+
+  switch (_encoding) {
+  case ArrayEncoding::k_varint:
+    [[fallthrough]];
+  case ArrayEncoding::k_delta:
+    {
+      const bool delta{_encoding == ArrayEncoding::k_delta};
+
+      // The size of the block goes first so it can be read whole.
+      Uint64 size{0};
+      for (Size i{0}; i < _count; i++) {
+        size += uleb128_size(varint_of(_data, i, delta));
+      }
+      if (!write_uint(size)) {
+        return false;
+      }
+
+      for (Size i{0}; i < _count; i++) {
+        if (used > sizeof chunk - 10) {
+          if (!m_buffer.write_bytes(chunk, used)) {
+            return error("write failed");
+          }
+          used = 0;
+        }
+        used += write_uleb128(chunk + used, varint_of(_data, i, delta));
+      }
+    }
+    break;
+  case ArrayEncoding::k_raw:
+    {
+      // The width of the elements, then padding to a multiple of it.
+      const Size padding{(sizeof(T) - (m_buffer.tell() + 2) % sizeof(T)) % sizeof(T)};
+      chunk[used++] = sizeof(T);
+      chunk[used++] = static_cast<Byte>(padding);
+      for (Size i{0}; i < padding; i++) {
+        chunk[used++] = 0;
+      }
+
+#if defined(RX_BYTE_ORDER_LITTLE_ENDIAN)
+      if (!m_buffer.write_bytes(chunk, used)
+        || !m_buffer.write_bytes(reinterpret_cast<const Byte*>(_data), _count * sizeof(T)))
+      {
+        return error("write failed");
+      }
+      used = 0;
+#else
+      for (Size i{0}; i < _count; i++) {
+        if (used > sizeof chunk - sizeof(T)) {
+          if (!m_buffer.write_bytes(chunk, used)) {
+            return error("write failed");
+          }
+          used = 0;
+        }
+        const Uint64 value{widen(_data[i])};
+        for (Size j{0}; j < sizeof(T); j++) {
+          chunk[used++] = static_cast<Byte>(value >> (j * 8));
+        }
+      }
+#endif
+    }
+    break;
+  }
+
+  if (!m_buffer.write_bytes(chunk, used)) {
+    return error("write failed");
+  }
+
+  return true;
+}
+
+template bool Encoder::write_array<Uint8>(const Uint8*, Size, ArrayEncoding);
+template bool Encoder::write_array<Uint16>(const Uint16*, Size, ArrayEncoding);
+template bool Encoder::write_array<Uint32>(const Uint32*, Size, ArrayEncoding);
+template bool Encoder::write_array<Uint64>(const Uint64*, Size, ArrayEncoding);
+template bool Encoder::write_array<Sint8>(const Sint8*, Size, ArrayEncoding);
+template bool Encoder::write_array<Sint16>(const Sint16*, Size, ArrayEncoding);
+template bool Encoder::write_array<Sint32>(const Sint32*, Size, ArrayEncoding);
+template bool Encoder::write_array<Sint64>(const Sint64*, Size, ArrayEncoding);
+
 bool Encoder::write_header() {
   const auto header_data = reinterpret_cast<const Byte*>(&m_header);
   const auto output_size = m_stream->write(header_data, sizeof m_header);
@@ -31,11 +31,14 @@ struct RX_API Encoder {
   [[nodiscard]] bool write_float_array(const Float32* _value, Size _count);
   [[nodiscard]] bool write_byte_array(const Byte* _data, Size _size);
 
+  // Write |_count| integers of |_data| in one block, encoded with |_encoding|.
   template<typename T>
-  [[nodiscard]] bool write_uint_array(const T* _data, Size _count);
+  [[nodiscard]] bool write_uint_array(const T* _data, Size _count,
+    ArrayEncoding _encoding = ArrayEncoding::k_varint);
 
   template<typename T>
-  [[nodiscard]] bool write_sint_array(const T* _data, Size _count);
+  [[nodiscard]] bool write_sint_array(const T* _data, Size _count,
+    ArrayEncoding _encoding = ArrayEncoding::k_varint);
 
   const String& message() const &;
   constexpr Memory::Allocator& allocator() const;
@@ -44,6 +47,9 @@ private:
   template<typename... Ts>
   bool error(const char* _format, Ts&&... _arguments);
 
+  template<typename T>
+  [[nodiscard]] bool write_array(const T* _data, Size _count, ArrayEncoding _encoding);
+
   [[nodiscard]] bool write_header();
   [[nodiscard]] bool finalize();
 
@@ -66,37 +72,15 @@ inline bool Encoder::write_string(const String& _string) {
 }
 
 template<typename T>
-inline bool Encoder::write_uint_array(const T* _data, Size _count) {
+inline bool Encoder::write_uint_array(const T* _data, Size _count, ArrayEncoding _encoding) {
   static_assert(traits::is_unsigned<T>, "T isn't unsigned integer Type");
-
-  if (!write_uint(_count)) {
-    return false;
-  }
-
-  for (Size i = 0; i < _count; i++) {
-    if (!write_uint(_data[i])) {
-      return false;
-    }
-  }
-
-  return true;
+  return write_array(_data, _count, _encoding);
 }
 
 template<typename T>
-inline bool Encoder::write_sint_array(const T* _data, Size _count) {
+inline bool Encoder::write_sint_array(const T* _data, Size _count, ArrayEncoding _encoding) {
   static_assert(traits::is_signed<T>, "T isn't signed integer Type");
-
-  if (!write_uint(_count)) {
-    return false;
-  }
-
-  for (Size i = 0; i < _count; i++) {
-    if (!write_uint(_data[i])) {
-      return false;
-    }
-  }
-
-  return true;
+  return write_array(_data, _count, _encoding);
 }
 
 inline const String& Encoder::message() const & {
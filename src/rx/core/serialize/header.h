@@ -18,6 +18,23 @@ struct Header {
   Uint64 string_size;
 };
 
+// How an array of integers is encoded. Signed integers in a variable-length
+// encoding are zigzag encoded first, so those close to zero are short either
+// side of it.
+enum class ArrayEncoding : Uint8 {
+  // Every element as a ULEB128, in one block of a known size.
+  k_varint,
+
+  // Every element as it is in memory, little-endian. The block starts on a
+  // multiple of the size of an element from the start of the stream so that
+  // it can be used in place.
+  k_raw,
+
+  // The difference of every element from the one before it as a ULEB128, in
+  // one block of a known size. For sorted or slowly changing values.
+  k_delta
+};
+
 inline constexpr Header::Header()
   : magic{'R', 'E', 'X', '\0'}
   , version{0}
@@ -5,6 +5,7 @@
 
 #include "rx/core/traits/is_trivially_destructible.h"
 #include "rx/core/traits/return_type.h"
+#include "rx/core/traits/remove_cvref.h"
 #include "rx/core/traits/is_same.h"
 
 #include "rx/core/utility/swap.h"
@@ -46,9 +47,9 @@ struct Set {
   K* insert(K&& _key);
   K* insert(const K& _key);
 
-  K* find(const K& _key) const;
+  K* find(LookupKey<K> _key) const;
 
-  bool erase(const K& _key);
+  bool erase(LookupKey<K> _key);
   Size size() const;
   bool is_empty() const;
 
@@ -64,7 +65,7 @@ struct Set {
 private:
   void clear_and_deallocate();
 
-  static Size hash_key(const K& _key);
+  static Size hash_key(LookupKey<K> _key);
   static bool is_deleted(Size _hash);
 
   Size desired_position(Size _hash) const;
@@ -82,7 +83,7 @@ private:
   K* inserter(Size _hash, K&& key_);
   K* inserter(Size _hash, const K& _key);
 
-  bool lookup_index(const K& _key, Size& _index) const;
+  bool lookup_index(LookupKey<K> _key, Size& _index) const;
 
   Memory::Allocator* m_allocator;
 
@@ -248,7 +249,7 @@ inline K* Set<K>::insert(const K& _key) {
 }
 
 template<typename K>
-K* Set<K>::find(const K& _key) const {
+K* Set<K>::find(LookupKey<K> _key) const {
   if (Size index; lookup_index(_key, index)) {
     return m_keys + index;
   }
@@ -256,7 +257,7 @@ K* Set<K>::find(const K& _key) const {
 }
 
 template<typename K>
-inline bool Set<K>::erase(const K& _key) {
+inline bool Set<K>::erase(LookupKey<K> _key) {
   if (Size index; lookup_index(_key, index)) {
     if constexpr (!traits::is_trivially_destructible<K>) {
       Utility::destruct<K>(m_keys + index);
@@ -285,8 +286,8 @@ inline bool Set<K>::is_empty() const {
 }
 
 template<typename K>
-inline Size Set<K>::hash_key(const K& _key) {
-  auto hash_value{Hash<K>{}(_key)};
+inline Size Set<K>::hash_key(LookupKey<K> _key) {
+  auto hash_value{Hash<traits::remove_cvref<LookupKey<K>>>{}(_key)};
 
   // MSB is used to indicate deleted elements
   if constexpr(sizeof hash_value == 8) {
@@ -431,7 +432,7 @@ inline K* Set<K>::inserter(Size _hash, const K& _key) {
 }
 
 template<typename K>
-inline bool Set<K>::lookup_index(const K& _key, Size& _index) const {
+inline bool Set<K>::lookup_index(LookupKey<K> _key, Size& _index) const {
   const Size hash{hash_key(_key)};
   Size position{desired_position(hash)};
   Size distance{0};
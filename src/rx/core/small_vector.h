@@ -0,0 +1,628 @@
+#ifndef RX_CORE_SMALL_VECTOR_H
+#define RX_CORE_SMALL_VECTOR_H
+#include "rx/core/vector.h"
+
+#include "rx/core/hints/likely.h"
+
+namespace Rx {
+
+// # Small Vector
+//
+// A |Vector| with storage for |N| elements inside of it. Nothing is allocated
+// until there are more than |N| elements, when everything moves to memory from
+// the allocator like a |Vector| and stays there. Meant for short-lived lists
+// which almost always stay small.
+//
+// Unlike |Vector| moving a small vector which hasn't spilled moves every
+// element, and |disown| isn't available.
+//
+// 32-bit: 16 + sizeof(T) * N bytes
+// 64-bit: 32 + sizeof(T) * N bytes
+template<typename T, Size N>
+struct SmallVector {
+  static_assert(N != 0, "use Vector");
+
+  template<typename U, Size E>
+  using Initializers = Array<U[E]>;
+
+  static inline constexpr const Size k_npos{-1_z};
+  static inline constexpr const Size k_inline_capacity{N};
+
+  SmallVector();
+  SmallVector(Memory::Allocator& _allocator);
+
+  template<typename U, Size E>
+  SmallVector(Memory::Allocator& _allocator, Initializers<U, E>&& _initializers);
+  template<typename U, Size E>
+  SmallVector(Initializers<U, E>&& _initializers);
+
+  SmallVector(Memory::Allocator& _allocator, Size _size);
+  SmallVector(Memory::Allocator& _allocator, const SmallVector& _other);
+  SmallVector(Size _size);
+  SmallVector(const SmallVector& _other);
+  SmallVector(SmallVector&& other_);
+
+  ~SmallVector();
+
+  SmallVector& operator=(const SmallVector& _other);
+  SmallVector& operator=(SmallVector&& other_);
+
+  T& operator[](Size _index);
+  const T& operator[](Size _index) const;
+
+  // resize to |size| with |value| for new objects
+  bool resize(Size _size, const T& _value = {});
+
+  // Resize of |_size| where the contents stays uninitialized.
+  // This should only be used with trivially copyable T.
+  bool resize(Size _size, Utility::UninitializedTag);
+
+  // reserve |size| elements
+  bool reserve(Size _size);
+
+  bool append(const SmallVector& _other);
+
+  void clear();
+
+  Size find(const T& _value) const;
+
+  template<typename F>
+  Size find_if(F&& _compare) const;
+
+  // append |data| by copy
+  bool push_back(const T& _data);
+  // append |data| by move
+  bool push_back(T&& data_);
+
+  void pop_back();
+
+  // append new |T| construct with |args|
+  template<typename... Ts>
+  bool emplace_back(Ts&&... _args);
+
+  Size size() const;
+  Size capacity() const;
+
+  bool in_range(Size _index) const;
+  bool is_empty() const;
+
+  // When the elements are stored inside and not allocated.
+  bool is_inline() const;
+
+  // enumerate collection either forward or reverse
+  template<typename F>
+  bool each_fwd(F&& _func);
+  template<typename F>
+  bool each_rev(F&& _func);
+  template<typename F>
+  bool each_fwd(F&& _func) const;
+  template<typename F>
+  bool each_rev(F&& _func) const;
+
+  void erase(Size _from, Size _to);
+
+  // first or last element
+  const T& first() const;
+  T& first();
+  const T& last() const;
+  T& last();
+
+  const T* data() const;
+  T* data();
+
+  constexpr Memory::Allocator& allocator() const;
+
+private:
+  T* storage();
+
+  // Moves the elements of |other_| into this one, which must be empty and
+  // inline, leaving |other_| empty.
+  void take(SmallVector&& other_);
+
+  void release();
+
+  // NOTE(dweiler): This does not adjust m_size, it only adjusts capacity.
+  bool grow_or_shrink_to(Size _size);
+
+  Memory::Allocator* m_allocator;
+  T* m_data;
+  Size m_size;
+  Size m_capacity;
+
+  alignas(T) Byte m_storage[sizeof(T) * N];
+};
+
+template<typename T, Size N>
+inline SmallVector<T, N>::SmallVector()
+  : SmallVector{Memory::SystemAllocator::instance()}
+{
+}
+
+template<typename T, Size N>
+inline SmallVector<T, N>::SmallVector(Memory::Allocator& _allocator)
+  : m_allocator{&_allocator}
+  , m_data{storage()}
+  , m_size{0}
+  , m_capacity{N}
+{
+}
+
+template<typename T, Size N>
+template<typename U, Size E>
+inline SmallVector<T, N>::SmallVector(Memory::Allocator& _allocator, Initializers<U, E>&& _initializers)
+  : SmallVector{_allocator}
+{
+  RX_ASSERT(reserve(E), "out of memory");
+  for (Size i = 0; i < E; i++) {
+    Utility::construct<T>(m_data + i, Utility::move(_initializers[i]));
+  }
+  m_size = E;
+}
+
+template<typename T, Size N>
+template<typename U, Size E>
+inline SmallVector<T, N>::SmallVector(Initializers<U, E>&& _initializers)
+  : SmallVector{Memory::SystemAllocator::instance(), Utility::move(_initializers)}
+{
+}
+
+template<typename T, Size N>
+inline SmallVector<T, N>::SmallVector(Memory::Allocator& _allocator, Size _size)
+  : SmallVector{_allocator}
+{
+  RX_ASSERT(reserve(_size), "out of memory");
+  for (Size i = 0; i < _size; i++) {
+    Utility::construct<T>(m_data + i);
+  }
+  m_size = _size;
+}
+
+template<typename T, Size N>
+inline SmallVector<T, N>::SmallVector(Memory::Allocator& _allocator, const SmallVector& _other)
+  : SmallVector{_allocator}
+{
+  RX_ASSERT(append(_other), "out of memory");
+}
+
+template<typename T, Size N>
+inline SmallVector<T, N>::SmallVector(Size _size)
+  : SmallVector{Memory::SystemAllocator::instance(), _size}
+{
+}
+
+template<typename T, Size N>
+inline SmallVector<T, N>::SmallVector(const SmallVector& _other)
+  : SmallVector{*_other.m_allocator, _other}
+{
+}
+
+template<typename T, Size N>
+inline SmallVector<T, N>::SmallVector(SmallVector&& other_)
+  : SmallVector{*other_.m_allocator}
+{
+  take(Utility::move(other_));
+}
+
+template<typename T, Size N>
+inline SmallVector<T, N>::~SmallVector() {
+  release();
+}
+
+template<typename T, Size N>
+inline SmallVector<T, N>& SmallVector<T, N>::operator=(const SmallVector& _other) {
+  RX_ASSERT(&_other != this, "self assignment");
+
+  // Keep whatever memory there is.
+  clear();
+  RX_ASSERT(append(_other), "out of memory");
+
+  return *this;
+}
+
+template<typename T, Size N>
+inline SmallVector<T, N>& SmallVector<T, N>::operator=(SmallVector&& other_) {
+  RX_ASSERT(&other_ != this, "self assignment");
+
+  release();
+
+  m_allocator = other_.m_allocator;
+  m_data = storage();
+  m_size = 0;
+  m_capacity = N;
+
+  take(Utility::move(other_));
+
+  return *this;
+}
+
+template<typename T, Size N>
+inline T& SmallVector<T, N>::operator[](Size _index) {
+  RX_ASSERT(in_range(_index), "out of bounds (%zu >= %zu)", _index, m_size);
+  return m_data[_index];
+}
+
+template<typename T, Size N>
+inline const T& SmallVector<T, N>::operator[](Size _index) const {
+  RX_ASSERT(in_range(_index), "out of bounds (%zu >= %zu)", _index, m_size);
+  return m_data[_index];
+}
+
+template<typename T, Size N>
+RX_HINT_FORCE_INLINE T* SmallVector<T, N>::storage() {
+  return reinterpret_cast<T*>(m_storage);
+}
+
+template<typename T, Size N>
+inline void SmallVector<T, N>::take(SmallVector&& other_) {
+  if (!other_.is_inline()) {
+    // Allocated elements just change owner.
+    m_data = Utility::exchange(other_.m_data, other_.storage());
+    m_capacity = Utility::exchange(other_.m_capacity, N);
+    m_size = Utility::exchange(other_.m_size, 0);
+    return;
+  }
+
+  if constexpr (traits::is_trivially_copyable<T>) {
+    if (other_.m_size) {
+      detail::copy(m_data, other_.m_data, sizeof(T) * other_.m_size);
+    }
+  } else for (Size i = 0; i < other_.m_size; i++) {
+    Utility::construct<T>(m_data + i, Utility::move(other_.m_data[i]));
+  }
+
+  m_size = other_.m_size;
+  other_.clear();
+}
+
+template<typename T, Size N>
+inline void SmallVector<T, N>::release() {
+  clear();
+  if (!is_inline()) {
+    allocator().deallocate(m_data);
+  }
+}
+
+template<typename T, Size N>
+bool SmallVector<T, N>::grow_or_shrink_to(Size _size) {
+  if (!reserve(_size)) {
+    return false;
+  }
+
+  if constexpr (!traits::is_trivially_destructible<T>) {
+    for (Size i = m_size; i > _size; --i) {
+      Utility::destruct<T>(m_data + (i - 1));
+    }
+  }
+
+  return true;
+}
+
+template<typename T, Size N>
+bool SmallVector<T, N>::resize(Size _size, const T& _value) {
+  if (!grow_or_shrink_to(_size)) {
+    return false;
+  }
+
+  // Copy construct the objects.
+  for (Size i{m_size}; i < _size; i++) {
+    if constexpr(traits::is_trivially_copyable<T>) {
+      m_data[i] = _value;
+    } else {
+      Utility::construct<T>(m_data + i, _value);
+    }
+  }
+
+  m_size = _size;
+  return true;
+}
+
+template<typename T, Size N>
+bool SmallVector<T, N>::resize(Size _size, Utility::UninitializedTag) {
+  RX_ASSERT(traits::is_trivially_copyable<T>,
+    "T isn't trivial, cannot leave uninitialized");
+
+  if (!grow_or_shrink_to(_size)) {
+    return false;
+  }
+
+  m_size = _size;
+  return true;
+}
+
+template<typename T, Size N>
+bool SmallVector<T, N>::reserve(Size _size) {
+  if (RX_HINT_LIKELY(_size <= m_capacity)) {
+    return true;
+  }
+
+  auto capacity = m_capacity;
+
+  // Always resize capacity with the Golden ratio.
+  while (capacity < _size) {
+    capacity = ((capacity + 1) * 3) / 2;
+  }
+
+  // Only memory from the allocator can be reallocated.
+  const bool was_inline{is_inline()};
+
+  T* resize = nullptr;
+  if constexpr (traits::is_trivially_copyable<T>) {
+    if (was_inline) {
+      resize = reinterpret_cast<T*>(allocator().allocate(sizeof(T), capacity));
+      if (resize && m_size) {
+        detail::copy(resize, m_data, sizeof(T) * m_size);
+      }
+    } else {
+      resize = reinterpret_cast<T*>(allocator().reallocate(m_data, capacity * sizeof *m_data));
+    }
+  } else {
+    resize = reinterpret_cast<T*>(allocator().allocate(sizeof(T), capacity));
+  }
+
+  if (RX_HINT_UNLIKELY(!resize)) {
+    return false;
+  }
+
+  if constexpr (!traits::is_trivially_copyable<T>) {
+    for (Size i{0}; i < m_size; i++) {
+      Utility::construct<T>(resize + i, Utility::move(*(m_data + i)));
+      Utility::destruct<T>(m_data + i);
+    }
+    if (!was_inline) {
+      allocator().deallocate(m_data);
+    }
+  }
+
+  m_data = resize;
+  m_capacity = capacity;
+
+  return true;
+}
+
+template<typename T, Size N>
+bool SmallVector<T, N>::append(const SmallVector& _other) {
+  const auto new_size = m_size + _other.m_size;
+
+  if (!reserve(new_size)) {
+    return false;
+  }
+
+  if constexpr (traits::is_trivially_copyable<T>) {
+    if (_other.m_size) {
+      detail::copy(m_data + m_size, _other.m_data, sizeof(T) * _other.m_size);
+    }
+  } else for (Size i = 0; i < _other.m_size; i++) {
+    Utility::construct<T>(m_data + m_size + i, _other[i]);
+  }
+
+  m_size = new_size;
+
+  return true;
+}
+
+template<typename T, Size N>
+inline void SmallVector<T, N>::clear() {
+  if constexpr (!traits::is_trivially_destructible<T>) {
+    for (Size i = m_size - 1; i < m_size; i--) {
+      Utility::destruct<T>(m_data + i);
+    }
+  }
+  m_size = 0;
+}
+
+template<typename T, Size N>
+inline Size SmallVector<T, N>::find(const T& _value) const {
+  for (Size i{0}; i < m_size; i++) {
+    if (m_data[i] == _value) {
+      return i;
+    }
+  }
+  return k_npos;
+}
+
+template<typename T, Size N>
+template<typename F>
+inline Size SmallVector<T, N>::find_if(F&& _compare) const {
+  for (Size i{0}; i < m_size; i++) {
+    if (_compare(m_data[i])) {
+      return i;
+    }
+  }
+  return k_npos;
+}
+
+template<typename T, Size N>
+inline bool SmallVector<T, N>::push_back(const T& _value) {
+  if (!reserve(m_size + 1)) {
+    return false;
+  }
+
+  // Copy construct object.
+  Utility::construct<T>(m_data + m_size, _value);
+
+  m_size++;
+  return true;
+}
+
+template<typename T, Size N>
+inline bool SmallVector<T, N>::push_back(T&& value_) {
+  if (!reserve(m_size + 1)) {
+    return false;
+  }
+
+  // Move construct object.
+  Utility::construct<T>(m_data + m_size, Utility::forward<T>(value_));
+
+  m_size++;
+  return true;
+}
+
+template<typename T, Size N>
+inline void SmallVector<T, N>::pop_back() {
+  RX_ASSERT(m_size, "empty vector");
+  grow_or_shrink_to(m_size - 1);
+  m_size--;
+}
+
+template<typename T, Size N>
+template<typename... Ts>
+inline bool SmallVector<T, N>::emplace_back(Ts&&... _args) {
+  if (!reserve(m_size + 1)) {
+    return false;
+  }
+
+  // Forward construct object.
+  Utility::construct<T>(m_data + m_size, Utility::forward<Ts>(_args)...);
+
+  m_size++;
+  return true;
+}
+
+template<typename T, Size N>
+RX_HINT_FORCE_INLINE Size SmallVector<T, N>::size() const {
+  return m_size;
+}
+
+template<typename T, Size N>
+RX_HINT_FORCE_INLINE Size SmallVector<T, N>::capacity() const {
+  return m_capacity;
+}
+
+template<typename T, Size N>
+RX_HINT_FORCE_INLINE bool SmallVector<T, N>::is_empty() const {
+  return m_size == 0;
+}
+
+template<typename T, Size N>
+RX_HINT_FORCE_INLINE bool SmallVector<T, N>::in_range(Size _index) const {
+  return _index < m_size;
+}
+
+template<typename T, Size N>
+RX_HINT_FORCE_INLINE bool SmallVector<T, N>::is_inline() const {
+  return m_data == reinterpret_cast<const T*>(m_storage);
+}
+
+template<typename T, Size N>
+template<typename F>
+inline bool SmallVector<T, N>::each_fwd(F&& _func) {
+  for (Size i{0}; i < m_size; i++) {
+    if constexpr (traits::is_same<traits::return_type<F>, bool>) {
+      if (!_func(m_data[i])) {
+        return false;
+      }
+    } else {
+      _func(m_data[i]);
+    }
+  }
+  return true;
+}
+
+template<typename T, Size N>
+template<typename F>
+inline bool SmallVector<T, N>::each_fwd(F&& _func) const {
+  for (Size i{0}; i < m_size; i++) {
+    if constexpr (traits::is_same<traits::return_type<F>, bool>) {
+      if (!_func(m_data[i])) {
+        return false;
+      }
+    } else {
+      _func(m_data[i]);
+    }
+  }
+  return true;
+}
+
+template<typename T, Size N>
+template<typename F>
+inline bool SmallVector<T, N>::each_rev(F&& _func) {
+  for (Size i{m_size - 1}; i < m_size; i--) {
+    if constexpr (traits::is_same<traits::return_type<F>, bool>) {
+      if (!_func(m_data[i])) {
+        return false;
+      }
+    } else {
+      _func(m_data[i]);
+    }
+  }
+  return true;
+}
+
+template<typename T, Size N>
+template<typename F>
+inline bool SmallVector<T, N>::each_rev(F&& _func) const {
+  for (Size i{m_size - 1}; i < m_size; i--) {
+    if constexpr (traits::is_same<traits::return_type<F>, bool>) {
+      if (!_func(m_data[i])) {
+        return false;
+      }
+    } else {
+      _func(m_data[i]);
+    }
+  }
+  return true;
+}
+
+template<typename T, Size N>
+inline void SmallVector<T, N>::erase(Size _from, Size _to) {
+  const Size range{_to - _from};
+  T* begin{m_data};
+  T* end{m_data + m_size};
+  T* first{begin + _from};
+  T* last{begin + _to};
+
+  for (T* value{last}, *dest{first}; value != end; ++value, ++dest) {
+    *dest = Utility::move(*value);
+  }
+
+  if constexpr (!traits::is_trivially_destructible<T>) {
+    for (T* value{end-range}; value < end; ++value) {
+      Utility::destruct<T>(value);
+    }
+  }
+
+  m_size -= range;
+}
+
+template<typename T, Size N>
+RX_HINT_FORCE_INLINE const T& SmallVector<T, N>::first() const {
+  RX_ASSERT(m_size, "empty vector");
+  return m_data[0];
+}
+
+template<typename T, Size N>
+RX_HINT_FORCE_INLINE T& SmallVector<T, N>::first() {
+  RX_ASSERT(m_size, "empty vector");
+  return m_data[0];
+}
+
+template<typename T, Size N>
+RX_HINT_FORCE_INLINE const T& SmallVector<T, N>::last() const {
+  RX_ASSERT(m_size, "empty vector");
+  return m_data[m_size - 1];
+}
+
+template<typename T, Size N>
+RX_HINT_FORCE_INLINE T& SmallVector<T, N>::last() {
+  RX_ASSERT(m_size, "empty vector");
+  return m_data[m_size - 1];
+}
+
+template<typename T, Size N>
+RX_HINT_FORCE_INLINE const T* SmallVector<T, N>::data() const {
+  return m_data;
+}
+
+template<typename T, Size N>
+RX_HINT_FORCE_INLINE T* SmallVector<T, N>::data() {
+  return m_data;
+}
+
+template<typename T, Size N>
+RX_HINT_FORCE_INLINE constexpr Memory::Allocator& SmallVector<T, N>::allocator() const {
+  return *m_allocator;
+}
+
+} // namespace rx
+
+#endif // RX_CORE_SMALL_VECTOR_H
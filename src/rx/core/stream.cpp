@@ -59,6 +59,10 @@ bool Stream::on_stat(Stat&) const {
   abort("stream does not implement on_stat");
 }
 
+const Byte* Stream::on_view(Uint64, Uint64) {
+  return nullptr;
+}
+
 Uint64 Stream::read(Byte* _data, Uint64 _size) {
   if (!can_read() || _size == 0) {
     return 0;
@@ -83,6 +87,19 @@ Uint64 Stream::write(const Byte* _data, Uint64 _size) {
   return write;
 }
 
+const Byte* Stream::view(Uint64 _size) {
+  if (!can_read()) {
+    return nullptr;
+  }
+
+  const auto data = on_view(_size, m_offset);
+  if (data) {
+    m_offset += _size;
+  }
+
+  return data;
+}
+
 bool Stream::seek(Sint64 _where, Whence _whence) {
   // Calculate the new offset based on |_whence|.
   if (_whence == Whence::CURRENT) {
@@ -40,6 +40,12 @@ struct RX_API Stream {
   // Write |_size| bytes from |_data|. Returns the amount of bytes written.
   [[nodiscard]] Uint64 write(const Byte* _data, Uint64 _size);
 
+  // View the next |_size| bytes of the stream in place, without copying them.
+  // The stream advances as if they were read. Returns nullptr when the stream
+  // cannot provide such a view, in which case nothing happens and |read| has to
+  // be used instead. The view is only valid for the lifetime of the stream.
+  [[nodiscard]] const Byte* view(Uint64 _size);
+
   // Seek stream |_where| bytes relative to |_whence|. Returns true on success.
   [[nodiscard]] bool seek(Sint64 _where, Whence _whence);
 
@@ -76,7 +82,14 @@ protected:
   // Stat the stream.
   virtual bool on_stat(Stat& stat_) const;
 
+  // View |_size| bytes of the stream at |_offset|. Streams which don't keep
+  // their contents in memory need not implement this.
+  virtual const Byte* on_view(Uint64 _size, Uint64 _offset);
+
 private:
+  // Serves reads and writes from its buffer without |on_read| and |on_write|.
+  friend struct BufferedStream;
+
   // End-of-stream flag. This is set when |on_read| returns a truncated result.
   static inline constexpr Uint32 EOS = 1 << 31;
   Uint32 m_flags;
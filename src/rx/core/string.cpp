@@ -6,7 +6,7 @@
 
 #include "rx/core/utility/swap.h"
 
-#include "rx/core/hash/fnv1a.h"
+#include "rx/core/hash/bytes.h"
 
 #include "rx/core/hints/unreachable.h"
 #include "rx/core/hints/unlikely.h"
@@ -518,13 +518,7 @@ bool String::contains(const String& _needle) const {
 }
 
 Size String::hash() const {
-  const Byte* data = reinterpret_cast<const Byte*>(m_data);
-  if constexpr (sizeof(Size) == 8) {
-    return Hash::fnv1a<Uint64>(data, size());
-  } else {
-    return Hash::fnv1a<Uint32>(data, size());
-  }
-  RX_HINT_UNREACHABLE();
+  return Hash::bytes(reinterpret_cast<const Byte*>(m_data), size());
 }
 
 Memory::View String::disown() {
@@ -3,6 +3,7 @@
 #include "rx/core/assert.h" // RX_ASSERT
 #include "rx/core/format.h" // format
 #include "rx/core/vector.h" // vector
+#include "rx/core/string_view.h" // StringView
 
 #include "rx/core/traits/remove_cvref.h"
 
@@ -18,6 +19,10 @@ struct RX_API String {
   static inline constexpr const Size k_npos{-1_z};
   static inline constexpr const Size k_small_string{16};
 
+  // Hash containers with |String| keys are searched with a |StringView| so a
+  // literal or a view doesn't have to be copied into a |String| to find it.
+  using LookupKey = StringView;
+
   constexpr String(Memory::Allocator& _allocator);
   String(Memory::Allocator& _allocator, const String& _contents);
   String(Memory::Allocator& _allocator, const char* _contents);
@@ -1,45 +1,152 @@
-#include <string.h> // strstr, strlen, memcpy
+#include <string.h> // strlen, memchr, memcpy, memcmp
 
 #include "rx/core/string_table.h"
 #include "rx/core/string.h"
 
+#include "rx/core/hash/bytes.h"
+
 #include "rx/core/hints/unlikely.h"
 
 namespace Rx {
 
+// Slots the index starts with, always a power of two.
+static constexpr const Size k_initial_slots{64};
+
 StringTable::StringTable(Memory::Allocator& _allocator, const char* _data, Size _size)
   : m_data{_allocator, _size}
+  , m_slots{_allocator}
+  , m_count{0}
+  , m_indexed{0}
 {
   RX_ASSERT(_data[_size] == '\0', "missing null-terminator");
   memcpy(m_data.data(), _data, _size);
 }
 
-Optional<Size> StringTable::find(const char* _string) const {
-  if (RX_HINT_UNLIKELY(m_data.is_empty())) {
+Size StringTable::hash_string(const char* _string, Size _size) {
+  const Size hash{Hash::bytes(reinterpret_cast<const Byte*>(_string), _size)};
+  // Zero marks an empty slot.
+  return hash ? hash : 1;
+}
+
+Optional<Size> StringTable::find(const char* _string, Size _size, Size _hash) const {
+  if (RX_HINT_UNLIKELY(m_slots.is_empty())) {
     return nullopt;
   }
 
-  if (const char* search = strstr(m_data.data(), _string)) {
-    return static_cast<Size>(search - m_data.data());
+  const Size mask{m_slots.size() - 1};
+  for (Size i{_hash & mask}; ; i = (i + 1) & mask) {
+    const Slot& slot{m_slots[i]};
+    if (slot.hash == 0) {
+      return nullopt;
+    }
+
+    // Strings in the table are null-terminated, so comparing the terminator
+    // as well makes sure the one in the table isn't just longer.
+    if (slot.hash == _hash && slot.offset + _size < m_data.size()) {
+      const char* string{m_data.data() + slot.offset};
+      if (string[_size] == '\0' && memcmp(string, _string, _size) == 0) {
+        return slot.offset;
+      }
+    }
   }
-  return nullopt;
 }
 
-Optional<Size> StringTable::add(const char* _string, Size _size) {
-  const Size index = m_data.size();
-  const Size total = _size + 1;
-  if (m_data.resize(index + total, Utility::UninitializedTag{})) {
-    memcpy(m_data.data() + index, _string, total);
-    return index;
+Optional<Size> StringTable::add(const char* _string, Size _size, Size _hash) {
+  const Size offset = m_data.size();
+  if (!m_data.resize(offset + _size + 1, Utility::UninitializedTag{})) {
+    return nullopt;
+  }
+
+  memcpy(m_data.data() + offset, _string, _size);
+  m_data[offset + _size] = '\0';
+
+  if (!index(offset, _hash)) {
+    m_data.resize(offset, Utility::UninitializedTag{});
+    return nullopt;
   }
-  return nullopt;
+
+  m_indexed = m_data.size();
+
+  return offset;
+}
+
+bool StringTable::index(Size _offset, Size _hash) {
+  // Keep the load factor at or below 3/4.
+  if ((m_count + 1) * 4 > m_slots.size() * 3 && !grow()) {
+    return false;
+  }
+
+  const Size mask{m_slots.size() - 1};
+  for (Size i{_hash & mask}; ; i = (i + 1) & mask) {
+    Slot& slot{m_slots[i]};
+    if (slot.hash == 0) {
+      slot = {_hash, _offset};
+      m_count++;
+      return true;
+    }
+  }
+}
+
+bool StringTable::index_data() {
+  while (m_indexed < m_data.size()) {
+    const char* string{m_data.data() + m_indexed};
+    const auto end{static_cast<const char*>(memchr(string, '\0', m_data.size() - m_indexed))};
+    if (!end) {
+      // An unterminated string at the end can't be found.
+      m_indexed = m_data.size();
+      break;
+    }
+
+    const Size size{static_cast<Size>(end - string)};
+    const Size hash{hash_string(string, size)};
+
+    // The raw data may have the same string more than once, the first one is
+    // the one that is found.
+    if (!find(string, size, hash) && !index(m_indexed, hash)) {
+      return false;
+    }
+
+    m_indexed += size + 1;
+  }
+  return true;
+}
+
+bool StringTable::grow() {
+  const Size size{m_slots.is_empty() ? k_initial_slots : m_slots.size() * 2};
+
+  Vector<Slot> slots{allocator()};
+  if (!slots.resize(size, {0, 0})) {
+    return false;
+  }
+
+  const Size mask{size - 1};
+  m_slots.each_fwd([&](const Slot& _slot) {
+    if (_slot.hash == 0) {
+      return;
+    }
+    Size i{_slot.hash & mask};
+    while (slots[i].hash != 0) {
+      i = (i + 1) & mask;
+    }
+    slots[i] = _slot;
+  });
+
+  m_slots = Utility::move(slots);
+
+  return true;
 }
 
 Optional<Size> StringTable::insert(const char* _string, Size _size) {
-  if (auto search = find(_string)) {
+  if (RX_HINT_UNLIKELY(m_indexed != m_data.size()) && !index_data()) {
+    return nullopt;
+  }
+
+  const Size hash{hash_string(_string, _size)};
+  if (auto search = find(_string, _size, hash)) {
     return *search;
   }
-  return add(_string, _size);
+
+  return add(_string, _size, hash);
 }
 
 Optional<Size> StringTable::insert(const char* _string) {
@@ -50,4 +157,15 @@ Optional<Size> StringTable::insert(const String& _string) {
   return insert(_string.data(), _string.size());
 }
 
+void StringTable::clear() {
+  m_data.clear();
+  if (m_count) {
+    m_slots.each_fwd([](Slot& slot_) {
+      slot_.hash = 0;
+    });
+    m_count = 0;
+  }
+  m_indexed = 0;
+}
+
 } // namespace rx
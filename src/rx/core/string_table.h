@@ -3,10 +3,23 @@
 #include "rx/core/vector.h"
 #include "rx/core/optional.h"
 
+#include "rx/core/utility/exchange.h"
+
 namespace Rx {
 
 struct String;
 
+// # String Table
+//
+// Strings stored back to back with their null-terminators, referred to by the
+// offset of their first character. Inserting a string that is already in the
+// table gives the offset of the existing one.
+//
+// An open-addressed hash index of the strings is kept next to the character
+// data so inserting is O(1) on average. Strings of a table constructed from
+// raw data are indexed on the first insert.
+//
+// Use |clear| to reuse a table, it keeps all memory.
 struct RX_API StringTable {
   constexpr StringTable();
   constexpr StringTable(Memory::Allocator& _allocator);
@@ -35,10 +48,27 @@ struct RX_API StringTable {
   constexpr Memory::Allocator& allocator() const;
 
 private:
-  Optional<Size> find(const char* _string) const;
-  Optional<Size> add(const char* _string, Size _size);
+  // A |hash| of zero marks an empty slot.
+  struct Slot {
+    Size hash;
+    Size offset;
+  };
+
+  static Size hash_string(const char* _string, Size _size);
+
+  Optional<Size> find(const char* _string, Size _size, Size _hash) const;
+  Optional<Size> add(const char* _string, Size _size, Size _hash);
+
+  [[nodiscard]] bool index(Size _offset, Size _hash);
+  [[nodiscard]] bool index_data();
+  [[nodiscard]] bool grow();
 
   Vector<char> m_data;
+  Vector<Slot> m_slots;
+  Size m_count;
+
+  // The strings in |m_data| before this offset are in the index.
+  Size m_indexed;
 };
 
 inline constexpr StringTable::StringTable()
@@ -48,31 +78,49 @@ inline constexpr StringTable::StringTable()
 
 inline constexpr StringTable::StringTable(Memory::Allocator& _allocator)
   : m_data{_allocator}
+  , m_slots{_allocator}
+  , m_count{0}
+  , m_indexed{0}
 {
 }
 
 inline StringTable::StringTable(Vector<char>&& data_)
   : m_data{Utility::move(data_)}
+  , m_slots{m_data.allocator()}
+  , m_count{0}
+  , m_indexed{0}
 {
 }
 
 inline StringTable::StringTable(StringTable&& string_table_)
   : m_data{Utility::move(string_table_.m_data)}
+  , m_slots{Utility::move(string_table_.m_slots)}
+  , m_count{Utility::exchange(string_table_.m_count, 0)}
+  , m_indexed{Utility::exchange(string_table_.m_indexed, 0)}
 {
 }
 
 inline StringTable::StringTable(const StringTable& _string_table)
   : m_data{_string_table.m_data}
+  , m_slots{_string_table.m_slots}
+  , m_count{_string_table.m_count}
+  , m_indexed{_string_table.m_indexed}
 {
 }
 
 inline StringTable& StringTable::operator=(StringTable&& string_table_) {
   m_data = Utility::move(string_table_.m_data);
+  m_slots = Utility::move(string_table_.m_slots);
+  m_count = Utility::exchange(string_table_.m_count, 0);
+  m_indexed = Utility::exchange(string_table_.m_indexed, 0);
   return *this;
 }
 
 inline StringTable& StringTable::operator=(const StringTable& _string_table) {
   m_data = _string_table.m_data;
+  m_slots = _string_table.m_slots;
+  m_count = _string_table.m_count;
+  m_indexed = _string_table.m_indexed;
   return *this;
 }
 
@@ -88,9 +136,6 @@ inline Size StringTable::size() const {
   return m_data.size();
 }
 
-inline void StringTable::clear() {
-  m_data.clear();
-}
 
 RX_HINT_FORCE_INLINE constexpr Memory::Allocator& StringTable::allocator() const {
   return m_data.allocator();
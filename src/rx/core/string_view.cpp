@@ -0,0 +1,35 @@
+#include <string.h> // strlen, memcmp
+
+#include "rx/core/string_view.h"
+#include "rx/core/string.h"
+
+#include "rx/core/hash/bytes.h"
+
+namespace Rx {
+
+StringView::StringView(const char* _string)
+  : m_data{_string}
+  , m_size{strlen(_string)}
+{
+}
+
+StringView::StringView(const String& _string)
+  : m_data{_string.data()}
+  , m_size{_string.size()}
+{
+}
+
+Size StringView::hash() const {
+  // Must match |String::hash|.
+  return Hash::bytes(reinterpret_cast<const Byte*>(m_data), m_size);
+}
+
+bool operator==(const StringView& _lhs, const StringView& _rhs) {
+  return _lhs.size() == _rhs.size() && memcmp(_lhs.data(), _rhs.data(), _lhs.size()) == 0;
+}
+
+bool operator!=(const StringView& _lhs, const StringView& _rhs) {
+  return !(_lhs == _rhs);
+}
+
+} // namespace rx
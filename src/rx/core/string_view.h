@@ -0,0 +1,73 @@
+#ifndef RX_CORE_STRING_VIEW_H
+#define RX_CORE_STRING_VIEW_H
+#include "rx/core/assert.h" // RX_ASSERT
+
+namespace Rx {
+
+struct String;
+
+// # String View
+//
+// A pointer and size into characters owned by something else, usually a
+// |String| or a literal. Nothing is copied or allocated, so the characters
+// must outlive the view. The characters need not be null-terminated.
+//
+// Hashes and compares equal to a |String| with the same contents, which lets
+// the hash containers look up |String| keys with a view, see |LookupKey|.
+//
+// 32-bit: 8 bytes
+// 64-bit: 16 bytes
+struct RX_API StringView {
+  constexpr StringView();
+  constexpr StringView(const char* _data, Size _size);
+  StringView(const char* _string);
+  StringView(const String& _string);
+
+  const char& operator[](Size _index) const;
+
+  const char* data() const;
+  Size size() const;
+  bool is_empty() const;
+
+  Size hash() const;
+
+private:
+  const char* m_data;
+  Size m_size;
+};
+
+RX_API bool operator==(const StringView& _lhs, const StringView& _rhs);
+RX_API bool operator!=(const StringView& _lhs, const StringView& _rhs);
+
+inline constexpr StringView::StringView()
+  : m_data{""}
+  , m_size{0}
+{
+}
+
+inline constexpr StringView::StringView(const char* _data, Size _size)
+  : m_data{_data}
+  , m_size{_size}
+{
+}
+
+inline const char& StringView::operator[](Size _index) const {
+  RX_ASSERT(_index < m_size, "out of bounds");
+  return m_data[_index];
+}
+
+inline const char* StringView::data() const {
+  return m_data;
+}
+
+inline Size StringView::size() const {
+  return m_size;
+}
+
+inline bool StringView::is_empty() const {
+  return m_size == 0;
+}
+
+} // namespace rx
+
+#endif // RX_CORE_STRING_VIEW_H
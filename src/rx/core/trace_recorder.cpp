@@ -0,0 +1,307 @@
+#include <string.h> // strncpy
+
+#include "rx/core/trace_recorder.h"
+#include "rx/core/stream.h"
+#include "rx/core/string.h"
+
+#include "rx/core/concurrency/scope_lock.h"
+
+#include "rx/core/hints/likely.h"
+#include "rx/core/hints/unlikely.h"
+
+#include "rx/core/utility/construct.h"
+
+#include "rx/core/time/qpc.h"
+
+namespace Rx {
+
+Global<TraceRecorder> TraceRecorder::s_instance{"system", "trace_recorder"};
+
+// The ring buffer of the calling thread and the name given to it. The name is
+// kept separate since threads are named before they record anything.
+static thread_local struct {
+  const TraceRecorder* owner;
+  void* buffer;
+  char name[64];
+} t_trace;
+
+TraceRecorder::TraceRecorder(Memory::Allocator& _allocator)
+  : m_allocator{_allocator}
+  , m_buffers{allocator()}
+  , m_recording{false}
+  , m_frame_count{0}
+{
+}
+
+TraceRecorder::~TraceRecorder() {
+  m_buffers.each_fwd([this](Buffer* _buffer) {
+    allocator().deallocate(_buffer);
+  });
+}
+
+Profiler::CPU TraceRecorder::cpu_device() {
+  return {this, on_thread_name, on_begin_cpu, on_end_cpu};
+}
+
+Profiler::GPU TraceRecorder::gpu_device() {
+  return {this, on_thread_name, on_begin_gpu, on_end_gpu};
+}
+
+void TraceRecorder::mark_frame() {
+  const Uint64 count{m_frame_count.load(Concurrency::MemoryOrder::k_relaxed)};
+  m_frames[count % k_max_frames] = Time::qpc_ticks();
+  m_frame_count.store(count + 1, Concurrency::MemoryOrder::k_release);
+}
+
+TraceRecorder::Buffer* TraceRecorder::buffer() {
+  if (RX_HINT_LIKELY(t_trace.owner == this)) {
+    return reinterpret_cast<Buffer*>(t_trace.buffer);
+  }
+
+  auto data{allocator().allocate(sizeof(Buffer) + sizeof(Event) * k_events_per_thread)};
+  if (!data) {
+    return nullptr;
+  }
+
+  auto buffer{reinterpret_cast<Buffer*>(data)};
+  Utility::construct<Concurrency::Atomic<Uint64>>(&buffer->head, 0_u64);
+  strncpy(buffer->name, t_trace.name, sizeof buffer->name);
+  buffer->events = reinterpret_cast<Event*>(data + sizeof(Buffer));
+
+  {
+    Concurrency::ScopeLock lock{m_lock};
+    buffer->id = m_buffers.size() + 1;
+    if (!m_buffers.push_back(buffer)) {
+      allocator().deallocate(data);
+      return nullptr;
+    }
+  }
+
+  t_trace.owner = this;
+  t_trace.buffer = buffer;
+
+  return buffer;
+}
+
+void TraceRecorder::record(Uint8 _kind, bool _gpu, const Profiler::Sample* _sample) {
+  if (!is_recording()) {
+    return;
+  }
+
+  auto buffer{this->buffer()};
+  if (RX_HINT_UNLIKELY(!buffer)) {
+    return;
+  }
+
+  // Only this thread writes |head|, the release publishes the event.
+  const Uint64 head{buffer->head.load(Concurrency::MemoryOrder::k_relaxed)};
+  Event& event{buffer->events[head % k_events_per_thread]};
+  event.ticks = Time::qpc_ticks();
+  event.tag = _sample->tag();
+  event.kind = _kind;
+  event.gpu = _gpu;
+  buffer->head.store(head + 1, Concurrency::MemoryOrder::k_release);
+}
+
+void TraceRecorder::on_thread_name(void* _context, const char* _name) {
+  auto self{reinterpret_cast<TraceRecorder*>(_context)};
+  strncpy(t_trace.name, _name, sizeof t_trace.name - 1);
+  if (t_trace.owner == self) {
+    auto buffer{reinterpret_cast<Buffer*>(t_trace.buffer)};
+    strncpy(buffer->name, t_trace.name, sizeof buffer->name);
+  }
+}
+
+void TraceRecorder::on_begin_cpu(void* _context, const Profiler::Sample* _sample) {
+  reinterpret_cast<TraceRecorder*>(_context)->record(Event::k_begin, false, _sample);
+}
+
+void TraceRecorder::on_end_cpu(void* _context, const Profiler::Sample* _sample) {
+  reinterpret_cast<TraceRecorder*>(_context)->record(Event::k_end, false, _sample);
+}
+
+void TraceRecorder::on_begin_gpu(void* _context, const Profiler::Sample* _sample) {
+  reinterpret_cast<TraceRecorder*>(_context)->record(Event::k_begin, true, _sample);
+}
+
+void TraceRecorder::on_end_gpu(void* _context, const Profiler::Sample* _sample) {
+  reinterpret_cast<TraceRecorder*>(_context)->record(Event::k_end, true, _sample);
+}
+
+// Buffers the JSON and writes it to the stream in large pieces.
+struct TraceWriter {
+  static inline constexpr const Size k_flush_size{64 << 10};
+
+  TraceWriter(Memory::Allocator& _allocator, Stream* _stream)
+    : m_stream{_stream}
+    , m_contents{_allocator}
+    , m_first{true}
+    , m_valid{true}
+  {
+  }
+
+  template<typename... Ts>
+  void print(const char* _format, Ts&&... _arguments) {
+    m_contents.append(String::format(m_contents.allocator(), _format,
+      Utility::forward<Ts>(_arguments)...));
+    if (m_contents.size() >= k_flush_size) {
+      flush();
+    }
+  }
+
+  // Begin the next event in the array.
+  void next() {
+    if (m_first) {
+      m_first = false;
+    } else {
+      m_contents.append(",\n");
+    }
+  }
+
+  void escape(const char* _string) {
+    for (const char* ch{_string}; *ch; ch++) {
+      switch (*ch) {
+      case '"':
+        m_contents.append("\\\"");
+        break;
+      case '\\':
+        m_contents.append("\\\\");
+        break;
+      default:
+        if (static_cast<Byte>(*ch) < 0x20) {
+          print("\\u%04x", static_cast<Uint32>(*ch));
+        } else {
+          m_contents.append(*ch);
+        }
+        break;
+      }
+    }
+  }
+
+  bool flush() {
+    const auto size{m_contents.size()};
+    if (size && m_stream->write(reinterpret_cast<const Byte*>(m_contents.data()), size) != size) {
+      m_valid = false;
+    }
+    m_contents.clear();
+    return m_valid;
+  }
+
+private:
+  Stream* m_stream;
+  String m_contents;
+  bool m_first;
+  bool m_valid;
+};
+
+bool TraceRecorder::dump(Stream* _stream, Size _frames) {
+  if (!_stream->can_write()) {
+    return false;
+  }
+
+  const Float64 us_per_tick{1000000.0 / static_cast<Float64>(Time::qpc_frequency())};
+
+  // The window starts at the end of the frame before the first one in it, so
+  // it takes one slot more than the frames in it. The slot |mark_frame| writes
+  // next is not read, which leaves room for at most |k_max_frames| - 2 frames.
+  const Uint64 frame_count{m_frame_count.load(Concurrency::MemoryOrder::k_acquire)};
+  const Uint64 frames{_frames < k_max_frames - 2 ? _frames : k_max_frames - 2};
+  const Uint64 first_frame{frame_count > frames ? frame_count - frames : 0};
+  const Uint64 window{first_frame ? m_frames[(first_frame - 1) % k_max_frames] : 0};
+
+  // Copy the buffer list so threads starting now don't wait on the dump.
+  Vector<Buffer*> buffers{allocator()};
+  {
+    Concurrency::ScopeLock lock{m_lock};
+    buffers = m_buffers;
+  }
+
+  TraceWriter writer{allocator(), _stream};
+  writer.print("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+  writer.next();
+  writer.print("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"cpu\"}}");
+  writer.next();
+  writer.print("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"args\":{\"name\":\"gpu\"}}");
+
+  struct Open {
+    const char* tag;
+    Uint64 ticks;
+  };
+
+  Vector<Event> events{allocator()};
+  Vector<Open> open[2]{{allocator()}, {allocator()}};
+
+  buffers.each_fwd([&](Buffer* _buffer) {
+    // Copy what's in the ring, then find out how much of it the thread wrote
+    // over while copying. The slot of the event after the last published one
+    // may be half written too.
+    const Uint64 head{_buffer->head.load(Concurrency::MemoryOrder::k_acquire)};
+    const Uint64 tail{head > k_events_per_thread ? head - k_events_per_thread : 0};
+    if (!events.resize(head - tail, Utility::UninitializedTag{})) {
+      return;
+    }
+    for (Uint64 i{tail}; i < head; i++) {
+      events[i - tail] = _buffer->events[i % k_events_per_thread];
+    }
+    Concurrency::atomic_thread_fence(Concurrency::MemoryOrder::k_acquire);
+    const Uint64 after{_buffer->head.load(Concurrency::MemoryOrder::k_relaxed)};
+    const Uint64 valid{after + 1 > k_events_per_thread ? after + 1 - k_events_per_thread : 0};
+
+    for (Size i{0}; i < 2; i++) {
+      writer.next();
+      writer.print("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%zu,\"tid\":%zu,\"args\":{\"name\":\"",
+        i + 1, _buffer->id);
+      if (*_buffer->name) {
+        writer.escape(_buffer->name);
+      } else {
+        writer.print("thread %zu", _buffer->id);
+      }
+      writer.print("\"}}");
+    }
+
+    open[0].clear();
+    open[1].clear();
+    for (Uint64 i{valid > tail ? valid : tail}; i < head; i++) {
+      const Event& event{events[i - tail]};
+      auto& stack{open[event.gpu]};
+      if (event.kind == Event::k_begin) {
+        stack.push_back({event.tag, event.ticks});
+        continue;
+      }
+
+      // The begin of this one was overwritten or came before recording.
+      if (stack.is_empty()) {
+        continue;
+      }
+
+      const Open begin{stack.last()};
+      stack.pop_back();
+      if (event.ticks < window) {
+        continue;
+      }
+
+      writer.next();
+      writer.print("{\"name\":\"");
+      writer.escape(begin.tag);
+      writer.print("\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%zu}",
+        event.gpu ? "gpu" : "cpu",
+        static_cast<Float64>(begin.ticks) * us_per_tick,
+        static_cast<Float64>(event.ticks - begin.ticks) * us_per_tick,
+        event.gpu ? 2 : 1,
+        _buffer->id);
+    }
+  });
+
+  for (Uint64 i{first_frame}; i < frame_count; i++) {
+    writer.next();
+    writer.print("{\"name\":\"frame %zu\",\"cat\":\"frame\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%.3f,\"pid\":1,\"tid\":0}",
+      static_cast<Size>(i), static_cast<Float64>(m_frames[i % k_max_frames]) * us_per_tick);
+  }
+
+  writer.print("\n]}\n");
+
+  return writer.flush();
+}
+
+} // namespace rx
@@ -0,0 +1,124 @@
+#ifndef RX_CORE_TRACE_RECORDER_H
+#define RX_CORE_TRACE_RECORDER_H
+#include "rx/core/profiler.h"
+#include "rx/core/vector.h"
+
+#include "rx/core/concurrency/atomic.h"
+#include "rx/core/concurrency/spin_lock.h"
+
+namespace Rx {
+
+struct Stream;
+
+// # Trace Recorder
+//
+// A profiler device that records every sample into a ring buffer per thread
+// and writes the most recent frames out in the Chrome trace event format, to
+// be viewed with chrome://tracing or Perfetto.
+//
+// Recording a sample is a timestamp and a store into the ring of the calling
+// thread, no locks are taken and nothing is allocated except on the first
+// sample of a thread. When a ring is full the oldest samples are overwritten.
+//
+// GPU samples are recorded with CPU timestamps taken when the commands are
+// recorded, they're kept apart from CPU samples under the "gpu" category.
+struct RX_API TraceRecorder {
+  static inline constexpr const Size k_events_per_thread{1 << 15};
+  static inline constexpr const Size k_max_frames{256};
+
+  TraceRecorder();
+  TraceRecorder(Memory::Allocator& _allocator);
+  ~TraceRecorder();
+
+  // Devices to bind with |Profiler::bind_cpu| and |Profiler::bind_gpu|.
+  Profiler::CPU cpu_device();
+  Profiler::GPU gpu_device();
+
+  // Samples are only recorded while recording. The devices can be left bound
+  // with recording off, that only costs a load per sample.
+  void record(bool _record);
+  bool is_recording() const;
+
+  // Mark the end of a frame, called once a frame by the thread that presents.
+  void mark_frame();
+
+  // Write the samples of the last |_frames| frames, at most |k_max_frames| - 2,
+  // to |_stream| as Chrome trace JSON. Samples still open or overwritten are
+  // left out.
+  //
+  // This function is thread-safe and may be called while recording.
+  bool dump(Stream* _stream, Size _frames);
+
+  constexpr Memory::Allocator& allocator() const;
+
+  static TraceRecorder& instance();
+
+private:
+  struct Event {
+    enum : Uint8 {
+      k_begin,
+      k_end
+    };
+
+    Uint64 ticks;
+    const char* tag;
+    Uint8 kind;
+    bool gpu;
+  };
+
+  // Only written by the thread it belongs to. Events are published by
+  // advancing |head|, the slot for index |i| is |i % k_events_per_thread|.
+  struct Buffer {
+    Concurrency::Atomic<Uint64> head;
+    char name[64];
+    Size id;
+    Event* events;
+  };
+
+  Buffer* buffer();
+  void record(Uint8 _kind, bool _gpu, const Profiler::Sample* _sample);
+
+  static void on_thread_name(void* _context, const char* _name);
+  static void on_begin_cpu(void* _context, const Profiler::Sample* _sample);
+  static void on_end_cpu(void* _context, const Profiler::Sample* _sample);
+  static void on_begin_gpu(void* _context, const Profiler::Sample* _sample);
+  static void on_end_gpu(void* _context, const Profiler::Sample* _sample);
+
+  Memory::Allocator& m_allocator;
+
+  Concurrency::SpinLock m_lock;
+  Vector<Buffer*> m_buffers RX_HINT_GUARDED_BY(m_lock);
+
+  Concurrency::Atomic<bool> m_recording;
+
+  // Ticks at the end of every frame, only written by |mark_frame|.
+  Uint64 m_frames[k_max_frames];
+  Concurrency::Atomic<Uint64> m_frame_count;
+
+  static Global<TraceRecorder> s_instance;
+};
+
+inline TraceRecorder::TraceRecorder()
+  : TraceRecorder{Memory::SystemAllocator::instance()}
+{
+}
+
+inline void TraceRecorder::record(bool _record) {
+  m_recording.store(_record, Concurrency::MemoryOrder::k_relaxed);
+}
+
+inline bool TraceRecorder::is_recording() const {
+  return m_recording.load(Concurrency::MemoryOrder::k_relaxed);
+}
+
+inline constexpr Memory::Allocator& TraceRecorder::allocator() const {
+  return m_allocator;
+}
+
+inline TraceRecorder& TraceRecorder::instance() {
+  return *s_instance;
+}
+
+} // namespace rx
+
+#endif // RX_CORE_TRACE_RECORDER_H
@@ -2,7 +2,7 @@
 #define RX_CORE_TRAITS_REMOVE_POINTER_H
 #include "rx/core/traits/type_identity.h"
 
-namespace rx::traits {
+namespace Rx::traits {
 
 namespace detail {
   template<typename T>
@@ -7,6 +7,9 @@ namespace Rx {
 template<typename T>
 inline Size bit_search_lsb(T _bits);
 
+template<typename T>
+inline Size bit_search_msb(T _bits);
+
 template<typename T>
 inline Size bit_pop_count(T _bits);
 
@@ -22,6 +25,16 @@ inline Size bit_search_lsb(Uint64 _bits) {
   return _bits ? __builtin_ctzll(_bits) : 64;
 }
 
+template<>
+inline Size bit_search_msb(Uint32 _bits) {
+  return _bits ? 31 - __builtin_clz(_bits) : 32;
+}
+
+template<>
+inline Size bit_search_msb(Uint64 _bits) {
+  return _bits ? 63 - __builtin_clzll(_bits) : 64;
+}
+
 template<>
 inline Size bit_pop_count(Uint32 _bits) {
   return __builtin_popcountl(_bits);
@@ -53,6 +66,45 @@ inline Size bit_search_lsb(Uint64 _bits) {
   return _bits ? k_table[Uint64{(_bits & -_bits) * 0x022fdd63cc95386d} >> 58] : 64;
 }
 
+template<>
+inline Size bit_search_msb(Uint32 _bits) {
+  static constexpr const Byte k_table[]{
+    0, 9, 1, 10, 13, 21, 2, 29, 11, 14, 16, 18, 22, 25, 3, 30, 8, 12, 20, 28,
+    15, 17, 24, 7, 19, 27, 23, 6, 26, 5, 4, 31
+  };
+  if (!_bits) {
+    return 32;
+  }
+  // smear the highest set bit into every bit below it
+  _bits |= _bits >> 1;
+  _bits |= _bits >> 2;
+  _bits |= _bits >> 4;
+  _bits |= _bits >> 8;
+  _bits |= _bits >> 16;
+  return k_table[Uint32{_bits * 0x07c4acdd} >> 27];
+}
+
+template<>
+inline Size bit_search_msb(Uint64 _bits) {
+  static constexpr const Byte k_table[]{
+    0, 47, 1, 56, 48, 27, 2, 60, 57, 49, 41, 37, 28, 16, 3, 61, 54, 58, 35, 52,
+    50, 42, 21, 44, 38, 32, 29, 23, 17, 11, 4, 62, 46, 55, 26, 59, 40, 36, 15,
+    53, 34, 51, 20, 43, 31, 22, 10, 45, 25, 39, 14, 33, 19, 30, 9, 24, 13, 18,
+    8, 12, 7, 6, 5, 63
+  };
+  if (!_bits) {
+    return 64;
+  }
+  // smear the highest set bit into every bit below it
+  _bits |= _bits >> 1;
+  _bits |= _bits >> 2;
+  _bits |= _bits >> 4;
+  _bits |= _bits >> 8;
+  _bits |= _bits >> 16;
+  _bits |= _bits >> 32;
+  return k_table[Uint64{_bits * 0x03f79d71b4cb0a89} >> 58];
+}
+
 template<>
 inline Size bit_pop_count(Uint32 _bits) {
   // hamming weight to count set bits; 17 arithmetic ops on x86_64
@@ -11,6 +11,8 @@
 #include "rx/display.h"
 
 #include "rx/core/filesystem/file.h"
+#include "rx/core/filesystem/archive.h"
+#include "rx/core/trace_recorder.h"
 
 // TODO(dweiler): Game factory...
 extern Rx::Ptr<Rx::Game> create(Rx::Render::Frontend::Context&, Rx::Input::Context&);
@@ -91,6 +93,20 @@ RX_CONSOLE_IVAR(
   65536,
   0x4597);
 
+RX_CONSOLE_BVAR(
+  profile_trace,
+  "profile.trace",
+  "record profile samples for trace_dump",
+  false);
+
+RX_CONSOLE_IVAR(
+  profile_trace_frames,
+  "profile.trace_frames",
+  "number of frames written by trace_dump",
+  1,
+  254,
+  60);
+
 RX_CONSOLE_IVAR(
   thread_pool_threads,
   "thread_pool.threads",
@@ -107,6 +123,24 @@ RX_CONSOLE_IVAR(
   4096,
   1024);
 
+RX_CONSOLE_BVAR(
+  log_deferred,
+  "log.deferred",
+  "format log messages on the logging thread rather than the calling thread",
+  false);
+
+RX_CONSOLE_SVAR(
+  log_binary,
+  "log.binary",
+  "file to also write the log to in binary form (empty disables)",
+  "");
+
+RX_CONSOLE_SVAR(
+  filesystem_archive,
+  "filesystem.archive",
+  "archive to look for files in before the file system (empty disables)",
+  "base.pak");
+
 static Global<Filesystem::File> g_engine_log{"system", "log", "log.log", "wb"};
 static constexpr const char* CONFIG = "config.cfg";
 
@@ -134,6 +168,12 @@ Engine::~Engine() {
   // The engine log should be moved to main so that it survives a longer time.
   Log::flush();
   Log::unsubscribe(&g_engine_log);
+  if (m_binary_log) {
+    Log::unsubscribe(m_binary_log.get());
+  }
+
+  Profiler::instance().unbind_cpu();
+  Profiler::instance().unbind_gpu();
 }
 
 bool Engine::init() {
@@ -149,6 +189,36 @@ bool Engine::init() {
     m_console.save(CONFIG);
   }
 
+  Log::defer(*log_deferred);
+  m_on_log_deferred_change = log_deferred->on_change([](bool _value) {
+    Log::defer(_value);
+  });
+
+  if (const auto& file_name = log_binary->get(); !file_name.is_empty()) {
+    auto& allocator = Memory::SystemAllocator::instance();
+    m_binary_log = make_ptr<Filesystem::File>(allocator, file_name, "wb");
+    if (!m_binary_log || !*m_binary_log || !Log::subscribe_binary(m_binary_log.get())) {
+      m_binary_log = nullptr;
+    }
+  }
+
+  // The trace recorder has to be bound before any threads are started for it
+  // to know their names.
+  Globals::find("system")->find("trace_recorder")->init();
+  auto& trace_recorder = TraceRecorder::instance();
+  if (*profile_cpu) {
+    Profiler::instance().bind_cpu(trace_recorder.cpu_device());
+  }
+  if (*profile_gpu) {
+    Profiler::instance().bind_gpu(trace_recorder.gpu_device());
+  }
+  Profiler::instance().set_thread_name("main");
+
+  trace_recorder.record(*profile_trace);
+  m_on_profile_trace_change = profile_trace->on_change([](bool _value) {
+    TraceRecorder::instance().record(_value);
+  });
+
   const Size static_pool_size = *thread_pool_static_pool_size;
   const Size threads = *thread_pool_threads ? *thread_pool_threads : SDL_GetCPUCount();
   Globals::find("system")->find("thread_pool")->init(threads, static_pool_size);
@@ -178,6 +248,11 @@ bool Engine::init() {
   // Initialize any other globals not already initialized.
   Globals::init();
 
+  // Mount the archive before anything is loaded so it's found in there.
+  if (const auto& file_name = filesystem_archive->get(); !file_name.is_empty()) {
+    Filesystem::Archive::instance().mount(file_name);
+  }
+
   // Bind some useful console commands early.
   m_console.add_command("reset", "s", [](Console::Context& console_, const Vector<Console::Command::Argument>& _arguments) {
     if (auto* variable = console_.find_variable_by_name(_arguments[0].as_string)) {
@@ -207,6 +282,19 @@ bool Engine::init() {
     return true;
   });
 
+  m_console.add_command("capture_frame", "s", [this](Console::Context&, const Vector<Console::Command::Argument>& _arguments) {
+    if (!m_render_frontend) {
+      return false;
+    }
+    m_render_frontend->capture(_arguments[0].as_string);
+    return true;
+  });
+
+  m_console.add_command("trace_dump", "s", [](Console::Context&, const Vector<Console::Command::Argument>& _arguments) {
+    Filesystem::File file{_arguments[0].as_string, "wb"};
+    return file && TraceRecorder::instance().dump(&file, *profile_trace_frames);
+  });
+
   // Try this as early as possible.
   if (SDL_Init(SDL_INIT_VIDEO) != 0) {
     return false;
@@ -504,6 +592,8 @@ Engine::Status Engine::run() {
     m_render_frontend->swap();
   }
 
+  TraceRecorder::instance().mark_frame();
+
   return m_status;
 }
 
@@ -13,6 +13,7 @@
 
 namespace Rx {
 
+namespace Filesystem { struct File; }
 namespace Render::Backend { struct Context; }
 namespace Render::Frontend { struct Context; }
 
@@ -47,6 +48,10 @@ protected:
   Event<void(Console::Variable<Sint32>&)>::Handle m_on_fullscreen_change;
   Event<void(Console::Variable<Sint32>&)>::Handle m_on_swap_interval_change;
   Event<void(Console::Variable<Math::Vec2i>&)>::Handle m_on_display_resolution_changed;
+  Event<void(Console::Variable<bool>&)>::Handle m_on_log_deferred_change;
+  Event<void(Console::Variable<bool>&)>::Handle m_on_profile_trace_change;
+
+  Ptr<Filesystem::File> m_binary_log;
 
   Ptr<Game> m_game;
 };
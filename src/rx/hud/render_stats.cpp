@@ -75,9 +75,9 @@ void RenderStats::render() {
     offset.y += *font_size;
   };
 
-  const auto &command_buffer = frontend.get_command_buffer();
-  const Size commands_used = command_buffer.used();
-  const Size commands_total = command_buffer.size();
+  const Size commands_used = frontend.command_memory_used();
+  const Size commands_total = frontend.command_memory_size();
+  const Size commands_peak = frontend.command_memory_peak();
   m_immediate->frame_queue().record_text(
     *font_name,
     offset,
@@ -85,11 +85,12 @@ void RenderStats::render() {
     1.0f,
     Render::Immediate2D::TextAlign::k_left,
     String::format(
-      "commands: ^[%x]%s ^wof ^g%s ^w(%zu total)",
+      "commands: ^[%x]%s ^wof ^g%s ^w(%zu total, %s peak)",
       color_ratio(commands_used, commands_total),
       String::human_size_format(commands_used),
       String::human_size_format(commands_total),
-      frontend.commands()),
+      frontend.commands(),
+      String::human_size_format(commands_peak)),
     {1.0f, 1.0f, 1.0f, 1.0f});
 
   offset.y += *font_size;
@@ -121,6 +122,9 @@ void RenderStats::render() {
   render_number("vertices", frontend.vertices());
   render_number("blits", frontend.blit_calls());
   render_number("clears", frontend.clear_calls());
+  render_number("sorted draws", frontend.sorted_draws());
+  render_number("removed program changes", frontend.removed_program_changes());
+  render_number("removed state changes", frontend.removed_state_changes());
 
   m_immediate->frame_queue().record_text(
     *font_name,
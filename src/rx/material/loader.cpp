@@ -1,6 +1,6 @@
 #include "rx/core/filesystem/file.h"
-#include "rx/core/concurrency/thread_pool.h"
-#include "rx/core/concurrency/wait_group.h"
+#include "rx/core/filesystem/mapped_file.h"
+#include "rx/core/filesystem/read_queue.h"
 #include "rx/core/json.h"
 #include "rx/core/algorithm/clamp.h"
 
@@ -57,7 +57,7 @@ bool Loader::load(Stream* _stream) {
 }
 
 bool Loader::load(const String& _file_name) {
-  if (Filesystem::File file{_file_name, "rb"}) {
+  if (Filesystem::MappedFile file{_file_name}) {
     return load(&file);
   }
   return false;
@@ -203,43 +203,47 @@ bool Loader::parse(const JSON& _definition) {
 }
 
 bool Loader::parse_textures(const JSON& _textures) {
-  bool success{true};
-  _textures.each([&](const JSON& _texture) {
-    Texture new_texture{allocator()};
-    if (_texture.is_string() && new_texture.load(_texture.as_string())) {
-      m_textures.push_back(Utility::move(new_texture));
-    } else if (_texture.is_object() && new_texture.parse(_texture)) {
-      m_textures.push_back(Utility::move(new_texture));
+  auto& queue{Filesystem::ReadQueue::instance()};
+
+  // Every texture has a definition naming the image it's made from. Find all
+  // of them first so the images are read while the ones before them decode.
+  Vector<JSON> definitions{allocator()};
+  Vector<Filesystem::ReadQueue::Read> images{allocator()};
+  const bool queued{_textures.each([&](const JSON& _texture) {
+    if (_texture.is_string()) {
+      auto contents{Filesystem::read_text_file(allocator(), _texture.as_string())};
+      if (!contents) {
+        return false;
+      }
+      definitions.emplace_back(contents->disown());
+    } else if (_texture.is_object()) {
+      definitions.push_back(_texture);
     } else {
-      success = false;
+      return error("expected String or Object for texture");
     }
-  });
-  return success;
-
-
-  // Revisit with wait groups
-#if 0
-  const Size n_textures{_textures.size()};
-  // concurrency::thread_pool threads{m_allocator, n_textures};
-  concurrency::wait_group group{n_textures};
-  concurrency::atomic<bool> success{true};
-  _textures.each([&](const json& _texture) {
-    concurrency::thread_pool::instance().add([&, _texture](int) {
-      texture new_texture{allocator()};
-      if (_texture.is_string() && new_texture.load(_texture.as_string())) {
-        m_textures.push_back(utility::move(new_texture));
-      } else if (_texture.is_object() && new_texture.parse(_texture)) {
-        m_textures.push_back(utility::move(new_texture));
-      } else {
-        success = false;
-      }
-      group.signal();
-    });
+
+    const auto& file{definitions.last()["file"]};
+    if (!file || !file.is_string()) {
+      return error("expected String for 'file'");
+    }
+
+    images.push_back(queue.read(file.as_string()));
     return true;
-  });
-  group.wait();
-  return success.load();
-#endif
+  })};
+
+  if (!queued) {
+    return false;
+  }
+
+  for (Size i{0}; i < definitions.size(); i++) {
+    Texture new_texture{allocator()};
+    if (!new_texture.parse(definitions[i], &images[i])) {
+      return false;
+    }
+    m_textures.push_back(Utility::move(new_texture));
+  }
+
+  return true;
 }
 
 void Loader::write_log(Log::Level _level, String&& message_) const {
@@ -1,4 +1,4 @@
-#include "rx/core/filesystem/file.h"
+#include "rx/core/filesystem/mapped_file.h"
 #include "rx/core/algorithm/clamp.h"
 #include "rx/core/math/log2.h"
 #include "rx/core/json.h"
@@ -26,13 +26,17 @@ bool Texture::load(Stream* _stream) {
 }
 
 bool Texture::load(const String& _file_name) {
-  if (Filesystem::File file{_file_name, "rb"}) {
+  if (Filesystem::MappedFile file{_file_name}) {
     return load(&file);
   }
   return false;
 }
 
 bool Texture::parse(const JSON& _definition) {
+  return parse(_definition, nullptr);
+}
+
+bool Texture::parse(const JSON& _definition, Stream* _image) {
   if (!_definition) {
     const auto json_error{_definition.error()};
     if (json_error) {
@@ -93,10 +97,10 @@ bool Texture::parse(const JSON& _definition) {
   m_file = file.as_string();
 
   // TODO(dweiler): Inject the max dimensions from a higher level place.
-  return load_texture_file({4096, 4096});
+  return load_texture_file(_image, {4096, 4096});
 }
 
-bool Texture::load_texture_file(const Math::Vec2z& _max_dimensions) {
+bool Texture::load_texture_file(Stream* _image, const Math::Vec2z& _max_dimensions) {
   Rx::Texture::PixelFormat want_format;
   if (m_type == "albedo") {
     want_format = Rx::Texture::PixelFormat::k_rgba_u8;
@@ -107,7 +111,10 @@ bool Texture::load_texture_file(const Math::Vec2z& _max_dimensions) {
   }
 
   Rx::Texture::Loader loader{allocator()};
-  if (!loader.load(m_file, want_format, _max_dimensions)) {
+  const bool loaded{_image
+    ? loader.load(_image, want_format, _max_dimensions)
+    : loader.load(m_file, want_format, _max_dimensions)};
+  if (!loaded) {
     return false;
   }
 
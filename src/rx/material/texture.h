@@ -43,6 +43,10 @@ struct Texture {
 
   bool parse(const JSON& _definition);
 
+  // Parse |_definition| but decode the image from |_image| rather than opening
+  // the file it names, for when it's already being read.
+  bool parse(const JSON& _definition, Stream* _image);
+
   const Filter& filter() const &;
   const Wrap& wrap() const &;
   const String& type() const &;
@@ -55,7 +59,7 @@ struct Texture {
   constexpr Memory::Allocator& allocator() const;
 
 private:
-  bool load_texture_file(const Math::Vec2z& _max_dimensions);
+  bool load_texture_file(Stream* _image, const Math::Vec2z& _max_dimensions);
 
   bool parse_type(const JSON& _type);
   bool parse_filter(const JSON& _filter, bool& _mipmaps);
@@ -2,7 +2,7 @@
 
 #include "rx/model/loader.h"
 
-#include "rx/core/filesystem/file.h"
+#include "rx/core/filesystem/mapped_file.h"
 #include "rx/core/algorithm/max.h"
 #include "rx/core/map.h"
 #include "rx/core/log.h"
@@ -152,7 +152,7 @@ bool Importer::load(Stream* _stream) {
 }
 
 bool Importer::load(const String& _file_name) {
-  if (Filesystem::File file{_file_name, "rb"}) {
+  if (Filesystem::MappedFile file{_file_name}) {
     return load(&file);
   }
   return false;
@@ -119,10 +119,16 @@ bool IQM::read(Stream* _stream) {
     return false;
   }
 
+  // Use the contents of the stream in place when it can give a view of them.
+  Vector<Byte> contents{allocator()};
+  const Byte* data{_stream->view(*size)};
+
   // Don't read the contents entierly into memory until we know it looks like a
   // valid IQM.
   Header read_header;
-  if (_stream->read(reinterpret_cast<Byte*>(&read_header), sizeof read_header) != sizeof read_header) {
+  if (data && *size >= sizeof read_header) {
+    memcpy(&read_header, data, sizeof read_header);
+  } else if (_stream->read(reinterpret_cast<Byte*>(&read_header), sizeof read_header) != sizeof read_header) {
     return error("could not read header");
   }
 
@@ -141,10 +147,15 @@ bool IQM::read(Stream* _stream) {
   // Offsets in the header are relative to the beginning of the file, make a
   // hole in the memory and skip it, such that |read_meshes| and
   // |read_animations| can use the |read_header|'s values directly.
-  Vector<Byte> data{allocator(), static_cast<Size>(*size), Utility::UninitializedTag{}};
-  const auto size_no_header = data.size() - sizeof read_header;
-  if (_stream->read(data.data() + sizeof read_header, size_no_header) != size_no_header) {
-    return error("unexpected end of file");
+  if (!data) {
+    if (!contents.resize(static_cast<Size>(*size), Utility::UninitializedTag{})) {
+      return error("out of memory");
+    }
+    const auto size_no_header = contents.size() - sizeof read_header;
+    if (_stream->read(contents.data() + sizeof read_header, size_no_header) != size_no_header) {
+      return error("unexpected end of file");
+    }
+    data = contents.data();
   }
 
   if (read_header.meshes && !read_meshes(read_header, data)) {
@@ -158,8 +169,8 @@ bool IQM::read(Stream* _stream) {
   return true;
 }
 
-bool IQM::read_meshes(const Header& _header, const Vector<Byte>& _data) {
-  const char* string_table{_header.text_offset ? reinterpret_cast<const char *>(_data.data() + _header.text_offset) : ""};
+bool IQM::read_meshes(const Header& _header, const Byte* _data) {
+  const char* string_table{_header.text_offset ? reinterpret_cast<const char *>(_data + _header.text_offset) : ""};
 
   const Float32* in_position{nullptr};
   const Float32* in_normal{nullptr};
@@ -168,7 +179,7 @@ bool IQM::read_meshes(const Header& _header, const Vector<Byte>& _data) {
   const Byte* in_blend_index{nullptr};
   const Byte* in_blend_weight{nullptr};
 
-  const auto vertex_arrays{reinterpret_cast<const IQMVertexArray*>(_data.data() + _header.vertex_arrays_offset)};
+  const auto vertex_arrays{reinterpret_cast<const IQMVertexArray*>(_data + _header.vertex_arrays_offset)};
   for (Uint32 i{0}; i < _header.vertex_arrays; i++) {
     const IQMVertexArray& array{vertex_arrays[i]};
     const auto attribute{static_cast<VertexAttribute>(array.type)};
@@ -184,7 +195,7 @@ bool IQM::read_meshes(const Header& _header, const Vector<Byte>& _data) {
       if (size != 3) {
         return error("invalid size for position");
       }
-      in_position = reinterpret_cast<const Float32*>(_data.data() + offset);
+      in_position = reinterpret_cast<const Float32*>(_data + offset);
       break;
     case VertexAttribute::k_normal:
       if (format != VertexFormat::k_f32) {
@@ -193,7 +204,7 @@ bool IQM::read_meshes(const Header& _header, const Vector<Byte>& _data) {
       if (size != 3) {
         return error("invalid size for normal");
       }
-      in_normal = reinterpret_cast<const Float32*>(_data.data() + offset);
+      in_normal = reinterpret_cast<const Float32*>(_data + offset);
       break;
     case VertexAttribute::k_tangent:
       if (format != VertexFormat::k_f32) {
@@ -202,7 +213,7 @@ bool IQM::read_meshes(const Header& _header, const Vector<Byte>& _data) {
       if (size != 4) {
         return error("invalid size for tangent");
       }
-      in_tangent = reinterpret_cast<const Float32*>(_data.data() + offset);
+      in_tangent = reinterpret_cast<const Float32*>(_data + offset);
       break;
     case VertexAttribute::k_coordinate:
       if (format != VertexFormat::k_f32) {
@@ -211,7 +222,7 @@ bool IQM::read_meshes(const Header& _header, const Vector<Byte>& _data) {
       if (size != 2) {
         return error("invalid size for coordinate");
       }
-      in_coordinate = reinterpret_cast<const Float32*>(_data.data() + offset);
+      in_coordinate = reinterpret_cast<const Float32*>(_data + offset);
       break;
     case VertexAttribute::k_blend_weights:
       if (format != VertexFormat::k_u8) {
@@ -220,7 +231,7 @@ bool IQM::read_meshes(const Header& _header, const Vector<Byte>& _data) {
       if (size != 4) {
         return error("invalid size for blend weights");
       }
-      in_blend_weight = _data.data() + offset;
+      in_blend_weight = _data + offset;
       break;
     case VertexAttribute::k_blend_indexes:
       if (format != VertexFormat::k_u8) {
@@ -229,7 +240,7 @@ bool IQM::read_meshes(const Header& _header, const Vector<Byte>& _data) {
       if (size != 4) {
         return error("invalid size for blend indices");
       }
-      in_blend_index = _data.data() + offset;
+      in_blend_index = _data + offset;
     default:
       break;
     }
@@ -301,7 +312,7 @@ bool IQM::read_meshes(const Header& _header, const Vector<Byte>& _data) {
     }
   }
 
-  const auto meshes{reinterpret_cast<const IQMMesh *>(_data.data() + _header.meshes_offset)};
+  const auto meshes{reinterpret_cast<const IQMMesh *>(_data + _header.meshes_offset)};
   for (Uint32 i{0}; i < _header.meshes; i++) {
     const auto& this_mesh{meshes[i]};
     const char* material_name{string_table + this_mesh.material};
@@ -310,7 +321,7 @@ bool IQM::read_meshes(const Header& _header, const Vector<Byte>& _data) {
 
   m_elements.resize(_header.triangles * 3);
   for (Uint32 i{0}; i < _header.triangles; i++) {
-    const auto* this_triangle{reinterpret_cast<const IQMTriangle*>(_data.data() + _header.triangles_offset) + i};
+    const auto* this_triangle{reinterpret_cast<const IQMTriangle*>(_data + _header.triangles_offset) + i};
     m_elements[i * 3 + 0] = this_triangle->vertex[0];
     m_elements[i * 3 + 1] = this_triangle->vertex[1];
     m_elements[i * 3 + 2] = this_triangle->vertex[2];
@@ -319,7 +330,7 @@ bool IQM::read_meshes(const Header& _header, const Vector<Byte>& _data) {
   return true;
 }
 
-bool IQM::read_animations(const Header& _header, const Vector<Byte>& _data) {
+bool IQM::read_animations(const Header& _header, const Byte* _data) {
   const auto n_joints{static_cast<Size>(_header.joints)};
 
   Vector<Math::Mat3x4f> generic_base_frame{allocator(), n_joints};
@@ -327,7 +338,7 @@ bool IQM::read_animations(const Header& _header, const Vector<Byte>& _data) {
 
   m_joints.resize(n_joints);
 
-  const auto joints{reinterpret_cast<const IQMJoint*>(_data.data() + _header.joints_offset)};
+  const auto joints{reinterpret_cast<const IQMJoint*>(_data + _header.joints_offset)};
 
   // Read base bind pose.
   for (Size i{0}; i < n_joints; i++) {
@@ -349,8 +360,8 @@ bool IQM::read_animations(const Header& _header, const Vector<Byte>& _data) {
     m_joints[i] = {generic_base_frame[i], this_joint.parent};
   }
 
-  const char* string_table{reinterpret_cast<const char *>(_data.data() + _header.text_offset)};
-  const IQMAnimation* animations{reinterpret_cast<const IQMAnimation*>(_data.data() + _header.animations_offset)};
+  const char* string_table{reinterpret_cast<const char *>(_data + _header.text_offset)};
+  const IQMAnimation* animations{reinterpret_cast<const IQMAnimation*>(_data + _header.animations_offset)};
   for (Uint32 i{0}; i < _header.animations; i++) {
     const IQMAnimation& this_animation{animations[i]};
     m_animations.push_back({this_animation.frame_rate, this_animation.first_frame,
@@ -358,8 +369,8 @@ bool IQM::read_animations(const Header& _header, const Vector<Byte>& _data) {
   }
 
   m_frames.resize(n_joints * _header.frames);
-  const auto* poses{reinterpret_cast<const IQMPose*>(_data.data() + _header.poses_offset)};
-  const Uint16* frame_data{reinterpret_cast<const Uint16*>(_data.data() + _header.frames_offset)};
+  const auto* poses{reinterpret_cast<const IQMPose*>(_data + _header.poses_offset)};
+  const Uint16* frame_data{reinterpret_cast<const Uint16*>(_data + _header.frames_offset)};
 
   for (Uint32 i{0}; i < _header.frames; i++) {
     for (Uint32 j{0}; j < _header.poses; j++) {
@@ -15,8 +15,8 @@ struct IQM
   virtual bool read(Stream* _stream);
 
 private:
-  bool read_meshes(const Header& _header, const Vector<Byte>& _data);
-  bool read_animations(const Header& _header, const Vector<Byte>& _data);
+  bool read_meshes(const Header& _header, const Byte* _data);
+  bool read_animations(const Header& _header, const Byte* _data);
 };
 
 inline IQM::IQM(Memory::Allocator& _allocator)
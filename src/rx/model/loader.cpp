@@ -4,11 +4,11 @@
 #include "rx/core/map.h"
 #include "rx/core/ptr.h"
 #include "rx/core/json.h"
-#include "rx/core/filesystem/file.h"
+#include "rx/core/filesystem/mapped_file.h"
 #include "rx/core/algorithm/clamp.h"
 
-#include "rx/core/concurrency/thread_pool.h"
-#include "rx/core/concurrency/wait_group.h"
+#include "rx/core/concurrency/parallel_for.h"
+#include "rx/core/concurrency/scope_lock.h"
 
 #include "rx/math/quat.h"
 
@@ -57,7 +57,7 @@ bool Loader::load(Stream* _stream) {
 }
 
 bool Loader::load(const String& _file_name) {
-  if (Filesystem::File file{_file_name, "rb"}) {
+  if (Filesystem::MappedFile file{_file_name}) {
     return load(&file);
   }
   return false;
@@ -118,27 +118,24 @@ bool Loader::parse(const JSON& _definition) {
   }
 
   // Load all the materials across multiple threads.
-  // concurrency::thread_pool pool{m_allocator, 32};
 
   // Clear incase we're being run multiple times to change.
   m_materials.clear();
 
   Concurrency::Mutex mutex;
-  Concurrency::WaitGroup group{materials.size()};
-  materials.each([&](const JSON& _material) {
-    Concurrency::ThreadPool::instance().add([&, _material](int) {
+  Concurrency::parallel_for(0, materials.size(), 1, [&](Size _begin, Size _end) {
+    for (Size i = _begin; i < _end; i++) {
+      const auto& material = materials[i];
       Material::Loader loader{allocator()};
-      if (_material.is_string() && loader.load(_material.as_string())) {
+      if (material.is_string() && loader.load(material.as_string())) {
         Concurrency::ScopeLock lock{mutex};
         m_materials.insert(loader.name(), Utility::move(loader));
-      } else if (_material.is_object() && loader.parse(_material)) {
+      } else if (material.is_object() && loader.parse(material)) {
         Concurrency::ScopeLock lock{mutex};
         m_materials.insert(loader.name(), Utility::move(loader));
       }
-      group.signal();
-    });
+    }
   });
-  group.wait();
 
   return true;
 }
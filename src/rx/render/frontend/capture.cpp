@@ -0,0 +1,566 @@
+#include <string.h> // strlen
+
+#include "rx/render/frontend/capture.h"
+#include "rx/render/frontend/command.h"
+#include "rx/render/frontend/buffer.h"
+#include "rx/render/frontend/target.h"
+#include "rx/render/frontend/program.h"
+#include "rx/render/frontend/texture.h"
+
+#include "rx/core/serialize/encoder.h"
+
+namespace Rx::Render::Frontend {
+
+static const Resource* resource_of(const UpdateCommand* _command) {
+  switch (_command->type) {
+  case UpdateCommand::Type::BUFFER:
+    return _command->as_buffer;
+  case UpdateCommand::Type::TEXTURE1D:
+    return _command->as_texture1D;
+  case UpdateCommand::Type::TEXTURE2D:
+    return _command->as_texture2D;
+  case UpdateCommand::Type::TEXTURE3D:
+    return _command->as_texture3D;
+  }
+  RX_HINT_UNREACHABLE();
+}
+
+Capture::Capture(Memory::Allocator& _allocator)
+  : m_allocator{_allocator}
+  , m_resources{m_allocator}
+  , m_indices{m_allocator}
+{
+}
+
+bool Capture::write(Stream* _stream, const Math::Vec2z& _dimensions,
+  const Vector<Byte*>& _commands)
+{
+  m_resources.clear();
+  m_indices.clear();
+
+  collect(_commands);
+
+  serialize::Encoder encoder{m_allocator, _stream};
+
+  if (!encoder.write_uint(k_version)
+    || !encoder.write_uint(_dimensions.w)
+    || !encoder.write_uint(_dimensions.h))
+  {
+    return false;
+  }
+
+  if (!encoder.write_uint(m_resources.size())) {
+    return false;
+  }
+
+  const Size n_resources{m_resources.size()};
+  for (Size i{0}; i < n_resources; i++) {
+    if (!write_resource(encoder, m_resources[i])) {
+      return false;
+    }
+  }
+
+  // Count the commands which are written first.
+  Size n_commands{0};
+  _commands.each_fwd([&](const Byte* _command) {
+    switch (reinterpret_cast<const CommandHeader*>(_command)->type) {
+    case CommandType::CLEAR:
+      [[fallthrough]];
+    case CommandType::DRAW:
+      [[fallthrough]];
+    case CommandType::BLIT:
+      [[fallthrough]];
+    case CommandType::PROFILE:
+      [[fallthrough]];
+    case CommandType::RESOURCE_UPDATE:
+      n_commands++;
+      break;
+    default:
+      break;
+    }
+  });
+
+  if (!encoder.write_uint(n_commands)) {
+    return false;
+  }
+
+  return _commands.each_fwd([&](const Byte* _command) {
+    return write_command(encoder, _command);
+  });
+}
+
+void Capture::collect(const Vector<Byte*>& _commands) {
+  _commands.each_fwd([this](const Byte* _command) {
+    auto header{reinterpret_cast<const CommandHeader*>(_command)};
+    auto payload{_command + sizeof *header};
+    switch (header->type) {
+    case CommandType::CLEAR:
+      collect(reinterpret_cast<const ClearCommand*>(payload)->render_target);
+      break;
+    case CommandType::DRAW:
+      {
+        auto command{reinterpret_cast<const DrawCommand*>(payload)};
+        collect(command->render_target);
+        collect(command->render_buffer);
+        collect(command->render_program);
+        const Size n_textures{command->draw_textures.size()};
+        for (Size i{0}; i < n_textures; i++) {
+          collect(command->draw_textures[i]);
+        }
+      }
+      break;
+    case CommandType::BLIT:
+      {
+        auto command{reinterpret_cast<const BlitCommand*>(payload)};
+        collect(command->src_target);
+        collect(command->dst_target);
+      }
+      break;
+    case CommandType::RESOURCE_UPDATE:
+      collect(resource_of(reinterpret_cast<const UpdateCommand*>(payload)));
+      break;
+    default:
+      break;
+    }
+  });
+}
+
+void Capture::collect(const Resource* _resource) {
+  if (!_resource || m_indices.find(_resource)) {
+    return;
+  }
+
+  // The textures of a target have to be written before it.
+  if (_resource->resource_type() == Resource::Type::k_target) {
+    auto target{static_cast<const Target*>(_resource)};
+    if (target->is_swapchain()) {
+      // The swapchain is replaced by the one of the replay.
+    } else {
+      if (target->has_depth_stencil()) {
+        collect(target->depth_stencil());
+      } else if (target->has_depth()) {
+        collect(target->depth());
+      } else if (target->has_stencil()) {
+        collect(target->stencil());
+      }
+      target->attachments().each_fwd([this](const Target::Attachment& _attachment) {
+        switch (_attachment.kind) {
+        case Target::Attachment::Type::k_texture2D:
+          collect(_attachment.as_texture2D.texture);
+          break;
+        case Target::Attachment::Type::k_textureCM:
+          collect(_attachment.as_textureCM.texture);
+          break;
+        }
+      });
+    }
+  }
+
+  m_indices.insert(_resource, m_resources.size());
+  m_resources.push_back(_resource);
+}
+
+bool Capture::write_resource(serialize::Encoder& encoder_,
+  const Resource* _resource)
+{
+  const auto type{_resource->resource_type()};
+  if (!encoder_.write_uint(static_cast<Uint64>(type))) {
+    return false;
+  }
+
+  switch (type) {
+  case Resource::Type::k_buffer:
+    return write_buffer(encoder_, static_cast<const Buffer*>(_resource));
+  case Resource::Type::k_target:
+    return write_target(encoder_, static_cast<const Target*>(_resource));
+  case Resource::Type::k_program:
+    return write_program(encoder_, static_cast<const Program*>(_resource));
+  case Resource::Type::k_texture1D:
+    [[fallthrough]];
+  case Resource::Type::k_texture2D:
+    [[fallthrough]];
+  case Resource::Type::k_texture3D:
+    [[fallthrough]];
+  case Resource::Type::k_textureCM:
+    return write_texture(encoder_, static_cast<const Texture*>(_resource));
+  case Resource::Type::k_downloader:
+    break;
+  }
+
+  return false;
+}
+
+bool Capture::write_buffer(serialize::Encoder& encoder_, const Buffer* _buffer) {
+  const auto& format{_buffer->format()};
+
+  auto write_attributes = [&](const Vector<Buffer::Attribute>& _attributes) {
+    if (!encoder_.write_uint(_attributes.size())) {
+      return false;
+    }
+    return _attributes.each_fwd([&](const Buffer::Attribute& _attribute) {
+      return encoder_.write_uint(static_cast<Uint64>(_attribute.type))
+        && encoder_.write_uint(_attribute.offset);
+    });
+  };
+
+  auto write_store = [&](const Vector<Byte>& _store) {
+    return encoder_.write_uint(_store.size())
+      && encoder_.write_byte_array(_store.data(), _store.size());
+  };
+
+  return encoder_.write_uint(static_cast<Uint64>(format.type()))
+    && encoder_.write_uint(static_cast<Uint64>(format.element_type()))
+    && encoder_.write_uint(format.vertex_stride())
+    && encoder_.write_uint(format.instance_stride())
+    && write_attributes(format.vertex_attributes())
+    && write_attributes(format.instance_attributes())
+    && write_store(_buffer->vertices())
+    && write_store(_buffer->elements())
+    && write_store(_buffer->instances());
+}
+
+bool Capture::write_target(serialize::Encoder& encoder_, const Target* _target) {
+  if (!encoder_.write_bool(_target->is_swapchain())) {
+    return false;
+  }
+
+  if (_target->is_swapchain()) {
+    return true;
+  }
+
+  // Owned depth and stencil textures are written as attached ones.
+  Uint64 depth_stencil_kind{0};
+  const Texture* depth_stencil{nullptr};
+  if (_target->has_depth_stencil()) {
+    depth_stencil_kind = 3;
+    depth_stencil = _target->depth_stencil();
+  } else if (_target->has_depth()) {
+    depth_stencil_kind = 1;
+    depth_stencil = _target->depth();
+  } else if (_target->has_stencil()) {
+    depth_stencil_kind = 2;
+    depth_stencil = _target->stencil();
+  }
+
+  if (!encoder_.write_uint(depth_stencil_kind)
+    || !write_reference(encoder_, depth_stencil))
+  {
+    return false;
+  }
+
+  const auto& attachments{_target->attachments()};
+  if (!encoder_.write_uint(attachments.size())) {
+    return false;
+  }
+
+  return attachments.each_fwd([&](const Target::Attachment& _attachment) {
+    if (!encoder_.write_uint(static_cast<Uint64>(_attachment.kind))
+      || !encoder_.write_uint(_attachment.level))
+    {
+      return false;
+    }
+
+    switch (_attachment.kind) {
+    case Target::Attachment::Type::k_texture2D:
+      return write_reference(encoder_, _attachment.as_texture2D.texture);
+    case Target::Attachment::Type::k_textureCM:
+      return write_reference(encoder_, _attachment.as_textureCM.texture)
+        && encoder_.write_uint(static_cast<Uint64>(_attachment.as_textureCM.face));
+    }
+
+    return false;
+  });
+}
+
+bool Capture::write_program(serialize::Encoder& encoder_, const Program* _program) {
+  auto write_string = [&](const String& _string) {
+    return encoder_.write_uint(_string.size())
+      && encoder_.write_byte_array(reinterpret_cast<const Byte*>(_string.data()),
+        _string.size());
+  };
+
+  auto write_inouts = [&](const Map<String, Shader::InOut>& _inouts) {
+    if (!encoder_.write_uint(_inouts.size())) {
+      return false;
+    }
+    return _inouts.each_pair([&](const String& _name, const Shader::InOut& _inout) {
+      return write_string(_name)
+        && encoder_.write_uint(_inout.index)
+        && encoder_.write_uint(static_cast<Uint64>(_inout.kind));
+    });
+  };
+
+  const auto& shaders{_program->shaders()};
+  if (!encoder_.write_uint(shaders.size())) {
+    return false;
+  }
+
+  const bool result = shaders.each_fwd([&](const Shader& _shader) {
+    return encoder_.write_uint(static_cast<Uint64>(_shader.kind))
+      && write_string(_shader.source)
+      && write_inouts(_shader.inputs)
+      && write_inouts(_shader.outputs);
+  });
+
+  if (!result) {
+    return false;
+  }
+
+  const auto& uniforms{_program->uniforms()};
+  if (!encoder_.write_uint(uniforms.size())) {
+    return false;
+  }
+
+  return uniforms.each_fwd([&](const Uniform& _uniform) {
+    return write_string(_uniform.name())
+      && encoder_.write_uint(static_cast<Uint64>(_uniform.type()))
+      && encoder_.write_bool(_uniform.is_padding());
+  });
+}
+
+bool Capture::write_texture(serialize::Encoder& encoder_, const Texture* _texture) {
+  if (!encoder_.write_bool(_texture->is_swapchain())) {
+    return false;
+  }
+
+  if (_texture->is_swapchain()) {
+    return true;
+  }
+
+  const auto filter{_texture->filter()};
+  const auto& border{_texture->border()};
+  const auto& data{_texture->data()};
+
+  if (!encoder_.write_uint(static_cast<Uint64>(_texture->format()))
+    || !encoder_.write_uint(static_cast<Uint64>(_texture->type()))
+    || !encoder_.write_uint(_texture->levels())
+    || !encoder_.write_bool(filter.bilinear)
+    || !encoder_.write_bool(filter.trilinear)
+    || !encoder_.write_bool(filter.mipmaps)
+    || !encoder_.write_float_array(border.data(), 4))
+  {
+    return false;
+  }
+
+  // Dimensions and wrap have as many components as the texture has.
+  Size dimensions[3]{0, 0, 0};
+  Texture::WrapType wrap[3]{};
+  Size components{0};
+
+  switch (_texture->resource_type()) {
+  case Resource::Type::k_texture1D:
+    {
+      auto texture{static_cast<const Texture1D*>(_texture)};
+      dimensions[0] = texture->dimensions();
+      wrap[0] = texture->wrap();
+      components = 1;
+    }
+    break;
+  case Resource::Type::k_texture2D:
+    {
+      auto texture{static_cast<const Texture2D*>(_texture)};
+      dimensions[0] = texture->dimensions().w;
+      dimensions[1] = texture->dimensions().h;
+      wrap[0] = texture->wrap().s;
+      wrap[1] = texture->wrap().t;
+      components = 2;
+    }
+    break;
+  case Resource::Type::k_texture3D:
+    {
+      auto texture{static_cast<const Texture3D*>(_texture)};
+      dimensions[0] = texture->dimensions().w;
+      dimensions[1] = texture->dimensions().h;
+      dimensions[2] = texture->dimensions().d;
+      wrap[0] = texture->wrap().s;
+      wrap[1] = texture->wrap().t;
+      wrap[2] = texture->wrap().p;
+      components = 3;
+    }
+    break;
+  case Resource::Type::k_textureCM:
+    {
+      auto texture{static_cast<const TextureCM*>(_texture)};
+      dimensions[0] = texture->dimensions().w;
+      dimensions[1] = texture->dimensions().h;
+      wrap[0] = texture->wrap().s;
+      wrap[1] = texture->wrap().t;
+      wrap[2] = texture->wrap().p;
+      components = 2;
+    }
+    break;
+  default:
+    return false;
+  }
+
+  for (Size i{0}; i < components; i++) {
+    if (!encoder_.write_uint(dimensions[i])) {
+      return false;
+    }
+  }
+
+  // Cubemaps have three wrap components for two dimensions.
+  const Size wraps{_texture->resource_type() == Resource::Type::k_textureCM ? 3 : components};
+  for (Size i{0}; i < wraps; i++) {
+    if (!encoder_.write_uint(static_cast<Uint64>(wrap[i]))) {
+      return false;
+    }
+  }
+
+  return encoder_.write_uint(data.size())
+    && encoder_.write_byte_array(data.data(), data.size());
+}
+
+bool Capture::write_command(serialize::Encoder& encoder_, const Byte* _command) {
+  auto header{reinterpret_cast<const CommandHeader*>(_command)};
+  auto payload{_command + sizeof *header};
+
+  auto write_type = [&] {
+    return encoder_.write_uint(static_cast<Uint64>(header->type));
+  };
+
+  switch (header->type) {
+  case CommandType::CLEAR:
+    {
+      auto command{reinterpret_cast<const ClearCommand*>(payload)};
+      return write_type()
+        && write_state(encoder_, command->render_state)
+        && write_reference(encoder_, command->render_target)
+        && write_buffers(encoder_, command->draw_buffers)
+        && encoder_.write_bool(command->clear_depth)
+        && encoder_.write_bool(command->clear_stencil)
+        && encoder_.write_uint(command->clear_colors)
+        && encoder_.write_uint(command->stencil_value)
+        && encoder_.write_float(command->depth_value)
+        && encoder_.write_float_array(command->color_values[0].data(),
+          4 * Buffers::k_max_buffers);
+    }
+  case CommandType::DRAW:
+    {
+      auto command{reinterpret_cast<const DrawCommand*>(payload)};
+
+      // The uniforms are the dirty ones, in order.
+      Size uniforms_size{0};
+      const auto& uniforms{command->render_program->uniforms()};
+      const Size n_uniforms{uniforms.size()};
+      for (Size i{0}; i < n_uniforms; i++) {
+        if (command->dirty_uniforms_bitset & (1_u64 << i)) {
+          uniforms_size += uniforms[i].size();
+        }
+      }
+
+      return write_type()
+        && write_state(encoder_, command->render_state)
+        && write_reference(encoder_, command->render_target)
+        && write_buffers(encoder_, command->draw_buffers)
+        && write_textures(encoder_, command->draw_textures)
+        && write_reference(encoder_, command->render_buffer)
+        && write_reference(encoder_, command->render_program)
+        && encoder_.write_uint(command->count)
+        && encoder_.write_uint(command->offset)
+        && encoder_.write_uint(command->instances)
+        && encoder_.write_uint(command->base_vertex)
+        && encoder_.write_uint(command->base_instance)
+        && encoder_.write_uint(static_cast<Uint64>(command->type))
+        && encoder_.write_uint(command->dirty_uniforms_bitset)
+        && encoder_.write_uint(uniforms_size)
+        && encoder_.write_byte_array(command->uniforms(), uniforms_size);
+    }
+  case CommandType::BLIT:
+    {
+      auto command{reinterpret_cast<const BlitCommand*>(payload)};
+      return write_type()
+        && write_state(encoder_, command->render_state)
+        && write_reference(encoder_, command->src_target)
+        && encoder_.write_uint(command->src_attachment)
+        && write_reference(encoder_, command->dst_target)
+        && encoder_.write_uint(command->dst_attachment);
+    }
+  case CommandType::PROFILE:
+    {
+      auto command{reinterpret_cast<const ProfileCommand*>(payload)};
+      const char* tag{command->tag ? command->tag : ""};
+      const Size length{strlen(tag)};
+      return write_type()
+        && encoder_.write_bool(command->tag != nullptr)
+        && encoder_.write_uint(length)
+        && encoder_.write_byte_array(reinterpret_cast<const Byte*>(tag), length);
+    }
+  case CommandType::RESOURCE_UPDATE:
+    {
+      auto command{reinterpret_cast<const UpdateCommand*>(payload)};
+
+      // Buffer edits are three integers, texture edits are a level and then
+      // an offset and size with as many components as the texture has.
+      Size edit_size{0};
+      switch (command->type) {
+      case UpdateCommand::Type::BUFFER:
+        edit_size = 3;
+        break;
+      case UpdateCommand::Type::TEXTURE1D:
+        edit_size = 3;
+        break;
+      case UpdateCommand::Type::TEXTURE2D:
+        edit_size = 5;
+        break;
+      case UpdateCommand::Type::TEXTURE3D:
+        edit_size = 7;
+        break;
+      }
+
+      return write_type()
+        && encoder_.write_uint(static_cast<Uint64>(command->type))
+        && write_reference(encoder_, resource_of(command))
+        && encoder_.write_uint(command->edits)
+        && encoder_.write_uint_array(command->edit(), command->edits * edit_size);
+    }
+  default:
+    // Resource lifetime and downloads are not captured.
+    return true;
+  }
+}
+
+bool Capture::write_reference(serialize::Encoder& encoder_,
+  const Resource* _resource)
+{
+  // Zero is reserved for no resource.
+  if (!_resource) {
+    return encoder_.write_uint(0);
+  }
+  const auto index{m_indices.find(_resource)};
+  RX_ASSERT(index, "resource not collected");
+  return encoder_.write_uint(*index + 1);
+}
+
+bool Capture::write_state(serialize::Encoder& encoder_, const State& _state) {
+  return encoder_.write_byte_array(reinterpret_cast<const Byte*>(&_state),
+    sizeof _state);
+}
+
+bool Capture::write_buffers(serialize::Encoder& encoder_, const Buffers& _buffers) {
+  const Size n_buffers{_buffers.size()};
+  if (!encoder_.write_uint(n_buffers)) {
+    return false;
+  }
+  for (Size i{0}; i < n_buffers; i++) {
+    if (!encoder_.write_uint(static_cast<Uint64>(_buffers[i]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Capture::write_textures(serialize::Encoder& encoder_, const Textures& _textures) {
+  const Size n_textures{_textures.size()};
+  if (!encoder_.write_uint(n_textures)) {
+    return false;
+  }
+  for (Size i{0}; i < n_textures; i++) {
+    if (!write_reference(encoder_, _textures[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace rx::render::frontend
@@ -0,0 +1,77 @@
+#ifndef RX_RENDER_FRONTEND_CAPTURE_H
+#define RX_RENDER_FRONTEND_CAPTURE_H
+#include "rx/core/vector.h"
+#include "rx/core/map.h"
+
+#include "rx/math/vec2.h"
+
+namespace Rx {
+struct Stream;
+} // namespace rx
+
+namespace Rx::serialize {
+struct Encoder;
+} // namespace rx::serialize
+
+namespace Rx::Render::Frontend {
+
+struct Resource;
+struct Buffer;
+struct Target;
+struct Program;
+struct Texture;
+struct State;
+struct Buffers;
+struct Textures;
+
+// # Capture
+//
+// Writes the commands handed to the backend in a frame to a stream, along
+// with every resource those commands reference. A capture can be loaded and
+// handed to any backend again with |Replay|.
+//
+// The capture is written with the serializer and contains, in order:
+//  * the capture version and the dimensions of the swapchain
+//  * every referenced resource, each one after the resources it references
+//  * every command, with resources referenced by their index in the above
+//
+// Resources are written as they are at the time of the capture, including
+// all of their data. The commands which allocate, construct and destroy
+// resources are not written as replay owns the lifetime of the resources
+// instead. Downloads are not written either.
+//
+// Render state is written as it's in memory so captures are only meant to
+// be replayed by the same build that made them.
+struct Capture {
+  static inline constexpr const Uint64 k_version{2};
+
+  Capture(Memory::Allocator& _allocator);
+
+  // Write |_commands| recorded against a swapchain of |_dimensions|.
+  bool write(Stream* _stream, const Math::Vec2z& _dimensions,
+    const Vector<Byte*>& _commands);
+
+private:
+  void collect(const Vector<Byte*>& _commands);
+  void collect(const Resource* _resource);
+
+  bool write_resource(serialize::Encoder& encoder_, const Resource* _resource);
+  bool write_buffer(serialize::Encoder& encoder_, const Buffer* _buffer);
+  bool write_target(serialize::Encoder& encoder_, const Target* _target);
+  bool write_program(serialize::Encoder& encoder_, const Program* _program);
+  bool write_texture(serialize::Encoder& encoder_, const Texture* _texture);
+  bool write_command(serialize::Encoder& encoder_, const Byte* _command);
+
+  bool write_reference(serialize::Encoder& encoder_, const Resource* _resource);
+  bool write_state(serialize::Encoder& encoder_, const State& _state);
+  bool write_buffers(serialize::Encoder& encoder_, const Buffers& _buffers);
+  bool write_textures(serialize::Encoder& encoder_, const Textures& _textures);
+
+  Memory::Allocator& m_allocator;
+  Vector<const Resource*> m_resources;
+  Map<const Resource*, Size> m_indices;
+};
+
+} // namespace rx::render::frontend
+
+#endif // RX_RENDER_FRONTEND_CAPTURE_H
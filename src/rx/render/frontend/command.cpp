@@ -1,22 +1,49 @@
 #include "rx/render/frontend/command.h"
 
+#include "rx/core/hints/likely.h"
+#include "rx/core/hints/unlikely.h"
+
+#include "rx/core/utility/swap.h"
+
 namespace Rx::Render::Frontend {
 
-CommandBuffer::CommandBuffer(Memory::Allocator& _allocator, Size _size)
-  : m_base_allocator{_allocator}
-  , m_base_memory{m_base_allocator.allocate(_size)}
-  , m_allocator{m_base_memory, _size}
+CommandBuffer::CommandBuffer(Memory::Allocator& _allocator, Size _page_size)
+  : m_allocator{_allocator}
+  , m_page_size{Memory::Allocator::round_to_alignment(_page_size)}
+  , m_pages{m_allocator}
+  , m_page{0}
+  , m_offset{0}
+  , m_used{0}
+  , m_size{0}
+  , m_high_water_mark{0}
 {
 }
 
 CommandBuffer::~CommandBuffer() {
-  m_base_allocator.deallocate(m_base_memory);
+  m_pages.each_fwd([this](Page& page_) {
+    m_allocator.deallocate(page_.data);
+  });
 }
 
 Byte* CommandBuffer::allocate(Size _size, CommandType _command, const CommandHeader::Info& _info) {
-  Byte* data = m_allocator.allocate(sizeof(CommandHeader) + _size);
+  // Keep everything aligned by ALIGNMENT.
+  _size = Memory::Allocator::round_to_alignment(sizeof(CommandHeader) + _size);
+
+  Byte* data = nullptr;
+  if (RX_HINT_LIKELY(m_page < m_pages.size() && m_offset + _size <= m_pages[m_page].size)) {
+    data = m_pages[m_page].data + m_offset;
+    m_offset += _size;
+  } else {
+    data = allocate_slow(_size);
+  }
+
   RX_ASSERT(data, "Out of memory");
 
+  m_used += _size;
+  if (m_used > m_high_water_mark) {
+    m_high_water_mark = m_used;
+  }
+
   auto* header = reinterpret_cast<CommandHeader*>(data);
   header->type = _command;
   header->tag = _info;
@@ -24,8 +51,47 @@ Byte* CommandBuffer::allocate(Size _size, CommandType _command, const CommandHea
   return data;
 }
 
+Byte* CommandBuffer::allocate_slow(Size _size) {
+  // Move onto the next page in the chain. The very first allocation lands
+  // here with an empty chain so there's no current page to move past.
+  if (!m_pages.is_empty()) {
+    m_page++;
+  }
+
+  m_offset = _size;
+
+  // Reuse the next page from a previous frame when it can fit the command.
+  if (m_page < m_pages.size() && _size <= m_pages[m_page].size) {
+    return m_pages[m_page].data;
+  }
+
+  // Add a new page. Commands larger than the page size get a page of their
+  // own. The page is inserted here so the chain stays in use order.
+  const Size size = _size > m_page_size ? _size : m_page_size;
+  Byte* data = m_allocator.allocate(size);
+  if (RX_HINT_UNLIKELY(!data)) {
+    return nullptr;
+  }
+
+  if (!m_pages.push_back({data, size})) {
+    m_allocator.deallocate(data);
+    return nullptr;
+  }
+
+  // Rotate the new page from the end of the chain into position.
+  for (Size i = m_pages.size() - 1; i > m_page; i--) {
+    Utility::swap(m_pages[i], m_pages[i - 1]);
+  }
+
+  m_size += size;
+
+  return data;
+}
+
 void CommandBuffer::reset() {
-  m_allocator.reset();
+  m_page = 0;
+  m_offset = 0;
+  m_used = 0;
 }
 
 } // namespace rx::render::frontend
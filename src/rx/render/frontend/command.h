@@ -2,7 +2,7 @@
 #define RX_RENDER_FRONTEND_COMMAND_H
 
 #include "rx/core/source_location.h"
-#include "rx/core/memory/bump_point_allocator.h"
+#include "rx/core/vector.h"
 #include "rx/core/utility/nat.h"
 #include "rx/math/vec4.h"
 #include "rx/render/frontend/state.h"
@@ -61,8 +61,21 @@ struct alignas(Memory::Allocator::ALIGNMENT) CommandHeader {
 #define RX_RENDER_TAG(_description) \
   ::Rx::Render::Frontend::CommandHeader::Info{(_description), RX_SOURCE_LOCATION}
 
+// # Command Buffer
+//
+// Commands are bump allocated from a chain of pages. When the current page
+// cannot fit a command the next page in the chain is used, a new page is
+// added to the chain when there is none. Commands larger than the page size
+// get a page of their own.
+//
+// Resetting the command buffer does not release any pages, they're reused
+// for the next frame. This way the command buffer grows to fit the heaviest
+// frame and stays there.
 struct CommandBuffer {
-  CommandBuffer(Memory::Allocator &_allocator, Size _size);
+  RX_MARK_NO_COPY(CommandBuffer);
+  RX_MARK_NO_MOVE(CommandBuffer);
+
+  CommandBuffer(Memory::Allocator &_allocator, Size _page_size);
   ~CommandBuffer();
 
   Byte *allocate(Size _size, CommandType _command,
@@ -70,14 +83,34 @@ struct CommandBuffer {
 
   void reset();
 
+  // Bytes used by commands since the last reset.
   Size used() const;
 
+  // Bytes reserved by all pages.
   Size size() const;
 
+  // The most bytes ever used between resets.
+  Size high_water_mark() const;
+
+  // Number of pages in the chain.
+  Size pages() const;
+
 private:
-  Memory::Allocator &m_base_allocator;
-  Byte *m_base_memory;
-  Memory::BumpPointAllocator m_allocator;
+  struct Page {
+    Byte* data;
+    Size size;
+  };
+
+  Byte* allocate_slow(Size _size);
+
+  Memory::Allocator &m_allocator;
+  Size m_page_size;
+  Vector<Page> m_pages;
+  Size m_page;
+  Size m_offset;
+  Size m_used;
+  Size m_size;
+  Size m_high_water_mark;
 };
 
 struct Buffers {
@@ -256,11 +289,19 @@ struct UpdateCommand {
 
 // command_buffer
 inline Size CommandBuffer::used() const {
-  return m_allocator.used();
+  return m_used;
 }
 
 inline Size CommandBuffer::size() const {
-  return m_allocator.size();
+  return m_size;
+}
+
+inline Size CommandBuffer::high_water_mark() const {
+  return m_high_water_mark;
+}
+
+inline Size CommandBuffer::pages() const {
+  return m_pages.size();
 }
 
 // textures
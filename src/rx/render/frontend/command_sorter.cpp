@@ -0,0 +1,227 @@
+#include <string.h> // memset, memcpy
+
+#include "rx/render/frontend/command_sorter.h"
+#include "rx/render/frontend/command.h"
+
+#include "rx/core/utility/swap.h"
+
+namespace Rx::Render::Frontend {
+
+static constexpr const Size k_program_bits{10};
+static constexpr const Size k_epoch_bits{20};
+static constexpr const Size k_state_bits{16};
+static constexpr const Size k_texture_bits{16};
+
+static constexpr const Size k_texture_shift{0};
+static constexpr const Size k_state_shift{k_texture_shift + k_texture_bits};
+static constexpr const Size k_follows_shift{k_state_shift + k_state_bits};
+static constexpr const Size k_epoch_shift{k_follows_shift + 1};
+static constexpr const Size k_program_shift{k_epoch_shift + k_epoch_bits};
+
+// Limit the length of a run so every rank fits in the key.
+static constexpr const Size k_max_run{1_z << k_state_bits};
+
+static_assert(k_program_shift + k_program_bits <= 64, "sort key too large");
+
+static inline const DrawCommand* as_draw(const Byte* _command) {
+  auto header{reinterpret_cast<const CommandHeader*>(_command)};
+  if (header->type != CommandType::DRAW) {
+    return nullptr;
+  }
+  return reinterpret_cast<const DrawCommand*>(_command + sizeof(CommandHeader));
+}
+
+static inline Size hash_textures(const Textures& _textures) {
+  Size hash{0};
+  const Size n_textures{_textures.size()};
+  for (Size i{0}; i < n_textures; i++) {
+    hash = hash_combine(hash, Hash<Texture*>{}(_textures[i]));
+  }
+  return hash;
+}
+
+// Find the rank of |_key| in |ranks_|, assigning the next one if new.
+template<typename K>
+static inline Uint64 rank_of(Map<K, Uint64>& ranks_, const K& _key) {
+  if (auto find{ranks_.find(_key)}) {
+    return *find;
+  }
+  const Uint64 rank{ranks_.size()};
+  ranks_.insert(_key, rank);
+  return rank;
+}
+
+CommandSorter::CommandSorter(Memory::Allocator& _allocator)
+  : m_allocator{_allocator}
+  , m_items{m_allocator}
+  , m_scratch{m_allocator}
+  , m_original{m_allocator}
+  , m_programs{m_allocator}
+  , m_states{m_allocator}
+  , m_textures{m_allocator}
+  , m_sorted_draws{0}
+  , m_removed_program_changes{0}
+  , m_removed_state_changes{0}
+{
+}
+
+bool CommandSorter::is_sortable(const DrawCommand* _command) {
+  const auto& state{_command->render_state};
+  return !state.blend.enabled()
+    && state.depth.test()
+    && state.depth.write()
+    && !state.stencil.enabled();
+}
+
+void CommandSorter::sort(Vector<Byte*>& commands_) {
+  m_sorted_draws = 0;
+  m_removed_program_changes = 0;
+  m_removed_state_changes = 0;
+
+  Byte** commands{commands_.data()};
+  const Size n_commands{commands_.size()};
+
+  Size run_begin{0};
+  const Target* run_target{nullptr};
+
+  auto flush = [&](Size _end) {
+    if (!m_items.is_empty()) {
+      sort_run(commands + run_begin, m_items.size());
+    }
+    m_items.clear();
+    m_programs.clear();
+    m_states.clear();
+    m_textures.clear();
+    run_begin = _end;
+  };
+
+  for (Size i{0}; i < n_commands; i++) {
+    const auto draw{as_draw(commands[i])};
+    if (!draw || !is_sortable(draw)) {
+      // This command cannot move, end the run at it.
+      flush(i + 1);
+      continue;
+    }
+
+    // End the run on a change of target, or when a rank would overflow.
+    if (draw->render_target != run_target
+      || m_items.size() == k_max_run
+      || (m_programs.size() == (1_z << k_program_bits)
+        && !m_programs.find(draw->render_program)))
+    {
+      flush(i);
+      run_target = draw->render_target;
+    }
+
+    // A draw with dirty uniforms begins a new epoch for the program. The first
+    // draw of a program in a run always begins one.
+    bool follows{true};
+    auto program{m_programs.find(draw->render_program)};
+    if (!program) {
+      program = m_programs.insert(draw->render_program, {m_programs.size(), 0});
+      follows = false;
+    } else if (draw->dirty_uniforms_bitset) {
+      program->epoch++;
+      follows = false;
+    }
+
+    const Uint64 state{rank_of(m_states, draw->render_state.hash())};
+    const Uint64 texture{rank_of(m_textures, hash_textures(draw->draw_textures))};
+
+    const Uint64 key{(program->rank << k_program_shift)
+      | (program->epoch << k_epoch_shift)
+      | (Uint64{follows} << k_follows_shift)
+      | (state << k_state_shift)
+      | (texture << k_texture_shift)};
+
+    m_items.push_back({key, commands[i]});
+  }
+
+  flush(n_commands);
+}
+
+void CommandSorter::sort_run(Byte** commands_, Size _count) {
+  if (_count < 2) {
+    return;
+  }
+
+  Size programs_before{0};
+  Size states_before{0};
+  count_changes(commands_, _count, programs_before, states_before);
+
+  // Keep the recorded order in case sorting makes things worse.
+  m_original.resize(_count, Utility::UninitializedTag{});
+  memcpy(m_original.data(), commands_, sizeof *commands_ * _count);
+
+  // Least-significant digit radix sort, 8 bits at a time. This is stable so
+  // draws with the same key keep their recorded order. Passes where every
+  // key shares the same digit are skipped, which is most of them.
+  m_scratch.resize(_count, Utility::UninitializedTag{});
+  Item* src{m_items.data()};
+  Item* dst{m_scratch.data()};
+  for (Size shift{0}; shift < 64; shift += 8) {
+    Size histogram[256];
+    memset(histogram, 0, sizeof histogram);
+    for (Size i{0}; i < _count; i++) {
+      histogram[(src[i].key >> shift) & 0xff]++;
+    }
+
+    if (histogram[(src[0].key >> shift) & 0xff] == _count) {
+      continue;
+    }
+
+    Size offset{0};
+    for (Size i{0}; i < 256; i++) {
+      const Size count{histogram[i]};
+      histogram[i] = offset;
+      offset += count;
+    }
+
+    for (Size i{0}; i < _count; i++) {
+      dst[histogram[(src[i].key >> shift) & 0xff]++] = src[i];
+    }
+
+    Utility::swap(src, dst);
+  }
+
+  for (Size i{0}; i < _count; i++) {
+    commands_[i] = src[i].command;
+  }
+
+  Size programs_after{0};
+  Size states_after{0};
+  count_changes(commands_, _count, programs_after, states_after);
+
+  // Grouping by program can split up draws which shared state. When that
+  // costs more than it saves, put the recorded order back.
+  if (programs_after + states_after > programs_before + states_before) {
+    memcpy(commands_, m_original.data(), sizeof *commands_ * _count);
+    return;
+  }
+
+  // Grouping by program never adds program changes but can add state changes
+  // to a run which still comes out ahead overall.
+  m_sorted_draws += _count;
+  m_removed_program_changes += programs_before - programs_after;
+  if (states_before > states_after) {
+    m_removed_state_changes += states_before - states_after;
+  }
+}
+
+void CommandSorter::count_changes(Byte* const* _commands, Size _count,
+  Size& programs_, Size& states_) const
+{
+  const DrawCommand* last{nullptr};
+  for (Size i{0}; i < _count; i++) {
+    const auto draw{as_draw(_commands[i])};
+    if (!last || draw->render_program != last->render_program) {
+      programs_++;
+    }
+    if (!last || draw->render_state != last->render_state) {
+      states_++;
+    }
+    last = draw;
+  }
+}
+
+} // namespace rx::render::frontend
@@ -0,0 +1,95 @@
+#ifndef RX_RENDER_FRONTEND_COMMAND_SORTER_H
+#define RX_RENDER_FRONTEND_COMMAND_SORTER_H
+#include "rx/core/vector.h"
+#include "rx/core/map.h"
+
+namespace Rx::Render::Frontend {
+
+struct Program;
+struct DrawCommand;
+
+// # Command Sorter
+//
+// Reorders draw commands to reduce the number of program, state and texture
+// changes the backend has to make. Each draw is given a 64-bit sort key and
+// the keys are radix sorted.
+//
+// Only runs of draw commands are sorted. A run ends at any command that isn't
+// a draw, at a change of render target, or at a draw whose result depends on
+// the order it's drawn in, i.e blending, no depth test or writes, or stencil.
+//
+// Uniforms are recorded as deltas against the previous draw with the same
+// program, so the order of draws sharing a program matters. A draw with
+// dirty uniforms begins a new "epoch" for that program. Epochs keep their
+// order and the draw which begins an epoch sorts first in it. Draws inside
+// an epoch, and draws of different programs, are free to be reordered.
+//
+// The key layout from most to least significant bit is:
+//  program: 10 bits (rank of first appearance in run)
+//  epoch:   20 bits
+//  follows:  1 bit  (0 for the draw which begins an epoch)
+//  state:   16 bits (rank of first appearance in run)
+//  texture: 16 bits (rank of first appearance in run)
+//
+// There's no depth in the key as a draw command has no notion of view depth,
+// the sort is stable so any depth ordering of the recording is kept.
+struct CommandSorter {
+  CommandSorter(Memory::Allocator& _allocator);
+
+  // Sort all runs of draw commands in |commands_| in-place.
+  void sort(Vector<Byte*>& commands_);
+
+  // Statistics about the last call to |sort|.
+  Size sorted_draws() const;
+  Size removed_program_changes() const;
+  Size removed_state_changes() const;
+
+private:
+  struct Item {
+    Uint64 key;
+    Byte* command;
+  };
+
+  struct ProgramInfo {
+    Uint64 rank;
+    Uint64 epoch;
+  };
+
+  static bool is_sortable(const DrawCommand* _command);
+
+  void sort_run(Byte** commands_, Size _count);
+
+  // Count program and state changes over |_count| commands in |_commands|.
+  void count_changes(Byte* const* _commands, Size _count,
+    Size& programs_, Size& states_) const;
+
+  Memory::Allocator& m_allocator;
+
+  Vector<Item> m_items;
+  Vector<Item> m_scratch;
+  Vector<Byte*> m_original;
+
+  Map<const Program*, ProgramInfo> m_programs;
+  Map<Size, Uint64> m_states;
+  Map<Size, Uint64> m_textures;
+
+  Size m_sorted_draws;
+  Size m_removed_program_changes;
+  Size m_removed_state_changes;
+};
+
+inline Size CommandSorter::sorted_draws() const {
+  return m_sorted_draws;
+}
+
+inline Size CommandSorter::removed_program_changes() const {
+  return m_removed_program_changes;
+}
+
+inline Size CommandSorter::removed_state_changes() const {
+  return m_removed_state_changes;
+}
+
+} // namespace rx::render::frontend
+
+#endif // RX_RENDER_FRONTEND_COMMAND_SORTER_H
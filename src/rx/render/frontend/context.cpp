@@ -8,13 +8,19 @@
 #include "rx/render/frontend/program.h"
 #include "rx/render/frontend/texture.h"
 #include "rx/render/frontend/downloader.h"
+#include "rx/render/frontend/capture.h"
 
 #include "rx/render/frontend/technique.h"
 #include "rx/render/frontend/module.h"
 #include "rx/render/frontend/material.h"
 
 #include "rx/core/concurrency/scope_lock.h"
+#include "rx/core/hints/likely.h"
+#include "rx/core/hints/unlikely.h"
+#include "rx/core/algorithm/insertion_sort.h"
 #include "rx/core/filesystem/directory.h"
+#include "rx/core/filesystem/archive.h"
+#include "rx/core/filesystem/file.h"
 
 #include "rx/core/profiler.h"
 #include "rx/core/log.h"
@@ -29,7 +35,14 @@ RX_CONSOLE_IVAR(max_texture2D, "render.max_texture2D", "maximum 2D textures", 16
 RX_CONSOLE_IVAR(max_texture3D, "render.max_texture3D", "maximum 3D textures", 16, 128, 16);
 RX_CONSOLE_IVAR(max_textureCM, "render.max_textureCM", "maximum CM textures", 16, 128, 16);
 RX_CONSOLE_IVAR(max_downloaders, "render.max_downloaders", "maximum downloaders", 2, 16, 8);
-RX_CONSOLE_IVAR(command_memory, "render.command_memory", "memory for command buffer in MiB", 1, 4, 2);
+RX_CONSOLE_IVAR(command_page_size, "render.command_page_size", "size of a command buffer page in KiB", 16, 4096, 256);
+RX_CONSOLE_IVAR(frame_memory_size, "render.frame_memory_size", "size of the per-frame memory in KiB", 64, 65536, 1024);
+
+RX_CONSOLE_BVAR(
+  sort_draws,
+  "render.sort_draws",
+  "reorder draws to reduce program and state changes",
+  false);
 
 RX_CONSOLE_V2IVAR(
   max_texture_dimensions,
@@ -46,9 +59,88 @@ static constexpr const char* k_module_path = "base/renderer/modules";
 
 namespace Rx::Render::Frontend {
 
+static Concurrency::Atomic<Uint64> g_context_id;
+
+// Calls |_function| with the path of every description in |_directory|. When
+// the mounted archive has the directory it's used instead of the file system.
+template<typename F>
+static void each_description(const char* _directory, F&& _function) {
+  auto visit{[&](const char* _name) {
+    const String name{_name};
+    if (name.ends_with(".json5")) {
+      _function(String::format("%s/%s", _directory, name));
+    }
+  }};
+
+  if (Filesystem::Archive::instance().each(_directory, [&](const char* _name) { visit(_name); })) {
+    return;
+  }
+
+  if (Filesystem::Directory directory{_directory}) {
+    directory.each([&](Filesystem::Directory::Item&& item_) {
+      if (item_.is_file()) {
+        visit(item_.name().data());
+      }
+    });
+  }
+}
+
+// The command list last used by the calling thread and the context it
+// belongs to. The address of |t_command_list| also identifies the thread.
+static thread_local struct {
+  Uint64 context;
+  void* list;
+} t_command_list;
+
+Context::CommandList::CommandList(Memory::Allocator& _allocator, const void* _thread)
+  : thread{_thread}
+  , key{0}
+  , commands{_allocator}
+  , spans{_allocator}
+  , command_buffer{_allocator, static_cast<Size>(*command_page_size) * 1024}
+  , edit_buffers{_allocator}
+  , edit_textures1D{_allocator}
+  , edit_textures2D{_allocator}
+  , edit_textures3D{_allocator}
+  , edit_texturesCM{_allocator}
+  , draw_calls{0}
+  , instanced_draw_calls{0}
+  , clear_calls{0}
+  , blit_calls{0}
+  , vertices{0}
+  , triangles{0}
+  , lines{0}
+  , points{0}
+  , footprint{0}
+{
+}
+
+void Context::CommandList::reset() {
+  commands.clear();
+  spans.clear();
+  command_buffer.reset();
+
+  edit_buffers.clear();
+  edit_textures1D.clear();
+  edit_textures2D.clear();
+  edit_textures3D.clear();
+  edit_texturesCM.clear();
+
+  draw_calls = 0;
+  instanced_draw_calls = 0;
+  clear_calls = 0;
+  blit_calls = 0;
+  vertices = 0;
+  triangles = 0;
+  lines = 0;
+  points = 0;
+  footprint = 0;
+}
+
 Context::Context(Memory::Allocator& _allocator, Backend::Context* _backend, const Math::Vec2z& _dimensions, bool _hdr)
   : m_allocator{_allocator}
   , m_backend{_backend}
+  , m_frame_allocator{allocator(), static_cast<Size>(*frame_memory_size) << 10, 2}
   , m_allocation_info{m_backend->query_allocation_info()}
   , m_buffer_pool{allocator(), m_allocation_info.buffer_size + sizeof(Buffer), static_cast<Size>(*max_buffers)}
   , m_target_pool{allocator(), m_allocation_info.target_size + sizeof(Target), static_cast<Size>(*max_targets)}
@@ -66,9 +158,19 @@ Context::Context(Memory::Allocator& _allocator, Backend::Context* _backend, cons
   , m_destroy_texturesCM{allocator()}
   , m_swapchain_target{nullptr}
   , m_swapchain_texture{nullptr}
+  , m_id{++g_context_id}
+  , m_command_lists{allocator()}
+  , m_merge_spans{allocator()}
   , m_commands{allocator()}
-  , m_command_buffer{allocator(), static_cast<Size>(*command_memory) * 1024 * 1024}
+  , m_command_sorter{allocator()}
+  , m_capture_file{allocator()}
   , m_deferred_process{[this]() { process(); }}
+  , m_command_memory_used{0}
+  , m_command_memory_size{0}
+  , m_command_memory_peak{0}
+  , m_sorted_draws{0}
+  , m_removed_program_changes{0}
+  , m_removed_state_changes{0}
   , m_device_info{allocator()}
 {
   RX_ASSERT(_backend, "expected valid backend");
@@ -82,33 +184,21 @@ Context::Context(Memory::Allocator& _allocator, Backend::Context* _backend, cons
   m_device_info.version = info.version;
 
   // load all modules
-  if (Filesystem::Directory directory{k_module_path}) {
-    directory.each([this](Filesystem::Directory::Item&& item_) {
-      if (item_.is_file() && item_.name().ends_with(".json5")) {
-        Module new_module{allocator()};
-        const auto path{String::format("%s/%s", k_module_path,
-                                       Utility::move(item_.name()))};
-        if (new_module.load(path)) {
-          m_modules.insert(new_module.name(), Utility::move(new_module));
-        }
-      }
-    });
-  }
+  each_description(k_module_path, [this](const String& _path) {
+    Module new_module{allocator()};
+    if (new_module.load(_path)) {
+      m_modules.insert(new_module.name(), Utility::move(new_module));
+    }
+  });
 
   // Load all the techniques.
-  if (Filesystem::Directory directory{k_technique_path}) {
-    directory.each([this](Filesystem::Directory::Item&& item_) {
-      if (item_.is_file() && item_.name().ends_with(".json5")) {
-        Technique new_technique{this};
-        const auto path{String::format("%s/%s", k_technique_path,
-                                       Utility::move(item_.name()))};
-        if (new_technique.load(path) && new_technique.compile(m_modules)) {
-          m_techniques.insert(new_technique.name(),
-                              Utility::move(new_technique));
-        }
-      }
-    });
-  }
+  each_description(k_technique_path, [this](const String& _path) {
+    Technique new_technique{this};
+    if (new_technique.load(_path) && new_technique.compile(m_modules)) {
+      m_techniques.insert(Atom{new_technique.name()},
+                          Utility::move(new_technique));
+    }
+  });
 
   // Generate swapchain target.
   m_swapchain_texture = create_texture2D(RX_RENDER_TAG("swapchain"));
@@ -160,83 +250,116 @@ Context::~Context() {
 
 // create_*
 Buffer* Context::create_buffer(const CommandHeader::Info& _info) {
-  Concurrency::ScopeLock lock{m_mutex};
-  auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_ALLOCATE, _info);
+  // Only the resource pool needs to be serialized, not the recording.
+  Buffer* buffer{nullptr};
+  {
+    Concurrency::ScopeLock lock{m_mutex};
+    buffer = m_buffer_pool.create<Buffer>(this);
+  }
+
+  auto command_base = record_command(command_list(), sizeof(ResourceCommand), CommandType::RESOURCE_ALLOCATE, _info);
   auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
   command->type = ResourceCommand::Type::BUFFER;
-  command->as_buffer = m_buffer_pool.create<Buffer>(this);
-  m_commands.push_back(command_base);
-  return command->as_buffer;
+  command->as_buffer = buffer;
+  return buffer;
 }
 
 Target* Context::create_target(const CommandHeader::Info& _info) {
-  Concurrency::ScopeLock lock{m_mutex};
-  auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_ALLOCATE, _info);
+  Target* target{nullptr};
+  {
+    Concurrency::ScopeLock lock{m_mutex};
+    target = m_target_pool.create<Target>(this);
+  }
+
+  auto command_base = record_command(command_list(), sizeof(ResourceCommand), CommandType::RESOURCE_ALLOCATE, _info);
   auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
   command->type = ResourceCommand::Type::TARGET;
-  command->as_target = m_target_pool.create<Target>(this);
-  m_commands.push_back(command_base);
-  return command->as_target;
+  command->as_target = target;
+  return target;
 }
 
 Program* Context::create_program(const CommandHeader::Info& _info) {
-  Concurrency::ScopeLock lock{m_mutex};
-  auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_ALLOCATE, _info);
+  Program* program{nullptr};
+  {
+    Concurrency::ScopeLock lock{m_mutex};
+    program = m_program_pool.create<Program>(this);
+  }
+
+  auto command_base = record_command(command_list(), sizeof(ResourceCommand), CommandType::RESOURCE_ALLOCATE, _info);
   auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
   command->type = ResourceCommand::Type::PROGRAM;
-  command->as_program = m_program_pool.create<Program>(this);
-  m_commands.push_back(command_base);
-  return command->as_program;
+  command->as_program = program;
+  return program;
 }
 
 Texture1D* Context::create_texture1D(const CommandHeader::Info& _info) {
-  Concurrency::ScopeLock lock{m_mutex};
-  auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_ALLOCATE, _info);
+  Texture1D* texture{nullptr};
+  {
+    Concurrency::ScopeLock lock{m_mutex};
+    texture = m_texture1D_pool.create<Texture1D>(this);
+  }
+
+  auto command_base = record_command(command_list(), sizeof(ResourceCommand), CommandType::RESOURCE_ALLOCATE, _info);
   auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
   command->type = ResourceCommand::Type::TEXTURE1D;
-  command->as_texture1D = m_texture1D_pool.create<Texture1D>(this);
-  m_commands.push_back(command_base);
-  return command->as_texture1D;
+  command->as_texture1D = texture;
+  return texture;
 }
 
 Texture2D* Context::create_texture2D(const CommandHeader::Info& _info) {
-  Concurrency::ScopeLock lock{m_mutex};
-  auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_ALLOCATE, _info);
+  Texture2D* texture{nullptr};
+  {
+    Concurrency::ScopeLock lock{m_mutex};
+    texture = m_texture2D_pool.create<Texture2D>(this);
+  }
+
+  auto command_base = record_command(command_list(), sizeof(ResourceCommand), CommandType::RESOURCE_ALLOCATE, _info);
   auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
   command->type = ResourceCommand::Type::TEXTURE2D;
-  command->as_texture2D = m_texture2D_pool.create<Texture2D>(this);
-  m_commands.push_back(command_base);
-  return command->as_texture2D;
+  command->as_texture2D = texture;
+  return texture;
 }
 
 Texture3D* Context::create_texture3D(const CommandHeader::Info& _info) {
-  Concurrency::ScopeLock lock{m_mutex};
-  auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_ALLOCATE, _info);
+  Texture3D* texture{nullptr};
+  {
+    Concurrency::ScopeLock lock{m_mutex};
+    texture = m_texture3D_pool.create<Texture3D>(this);
+  }
+
+  auto command_base = record_command(command_list(), sizeof(ResourceCommand), CommandType::RESOURCE_ALLOCATE, _info);
   auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
   command->type = ResourceCommand::Type::TEXTURE3D;
-  command->as_texture3D = m_texture3D_pool.create<Texture3D>(this);
-  m_commands.push_back(command_base);
-  return command->as_texture3D;
+  command->as_texture3D = texture;
+  return texture;
 }
 
 TextureCM* Context::create_textureCM(const CommandHeader::Info& _info) {
-  Concurrency::ScopeLock lock{m_mutex};
-  auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_ALLOCATE, _info);
+  TextureCM* texture{nullptr};
+  {
+    Concurrency::ScopeLock lock{m_mutex};
+    texture = m_textureCM_pool.create<TextureCM>(this);
+  }
+
+  auto command_base = record_command(command_list(), sizeof(ResourceCommand), CommandType::RESOURCE_ALLOCATE, _info);
   auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
   command->type = ResourceCommand::Type::TEXTURECM;
-  command->as_textureCM = m_textureCM_pool.create<TextureCM>(this);
-  m_commands.push_back(command_base);
-  return command->as_textureCM;
+  command->as_textureCM = texture;
+  return texture;
 }
 
 Downloader* Context::create_downloader(const CommandHeader::Info& _info) {
-  Concurrency::ScopeLock lock{m_mutex};
-  auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_ALLOCATE, _info);
+  Downloader* downloader{nullptr};
+  {
+    Concurrency::ScopeLock lock{m_mutex};
+    downloader = m_downloader_pool.create<Downloader>(this);
+  }
+
+  auto command_base = record_command(command_list(), sizeof(ResourceCommand), CommandType::RESOURCE_ALLOCATE, _info);
   auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
   command->type = ResourceCommand::Type::DOWNLOADER;
-  command->as_downloader = m_downloader_pool.create<Downloader>(this);
-  m_commands.push_back(command_base);
-  return command->as_downloader;
+  command->as_downloader = downloader;
+  return downloader;
 }
 
 // initialize_*
@@ -244,115 +367,107 @@ void Context::initialize_buffer(const CommandHeader::Info& _info, Buffer* _buffe
   RX_ASSERT(_buffer, "_buffer is null");
   _buffer->validate();
 
-  Concurrency::ScopeLock lock{m_mutex};
-  auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_CONSTRUCT, _info);
+  auto& list{command_list()};
+  auto command_base = record_command(list, sizeof(ResourceCommand), CommandType::RESOURCE_CONSTRUCT, _info);
   auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
   command->type = ResourceCommand::Type::BUFFER;
   command->as_buffer = _buffer;
-  m_commands.push_back(command_base);
-  m_footprint[0] += _buffer->resource_usage();
+  list.footprint += _buffer->resource_usage();
 }
 
 void Context::initialize_target(const CommandHeader::Info& _info, Target* _target) {
   RX_ASSERT(_target, "_target is null");
   _target->validate();
 
-  Concurrency::ScopeLock lock{m_mutex};
-  auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_CONSTRUCT, _info);
+  auto& list{command_list()};
+  auto command_base = record_command(list, sizeof(ResourceCommand), CommandType::RESOURCE_CONSTRUCT, _info);
   auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
   command->type = ResourceCommand::Type::TARGET;
   command->as_target = _target;
-  m_commands.push_back(command_base);
-  m_footprint[0] += _target->resource_usage();
+  list.footprint += _target->resource_usage();
 }
 
 void Context::initialize_program(const CommandHeader::Info& _info, Program* _program) {
   RX_ASSERT(_program, "_program is null");
   _program->validate();
 
-  Concurrency::ScopeLock lock{m_mutex};
-  auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_CONSTRUCT, _info);
+  auto& list{command_list()};
+  auto command_base = record_command(list, sizeof(ResourceCommand), CommandType::RESOURCE_CONSTRUCT, _info);
   auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
   command->type = ResourceCommand::Type::PROGRAM;
   command->as_program = _program;
-  m_commands.push_back(command_base);
-  m_footprint[0] += _program->resource_usage();
+  list.footprint += _program->resource_usage();
 }
 
 void Context::initialize_texture(const CommandHeader::Info& _info, Texture1D* _texture) {
   RX_ASSERT(_texture, "_texture is null");
   _texture->validate();
 
-  Concurrency::ScopeLock lock{m_mutex};
-  auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_CONSTRUCT, _info);
+  auto& list{command_list()};
+  auto command_base = record_command(list, sizeof(ResourceCommand), CommandType::RESOURCE_CONSTRUCT, _info);
   auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
   command->type = ResourceCommand::Type::TEXTURE1D;
   command->as_texture1D = _texture;
-  m_commands.push_back(command_base);
-  m_footprint[0] += _texture->resource_usage();
+  list.footprint += _texture->resource_usage();
 }
 
 void Context::initialize_texture(const CommandHeader::Info& _info, Texture2D* _texture) {
   RX_ASSERT(_texture, "_texture is null");
   _texture->validate();
 
-  Concurrency::ScopeLock lock{m_mutex};
-  auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_CONSTRUCT, _info);
+  auto& list{command_list()};
+  auto command_base = record_command(list, sizeof(ResourceCommand), CommandType::RESOURCE_CONSTRUCT, _info);
   auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
   command->type = ResourceCommand::Type::TEXTURE2D;
   command->as_texture2D = _texture;
-  m_commands.push_back(command_base);
-  m_footprint[0] += _texture->resource_usage();
+  list.footprint += _texture->resource_usage();
 }
 
 void Context::initialize_texture(const CommandHeader::Info& _info, Texture3D* _texture) {
   RX_ASSERT(_texture, "_texture is null");
   _texture->validate();
 
-  Concurrency::ScopeLock lock{m_mutex};
-  auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_CONSTRUCT, _info);
+  auto& list{command_list()};
+  auto command_base = record_command(list, sizeof(ResourceCommand), CommandType::RESOURCE_CONSTRUCT, _info);
   auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
   command->type = ResourceCommand::Type::TEXTURE3D;
   command->as_texture3D = _texture;
-  m_commands.push_back(command_base);
-  m_footprint[0] += _texture->resource_usage();
+  list.footprint += _texture->resource_usage();
 }
 
 void Context::initialize_texture(const CommandHeader::Info& _info, TextureCM* _texture) {
   RX_ASSERT(_texture, "_texture is null");
   _texture->validate();
 
-  Concurrency::ScopeLock lock{m_mutex};
-  auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_CONSTRUCT, _info);
+  auto& list{command_list()};
+  auto command_base = record_command(list, sizeof(ResourceCommand), CommandType::RESOURCE_CONSTRUCT, _info);
   auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
   command->type = ResourceCommand::Type::TEXTURECM;
   command->as_textureCM = _texture;
-  m_commands.push_back(command_base);
-  m_footprint[0] += _texture->resource_usage();
+  list.footprint += _texture->resource_usage();
 }
 
 void Context::initialize_downloader(const CommandHeader::Info& _info, Downloader* _downloader) {
   RX_ASSERT(_downloader, "_downloader is null");
 
-  Concurrency::ScopeLock lock{m_mutex};
-  auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_CONSTRUCT, _info);
+  auto& list{command_list()};
+  auto command_base = record_command(list, sizeof(ResourceCommand), CommandType::RESOURCE_CONSTRUCT, _info);
   auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
   command->type = ResourceCommand::Type::DOWNLOADER;
   command->as_downloader = _downloader;
-  m_commands.push_back(command_base);
 }
 
 // update_*
 void Context::update_buffer(const CommandHeader::Info& _info, Buffer* _buffer) {
   if (_buffer) {
-    Concurrency::ScopeLock lock{m_mutex};
+    auto& list{command_list()};
 
     // Optimize the edits. Any overlapping, redundant, or superfluous edits
     // will be coalesced or removed at this point.
     _buffer->optimize_edits();
 
     // Keep track of frame footprint.
-    m_footprint[0] += _buffer->bytes_for_edits();
+    list.footprint += _buffer->bytes_for_edits();
 
     const auto& edits = _buffer->edits();
     if (edits.is_empty()) {
@@ -363,31 +478,30 @@ void Context::update_buffer(const CommandHeader::Info& _info, Buffer* _buffer) {
     const auto n_edits = edits.size();
     const Size edit_bytes = n_edits * sizeof(Buffer::Edit);
 
-    auto command_base = m_command_buffer.allocate(sizeof(UpdateCommand) + edit_bytes, CommandType::RESOURCE_UPDATE, _info);
+    auto command_base = record_command(list, sizeof(UpdateCommand) + edit_bytes, CommandType::RESOURCE_UPDATE, _info);
     auto command = reinterpret_cast<UpdateCommand*>(command_base + sizeof(CommandHeader));
 
     command->edits = n_edits;
     command->type = UpdateCommand::Type::BUFFER;
     command->as_buffer = _buffer;
     memcpy(command->edit(), edits.data(), edit_bytes);
-    m_commands.push_back(command_base);
 
     // So we can clear edit list after processing.
-    // m_edit_buffers.push_back(_buffer);
+    // list.edit_buffers.push_back(_buffer);
     _buffer->clear_edits();
   }
 }
 
 void Context::update_texture(const CommandHeader::Info& _info, Texture1D* _texture) {
   if (_texture) {
-    Concurrency::ScopeLock lock{m_mutex};
+    auto& list{command_list()};
 
     // Optimize the edits. Any overlapping, redundant, or superfluous edits
     // will be coalesced or removed at this point.
     _texture->optimize_edits();
 
     // Keep track of frame footprint.
-    m_footprint[0] += _texture->bytes_for_edits();
+    list.footprint += _texture->bytes_for_edits();
 
     const auto& edits = _texture->edits();
     if (edits.is_empty()) {
@@ -398,30 +512,29 @@ void Context::update_texture(const CommandHeader::Info& _info, Texture1D* _textu
     const auto n_edits = edits.size();
     const Size edit_bytes = n_edits * sizeof(Texture::Edit<Texture1D::DimensionType>);
 
-    auto command_base = m_command_buffer.allocate(sizeof(UpdateCommand) + edit_bytes, CommandType::RESOURCE_UPDATE, _info);
+    auto command_base = record_command(list, sizeof(UpdateCommand) + edit_bytes, CommandType::RESOURCE_UPDATE, _info);
     auto command = reinterpret_cast<UpdateCommand*>(command_base + sizeof(CommandHeader));
 
     command->edits = n_edits;
     command->type = UpdateCommand::Type::TEXTURE1D;
     command->as_texture1D = _texture;
     memcpy(command->edit(), edits.data(), edit_bytes);
-    m_commands.push_back(command_base);
 
     // So we can clear edit list after processing.
-    m_edit_textures1D.push_back(_texture);
+    list.edit_textures1D.push_back(_texture);
   }
 }
 
 void Context::update_texture(const CommandHeader::Info& _info, Texture2D* _texture) {
   if (_texture) {
-    Concurrency::ScopeLock lock{m_mutex};
+    auto& list{command_list()};
 
     // Optimize the edits. Any overlapping, redundant, or superfluous edits
     // will be coalesced or removed at this point.
     _texture->optimize_edits();
 
     // Keep track of frame footprint.
-    m_footprint[0] += _texture->bytes_for_edits();
+    list.footprint += _texture->bytes_for_edits();
 
     const auto& edits = _texture->edits();
     if (edits.is_empty()) {
@@ -432,30 +545,29 @@ void Context::update_texture(const CommandHeader::Info& _info, Texture2D* _textu
     const auto n_edits = edits.size();
     const Size edit_bytes = n_edits * sizeof(Texture::Edit<Texture2D::DimensionType>);
 
-    auto command_base = m_command_buffer.allocate(sizeof(UpdateCommand) + edit_bytes, CommandType::RESOURCE_UPDATE, _info);
+    auto command_base = record_command(list, sizeof(UpdateCommand) + edit_bytes, CommandType::RESOURCE_UPDATE, _info);
     auto command = reinterpret_cast<UpdateCommand*>(command_base + sizeof(CommandHeader));
 
     command->edits = n_edits;
     command->type = UpdateCommand::Type::TEXTURE2D;
     command->as_texture2D = _texture;
     memcpy(command->edit(), edits.data(), edit_bytes);
-    m_commands.push_back(command_base);
 
     // So we can clear edit list after processing.
-    m_edit_textures2D.push_back(_texture);
+    list.edit_textures2D.push_back(_texture);
   }
 }
 
 void Context::update_texture(const CommandHeader::Info& _info, Texture3D* _texture) {
   if (_texture) {
-    Concurrency::ScopeLock lock{m_mutex};
+    auto& list{command_list()};
 
     // Optimize the edits. Any overlapping, redundant, or superfluous edits
     // will be coalesced or removed at this point.
     _texture->optimize_edits();
 
     // Keep track of frame footprint.
-    m_footprint[0] += _texture->bytes_for_edits();
+    list.footprint += _texture->bytes_for_edits();
 
     const auto& edits = _texture->edits();
     if (edits.is_empty()) {
@@ -466,43 +578,42 @@ void Context::update_texture(const CommandHeader::Info& _info, Texture3D* _textu
     const auto n_edits = edits.size();
     const Size edit_bytes = n_edits * sizeof(Texture::Edit<Texture2D::DimensionType>);
 
-    auto command_base = m_command_buffer.allocate(sizeof(UpdateCommand) + edit_bytes, CommandType::RESOURCE_UPDATE, _info);
+    auto command_base = record_command(list, sizeof(UpdateCommand) + edit_bytes, CommandType::RESOURCE_UPDATE, _info);
     auto command = reinterpret_cast<UpdateCommand*>(command_base + sizeof(CommandHeader));
 
     command->edits = n_edits;
     command->type = UpdateCommand::Type::TEXTURE3D;
     command->as_texture3D = _texture;
     memcpy(command->edit(), edits.data(), edit_bytes);
-    m_commands.push_back(command_base);
 
     // So we can clear edit list after processing.
-    m_edit_textures3D.push_back(_texture);
+    list.edit_textures3D.push_back(_texture);
   }
 }
 
 // destroy_*
 void Context::destroy_buffer(const CommandHeader::Info& _info, Buffer* _buffer) {
   if (_buffer && _buffer->release_reference()) {
+    auto& list{command_list()};
     Concurrency::ScopeLock lock{m_mutex};
     remove_from_cache(m_cached_buffers, _buffer);
-    auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_DESTROY, _info);
+    auto command_base = record_command(list, sizeof(ResourceCommand), CommandType::RESOURCE_DESTROY, _info);
     auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
     command->type = ResourceCommand::Type::BUFFER;
     command->as_buffer = _buffer;
-    m_commands.push_back(command_base);
     m_destroy_buffers.push_back(_buffer);
   }
 }
 
 void Context::destroy_target(const CommandHeader::Info& _info, Target* _target) {
   if (_target && _target->release_reference()) {
+    auto& list{command_list()};
     Concurrency::ScopeLock lock{m_mutex};
     remove_from_cache(m_cached_targets, _target);
-    auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_DESTROY, _info);
+    auto command_base = record_command(list, sizeof(ResourceCommand), CommandType::RESOURCE_DESTROY, _info);
     auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
     command->type = ResourceCommand::Type::TARGET;
     command->as_target = _target;
-    m_commands.push_back(command_base);
     m_destroy_targets.push_back(_target);
 
     // Anything owned by the target will also be queued for destruction at this
@@ -515,57 +626,60 @@ void Context::destroy_target(const CommandHeader::Info& _info, Target* _target)
 
 void Context::destroy_program(const CommandHeader::Info& _info, Program* _program) {
   if (_program && _program->release_reference()) {
+    auto& list{command_list()};
     Concurrency::ScopeLock lock{m_mutex};
     // remove_from_cache(m_cached_programs, _program);
-    auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_DESTROY, _info);
+    auto command_base = record_command(list, sizeof(ResourceCommand), CommandType::RESOURCE_DESTROY, _info);
     auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
     command->type = ResourceCommand::Type::PROGRAM;
     command->as_program = _program;
-    m_commands.push_back(command_base);
     m_destroy_programs.push_back(_program);
   }
 }
 
 void Context::destroy_texture(const CommandHeader::Info& _info, Texture1D* _texture) {
   if (_texture && _texture->release_reference()) {
+    auto& list{command_list()};
     Concurrency::ScopeLock lock{m_mutex};
     remove_from_cache(m_cached_textures1D, _texture);
-    auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_DESTROY, _info);
+    auto command_base = record_command(list, sizeof(ResourceCommand), CommandType::RESOURCE_DESTROY, _info);
     auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
     command->type = ResourceCommand::Type::TEXTURE1D;
     command->as_texture1D = _texture;
-    m_commands.push_back(command_base);
     m_destroy_textures1D.push_back(_texture);
   }
 }
 
 void Context::destroy_texture(const CommandHeader::Info& _info, Texture2D* _texture) {
+  // Ensure the command list exists before |m_mutex| is held since creating it
+  // needs to acquire |m_mutex|.
+  command_list();
   Concurrency::ScopeLock lock{m_mutex};
   destroy_texture_unlocked(_info, _texture);
 }
 
 void Context::destroy_texture(const CommandHeader::Info& _info, Texture3D* _texture) {
   if (_texture && _texture->release_reference()) {
+    auto& list{command_list()};
     Concurrency::ScopeLock lock{m_mutex};
     remove_from_cache(m_cached_textures3D, _texture);
-    auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_DESTROY, _info);
+    auto command_base = record_command(list, sizeof(ResourceCommand), CommandType::RESOURCE_DESTROY, _info);
     auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
     command->type = ResourceCommand::Type::TEXTURE3D;
     command->as_texture3D = _texture;
-    m_commands.push_back(command_base);
     m_destroy_textures3D.push_back(_texture);
   }
 }
 
 void Context::destroy_texture(const CommandHeader::Info& _info, TextureCM* _texture) {
   if (_texture && _texture->release_reference()) {
+    auto& list{command_list()};
     Concurrency::ScopeLock lock{m_mutex};
     remove_from_cache(m_cached_texturesCM, _texture);
-    auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_DESTROY, _info);
+    auto command_base = record_command(list, sizeof(ResourceCommand), CommandType::RESOURCE_DESTROY, _info);
     auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
     command->type = ResourceCommand::Type::TEXTURECM;
     command->as_textureCM = _texture;
-    m_commands.push_back(command_base);
     m_destroy_texturesCM.push_back(_texture);
   }
 }
@@ -573,11 +687,10 @@ void Context::destroy_texture(const CommandHeader::Info& _info, TextureCM* _text
 void Context::destroy_texture_unlocked(const CommandHeader::Info& _info, Texture2D* _texture) {
   if (_texture && _texture->release_reference()) {
     remove_from_cache(m_cached_textures2D, _texture);
-    auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_DESTROY, _info);
+    auto command_base = record_command(command_list(), sizeof(ResourceCommand), CommandType::RESOURCE_DESTROY, _info);
     auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
     command->type = ResourceCommand::Type::TEXTURE2D;
     command->as_texture2D = _texture;
-    m_commands.push_back(command_base);
     m_destroy_textures2D.push_back(_texture);
   }
 }
@@ -585,12 +698,12 @@ void Context::destroy_texture_unlocked(const CommandHeader::Info& _info, Texture
 void Context::destroy_downloader(const CommandHeader::Info& _info, Downloader* _downloader) {
   // NOTE(dweiler): Do not manage a reference count for downloader resources as they're not shareable.
   if (_downloader) {
+    auto& list{command_list()};
     Concurrency::ScopeLock lock{m_mutex};
-    auto command_base = m_command_buffer.allocate(sizeof(ResourceCommand), CommandType::RESOURCE_DESTROY, _info);
+    auto command_base = record_command(list, sizeof(ResourceCommand), CommandType::RESOURCE_DESTROY, _info);
     auto command = reinterpret_cast<ResourceCommand*>(command_base + sizeof(CommandHeader));
     command->type = ResourceCommand::Type::DOWNLOADER;
     command->as_downloader = _downloader;
-    m_commands.push_back(command_base);
     m_destroy_downloaders.push_back(_downloader);
   }
 }
@@ -639,28 +752,29 @@ void Context::draw(
       "draw call forms texture <=> target feedback loop");
   }
 
-  m_vertices[0] += _count * instances;
+  auto& list{command_list()};
+
+  list.vertices += _count * instances;
 
   switch (_primitive_type) {
   case PrimitiveType::LINES:
-    m_lines[0] += (_count / 2) * instances;
+    list.lines += (_count / 2) * instances;
     break;
   case PrimitiveType::POINTS:
-    m_points[0] += _count * _instances;
+    list.points += _count * _instances;
     break;
   case PrimitiveType::TRIANGLE_STRIP:
-    m_triangles[0] += (_count - 2) * instances;
+    list.triangles += (_count - 2) * instances;
     break;
   case PrimitiveType::TRIANGLES:
-    m_triangles[0] += (_count / 3) * instances;
+    list.triangles += (_count / 3) * instances;
     break;
   }
 
   {
-    Concurrency::ScopeLock lock{m_mutex};
     const auto dirty_uniforms_size{_program->dirty_uniforms_size()};
 
-    auto command_base{m_command_buffer.allocate(sizeof(DrawCommand) + dirty_uniforms_size, CommandType::DRAW, _info)};
+    auto command_base{record_command(list, sizeof(DrawCommand) + dirty_uniforms_size, CommandType::DRAW, _info)};
     auto command{reinterpret_cast<DrawCommand*>(command_base + sizeof(CommandHeader))};
 
     command->draw_buffers = _draw_buffers;
@@ -684,16 +798,14 @@ void Context::draw(
     // Copy the uniforms directly into the command.
     if (dirty_uniforms_size) {
       _program->flush_dirty_uniforms(command->uniforms());
-      m_footprint[0] += dirty_uniforms_size;
+      list.footprint += dirty_uniforms_size;
     }
-
-    m_commands.push_back(command_base);
   }
 
-  m_draw_calls[0]++;
+  list.draw_calls++;
 
   if (_instances) {
-    m_instanced_draw_calls[0]++;
+    list.instanced_draw_calls++;
   }
 }
 
@@ -711,10 +823,10 @@ void Context::clear(const CommandHeader::Info& _info, const State& _state,
 
   _clear_mask >>= 2;
 
-  {
-    Concurrency::ScopeLock lock{m_mutex};
+  auto& list{command_list()};
 
-    auto command_base = m_command_buffer.allocate(sizeof(ClearCommand), CommandType::CLEAR, _info);
+  {
+    auto command_base = record_command(list, sizeof(ClearCommand), CommandType::CLEAR, _info);
     auto command = reinterpret_cast<ClearCommand*>(command_base + sizeof(CommandHeader));
 
     command->render_state = _state;
@@ -747,11 +859,9 @@ void Context::clear(const CommandHeader::Info& _info, const State& _state,
       }
     }
     va_end(va);
-
-    m_commands.push_back(command_base);
   }
 
-  m_clear_calls[0]++;
+  list.clear_calls++;
 }
 
 void Context::blit(
@@ -809,10 +919,10 @@ void Context::blit(
   RX_ASSERT(is_float_color(src_attachment->format()) == is_float_color(dst_attachment->format()),
     "incompatible formats between attachments");
 
-  {
-    Concurrency::ScopeLock lock{m_mutex};
+  auto& list{command_list()};
 
-    auto command_base = m_command_buffer.allocate(sizeof(BlitCommand), CommandType::BLIT, _info);
+  {
+    auto command_base = record_command(list, sizeof(BlitCommand), CommandType::BLIT, _info);
     auto command = reinterpret_cast<BlitCommand*>(command_base + sizeof(CommandHeader));
 
     command->render_state = _state;
@@ -822,11 +932,9 @@ void Context::blit(
     command->dst_attachment = _dst_attachment;
 
     command->render_state.flush();
-
-    m_commands.push_back(command_base);
   }
 
-  m_blit_calls[0]++;
+  list.blit_calls++;
 }
 
 void Context::download(
@@ -836,28 +944,20 @@ void Context::download(
   const Math::Vec2z& _offset,
   Downloader* _downloader)
 {
-  Concurrency::ScopeLock lock{m_mutex};
-
-  auto command_base = m_command_buffer.allocate(sizeof(DownloadCommand), CommandType::DOWNLOAD, _info);
+  auto command_base = record_command(command_list(), sizeof(DownloadCommand), CommandType::DOWNLOAD, _info);
   auto command = reinterpret_cast<DownloadCommand*>(command_base + sizeof(CommandHeader));
 
   command->src_target = _src_target;
   command->src_attachment = _src_attachment;
   command->offset = _offset;
   command->downloader = _downloader;
-
-  m_commands.push_back(command_base);
 }
 
 void Context::profile(const char* _tag) {
-  Concurrency::ScopeLock lock{m_mutex};
-
-  auto command_base = m_command_buffer.allocate(sizeof(ProfileCommand), CommandType::PROFILE, RX_RENDER_TAG("profile"));
+  auto command_base = record_command(command_list(), sizeof(ProfileCommand), CommandType::PROFILE, RX_RENDER_TAG("profile"));
   auto command = reinterpret_cast<ProfileCommand*>(command_base + sizeof(CommandHeader));
 
   command->tag = _tag;
-
-  m_commands.push_back(command_base);
 }
 
 void Context::resize(const Math::Vec2z& _resolution) {
@@ -866,25 +966,96 @@ void Context::resize(const Math::Vec2z& _resolution) {
   m_swapchain_target->m_dimensions = _resolution;
 }
 
+void Context::capture(const String& _file_name) {
+  Concurrency::ScopeLock lock{m_mutex};
+  m_capture_file = _file_name;
+}
+
+void Context::write_capture() {
+  Filesystem::File file{m_capture_file, "wb"};
+  if (!file) {
+    logger->error("failed to open \"%s\" for capture", m_capture_file);
+  } else {
+    // The capture has to be finished before the file is closed.
+    bool result{false};
+    {
+      Capture capture{frame_allocator()};
+      result = capture.write(&file, m_swapchain_target->dimensions(), m_commands);
+    }
+    if (result) {
+      logger->info("captured %zu commands to \"%s\"", m_commands.size(),
+        m_capture_file);
+    } else {
+      logger->error("failed to write capture \"%s\"", m_capture_file);
+    }
+  }
+  m_capture_file.clear();
+}
+
 bool Context::process() {
   RX_PROFILE_CPU("process");
 
+  Concurrency::ScopeLock lock{m_mutex};
+
+  merge_command_lists();
+
   if (m_commands.is_empty()) {
     return false;
   }
 
   m_commands_recorded[0] = m_commands.size();
 
-  Concurrency::ScopeLock lock{m_mutex};
+  // Reorder draws to reduce the state changes in the backend.
+  if (*sort_draws) {
+    m_command_sorter.sort(m_commands);
+    m_sorted_draws = m_command_sorter.sorted_draws();
+    m_removed_program_changes = m_command_sorter.removed_program_changes();
+    m_removed_state_changes = m_command_sorter.removed_state_changes();
+  } else {
+    m_sorted_draws = 0;
+    m_removed_program_changes = 0;
+    m_removed_state_changes = 0;
+  }
+
+  if (!m_capture_file.is_empty()) {
+    write_capture();
+  }
 
   // Consume all recorded commands on the backend.
   m_backend->process(m_commands);
 
-  // Clear edit lists
-  m_edit_buffers.each_fwd([this](Buffer* _buffer) { _buffer->clear_edits(); });
-  m_edit_textures1D.each_fwd([this](Texture1D* _texture) { _texture->clear_edits(); });
-  m_edit_textures2D.each_fwd([this](Texture2D* _texture) { _texture->clear_edits(); });
-  m_edit_textures3D.each_fwd([this](Texture3D* _texture) { _texture->clear_edits(); });
+  Size command_memory_used{0};
+  Size command_memory_size{0};
+  Size command_memory_peak{0};
+  m_command_lists.each_fwd([&](Ptr<CommandList>& list_) {
+    // Clear edit lists
+    list_->edit_buffers.each_fwd([](Buffer* _buffer) { _buffer->clear_edits(); });
+    list_->edit_textures1D.each_fwd([](Texture1D* _texture) { _texture->clear_edits(); });
+    list_->edit_textures2D.each_fwd([](Texture2D* _texture) { _texture->clear_edits(); });
+    list_->edit_textures3D.each_fwd([](Texture3D* _texture) { _texture->clear_edits(); });
+
+    // Gather the statistics recorded on this thread.
+    m_draw_calls[0] += list_->draw_calls;
+    m_instanced_draw_calls[0] += list_->instanced_draw_calls;
+    m_clear_calls[0] += list_->clear_calls;
+    m_blit_calls[0] += list_->blit_calls;
+    m_vertices[0] += list_->vertices;
+    m_triangles[0] += list_->triangles;
+    m_lines[0] += list_->lines;
+    m_points[0] += list_->points;
+    m_footprint[0] += list_->footprint;
+
+    command_memory_used += list_->command_buffer.used();
+    command_memory_size += list_->command_buffer.size();
+    command_memory_peak += list_->command_buffer.high_water_mark();
+
+    // Reset the command buffer and edit lists.
+    list_->reset();
+  });
+
+  m_command_memory_used = command_memory_used;
+  m_command_memory_size = command_memory_size;
+  m_command_memory_peak = command_memory_peak;
 
   // Cleanup unreferenced frontend resources.
   m_destroy_buffers.each_fwd([this](Buffer* _buffer) { m_buffer_pool.destroy<Buffer>(_buffer); });
@@ -896,15 +1067,7 @@ bool Context::process() {
   m_destroy_texturesCM.each_fwd([this](TextureCM* _texture) { m_textureCM_pool.destroy<TextureCM>(_texture); });
   m_destroy_downloaders.each_fwd([this](Downloader* _downloader) { m_downloader_pool.destroy<Downloader>(_downloader); });
 
-  // Reset the command buffer.
   m_commands.clear();
-  m_command_buffer.reset();
-
-  // Cleanup edit lists.
-  m_edit_buffers.clear();
-  m_edit_textures1D.clear();
-  m_edit_textures2D.clear();
-  m_edit_textures3D.clear();
 
   // Cleanup destroyed resources list.
   m_destroy_buffers.clear();
@@ -933,6 +1096,90 @@ bool Context::process() {
   return true;
 }
 
+Context::CommandList& Context::command_list() {
+  // Fast path, this thread already recorded into this context.
+  if (RX_HINT_LIKELY(t_command_list.context == m_id)) {
+    return *reinterpret_cast<CommandList*>(t_command_list.list);
+  }
+
+  // Slow path, the thread either never recorded into this context or last
+  // recorded into a different one.
+  auto& list{create_command_list(&t_command_list)};
+  t_command_list.context = m_id;
+  t_command_list.list = &list;
+  return list;
+}
+
+Context::CommandList& Context::create_command_list(const void* _thread) {
+  Concurrency::ScopeLock lock{m_mutex};
+
+  const auto index{m_command_lists.find_if([_thread](const Ptr<CommandList>& _list) {
+    return _list->thread == _thread;
+  })};
+
+  if (index != -1_z) {
+    return *m_command_lists[index];
+  }
+
+  auto list{make_ptr<CommandList>(allocator(), allocator(), _thread)};
+  RX_ASSERT(list, "out of memory");
+  auto& result{*list};
+  m_command_lists.push_back(Utility::move(list));
+  return result;
+}
+
+Byte* Context::record_command(CommandList& list_, Size _size,
+  CommandType _type, const CommandHeader::Info& _info)
+{
+  auto command_base{list_.command_buffer.allocate(_size, _type, _info)};
+
+  // A span only starts when the key changed since the last command.
+  if (RX_HINT_UNLIKELY(list_.spans.is_empty() || list_.spans.last().key != list_.key)) {
+    list_.spans.push_back({list_.key, list_.commands.size()});
+  }
+
+  list_.commands.push_back(command_base);
+  return command_base;
+}
+
+void Context::set_submission_key(Uint64 _key) {
+  command_list().key = _key;
+}
+
+void Context::merge_command_lists() {
+  m_commands.clear();
+  m_merge_spans.clear();
+
+  // Gather the spans of every list, lists in the order they were created in
+  // and spans in the order they were recorded in.
+  Size total{0};
+  m_command_lists.each_fwd([&](const Ptr<CommandList>& _list) {
+    const auto& spans{_list->spans};
+    for (Size i{0}; i < spans.size(); i++) {
+      const Size end{i + 1 < spans.size() ? spans[i + 1].offset : _list->commands.size()};
+      m_merge_spans.push_back({spans[i].key, _list->commands.data() + spans[i].offset,
+        end - spans[i].offset});
+    }
+    total += _list->commands.size();
+  });
+
+  // The sort is stable, spans under the same key keep the order above. There
+  // are only as many spans as times a thread changed its key, so an insertion
+  // sort does, and is about free when threads record in increasing keys.
+  Algorithm::insertion_sort(m_merge_spans.data(),
+    m_merge_spans.data() + m_merge_spans.size(),
+    [](const MergeSpan& _lhs, const MergeSpan& _rhs) {
+      return _lhs.key < _rhs.key;
+    });
+
+  m_commands.reserve(total);
+  m_merge_spans.each_fwd([this](const MergeSpan& _span) {
+    for (Size i{0}; i < _span.count; i++) {
+      m_commands.push_back(_span.commands[i]);
+    }
+  });
+}
+
 Context::Statistics Context::stats(Resource::Type _type) const {
   Concurrency::ScopeLock lock(m_mutex);
 
@@ -964,12 +1211,15 @@ bool Context::swap() {
 
   m_backend->swap();
 
+  // The backend is done with what was allocated for the frame before this one.
+  m_frame_allocator.next_frame();
+
   m_frame++;
 
   return m_timer.update();
 }
 
-Buffer* Context::cached_buffer(const String& _key) {
+Buffer* Context::cached_buffer(Atom _key) {
   Concurrency::ScopeLock lock{m_mutex};
   if (auto find = m_cached_buffers.find(_key)) {
     auto result = *find;
@@ -979,7 +1229,7 @@ Buffer* Context::cached_buffer(const String& _key) {
   return nullptr;
 }
 
-Target* Context::cached_target(const String& _key) {
+Target* Context::cached_target(Atom _key) {
   Concurrency::ScopeLock lock{m_mutex};
   if (auto find{m_cached_targets.find(_key)}) {
     auto result{*find};
@@ -989,7 +1239,7 @@ Target* Context::cached_target(const String& _key) {
   return nullptr;
 }
 
-Texture1D* Context::cached_texture1D(const String& _key) {
+Texture1D* Context::cached_texture1D(Atom _key) {
   Concurrency::ScopeLock lock{m_mutex};
   if (auto find{m_cached_textures1D.find(_key)}) {
     auto result{*find};
@@ -999,7 +1249,7 @@ Texture1D* Context::cached_texture1D(const String& _key) {
   return nullptr;
 }
 
-Texture2D* Context::cached_texture2D(const String& _key) {
+Texture2D* Context::cached_texture2D(Atom _key) {
   Concurrency::ScopeLock lock{m_mutex};
   if (auto find{m_cached_textures2D.find(_key)}) {
     auto result{*find};
@@ -1009,7 +1259,7 @@ Texture2D* Context::cached_texture2D(const String& _key) {
   return nullptr;
 }
 
-Texture3D* Context::cached_texture3D(const String& _key) {
+Texture3D* Context::cached_texture3D(Atom _key) {
   Concurrency::ScopeLock lock{m_mutex};
   if (auto find{m_cached_textures3D.find(_key)}) {
     auto result{*find};
@@ -1019,7 +1269,7 @@ Texture3D* Context::cached_texture3D(const String& _key) {
   return nullptr;
 }
 
-TextureCM* Context::cached_textureCM(const String& _key) {
+TextureCM* Context::cached_textureCM(Atom _key) {
   Concurrency::ScopeLock lock{m_mutex};
   if (auto find{m_cached_texturesCM.find(_key)}) {
     auto result{*find};
@@ -1029,38 +1279,93 @@ TextureCM* Context::cached_textureCM(const String& _key) {
   return nullptr;
 }
 
-void Context::cache_buffer(Buffer* _buffer, const String& _key) {
+void Context::cache_buffer(Buffer* _buffer, Atom _key) {
   Concurrency::ScopeLock lock{m_mutex};
   m_cached_buffers.insert(_key, _buffer);
 }
 
-void Context::cache_target(Target* _target, const String& _key) {
+void Context::cache_target(Target* _target, Atom _key) {
   Concurrency::ScopeLock lock{m_mutex};
   m_cached_targets.insert(_key, _target);
 }
 
-void Context::cache_texture(Texture1D* _texture, const String& _key) {
+void Context::cache_texture(Texture1D* _texture, Atom _key) {
   Concurrency::ScopeLock lock{m_mutex};
   m_cached_textures1D.insert(_key, _texture);
 }
 
-void Context::cache_texture(Texture2D* _texture, const String& _key) {
+void Context::cache_texture(Texture2D* _texture, Atom _key) {
   Concurrency::ScopeLock lock{m_mutex};
   m_cached_textures2D.insert(_key, _texture);
 }
 
-void Context::cache_texture(Texture3D* _texture, const String& _key) {
+void Context::cache_texture(Texture3D* _texture, Atom _key) {
   Concurrency::ScopeLock lock{m_mutex};
   m_cached_textures3D.insert(_key, _texture);
 }
 
-void Context::cache_texture(TextureCM* _texture, const String& _key) {
+void Context::cache_texture(TextureCM* _texture, Atom _key) {
   Concurrency::ScopeLock lock{m_mutex};
   m_cached_texturesCM.insert(_key, _texture);
 }
 
-Technique* Context::find_technique_by_name(const char* _name) {
-  return m_techniques.find(_name);
+Buffer* Context::cached_buffer(StringView _key) {
+  const auto atom{Atom::find(_key)};
+  return atom ? cached_buffer(*atom) : nullptr;
+}
+
+Target* Context::cached_target(StringView _key) {
+  const auto atom{Atom::find(_key)};
+  return atom ? cached_target(*atom) : nullptr;
+}
+
+Texture1D* Context::cached_texture1D(StringView _key) {
+  const auto atom{Atom::find(_key)};
+  return atom ? cached_texture1D(*atom) : nullptr;
+}
+
+Texture2D* Context::cached_texture2D(StringView _key) {
+  const auto atom{Atom::find(_key)};
+  return atom ? cached_texture2D(*atom) : nullptr;
+}
+
+Texture3D* Context::cached_texture3D(StringView _key) {
+  const auto atom{Atom::find(_key)};
+  return atom ? cached_texture3D(*atom) : nullptr;
+}
+
+TextureCM* Context::cached_textureCM(StringView _key) {
+  const auto atom{Atom::find(_key)};
+  return atom ? cached_textureCM(*atom) : nullptr;
+}
+
+void Context::cache_buffer(Buffer* _buffer, StringView _key) {
+  cache_buffer(_buffer, Atom{_key});
+}
+
+void Context::cache_target(Target* _target, StringView _key) {
+  cache_target(_target, Atom{_key});
+}
+
+void Context::cache_texture(Texture1D* _texture, StringView _key) {
+  cache_texture(_texture, Atom{_key});
+}
+
+void Context::cache_texture(Texture2D* _texture, StringView _key) {
+  cache_texture(_texture, Atom{_key});
+}
+
+void Context::cache_texture(Texture3D* _texture, StringView _key) {
+  cache_texture(_texture, Atom{_key});
+}
+
+void Context::cache_texture(TextureCM* _texture, StringView _key) {
+  cache_texture(_texture, Atom{_key});
+}
+
+Technique* Context::find_technique_by_name(StringView _name) {
+  const auto atom{Atom::find(_name)};
+  return atom ? m_techniques.find(*atom) : nullptr;
 }
 
 Arena* Context::arena(const Buffer::Format& _format) {
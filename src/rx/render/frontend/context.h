@@ -4,12 +4,18 @@
 #include "rx/core/vector.h"
 #include "rx/core/string.h"
 #include "rx/core/static_pool.h"
+#include "rx/core/flat_map.h"
+#include "rx/core/atom.h"
 #include "rx/core/map.h"
+#include "rx/core/ptr.h"
+
+#include "rx/core/memory/frame_allocator.h"
 
 #include "rx/core/concurrency/mutex.h"
 #include "rx/core/concurrency/atomic.h"
 
 #include "rx/render/frontend/command.h"
+#include "rx/render/frontend/command_sorter.h"
 #include "rx/render/frontend/resource.h"
 #include "rx/render/frontend/arena.h"
 #include "rx/render/frontend/timer.h"
@@ -186,27 +192,61 @@ struct Context {
 
   void resize(const Math::Vec2z& _resolution);
 
+  // Write the commands of the next processed frame to |_file_name|, see
+  // |Capture| for the format.
+  void capture(const String& _file_name);
+
+  // Commands recorded by the calling thread from here on are handed to the
+  // backend after those recorded under a smaller |_key| on any thread, and
+  // before those under a larger one. Use it for a pass or submission index
+  // when recording from more than one thread. Commands recorded under the
+  // same key stay in the order they were recorded in on each thread, and
+  // the threads follow each other in the order they first recorded into the
+  // context. The key of a thread starts at zero and stays until it's set
+  // again, across frames too.
+  void set_submission_key(Uint64 _key);
+
   bool process();
   bool swap();
 
-  Buffer* cached_buffer(const String& _key);
-  Target* cached_target(const String& _key);
-  Texture1D* cached_texture1D(const String& _key);
-  Texture2D* cached_texture2D(const String& _key);
-  Texture3D* cached_texture3D(const String& _key);
-  TextureCM* cached_textureCM(const String& _key);
+  // Caches are keyed by |Atom|, looking up by name only finds the atom first.
+  Buffer* cached_buffer(Atom _key);
+  Target* cached_target(Atom _key);
+  Texture1D* cached_texture1D(Atom _key);
+  Texture2D* cached_texture2D(Atom _key);
+  Texture3D* cached_texture3D(Atom _key);
+  TextureCM* cached_textureCM(Atom _key);
+
+  Buffer* cached_buffer(StringView _key);
+  Target* cached_target(StringView _key);
+  Texture1D* cached_texture1D(StringView _key);
+  Texture2D* cached_texture2D(StringView _key);
+  Texture3D* cached_texture3D(StringView _key);
+  TextureCM* cached_textureCM(StringView _key);
 
   // Pin a given resource to the render cache with the given |_key| allowing
   // it to be reused by checking the cache with the above functions.
-  void cache_buffer(Buffer* _buffer, const String& _key);
-  void cache_target(Target* _target, const String& _key);
-  void cache_texture(Texture1D* _texture, const String& _key);
-  void cache_texture(Texture2D* _texture, const String& _key);
-  void cache_texture(Texture3D* _texture, const String& _key);
-  void cache_texture(TextureCM* _texture, const String& _key);
+  void cache_buffer(Buffer* _buffer, Atom _key);
+  void cache_target(Target* _target, Atom _key);
+  void cache_texture(Texture1D* _texture, Atom _key);
+  void cache_texture(Texture2D* _texture, Atom _key);
+  void cache_texture(Texture3D* _texture, Atom _key);
+  void cache_texture(TextureCM* _texture, Atom _key);
+
+  void cache_buffer(Buffer* _buffer, StringView _key);
+  void cache_target(Target* _target, StringView _key);
+  void cache_texture(Texture1D* _texture, StringView _key);
+  void cache_texture(Texture2D* _texture, StringView _key);
+  void cache_texture(Texture3D* _texture, StringView _key);
+  void cache_texture(TextureCM* _texture, StringView _key);
 
   constexpr Memory::Allocator& allocator() const;
 
+  // Allocator for data which only has to live until the frame is processed.
+  // Anything allocated stays valid until |swap| has been called twice, it never
+  // has to be deallocated.
+  Memory::Allocator& frame_allocator();
+
   struct Statistics {
     Size total;
     Size used;
@@ -233,22 +273,92 @@ struct Context {
   Size points() const;
   Size commands() const;
   Size footprint() const;
+
+  // Statistics of the draw sorting stage, see |CommandSorter|.
+  Size sorted_draws() const;
+  Size removed_program_changes() const;
+  Size removed_state_changes() const;
   Uint64 frame() const;
 
   Target* swapchain() const;
 
-  Technique* find_technique_by_name(const char* _name);
+  Technique* find_technique_by_name(StringView _name);
 
   Arena* arena(const Buffer::Format& _format);
 
+  // Command memory used and reserved by all command lists in the last frame
+  // and the high-water mark of command memory used by them.
+  Size command_memory_used() const;
+  Size command_memory_size() const;
+  Size command_memory_peak() const;
+
   const FrameTimer& timer() const &;
-  const CommandBuffer& get_command_buffer() const &;
   const DeviceInfo& get_device_info() const &;
 
 private:
   friend struct Target;
   friend struct Resource;
 
+  // Every thread that records commands gets its own command list so that
+  // recording never has to serialize on |m_mutex|. The list owns the command
+  // memory, the edit lists and the statistics for that thread. The lists are
+  // merged by |process| by the submission key of their commands.
+  struct CommandList {
+    CommandList(Memory::Allocator& _allocator, const void* _thread);
+
+    void reset();
+
+    // Identifies the thread which owns this list.
+    const void* thread;
+
+    // A run of |commands| recorded under the same submission key, starting
+    // at |offset|. The run ends where the next one starts.
+    struct Span {
+      Uint64 key;
+      Size offset;
+    };
+
+    // The submission key commands are recorded under.
+    Uint64 key;
+
+    Vector<Byte*> commands;
+    Vector<Span> spans;
+    CommandBuffer command_buffer;
+
+    // Resources that were edited are recorded into the following vectors
+    // so that the edits can be handled at the start of the frame.
+    Vector<Buffer*> edit_buffers;
+    Vector<Texture1D*> edit_textures1D;
+    Vector<Texture2D*> edit_textures2D;
+    Vector<Texture3D*> edit_textures3D;
+    Vector<TextureCM*> edit_texturesCM;
+
+    Size draw_calls;
+    Size instanced_draw_calls;
+    Size clear_calls;
+    Size blit_calls;
+    Size vertices;
+    Size triangles;
+    Size lines;
+    Size points;
+    Size footprint;
+  };
+
+  // Find or create the command list for the calling thread.
+  CommandList& command_list();
+  CommandList& create_command_list(const void* _thread);
+
+  // Allocate a command of |_type| with |_size| bytes of payload in |list_|
+  // and record it.
+  Byte* record_command(CommandList& list_, Size _size, CommandType _type,
+    const CommandHeader::Info& _info);
+
+  // Merge all command lists into |m_commands| by submission key.
+  void merge_command_lists();
+
+  // Write |m_commands| to |m_capture_file| and disarm the capture.
+  void write_capture();
+
   // Needed by target to release depth/stencil textures without holding
   // the non-recursive mutex |m_mutex|.
   void destroy_texture_unlocked(const CommandHeader::Info& _info,
@@ -256,13 +366,15 @@ private:
 
   // Remove a given object |_object| from the cache |_cache|.
   template<typename T>
-  void remove_from_cache(Map<String, T*>& cache_, T* _object);
+  void remove_from_cache(FlatMap<Atom, T*>& cache_, T* _object);
 
   mutable Concurrency::Mutex m_mutex;
 
   Memory::Allocator& m_allocator               RX_HINT_GUARDED_BY(m_mutex);
   Backend::Context* m_backend                  RX_HINT_GUARDED_BY(m_mutex);
 
+  Memory::FrameAllocator m_frame_allocator;
+
   // size of resources as reported by the backend
   Backend::AllocationInfo m_allocation_info;
 
@@ -286,35 +398,46 @@ private:
   Vector<TextureCM*> m_destroy_texturesCM      RX_HINT_GUARDED_BY(m_mutex);
   Vector<Downloader*> m_destroy_downloaders    RX_HINT_GUARDED_BY(m_mutex);
 
-  // Resources that were edited are recorded into the following vectors
-  // so that the edits can be handled at the start of the frame.
-  Vector<Buffer*> m_edit_buffers               RX_HINT_GUARDED_BY(m_mutex);
-  Vector<Texture1D*> m_edit_textures1D         RX_HINT_GUARDED_BY(m_mutex);
-  Vector<Texture2D*> m_edit_textures2D         RX_HINT_GUARDED_BY(m_mutex);
-  Vector<Texture3D*> m_edit_textures3D         RX_HINT_GUARDED_BY(m_mutex);
-  Vector<TextureCM*> m_edit_texturesCM         RX_HINT_GUARDED_BY(m_mutex);
-
   Target* m_swapchain_target                   RX_HINT_GUARDED_BY(m_mutex);
   Texture2D* m_swapchain_texture               RX_HINT_GUARDED_BY(m_mutex);
 
+  // Unique identifier of this context, used to validate the command list
+  // cached in thread local storage by |command_list|.
+  Uint64 m_id;
+
+  Vector<Ptr<CommandList>> m_command_lists     RX_HINT_GUARDED_BY(m_mutex);
+
+  // The spans of all command lists in the order they're merged in, kept
+  // around to not allocate them every frame.
+  struct MergeSpan {
+    Uint64 key;
+    Byte* const* commands;
+    Size count;
+  };
+  Vector<MergeSpan> m_merge_spans              RX_HINT_GUARDED_BY(m_mutex);
+
+  // The merged command lists which are handed to the backend.
   Vector<Byte*> m_commands                     RX_HINT_GUARDED_BY(m_mutex);
-  CommandBuffer m_command_buffer               RX_HINT_GUARDED_BY(m_mutex);
+  CommandSorter m_command_sorter               RX_HINT_GUARDED_BY(m_mutex);
 
-  Map<String, Buffer*> m_cached_buffers        RX_HINT_GUARDED_BY(m_mutex);
-  Map<String, Target*> m_cached_targets        RX_HINT_GUARDED_BY(m_mutex);
-  Map<String, Texture1D*> m_cached_textures1D  RX_HINT_GUARDED_BY(m_mutex);
-  Map<String, Texture2D*> m_cached_textures2D  RX_HINT_GUARDED_BY(m_mutex);
-  Map<String, Texture3D*> m_cached_textures3D  RX_HINT_GUARDED_BY(m_mutex);
-  Map<String, TextureCM*> m_cached_texturesCM  RX_HINT_GUARDED_BY(m_mutex);
+  // The file to capture the next processed frame to, empty when not armed.
+  String m_capture_file                        RX_HINT_GUARDED_BY(m_mutex);
+
+  FlatMap<Atom, Buffer*> m_cached_buffers       RX_HINT_GUARDED_BY(m_mutex);
+  FlatMap<Atom, Target*> m_cached_targets       RX_HINT_GUARDED_BY(m_mutex);
+  FlatMap<Atom, Texture1D*> m_cached_textures1D RX_HINT_GUARDED_BY(m_mutex);
+  FlatMap<Atom, Texture2D*> m_cached_textures2D RX_HINT_GUARDED_BY(m_mutex);
+  FlatMap<Atom, Texture3D*> m_cached_textures3D RX_HINT_GUARDED_BY(m_mutex);
+  FlatMap<Atom, TextureCM*> m_cached_texturesCM RX_HINT_GUARDED_BY(m_mutex);
 
   // NOTE(dweiler): This has to come before techniques and modules. Everything
   // above must stay alive for the destruction of m_techniques and m_modules
   // to work.
   DeferredFunction<void()> m_deferred_process;
 
-  Map<String, Technique> m_techniques          RX_HINT_GUARDED_BY(m_mutex);
-  Map<String, Module> m_modules                RX_HINT_GUARDED_BY(m_mutex);
-  Map<Buffer::Format, Arena> m_arenas          RX_HINT_GUARDED_BY(m_mutex);
+  FlatMap<Atom, Technique> m_techniques RX_HINT_GUARDED_BY(m_mutex);
+  Map<String, Module> m_modules         RX_HINT_GUARDED_BY(m_mutex);
+  Map<Buffer::Format, Arena> m_arenas   RX_HINT_GUARDED_BY(m_mutex);
 
   Concurrency::Atomic<Size> m_draw_calls[2];
   Concurrency::Atomic<Size> m_instanced_draw_calls[2];
@@ -326,6 +449,12 @@ private:
   Concurrency::Atomic<Size> m_points[2];
   Concurrency::Atomic<Size> m_commands_recorded[2];
   Concurrency::Atomic<Size> m_footprint[2];
+  Concurrency::Atomic<Size> m_command_memory_used;
+  Concurrency::Atomic<Size> m_command_memory_size;
+  Concurrency::Atomic<Size> m_command_memory_peak;
+  Concurrency::Atomic<Size> m_sorted_draws;
+  Concurrency::Atomic<Size> m_removed_program_changes;
+  Concurrency::Atomic<Size> m_removed_state_changes;
 
   Uint64 m_frame;
 
@@ -343,8 +472,8 @@ inline constexpr Context::DeviceInfo::DeviceInfo(Memory::Allocator& _allocator)
 }
 
 template<typename T>
-inline void Context::remove_from_cache(Map<String, T*>& cache_, T* _object) {
-  cache_.each_pair([&](const String& _key, T* _value) {
+inline void Context::remove_from_cache(FlatMap<Atom, T*>& cache_, T* _object) {
+  cache_.each_pair([&](Atom _key, T* _value) {
     if (_value != _object) {
       return true;
     }
@@ -357,6 +486,10 @@ RX_HINT_FORCE_INLINE constexpr Memory::Allocator& Context::allocator() const {
   return m_allocator;
 }
 
+inline Memory::Allocator& Context::frame_allocator() {
+  return m_frame_allocator;
+}
+
 inline Size Context::draw_calls() const {
   return m_draw_calls[1].load();
 }
@@ -397,6 +530,18 @@ inline Size Context::footprint() const {
   return m_footprint[1].load();
 }
 
+inline Size Context::sorted_draws() const {
+  return m_sorted_draws.load();
+}
+
+inline Size Context::removed_program_changes() const {
+  return m_removed_program_changes.load();
+}
+
+inline Size Context::removed_state_changes() const {
+  return m_removed_state_changes.load();
+}
+
 inline Uint64 Context::frame() const {
   return m_frame;
 }
@@ -409,8 +554,16 @@ inline const FrameTimer& Context::timer() const & {
   return m_timer;
 }
 
-inline const CommandBuffer& Context::get_command_buffer() const & {
-  return m_command_buffer;
+inline Size Context::command_memory_used() const {
+  return m_command_memory_used.load();
+}
+
+inline Size Context::command_memory_size() const {
+  return m_command_memory_size.load();
+}
+
+inline Size Context::command_memory_peak() const {
+  return m_command_memory_peak.load();
 }
 
 inline const Context::DeviceInfo& Context::get_device_info() const & {
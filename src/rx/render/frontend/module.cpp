@@ -1,4 +1,4 @@
-#include "rx/core/filesystem/file.h"
+#include "rx/core/filesystem/mapped_file.h"
 #include "rx/core/json.h"
 
 #include "rx/render/frontend/module.h"
@@ -40,7 +40,7 @@ bool Module::load(Stream* _stream) {
 }
 
 bool Module::load(const String& _file_name) {
-  if (Filesystem::File file{_file_name, "rb"}) {
+  if (Filesystem::MappedFile file{_file_name}) {
     return load(&file);
   }
   return false;
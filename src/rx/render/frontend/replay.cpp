@@ -0,0 +1,761 @@
+#include "rx/render/frontend/replay.h"
+#include "rx/render/frontend/capture.h"
+#include "rx/render/frontend/context.h"
+#include "rx/render/frontend/buffer.h"
+#include "rx/render/frontend/target.h"
+#include "rx/render/frontend/program.h"
+#include "rx/render/frontend/texture.h"
+
+#include "rx/render/backend/context.h"
+
+#include "rx/core/serialize/decoder.h"
+
+namespace Rx::Render::Frontend {
+
+// Size of the pages used to hold the commands of the capture.
+static constexpr const Size k_page_size{256 * 1024};
+
+Replay::Replay(Context* _frontend, Backend::Context* _backend)
+  : m_frontend{_frontend}
+  , m_backend{_backend}
+  , m_resources{m_frontend->allocator()}
+  , m_owned{m_frontend->allocator()}
+  , m_command_buffer{m_frontend->allocator(), k_page_size}
+  , m_commands{m_frontend->allocator()}
+  , m_tags{m_frontend->allocator()}
+{
+}
+
+Replay::~Replay() {
+  release();
+}
+
+bool Replay::load(Stream* _stream) {
+  release();
+
+  serialize::Decoder decoder{m_frontend->allocator(), _stream};
+
+  Uint64 version{0};
+  if (!decoder.read_uint(version) || version != Capture::k_version) {
+    return false;
+  }
+
+  Uint64 dimensions[2];
+  if (!decoder.read_uint(dimensions[0]) || !decoder.read_uint(dimensions[1])) {
+    return false;
+  }
+
+  m_dimensions = {dimensions[0], dimensions[1]};
+  m_frontend->resize(m_dimensions);
+
+  Uint64 n_resources{0};
+  if (!decoder.read_uint(n_resources)) {
+    return false;
+  }
+
+  for (Uint64 i{0}; i < n_resources; i++) {
+    if (!read_resource(decoder)) {
+      return false;
+    }
+  }
+
+  Uint64 n_commands{0};
+  if (!decoder.read_uint(n_commands)) {
+    return false;
+  }
+
+  // Profile commands point into |m_tags| so it must never grow.
+  if (!m_tags.reserve(n_commands)) {
+    return false;
+  }
+
+  for (Uint64 i{0}; i < n_commands; i++) {
+    if (!read_command(decoder)) {
+      return false;
+    }
+  }
+
+  // Construct all the resources on the backend.
+  m_frontend->process();
+
+  return true;
+}
+
+void Replay::process() {
+  m_backend->process(m_commands);
+}
+
+bool Replay::read_resource(serialize::Decoder& decoder_) {
+  Uint64 type{0};
+  if (!decoder_.read_uint(type)) {
+    return false;
+  }
+
+  Resource* resource{nullptr};
+  switch (static_cast<Resource::Type>(type)) {
+  case Resource::Type::k_buffer:
+    resource = read_buffer(decoder_);
+    break;
+  case Resource::Type::k_target:
+    resource = read_target(decoder_);
+    break;
+  case Resource::Type::k_program:
+    resource = read_program(decoder_);
+    break;
+  case Resource::Type::k_texture1D:
+    [[fallthrough]];
+  case Resource::Type::k_texture2D:
+    [[fallthrough]];
+  case Resource::Type::k_texture3D:
+    [[fallthrough]];
+  case Resource::Type::k_textureCM:
+    resource = read_texture(decoder_, type);
+    break;
+  default:
+    break;
+  }
+
+  return resource && m_resources.push_back(resource);
+}
+
+Resource* Replay::read_buffer(serialize::Decoder& decoder_) {
+  Uint64 type{0};
+  Uint64 element_type{0};
+  Uint64 vertex_stride{0};
+  Uint64 instance_stride{0};
+  if (!decoder_.read_uint(type)
+    || !decoder_.read_uint(element_type)
+    || !decoder_.read_uint(vertex_stride)
+    || !decoder_.read_uint(instance_stride))
+  {
+    return nullptr;
+  }
+
+  Buffer::Format format;
+  format.record_type(static_cast<Buffer::Type>(type));
+  format.record_element_type(static_cast<Buffer::ElementType>(element_type));
+  format.record_vertex_stride(vertex_stride);
+
+  for (Size i{0}; i < 2; i++) {
+    Uint64 n_attributes{0};
+    if (!decoder_.read_uint(n_attributes)) {
+      return nullptr;
+    }
+    for (Uint64 j{0}; j < n_attributes; j++) {
+      Uint64 attribute_type{0};
+      Uint64 offset{0};
+      if (!decoder_.read_uint(attribute_type) || !decoder_.read_uint(offset)) {
+        return nullptr;
+      }
+      const Buffer::Attribute attribute{
+        static_cast<Buffer::Attribute::Type>(attribute_type), offset};
+      if (i == 0) {
+        format.record_vertex_attribute(attribute);
+      } else {
+        format.record_instance_attribute(attribute);
+      }
+    }
+    // Instanced formats are the ones with instance attributes.
+    if (i == 1 && n_attributes) {
+      format.record_instance_stride(instance_stride);
+    }
+  }
+
+  format.finalize();
+
+  auto buffer{m_frontend->create_buffer(RX_RENDER_TAG("replay"))};
+  m_owned.push_back(buffer);
+  buffer->record_format(format);
+
+  // Read the vertices, elements and instances straight into the buffer.
+  for (Size i{0}; i < 3; i++) {
+    Uint64 size{0};
+    if (!decoder_.read_uint(size)) {
+      return nullptr;
+    }
+    // Empty stores cannot be mapped but are still written as empty arrays.
+    Byte* data{nullptr};
+    if (size) {
+      switch (i) {
+      case 0:
+        data = buffer->map_vertices(size);
+        break;
+      case 1:
+        data = buffer->map_elements(size);
+        break;
+      case 2:
+        data = buffer->map_instances(size);
+        break;
+      }
+    }
+    if (!decoder_.read_byte_array(data, size)) {
+      return nullptr;
+    }
+  }
+
+  m_frontend->initialize_buffer(RX_RENDER_TAG("replay"), buffer);
+
+  return buffer;
+}
+
+Resource* Replay::read_target(serialize::Decoder& decoder_) {
+  bool swapchain{false};
+  if (!decoder_.read_bool(swapchain)) {
+    return nullptr;
+  }
+
+  if (swapchain) {
+    return m_frontend->swapchain();
+  }
+
+  auto target{m_frontend->create_target(RX_RENDER_TAG("replay"))};
+  m_owned.push_back(target);
+
+  Uint64 depth_stencil_kind{0};
+  Texture2D* depth_stencil{nullptr};
+  if (!decoder_.read_uint(depth_stencil_kind)
+    || !read_reference(decoder_, depth_stencil))
+  {
+    return nullptr;
+  }
+
+  switch (depth_stencil_kind) {
+  case 1:
+    target->attach_depth(depth_stencil);
+    break;
+  case 2:
+    target->attach_stencil(depth_stencil);
+    break;
+  case 3:
+    target->attach_depth_stencil(depth_stencil);
+    break;
+  }
+
+  Uint64 n_attachments{0};
+  if (!decoder_.read_uint(n_attachments)) {
+    return nullptr;
+  }
+
+  for (Uint64 i{0}; i < n_attachments; i++) {
+    Uint64 kind{0};
+    Uint64 level{0};
+    if (!decoder_.read_uint(kind) || !decoder_.read_uint(level)) {
+      return nullptr;
+    }
+
+    switch (static_cast<Target::Attachment::Type>(kind)) {
+    case Target::Attachment::Type::k_texture2D:
+      {
+        Texture2D* texture{nullptr};
+        if (!read_reference(decoder_, texture) || !texture) {
+          return nullptr;
+        }
+        target->attach_texture(texture, level);
+      }
+      break;
+    case Target::Attachment::Type::k_textureCM:
+      {
+        TextureCM* texture{nullptr};
+        Uint64 face{0};
+        if (!read_reference(decoder_, texture) || !texture
+          || !decoder_.read_uint(face))
+        {
+          return nullptr;
+        }
+        target->attach_texture(texture, static_cast<TextureCM::Face>(face), level);
+      }
+      break;
+    }
+  }
+
+  m_frontend->initialize_target(RX_RENDER_TAG("replay"), target);
+
+  return target;
+}
+
+Resource* Replay::read_program(serialize::Decoder& decoder_) {
+  auto program{m_frontend->create_program(RX_RENDER_TAG("replay"))};
+  m_owned.push_back(program);
+
+  auto read_inouts = [&](Map<String, Shader::InOut>& inouts_) {
+    Uint64 n_inouts{0};
+    if (!decoder_.read_uint(n_inouts)) {
+      return false;
+    }
+    for (Uint64 i{0}; i < n_inouts; i++) {
+      String name;
+      Uint64 index{0};
+      Uint64 kind{0};
+      if (!read_string(decoder_, name)
+        || !decoder_.read_uint(index)
+        || !decoder_.read_uint(kind))
+      {
+        return false;
+      }
+      inouts_.insert(name, {index, static_cast<Shader::InOutType>(kind)});
+    }
+    return true;
+  };
+
+  Uint64 n_shaders{0};
+  if (!decoder_.read_uint(n_shaders)) {
+    return nullptr;
+  }
+
+  for (Uint64 i{0}; i < n_shaders; i++) {
+    Uint64 kind{0};
+    Shader shader;
+    if (!decoder_.read_uint(kind)
+      || !read_string(decoder_, shader.source)
+      || !read_inouts(shader.inputs)
+      || !read_inouts(shader.outputs))
+    {
+      return nullptr;
+    }
+    shader.kind = static_cast<Shader::Type>(kind);
+    program->add_shader(Utility::move(shader));
+  }
+
+  Uint64 n_uniforms{0};
+  if (!decoder_.read_uint(n_uniforms)) {
+    return nullptr;
+  }
+
+  for (Uint64 i{0}; i < n_uniforms; i++) {
+    String name;
+    Uint64 type{0};
+    bool is_padding{false};
+    if (!read_string(decoder_, name)
+      || !decoder_.read_uint(type)
+      || !decoder_.read_bool(is_padding))
+    {
+      return nullptr;
+    }
+    program->add_uniform(name, static_cast<Uniform::Type>(type), is_padding);
+  }
+
+  m_frontend->initialize_program(RX_RENDER_TAG("replay"), program);
+
+  return program;
+}
+
+Resource* Replay::read_texture(serialize::Decoder& decoder_, Uint64 _type) {
+  bool swapchain{false};
+  if (!decoder_.read_bool(swapchain)) {
+    return nullptr;
+  }
+
+  if (swapchain) {
+    return m_frontend->swapchain()->attachments()[0].as_texture2D.texture;
+  }
+
+  Uint64 format{0};
+  Uint64 type{0};
+  Uint64 levels{0};
+  Texture::FilterOptions filter;
+  Math::Vec4f border;
+  if (!decoder_.read_uint(format)
+    || !decoder_.read_uint(type)
+    || !decoder_.read_uint(levels)
+    || !decoder_.read_bool(filter.bilinear)
+    || !decoder_.read_bool(filter.trilinear)
+    || !decoder_.read_bool(filter.mipmaps)
+    || !decoder_.read_float_array(border.data(), 4))
+  {
+    return nullptr;
+  }
+
+  const auto resource_type{static_cast<Resource::Type>(_type)};
+
+  Size components{0};
+  Size wraps{0};
+  switch (resource_type) {
+  case Resource::Type::k_texture1D:
+    components = 1;
+    wraps = 1;
+    break;
+  case Resource::Type::k_texture2D:
+    components = 2;
+    wraps = 2;
+    break;
+  case Resource::Type::k_texture3D:
+    components = 3;
+    wraps = 3;
+    break;
+  case Resource::Type::k_textureCM:
+    components = 2;
+    wraps = 3;
+    break;
+  default:
+    return nullptr;
+  }
+
+  Uint64 dimensions[3]{0, 0, 0};
+  for (Size i{0}; i < components; i++) {
+    if (!decoder_.read_uint(dimensions[i])) {
+      return nullptr;
+    }
+  }
+
+  Texture::WrapType wrap[3]{};
+  for (Size i{0}; i < wraps; i++) {
+    Uint64 value{0};
+    if (!decoder_.read_uint(value)) {
+      return nullptr;
+    }
+    wrap[i] = static_cast<Texture::WrapType>(value);
+  }
+
+  // Everything but the dimensions and wrap is recorded the same way.
+  auto record = [&](Texture* texture_) {
+    m_owned.push_back(texture_);
+    texture_->record_format(static_cast<Texture::DataFormat>(format));
+    texture_->record_type(static_cast<Texture::Type>(type));
+    texture_->record_levels(levels);
+    texture_->record_filter(filter);
+  };
+
+  Texture* texture{nullptr};
+  Byte* data{nullptr};
+  switch (resource_type) {
+  case Resource::Type::k_texture1D:
+    {
+      auto texture1D{m_frontend->create_texture1D(RX_RENDER_TAG("replay"))};
+      record(texture1D);
+      texture1D->record_dimensions(dimensions[0]);
+      texture1D->record_wrap(wrap[0]);
+      texture1D->record_border(border);
+      if (texture1D->type() != Texture::Type::ATTACHMENT) {
+        data = texture1D->map(0);
+      }
+      texture = texture1D;
+    }
+    break;
+  case Resource::Type::k_texture2D:
+    {
+      auto texture2D{m_frontend->create_texture2D(RX_RENDER_TAG("replay"))};
+      record(texture2D);
+      texture2D->record_dimensions({dimensions[0], dimensions[1]});
+      texture2D->record_wrap({wrap[0], wrap[1]});
+      texture2D->record_border(border);
+      if (texture2D->type() != Texture::Type::ATTACHMENT) {
+        data = texture2D->map(0);
+      }
+      texture = texture2D;
+    }
+    break;
+  case Resource::Type::k_texture3D:
+    {
+      auto texture3D{m_frontend->create_texture3D(RX_RENDER_TAG("replay"))};
+      record(texture3D);
+      texture3D->record_dimensions({dimensions[0], dimensions[1], dimensions[2]});
+      texture3D->record_wrap({wrap[0], wrap[1], wrap[2]});
+      texture3D->record_border(border);
+      if (texture3D->type() != Texture::Type::ATTACHMENT) {
+        data = texture3D->map(0);
+      }
+      texture = texture3D;
+    }
+    break;
+  case Resource::Type::k_textureCM:
+    {
+      auto textureCM{m_frontend->create_textureCM(RX_RENDER_TAG("replay"))};
+      record(textureCM);
+      textureCM->record_dimensions({dimensions[0], dimensions[1]});
+      textureCM->record_wrap({wrap[0], wrap[1], wrap[2]});
+      textureCM->record_border(border);
+      if (textureCM->type() != Texture::Type::ATTACHMENT) {
+        data = textureCM->map(0, TextureCM::Face::k_right);
+      }
+      texture = textureCM;
+    }
+    break;
+  default:
+    return nullptr;
+  }
+
+  // The levels are stored one after the other from the first, read them all
+  // straight into the texture.
+  Uint64 size{0};
+  if (!decoder_.read_uint(size) || size != texture->data().size()) {
+    return nullptr;
+  }
+
+  if (!decoder_.read_byte_array(data, size)) {
+    return nullptr;
+  }
+
+  switch (resource_type) {
+  case Resource::Type::k_texture1D:
+    m_frontend->initialize_texture(RX_RENDER_TAG("replay"), static_cast<Texture1D*>(texture));
+    break;
+  case Resource::Type::k_texture2D:
+    m_frontend->initialize_texture(RX_RENDER_TAG("replay"), static_cast<Texture2D*>(texture));
+    break;
+  case Resource::Type::k_texture3D:
+    m_frontend->initialize_texture(RX_RENDER_TAG("replay"), static_cast<Texture3D*>(texture));
+    break;
+  case Resource::Type::k_textureCM:
+    m_frontend->initialize_texture(RX_RENDER_TAG("replay"), static_cast<TextureCM*>(texture));
+    break;
+  default:
+    break;
+  }
+
+  return texture;
+}
+
+bool Replay::read_command(serialize::Decoder& decoder_) {
+  Uint64 type{0};
+  if (!decoder_.read_uint(type)) {
+    return false;
+  }
+
+  auto allocate = [&](Size _size) {
+    auto command_base{m_command_buffer.allocate(_size,
+      static_cast<CommandType>(type), RX_RENDER_TAG("replay"))};
+    m_commands.push_back(command_base);
+    return command_base + sizeof(CommandHeader);
+  };
+
+  switch (static_cast<CommandType>(type)) {
+  case CommandType::CLEAR:
+    {
+      auto command{reinterpret_cast<ClearCommand*>(allocate(sizeof(ClearCommand)))};
+      command->draw_buffers = {};
+      Uint64 clear_colors{0};
+      Uint64 stencil_value{0};
+      if (!read_state(decoder_, command->render_state)
+        || !read_reference(decoder_, command->render_target)
+        || !read_buffers(decoder_, command->draw_buffers)
+        || !decoder_.read_bool(command->clear_depth)
+        || !decoder_.read_bool(command->clear_stencil)
+        || !decoder_.read_uint(clear_colors)
+        || !decoder_.read_uint(stencil_value)
+        || !decoder_.read_float(command->depth_value)
+        || !decoder_.read_float_array(command->color_values[0].data(),
+          4 * Buffers::k_max_buffers))
+      {
+        return false;
+      }
+      command->clear_colors = static_cast<Uint32>(clear_colors);
+      command->stencil_value = static_cast<Uint8>(stencil_value);
+      return true;
+    }
+  case CommandType::DRAW:
+    {
+      // The size of the uniforms comes last so the command is read before
+      // it's allocated.
+      DrawCommand draw;
+      Uint64 primitive_type{0};
+      Uint64 uniforms_size{0};
+      if (!read_state(decoder_, draw.render_state)
+        || !read_reference(decoder_, draw.render_target)
+        || !read_buffers(decoder_, draw.draw_buffers)
+        || !read_textures(decoder_, draw.draw_textures)
+        || !read_reference(decoder_, draw.render_buffer)
+        || !read_reference(decoder_, draw.render_program)
+        || !decoder_.read_uint(draw.count)
+        || !decoder_.read_uint(draw.offset)
+        || !decoder_.read_uint(draw.instances)
+        || !decoder_.read_uint(draw.base_vertex)
+        || !decoder_.read_uint(draw.base_instance)
+        || !decoder_.read_uint(primitive_type)
+        || !decoder_.read_uint(draw.dirty_uniforms_bitset)
+        || !decoder_.read_uint(uniforms_size)
+        || !draw.render_target
+        || !draw.render_program)
+      {
+        return false;
+      }
+      draw.type = static_cast<PrimitiveType>(primitive_type);
+
+      auto command{reinterpret_cast<DrawCommand*>(
+        allocate(sizeof(DrawCommand) + uniforms_size))};
+      *command = draw;
+      return decoder_.read_byte_array(command->uniforms(), uniforms_size);
+    }
+  case CommandType::BLIT:
+    {
+      auto command{reinterpret_cast<BlitCommand*>(allocate(sizeof(BlitCommand)))};
+      return read_state(decoder_, command->render_state)
+        && read_reference(decoder_, command->src_target)
+        && decoder_.read_uint(command->src_attachment)
+        && read_reference(decoder_, command->dst_target)
+        && decoder_.read_uint(command->dst_attachment)
+        && command->src_target
+        && command->dst_target;
+    }
+  case CommandType::PROFILE:
+    {
+      bool has_tag{false};
+      Uint64 length{0};
+      if (!decoder_.read_bool(has_tag) || !decoder_.read_uint(length)) {
+        return false;
+      }
+
+      String tag{m_frontend->allocator()};
+      if (!tag.resize(length)
+        || !decoder_.read_byte_array(reinterpret_cast<Byte*>(tag.data()), length)
+        || !m_tags.push_back(Utility::move(tag)))
+      {
+        return false;
+      }
+
+      auto command{reinterpret_cast<ProfileCommand*>(allocate(sizeof(ProfileCommand)))};
+      command->tag = has_tag ? m_tags.last().data() : nullptr;
+      return true;
+    }
+  case CommandType::RESOURCE_UPDATE:
+    {
+      Uint64 update_type{0};
+      Resource* resource{nullptr};
+      Uint64 edits{0};
+      if (!decoder_.read_uint(update_type)
+        || !read_reference(decoder_, resource)
+        || !resource
+        || !decoder_.read_uint(edits))
+      {
+        return false;
+      }
+
+      Size edit_size{0};
+      switch (static_cast<UpdateCommand::Type>(update_type)) {
+      case UpdateCommand::Type::BUFFER:
+        edit_size = 3;
+        break;
+      case UpdateCommand::Type::TEXTURE1D:
+        edit_size = 3;
+        break;
+      case UpdateCommand::Type::TEXTURE2D:
+        edit_size = 5;
+        break;
+      case UpdateCommand::Type::TEXTURE3D:
+        edit_size = 7;
+        break;
+      default:
+        return false;
+      }
+
+      const Size edit_bytes{sizeof(Size) * edits * edit_size};
+      auto command{reinterpret_cast<UpdateCommand*>(
+        allocate(sizeof(UpdateCommand) + edit_bytes))};
+
+      command->type = static_cast<UpdateCommand::Type>(update_type);
+      command->edits = edits;
+
+      switch (command->type) {
+      case UpdateCommand::Type::BUFFER:
+        command->as_buffer = static_cast<Buffer*>(resource);
+        break;
+      case UpdateCommand::Type::TEXTURE1D:
+        command->as_texture1D = static_cast<Texture1D*>(resource);
+        break;
+      case UpdateCommand::Type::TEXTURE2D:
+        command->as_texture2D = static_cast<Texture2D*>(resource);
+        break;
+      case UpdateCommand::Type::TEXTURE3D:
+        command->as_texture3D = static_cast<Texture3D*>(resource);
+        break;
+      }
+
+      return decoder_.read_uint_array(command->edit(), edits * edit_size);
+    }
+  default:
+    return false;
+  }
+}
+
+template<typename T>
+bool Replay::read_reference(serialize::Decoder& decoder_, T*& resource_) {
+  // Zero is reserved for no resource.
+  Uint64 index{0};
+  if (!decoder_.read_uint(index) || index > m_resources.size()) {
+    return false;
+  }
+  resource_ = index ? static_cast<T*>(m_resources[index - 1]) : nullptr;
+  return true;
+}
+
+bool Replay::read_state(serialize::Decoder& decoder_, State& state_) {
+  return decoder_.read_byte_array(reinterpret_cast<Byte*>(&state_),
+    sizeof state_);
+}
+
+bool Replay::read_buffers(serialize::Decoder& decoder_, Buffers& buffers_) {
+  Uint64 n_buffers{0};
+  if (!decoder_.read_uint(n_buffers) || n_buffers > Buffers::k_max_buffers) {
+    return false;
+  }
+  for (Uint64 i{0}; i < n_buffers; i++) {
+    Uint64 buffer{0};
+    if (!decoder_.read_uint(buffer)) {
+      return false;
+    }
+    buffers_.add(static_cast<int>(buffer));
+  }
+  return true;
+}
+
+bool Replay::read_textures(serialize::Decoder& decoder_, Textures& textures_) {
+  Uint64 n_textures{0};
+  if (!decoder_.read_uint(n_textures) || n_textures > Textures::k_max_textures) {
+    return false;
+  }
+  for (Uint64 i{0}; i < n_textures; i++) {
+    Texture* texture{nullptr};
+    if (!read_reference(decoder_, texture)) {
+      return false;
+    }
+    textures_.add(texture);
+  }
+  return true;
+}
+
+bool Replay::read_string(serialize::Decoder& decoder_, String& string_) {
+  Uint64 size{0};
+  return decoder_.read_uint(size)
+    && string_.resize(size)
+    && decoder_.read_byte_array(reinterpret_cast<Byte*>(string_.data()), size);
+}
+
+void Replay::release() {
+  m_commands.clear();
+  m_command_buffer.reset();
+  m_tags.clear();
+  m_resources.clear();
+
+  // Destroy in the reverse order of creation so targets go before the
+  // textures attached to them.
+  m_owned.each_rev([this](Resource* _resource) {
+    switch (_resource->resource_type()) {
+    case Resource::Type::k_buffer:
+      m_frontend->destroy_buffer(RX_RENDER_TAG("replay"), static_cast<Buffer*>(_resource));
+      break;
+    case Resource::Type::k_target:
+      m_frontend->destroy_target(RX_RENDER_TAG("replay"), static_cast<Target*>(_resource));
+      break;
+    case Resource::Type::k_program:
+      m_frontend->destroy_program(RX_RENDER_TAG("replay"), static_cast<Program*>(_resource));
+      break;
+    case Resource::Type::k_texture1D:
+      m_frontend->destroy_texture(RX_RENDER_TAG("replay"), static_cast<Texture1D*>(_resource));
+      break;
+    case Resource::Type::k_texture2D:
+      m_frontend->destroy_texture(RX_RENDER_TAG("replay"), static_cast<Texture2D*>(_resource));
+      break;
+    case Resource::Type::k_texture3D:
+      m_frontend->destroy_texture(RX_RENDER_TAG("replay"), static_cast<Texture3D*>(_resource));
+      break;
+    case Resource::Type::k_textureCM:
+      m_frontend->destroy_texture(RX_RENDER_TAG("replay"), static_cast<TextureCM*>(_resource));
+      break;
+    case Resource::Type::k_downloader:
+      break;
+    }
+  });
+
+  m_owned.clear();
+}
+
+} // namespace rx::render::frontend
@@ -0,0 +1,93 @@
+#ifndef RX_RENDER_FRONTEND_REPLAY_H
+#define RX_RENDER_FRONTEND_REPLAY_H
+#include "rx/core/vector.h"
+#include "rx/core/string.h"
+
+#include "rx/math/vec2.h"
+
+#include "rx/render/frontend/command.h"
+
+namespace Rx {
+struct Stream;
+} // namespace rx
+
+namespace Rx::serialize {
+struct Decoder;
+} // namespace rx::serialize
+
+namespace Rx::Render::Backend {
+struct Context;
+} // namespace rx::render::backend
+
+namespace Rx::Render::Frontend {
+
+struct Context;
+struct Resource;
+
+// # Replay
+//
+// Loads a frame written by |Capture| and hands it's commands to a backend,
+// as many times as wanted.
+//
+// The resources of the capture are created on the frontend when loaded and
+// destroyed with the replay. The backend must be the one the frontend was
+// created with. The swapchain of the capture is replaced by the swapchain of
+// the frontend, which is resized to the dimensions of the capture.
+struct Replay {
+  RX_MARK_NO_COPY(Replay);
+  RX_MARK_NO_MOVE(Replay);
+
+  Replay(Context* _frontend, Backend::Context* _backend);
+  ~Replay();
+
+  // Load the capture in |_stream| and create it's resources.
+  bool load(Stream* _stream);
+
+  // Hand the commands of the capture to the backend.
+  void process();
+
+  Size commands() const;
+  const Math::Vec2z& dimensions() const &;
+
+private:
+  bool read_resource(serialize::Decoder& decoder_);
+  Resource* read_buffer(serialize::Decoder& decoder_);
+  Resource* read_target(serialize::Decoder& decoder_);
+  Resource* read_program(serialize::Decoder& decoder_);
+  Resource* read_texture(serialize::Decoder& decoder_, Uint64 _type);
+  bool read_command(serialize::Decoder& decoder_);
+
+  template<typename T>
+  bool read_reference(serialize::Decoder& decoder_, T*& resource_);
+  bool read_state(serialize::Decoder& decoder_, State& state_);
+  bool read_buffers(serialize::Decoder& decoder_, Buffers& buffers_);
+  bool read_textures(serialize::Decoder& decoder_, Textures& textures_);
+  bool read_string(serialize::Decoder& decoder_, String& string_);
+
+  void release();
+
+  Context* m_frontend;
+  Backend::Context* m_backend;
+
+  // Every resource in the order of the capture. The swapchain is in here
+  // too but not in |m_owned| since it's not created by the replay.
+  Vector<Resource*> m_resources;
+  Vector<Resource*> m_owned;
+
+  CommandBuffer m_command_buffer;
+  Vector<Byte*> m_commands;
+  Vector<String> m_tags;
+  Math::Vec2z m_dimensions;
+};
+
+inline Size Replay::commands() const {
+  return m_commands.size();
+}
+
+inline const Math::Vec2z& Replay::dimensions() const & {
+  return m_dimensions;
+}
+
+} // namespace rx::render::frontend
+
+#endif // RX_RENDER_FRONTEND_REPLAY_H
@@ -281,6 +281,9 @@ struct State {
 
   void flush();
 
+  // Hash of the whole state vector, only valid after |flush|.
+  Size hash() const;
+
   bool operator==(const State& _state) const;
   bool operator!=(const State& _state) const;
 
@@ -600,6 +603,10 @@ inline bool ViewportState::operator==(const ViewportState& _other) const {
 }
 
 // state
+inline Size State::hash() const {
+  return m_hash;
+}
+
 inline bool State::operator!=(const State& _state) const {
   return !operator==(_state);
 }
@@ -6,7 +6,7 @@
 
 #include "rx/core/json.h"
 #include "rx/core/optional.h"
-#include "rx/core/filesystem/file.h"
+#include "rx/core/filesystem/mapped_file.h"
 #include "rx/core/algorithm/topological_sort.h"
 
 RX_LOG("render/technique", logger);
@@ -535,7 +535,7 @@ bool Technique::load(Stream* _stream) {
 }
 
 bool Technique::load(const String& _file_name) {
-  if (Filesystem::File file{_file_name, "rb"}) {
+  if (Filesystem::MappedFile file{_file_name}) {
     return load(&file);
   }
   return false;
@@ -1,5 +1,6 @@
 #ifndef RX_RENDER_FRONTEND_TECHNIQUE_H
 #define RX_RENDER_FRONTEND_TECHNIQUE_H
+#include "rx/core/small_vector.h"
 #include "rx/core/log.h"
 
 #include "rx/render/frontend/program.h"
@@ -89,7 +90,7 @@ private:
 
     Shader::Type kind;
     String source;
-    Vector<String> dependencies;
+    SmallVector<String, 4> dependencies;
     Map<String, InOut> inputs;
     Map<String, InOut> outputs;
     String when;
@@ -3,7 +3,7 @@
 #include "rx/core/string.h"
 #include "rx/core/string_table.h"
 #include "rx/core/optional.h"
-#include "rx/core/map.h"
+#include "rx/core/flat_map.h"
 #include "rx/core/ptr.h"
 
 #include "rx/math/vec2.h"
@@ -239,7 +239,7 @@ private:
   Frontend::Technique* m_technique;
 
   // loaded fonts
-  Map<Font::Key, Ptr<Font>> m_fonts;
+  FlatMap<Font::Key, Ptr<Font>> m_fonts;
 
   // current scissor rectangle
   Math::Vec2i m_scissor_position;
@@ -7,7 +7,8 @@
 
 #include "rx/math/vec3.h"
 
-#include "rx/core/filesystem/file.h"
+#include "rx/core/filesystem/mapped_file.h"
+#include "rx/core/filesystem/read_queue.h"
 #include "rx/core/json.h"
 #include "rx/core/profiler.h"
 
@@ -78,7 +79,7 @@ void Skybox::render(Frontend::Target* _target, const Math::Mat4x4f& _view,
 }
 
 bool Skybox::load(const String& _file_name, const Math::Vec2z& _max_face_dimensions) {
-  if (Filesystem::File file{_file_name, "rb"}) {
+  if (Filesystem::MappedFile file{_file_name}) {
     return load(&file, _max_face_dimensions);
   }
   return false;
@@ -124,11 +125,18 @@ bool Skybox::load(Stream* _stream, const Math::Vec2z& _max_face_dimensions) {
                                  Frontend::Texture::WrapType::k_clamp_to_edge,
                                  Frontend::Texture::WrapType::k_clamp_to_edge});
 
+  // Read every face ahead of decoding them.
+  auto& queue{Filesystem::ReadQueue::instance()};
+  Vector<Filesystem::ReadQueue::Read> reads{m_frontend->allocator()};
+  faces.each([&](const JSON& _file_name) {
+    reads.push_back(queue.read(_file_name.as_string()));
+  });
+
   Math::Vec2z dimensions;
   Frontend::TextureCM::Face face{Frontend::TextureCM::Face::k_right};
-  bool result{faces.each([&](const JSON& file_name) {
+  bool result{reads.each_fwd([&](Filesystem::ReadQueue::Read& read_) {
     Texture::Loader texture{m_frontend->allocator()};
-    if (!texture.load(file_name.as_string(), Texture::PixelFormat::k_rgb_u8, _max_face_dimensions)) {
+    if (!texture.load(&read_, Texture::PixelFormat::k_rgb_u8, _max_face_dimensions)) {
       return false;
     }
 
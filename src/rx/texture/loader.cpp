@@ -3,7 +3,7 @@
 #include "rx/texture/loader.h"
 #include "rx/texture/scale.h"
 
-#include "rx/core/filesystem/file.h"
+#include "rx/core/filesystem/mapped_file.h"
 #include "rx/core/log.h"
 #include "rx/core/stream.h"
 
@@ -16,9 +16,24 @@ namespace Rx::Texture {
 bool Loader::load(Stream* _stream, PixelFormat _want_format,
   const Math::Vec2z& _max_dimensions)
 {
-  auto data = read_binary_stream(allocator(), _stream);
+  // Decode straight out of the stream when it can give a view of its contents,
+  // otherwise they have to be read into memory first.
+  Vector<Byte> contents{allocator()};
+  const Byte* data{nullptr};
+  Size size{0};
+  if (const auto stream_size = _stream->size()) {
+    size = static_cast<Size>(*stream_size);
+    data = _stream->view(size);
+  }
+
   if (!data) {
-    return false;
+    auto read = read_binary_stream(allocator(), _stream);
+    if (!read) {
+      return false;
+    }
+    contents = Utility::move(*read);
+    data = contents.data();
+    size = contents.size();
   }
 
   Math::Vec2<int> dimensions;
@@ -42,8 +57,8 @@ bool Loader::load(Stream* _stream, PixelFormat _want_format,
 
   int channels;
   Byte* decoded_image{stbi_load_from_memory(
-    data->data(),
-    static_cast<int>(data->size()),
+    data,
+    static_cast<int>(size),
     &dimensions.w,
     &dimensions.h,
     &channels,
@@ -132,7 +147,7 @@ bool Loader::load(Stream* _stream, PixelFormat _want_format,
 bool Loader::load(const String& _file_name, PixelFormat _want_format,
   const Math::Vec2z& _max_dimensions)
 {
-  if (Filesystem::File file{_file_name, "rb"}) {
+  if (Filesystem::MappedFile file{_file_name}) {
     return load(&file, _want_format, _max_dimensions);
   }
   return false;
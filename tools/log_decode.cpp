@@ -0,0 +1,76 @@
+#include <stdio.h> // printf, fprintf
+#include <time.h> // time_t, strftime
+
+#include "rx/core/filesystem/file.h"
+#include "rx/core/buffered_stream.h"
+#include "rx/core/global.h"
+#include "rx/core/log.h"
+
+// Expands a binary log, as written with the "log.binary" console variable,
+// into the same text the engine writes to "log.log".
+//
+// Deferred messages are stored in a binary log with their arguments but
+// unformatted, this formats them with the format strings stored in the log.
+//
+// Usage: log_decode FILE
+
+using namespace Rx;
+
+static const char* string_for_level(Log::Level _level) {
+  switch (_level) {
+  case Log::Level::k_error:
+    return "error";
+  case Log::Level::k_warning:
+    return "warning";
+  case Log::Level::k_info:
+    return "info";
+  case Log::Level::k_verbose:
+    return "verbose";
+  }
+  return "?";
+}
+
+int main(int _argc, char** _argv) {
+  if (_argc != 2) {
+    fprintf(stderr, "usage: %s FILE\n", _argv[0]);
+    return 1;
+  }
+
+  if (!Globals::link()) {
+    return 1;
+  }
+
+  Globals::init();
+
+  int status{0};
+  {
+    Filesystem::File file{_argv[1], "rb"};
+    // Records are read a field at a time, not a read of the file each.
+    BufferedStream buffered{&file};
+    if (!file) {
+      fprintf(stderr, "failed to open '%s'\n", _argv[1]);
+      status = 1;
+    } else if (!Log::read_binary(&buffered, [](const char* _name, Log::Level _level,
+      Sint64 _time, const String& _contents)
+    {
+      const time_t time{static_cast<time_t>(_time)};
+      struct tm tm;
+#if defined(RX_PLATFORM_WINDOWS)
+      localtime_s(&tm, &time);
+#else
+      localtime_r(&time, &tm);
+#endif
+      char date[64];
+      strftime(date, sizeof date, "%Y-%m-%d %H:%M:%S", &tm);
+      printf("[%s] [%s/%s] | %s\n", date, _name, string_for_level(_level),
+        _contents.data());
+    })) {
+      fprintf(stderr, "'%s' is not a binary log or is truncated\n", _argv[1]);
+      status = 1;
+    }
+  }
+
+  Globals::fini();
+
+  return status;
+}
@@ -0,0 +1,243 @@
+#include <stdio.h> // printf, fprintf
+#include <stdlib.h> // strtoul
+#include <string.h> // memcpy, strcmp, strncmp
+
+#include "rx/core/filesystem/archive.h"
+#include "rx/core/filesystem/directory.h"
+#include "rx/core/filesystem/file.h"
+#include "rx/core/compression/lz4.h"
+#include "rx/core/algorithm/quick_sort.h"
+#include "rx/core/global.h"
+
+// Packs every file in a directory, and the directories in it, into an archive
+// for |Filesystem::Archive|.
+//
+// Files are stored under their path as it's given here, so run it from where
+// the engine runs with the same relative path the engine loads files with,
+// e.g. "pack base base.pak" for files loaded as "base/...".
+//
+// With --compress files are compressed with LZ4 when that makes them at least
+// an eighth smaller, the rest are stored as they are so they can be used in
+// place. Every file starts on a multiple of --align bytes.
+//
+// Usage: pack DIRECTORY ARCHIVE [--compress] [--align=N]
+
+using namespace Rx;
+
+struct Options {
+  const char* directory;
+  const char* archive;
+  bool compress;
+  Uint32 alignment;
+};
+
+struct Item {
+  String path;
+  String name;
+  Uint64 hash;
+};
+
+static bool parse(int _argc, char** _argv, Options& options_) {
+  for (int i{1}; i < _argc; i++) {
+    const char* argument{_argv[i]};
+    if (!strcmp(argument, "--compress")) {
+      options_.compress = true;
+    } else if (!strncmp(argument, "--align=", 8)) {
+      options_.alignment = static_cast<Uint32>(strtoul(argument + 8, nullptr, 10));
+    } else if (!options_.directory && strncmp(argument, "--", 2)) {
+      options_.directory = argument;
+    } else if (!options_.archive && strncmp(argument, "--", 2)) {
+      options_.archive = argument;
+    } else {
+      return false;
+    }
+  }
+  return options_.directory && options_.archive && options_.alignment != 0
+    && (options_.alignment & (options_.alignment - 1)) == 0;
+}
+
+static bool collect(Filesystem::Directory& _directory, Vector<Item>& items_) {
+  bool result{true};
+  _directory.each([&](Filesystem::Directory::Item&& item_) {
+    if (item_.is_directory()) {
+      if (auto directory = item_.as_directory(); !directory || !collect(*directory, items_)) {
+        result = false;
+      }
+      return;
+    }
+
+    auto path{String::format("%s/%s", _directory.path(), item_.name())};
+
+    Filesystem::PathResolver resolver;
+    if (!Filesystem::Archive::resolve(path.data(), resolver)) {
+      fprintf(stderr, "cannot store '%s' in an archive\n", path.data());
+      result = false;
+      return;
+    }
+
+    String name{resolver.path()};
+    const auto hash{Filesystem::Archive::hash(name.data())};
+    items_.push_back(Item{Utility::move(path), Utility::move(name), hash});
+  });
+  return result;
+}
+
+static bool pad(Filesystem::File& file_, Uint64 _size) {
+  static constexpr const Byte k_zero[64]{};
+  while (_size) {
+    const Uint64 size{_size < sizeof k_zero ? _size : sizeof k_zero};
+    if (file_.write(k_zero, size) != size) {
+      return false;
+    }
+    _size -= size;
+  }
+  return true;
+}
+
+static bool pack(const Options& _options) {
+  using Archive = Filesystem::Archive;
+
+  Filesystem::Directory directory{_options.directory};
+  if (!directory) {
+    fprintf(stderr, "failed to open '%s'\n", _options.directory);
+    return false;
+  }
+
+  Vector<Item> items;
+  if (!collect(directory, items)) {
+    return false;
+  }
+
+  Algorithm::quick_sort(items.data(), items.data() + items.size(),
+    [](const Item& _lhs, const Item& _rhs) { return _lhs.hash < _rhs.hash; });
+
+  // Files are found by hash alone, two with the same hash can't be told apart.
+  for (Size i{1}; i < items.size(); i++) {
+    if (items[i - 1].hash == items[i].hash) {
+      fprintf(stderr, "'%s' and '%s' have the same hash, rename one\n",
+        items[i - 1].name.data(), items[i].name.data());
+      return false;
+    }
+  }
+
+  Vector<Archive::Entry> entries{items.size()};
+
+  Vector<char> names;
+  for (Size i{0}; i < items.size(); i++) {
+    const auto& name{items[i].name};
+    entries[i].hash = items[i].hash;
+    entries[i].name = static_cast<Uint32>(names.size());
+    if (!names.resize(names.size() + name.size() + 1)) {
+      return false;
+    }
+    memcpy(names.data() + entries[i].name, name.data(), name.size() + 1);
+  }
+
+  Archive::Header header;
+  memcpy(header.magic, "RXPK", sizeof header.magic);
+  header.version = Archive::k_version;
+  header.entries = static_cast<Uint32>(entries.size());
+  header.alignment = _options.alignment;
+  header.names_offset = sizeof header + entries.size() * sizeof(Archive::Entry);
+  header.names_size = names.size();
+
+  Filesystem::File file{_options.archive, "wb"};
+  if (!file) {
+    fprintf(stderr, "failed to open '%s'\n", _options.archive);
+    return false;
+  }
+
+  // The index is written again once the data is, when it's all known.
+  Uint64 offset{header.names_offset + header.names_size};
+  if (file.write(reinterpret_cast<const Byte*>(&header), sizeof header) != sizeof header
+    || file.write(reinterpret_cast<const Byte*>(entries.data()),
+                  entries.size() * sizeof(Archive::Entry)) != entries.size() * sizeof(Archive::Entry)
+    || file.write(reinterpret_cast<const Byte*>(names.data()), names.size()) != names.size())
+  {
+    fprintf(stderr, "failed to write '%s'\n", _options.archive);
+    return false;
+  }
+
+  Uint64 total_size{0};
+  Uint64 total_stored_size{0};
+
+  Vector<Byte> compressed;
+  for (Size i{0}; i < items.size(); i++) {
+    auto contents{Filesystem::read_binary_file(items[i].path)};
+    if (!contents) {
+      return false;
+    }
+
+    const Byte* data{contents->data()};
+    Uint64 size{contents->size()};
+
+    auto& entry{entries[i]};
+    entry.size = size;
+    entry.compression = Archive::Compression::k_none;
+
+    // Only worth it when it makes the file at least an eighth smaller.
+    if (_options.compress && size != 0) {
+      const Size capacity{Size(size - size / 8)};
+      if (!compressed.resize(capacity, Utility::UninitializedTag{})) {
+        return false;
+      }
+      if (const auto compressed_size = Compression::lz4_compress(data, Size(size),
+        compressed.data(), capacity))
+      {
+        data = compressed.data();
+        size = compressed_size;
+        entry.compression = Archive::Compression::k_lz4;
+      }
+    }
+
+    const Uint64 alignment{header.alignment};
+    const Uint64 padding{(alignment - offset % alignment) % alignment};
+    if (!pad(file, padding) || file.write(data, size) != size) {
+      fprintf(stderr, "failed to write '%s'\n", _options.archive);
+      return false;
+    }
+
+    entry.offset = offset + padding;
+    entry.stored_size = size;
+    offset = entry.offset + size;
+
+    total_size += entry.size;
+    total_stored_size += entry.stored_size;
+  }
+
+  if (!file.seek(sizeof header, Stream::Whence::SET)
+    || file.write(reinterpret_cast<const Byte*>(entries.data()),
+                  entries.size() * sizeof(Archive::Entry)) != entries.size() * sizeof(Archive::Entry))
+  {
+    fprintf(stderr, "failed to write '%s'\n", _options.archive);
+    return false;
+  }
+
+  printf("%s:\n", _options.archive);
+  printf("  files:  %zu\n", items.size());
+  printf("  size:   %llu bytes\n", static_cast<unsigned long long>(total_size));
+  printf("  stored: %llu bytes\n", static_cast<unsigned long long>(total_stored_size));
+  printf("  total:  %llu bytes\n", static_cast<unsigned long long>(offset));
+
+  return true;
+}
+
+int main(int _argc, char** _argv) {
+  Options options{nullptr, nullptr, false, 16};
+  if (!parse(_argc, _argv, options)) {
+    fprintf(stderr, "usage: %s DIRECTORY ARCHIVE [--compress] [--align=N]\n", _argv[0]);
+    return 1;
+  }
+
+  if (!Globals::link()) {
+    return 1;
+  }
+
+  Globals::init();
+
+  const bool result{pack(options)};
+
+  Globals::fini();
+
+  return result ? 0 : 1;
+}